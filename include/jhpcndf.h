@@ -12,6 +12,56 @@
 
 #ifndef INTERFACE_H
 #define INTERFACE_H
+#include <stddef.h>
+
+//@brief JHPCNDF::fopen_callbacksで使う利用者定義の入出力先
+//
+//write: ptrからsizeバイトを出力し、出力したサイズを返す
+//read:  ptrへ最大sizeバイトを読み込み、読み込んだサイズを返す
+//       sizeより小さい値を返した場合は入力元の終端に達したものとして扱う
+//context: write/readの第3引数としてそのまま渡される
+//
+//圧縮済データはIOバッファサイズ程度の断片毎にwrite/readが呼ばれる
+//書き込み専用/読み込み専用で使う場合は、使わない方の関数はNULLで良い
+typedef struct
+{
+  size_t (*write)(const void* ptr, size_t size, void* context);
+  size_t (*read)(void* ptr, size_t size, void* context);
+  void* context;
+} JHPCNDF_Callbacks;
+
+//@brief JHPCNDF_fwrite_batchに渡す1つの配列の出力指定 (各メンバの意味はJHPCNDF::WriteRequestと同じ)
+//
+//encにNULLを指定した時は"binary_search"を使う
+typedef struct
+{
+  const void* ptr;
+  size_t size;
+  size_t nmemb;
+  float tolerance;
+  int is_relative;
+  const char* enc;
+} JHPCNDF_WriteRequest;
+
+//@brief JHPCNDF_fwrite_statistics_float/doubleが返す統計情報 (各メンバの意味はJHPCNDF::EncodeStatisticsと同じ)
+//
+//histogramは先頭のnum_bins要素だけが有効 (分割位置を持たないエンコーダでは0)
+typedef struct
+{
+  size_t histogram[53];
+  size_t num_bins;
+  size_t num_elements;
+  size_t num_full_mantissa;
+  double max_error;
+  double rms_error;
+  size_t upper_bytes_in;
+  size_t upper_bytes_out;
+  size_t lower_bytes_in;
+  size_t lower_bytes_out;
+  double encode_time;
+  double upper_output_time;
+  double lower_output_time;
+} JHPCNDF_EncodeStatistics;
 
 #ifdef __cplusplus
 
@@ -19,6 +69,8 @@
 // Interface routines for C++
 //
 #include <string>
+#include <vector>
+#include <iterator>
 namespace JHPCNDF
 {
     //@brief ファイルを開く
@@ -45,11 +97,57 @@ namespace JHPCNDF
     int fopen(const std::string& filename_upper, const std::string& filename_lower = "", const char* mode = "rb", const std::string& comp = "gzip", const size_t& buff_size=32768);
 
 
+    //@brief 大きなブロック単位の非同期入出力を使ってファイルを開く
+    //@param filename_upper 上位bit側のデータを格納するファイルの名前
+    //@param filename_lower 下位bit側のデータを格納するファイルの名前
+    //@param mode           "r", "rb"(読み込み用) または "w", "wb"(書き込み用)
+    //@param comp           圧縮形式(JHPCNDF::fopenの項を参照のこと)
+    //@param buff_size      圧縮/伸張する際のバッファサイズ(単位はbyte)
+    //@param queue_depth    同時に発行する入出力要求の数
+    //@param block_size     1要求あたりのサイズ(単位はbyte, 4KiB単位に切り上げる)
+    //@param direct_io      trueの時はO_DIRECTを指定して開く(開けなかった場合は指定せずに開く)
+    //@ret   開いたファイルを識別するためのID番号 (エラー時は負の値)
+    //
+    //圧縮済データをblock_size毎にまとめ、最大queue_depth個の要求を同時に発行して出力する
+    //読み込み時は同様に先読みを行う
+    //ビルド時に-DUSE_IO_URINGを指定した時(cmakeでは-Dwith_io_uring=yes)はio_uringを使う
+    //それ以外の場合やカーネルがio_uringに対応していない場合は、pwrite/preadで同期的に入出力する
+    int fopen_async(const std::string& filename_upper, const std::string& filename_lower = "", const char* mode = "rb", const std::string& comp = "gzip", const size_t& buff_size=32768, const size_t& queue_depth=4, const size_t& block_size=1048576, const bool& direct_io=false);
+
+
+    //@brief ファイルの代わりに利用者定義の入出力先を開く
+    //@param upper          上位bit側のデータの入出力先
+    //@param lower          下位bit側のデータの入出力先(下位bit側を入出力しない時はNULL)
+    //@param comp           圧縮形式(JHPCNDF::fopenの項を参照のこと)
+    //@param buff_size      圧縮/伸張する際のバッファサイズ(単位はbyte)
+    //@ret   開いた入出力先を識別するためのID番号
+    //
+    //返されたID番号はJHPCNDF::fopenのものと同様にfwrite/fread/fclose等に使う
+    //upper, lowerの内容はコピーして保持するので、呼び出し後に破棄しても良い
+    //upperがNULLの場合は負の値を返す
+    int fopen_callbacks(const JHPCNDF_Callbacks* upper, const JHPCNDF_Callbacks* lower = NULL, const std::string& comp = "gzip", const size_t& buff_size=32768);
+
+
     //@brief JHPCNDF::fopenで開いたファイルを閉じる
     //@param key 閉じるファイルを識別するためのID番号
     void fclose(const int& key);
 
 
+    //@brief fwrite/freadが内部で使う作業領域の保持サイズの上限を設定する
+    //@param key  対象ファイルを識別するためのID番号
+    //@param size 呼び出しをまたいで保持する作業領域の上限(単位はbyte)
+    //
+    //作業領域はファイル毎に確保され、fcloseされるまで次回以降の呼び出しで再利用される
+    //保持している領域の合計がsizeを越えた場合は、呼び出しの終了時に全て解放する
+    //0を指定すると毎回解放する。デフォルトは無制限
+    void set_scratch_capacity(const int& key, const size_t& size);
+
+
+    //@brief fwrite/freadが内部で保持している作業領域を解放する
+    //@param key  対象ファイルを識別するためのID番号
+    void release_scratch(const int& key);
+
+
     //@brief 渡されたデータを圧縮した上でファイルに出力する
     //@param ptr            出力するデータ
     //@param size           出力するデータの1wordの長さ(float=4, double=8で固定）
@@ -61,17 +159,98 @@ namespace JHPCNDF
     //@param time_measuring trueが指定されると、処理にかかった時間を計測し標準エラー出力ヘ出力する
     //@param byte_swap      ファイル出力時にエンディアン変換を行う
     //
-    //encに指定できるエンコーダは以下の6種類がある
+    //encに指定できるエンコーダは以下の7種類がある
     //  original:      論文どおりの実装
     //  linear_search: 分割位置を線形探索により上位bitから順に探す
     //  binary_search: 分割位置を二分探索で探す
     //  byte_aligned:  上位bitと下位bitの分割位置を8*n bitの位置に制限する
+    //  quantize:      幅2*toleranceのビンに量子化し、上位bit側はzlib等の代わりにrANSで符号化して出力する
     //  nbit_filter:   指定されたbit位置（tolerance) 以下を0埋めする
     //  dummy:         分割しない（全てのデータを上位bit側に出力する)
     template <typename T>
     size_t fwrite(const T* ptr, size_t size, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative=true, const std::string& enc="binary_search", const bool& time_measuring = false, const bool& byte_swap=false);
 
 
+    //@brief JHPCNDF::fwrite, JHPCNDF::encodeが1回の呼び出し毎に集計する統計情報
+    //
+    //誤差は元データと上位bit側データ(quantizeの場合は復元値)の差の絶対値
+    //時間の単位は秒、ファイルに出力しない場合や下位bit側を出力しない場合の該当メンバは0
+    struct EncodeStatistics
+    {
+      EncodeStatistics()
+      {
+        clear();
+      }
+      void clear(void)
+      {
+        histogram.clear();
+        num_elements=0;
+        num_full_mantissa=0;
+        max_error=0.0;
+        rms_error=0.0;
+        upper_bytes_in=0;
+        upper_bytes_out=0;
+        lower_bytes_in=0;
+        lower_bytes_out=0;
+        encode_time=0.0;
+        upper_output_time=0.0;
+        lower_output_time=0.0;
+      }
+      std::vector<size_t> histogram; //histogram[n]: 下位nbitを0埋めした要素数 (分割位置を持たないエンコーダでは空)
+      size_t num_elements;           //エンコードした要素数
+      size_t num_full_mantissa;      //許容誤差を満たすために仮数部を全て残した要素数 (histogram[0])
+      double max_error;              //誤差の最大値
+      double rms_error;              //誤差の二乗平均平方根
+      size_t upper_bytes_in;         //上位bit側のエンコード前のサイズ(byte)
+      size_t upper_bytes_out;        //上位bit側の出力サイズ(byte)
+      size_t lower_bytes_in;         //下位bit側のエンコード前のサイズ(byte)
+      size_t lower_bytes_out;        //下位bit側の出力サイズ(byte)
+      double encode_time;            //エンコードにかかった時間
+      double upper_output_time;      //上位bit側の圧縮と出力にかかった時間
+      double lower_output_time;      //下位bit側の圧縮と出力にかかった時間
+    };
+
+
+    //@brief 統計情報を集計しながら圧縮してファイルに出力する (float, doubleのみ)
+    //@param statistics 今回の呼び出しの統計情報で上書きする
+    //
+    //その他の引数と出力内容はJHPCNDF::fwriteと同じ
+    //エンコーダのループ内では要素毎の分割位置を記録するだけで、ヒストグラムと誤差はエンコード後にスレッド毎のカウンタで1回だけ集計する
+    template <typename T>
+    size_t fwrite(const T* ptr, size_t size, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc, EncodeStatistics* statistics);
+
+
+
+    //@brief JHPCNDF::fwrite_batchに渡す1つの配列の出力指定
+    struct WriteRequest
+    {
+      //@param arg_ptr         出力するデータ
+      //@param arg_size        1要素のサイズ (float=4, double=8)
+      //@param arg_nmemb       要素数
+      //@param arg_tolerance   許容誤差
+      //@param arg_is_relative 許容誤差を相対値で指定するかどうかのフラグ
+      //@param arg_enc         使用するエンコーダの種類
+      WriteRequest(const void* arg_ptr, const size_t& arg_size, const size_t& arg_nmemb, const float& arg_tolerance, const bool& arg_is_relative=true, const std::string& arg_enc="binary_search")
+        :ptr(arg_ptr), size(arg_size), nmemb(arg_nmemb), tolerance(arg_tolerance), is_relative(arg_is_relative), enc(arg_enc) {}
+      const void* ptr;
+      size_t      size;
+      size_t      nmemb;
+      float       tolerance;
+      bool        is_relative;
+      std::string enc;
+    };
+
+
+    //@brief 複数の配列をまとめてエンコード、圧縮してファイルに出力する
+    //@param requests 出力する配列の指定 (指定した順にレコードを出力する)
+    //@param key      出力先ファイルを識別するためのID番号
+    //@ret   出力したデータサイズの合計 エラー時は0 (この時は何も出力しない)
+    //
+    //全ての配列のエンコードと圧縮を1つの並列領域内のOpenMPタスクとして実行するので、小さな配列が多数ある場合も
+    //スレッドを有効に使える
+    //出力されるレコードはrequestsの各要素についてJHPCNDF::fwriteを順に呼んだ場合と同じなので、JHPCNDF::freadで順に読み込める
+    size_t fwrite_batch(const std::vector<WriteRequest>& requests, const int& key);
+
 
     //@brief 指定されたファイルからデータを読み込む
     //@param ptr       ファイルから読み込んだデータを格納する領域
@@ -86,6 +265,272 @@ namespace JHPCNDF
     size_t fread(T* ptr, size_t size, size_t nmemb, const int& key, const bool& byte_swap=false);
 
 
+    //@brief 要素毎に異なる許容誤差を指定して圧縮し、ファイルに出力する (float, doubleのみ)
+    //@param ptr         出力するデータ
+    //@param nmemb       出力するデータの要素数
+    //@param key         出力先ファイルを識別するためのID番号
+    //@param tolerances  要素毎の許容誤差 (nmemb要素)
+    //@param is_relative 許容誤差を相対値で指定するかどうかのフラグ
+    //@param enc         使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+    //@ret   上位bit側に出力したデータサイズ
+    //
+    //壁面付近など一部の領域だけ精度が必要な場合に、他の領域の許容誤差を緩めて圧縮率を上げるために使う
+    //quantizeは最も厳しい許容誤差でビン幅を決め、nbit_filter, dummyは要素毎の許容誤差を使わない
+    //出力されるレコードはJHPCNDF::fwriteと同じ形式なので、JHPCNDF::freadで読み込める
+    template <typename T>
+    size_t fwrite_tolerance_field(const T* ptr, size_t nmemb, const int& key, const float* tolerances, const bool& is_relative=true, const std::string& enc="binary_search");
+
+
+    //@brief 領域毎の許容誤差を、要素毎の領域番号と許容誤差の表で指定して圧縮し、ファイルに出力する (float, doubleのみ)
+    //@param ptr         出力するデータ
+    //@param nmemb       出力するデータの要素数
+    //@param key         出力先ファイルを識別するためのID番号
+    //@param mask        要素毎の領域番号 (nmemb要素)
+    //@param table       領域番号毎の許容誤差 (i番目の要素の許容誤差はtable[mask[i]])
+    //@param is_relative 許容誤差を相対値で指定するかどうかのフラグ
+    //@param enc         使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+    //@ret   上位bit側に出力したデータサイズ maskにtableの範囲外の値が含まれる場合は0
+    //
+    //エンコーダ毎の扱いはJHPCNDF::fwrite_tolerance_fieldと同じ
+    template <typename T>
+    size_t fwrite_tolerance_mask(const T* ptr, size_t nmemb, const int& key, const unsigned char* mask, const std::vector<float>& table, const bool& is_relative=true, const std::string& enc="binary_search");
+
+
+    //@brief 多次元配列の部分領域の指定
+    //
+    //配列は次元0が最も速く変化する順(index = i0 + n0*(i1 + n1*i2) ...)に並んでいるものとする
+    //部分領域の次元dの要素は、offsets[d], offsets[d]+strides[d], ... , offsets[d]+(counts[d]-1)*strides[d]
+    struct Subarray
+    {
+      //@param ndims   次元数
+      //@param extents 配列全体の各次元の要素数
+      //@param offsets 部分領域の先頭位置 (0始まり)
+      //@param counts  部分領域の各次元の要素数
+      //@param strides 部分領域内で何要素おきに取り出すか (NULLの場合は全て1)
+      Subarray(const size_t& ndims, const size_t* arg_extents, const size_t* arg_offsets, const size_t* arg_counts, const size_t* arg_strides=NULL)
+        :extents(arg_extents, arg_extents+ndims), offsets(arg_offsets, arg_offsets+ndims), counts(arg_counts, arg_counts+ndims), strides(ndims, 1)
+      {
+        if(arg_strides != NULL)
+        {
+          strides.assign(arg_strides, arg_strides+ndims);
+        }
+      }
+      //@brief 全ての次元の両端からhalo要素ずつ袖領域を除いた内部領域を指定する
+      Subarray(const size_t& ndims, const size_t* arg_extents, const size_t& halo)
+        :extents(arg_extents, arg_extents+ndims), offsets(ndims, halo), counts(ndims, 0), strides(ndims, 1)
+      {
+        for(size_t d=0; d<ndims; d++)
+        {
+          counts[d] = extents[d] > 2*halo ? extents[d]-2*halo : 0;
+        }
+      }
+      std::vector<size_t> extents;
+      std::vector<size_t> offsets;
+      std::vector<size_t> counts;
+      std::vector<size_t> strides;
+    };
+
+
+    //@brief 多次元配列のうち指定した部分領域のみを圧縮してファイルに出力する (float, doubleのみ)
+    //@param ptr         出力する配列全体の先頭
+    //@param subarray    出力する部分領域
+    //@param key         出力先ファイルを識別するためのID番号
+    //@param tolerance   許容誤差
+    //@param is_relative 許容誤差を相対値で指定するかどうかのフラグ
+    //@param enc         使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+    //@ret   上位bit側に出力したデータサイズ 部分領域の指定が不正な場合は0
+    //
+    //袖領域を除いた内部領域を出力する場合などに、連続領域へコピーせずにエンコード時に直接取り出す
+    //出力されるレコードは部分領域を連続領域にコピーしてJHPCNDF::fwriteで出力した場合と同じなので、
+    //JHPCNDF::freadで部分領域の要素数を指定して読み込むこともできる
+    template <typename T>
+    size_t fwrite_subarray(const T* ptr, const Subarray& subarray, const int& key, const float& tolerance, const bool& is_relative=true, const std::string& enc="binary_search");
+
+
+    //@brief ファイルから読み込んだデータを多次元配列の部分領域へ書き戻す (float, doubleのみ)
+    //@param ptr      書き戻す配列全体の先頭 (部分領域以外の要素は変更しない)
+    //@param subarray 書き戻す部分領域
+    //@param key      読み込むファイルを識別するためのID番号
+    //@ret   JHPCNDF::freadと同じ 部分領域の指定が不正な場合は0
+    template <typename T>
+    size_t fread_subarray(T* ptr, const Subarray& subarray, const int& key);
+
+
+    //@brief 上位bit側の出力サイズが目標値以下になるように許容誤差を決めて出力する (float, doubleのみ)
+    //@param ptr            出力するデータ
+    //@param nmemb          出力するデータの要素数
+    //@param key            出力先ファイルを識別するためのID番号
+    //@param target_size    上位bit側の出力サイズの目標値(Byte)
+    //@param tolerance_used 実際に使った許容誤差を返す (NULLの場合は返さない)
+    //@param is_relative    許容誤差を相対値で指定するかどうかのフラグ
+    //@param enc            使用するエンコーダの種類(nbit_filter, dummy以外)
+    //@ret   上位bit側に出力したデータサイズ
+    //
+    //配列から抜き出したサンプルを試しにエンコード、圧縮して、推定サイズが目標値以下になる最も厳しい許容誤差を探す
+    //サンプルからの推定値を使うので、実際の出力サイズは目標値をわずかに超えることがある
+    //最も緩い許容誤差(相対誤差では1)でも目標値に届かない場合は、その許容誤差で出力する
+    //出力されるレコードはJHPCNDF::fwriteと同じ形式なので、JHPCNDF::freadで読み込める
+    template <typename T>
+    size_t fwrite_target_size(const T* ptr, size_t nmemb, const int& key, const size_t& target_size, float* tolerance_used=NULL, const bool& is_relative=true, const std::string& enc="binary_search");
+
+
+    //@brief 上位bit側の圧縮率(元データのサイズ/出力サイズ)が目標値以上になるように許容誤差を決めて出力する (float, doubleのみ)
+    //@param target_ratio 圧縮率の目標値
+    //
+    //その他の引数と返り値はJHPCNDF::fwrite_target_sizeと同じ
+    template <typename T>
+    size_t fwrite_target_ratio(const T* ptr, size_t nmemb, const int& key, const double& target_ratio, float* tolerance_used=NULL, const bool& is_relative=true, const std::string& enc="binary_search");
+
+    //@brief 成分が交互に並んだ配列(u,v,w,u,v,w,...)を成分毎のレコードに分けて出力する (float, doubleのみ)
+    //@param ptr            出力するデータ
+    //@param num_components 成分数
+    //@param nmemb          1成分あたりの要素数
+    //@param key            出力先ファイルを識別するためのID番号
+    //@param tolerances     成分毎の許容誤差 (要素数が1の場合は全成分で共通の値を使う)
+    //@param is_relative    許容誤差を相対値で指定するかどうかのフラグ
+    //@param enc            使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+    //@ret   上位bit側に出力したデータサイズの合計 引数が不正な場合は0
+    //
+    //値の大きさが異なる成分を分けてエンコード、圧縮するので、1つの配列として出力するより圧縮率が良くなる
+    //各成分はエンコード時に元の配列から直接取り出し、JHPCNDF::fwriteで出力した場合と同じ形式のレコードとして
+    //成分の順に出力する
+    template <typename T>
+    size_t fwrite_components(const T* ptr, const size_t& num_components, size_t nmemb, const int& key, const std::vector<float>& tolerances, const bool& is_relative=true, const std::string& enc="binary_search");
+
+    //@brief 全成分で共通の許容誤差を使うJHPCNDF::fwrite_components
+    template <typename T>
+    size_t fwrite_components(const T* ptr, const size_t& num_components, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative=true, const std::string& enc="binary_search");
+
+
+    //@brief JHPCNDF::fwrite_componentsで出力したデータを読み込み、成分が交互に並んだ配列に戻す (float, doubleのみ)
+    //@param ptr            読み込んだデータを格納する領域 (num_components*nmemb要素)
+    //@param num_components 成分数
+    //@param nmemb          1成分あたりの要素数
+    //@param key            読み込むファイルを識別するためのID番号
+    //@ret   JHPCNDF::freadの返り値の全成分の合計
+    template <typename T>
+    size_t fread_components(T* ptr, const size_t& num_components, size_t nmemb, const int& key);
+
+
+    //@brief 同じ変数の時系列データを、直前のステップとの差分(上位bitのXOR)として出力する (float, doubleのみ)
+    //@param ptr               出力するデータ
+    //@param nmemb             出力するデータの要素数
+    //@param key               出力先ファイルを識別するためのID番号
+    //@param variable          変数名 (変数毎に直前のステップを保持する)
+    //@param tolerance         許容誤差
+    //@param is_relative       許容誤差を相対値で指定するかどうかのフラグ
+    //@param enc               使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+    //@param keyframe_interval キーフレーム(差分を取らずに出力するレコード)を出力する間隔
+    //@ret   出力したデータサイズ
+    //
+    //ゆっくり変化する場のデータでは、上位bitの大半が直前のステップと一致するため圧縮率が向上する
+    //最初のレコードと、要素数や型が変わったレコードは必ずキーフレームになる
+    //下位bit側はJHPCNDF::fwriteと同じ形式で出力する
+    //出力したデータはJHPCNDF::fread_temporalで、出力した時と同じ変数の順に読み込む必要がある
+    template <typename T>
+    size_t fwrite_temporal(const T* ptr, size_t nmemb, const int& key, const std::string& variable, const float& tolerance, const bool& is_relative=true, const std::string& enc="binary_search", const int& keyframe_interval=10);
+
+
+    //@brief JHPCNDF::fwrite_temporalで出力したデータを読み込む (float, doubleのみ)
+    //@param ptr       ファイルから読み込んだデータを格納する領域
+    //@param nmemb     読み込むデータの要素数
+    //@param key       読み込むファイルを識別するためのID番号
+    //@param variable  変数名
+    //@ret   読み込んだ要素数 レコードの形式が一致しない場合は0
+    template <typename T>
+    size_t fread_temporal(T* ptr, size_t nmemb, const int& key, const std::string& variable);
+
+
+    //@brief サンプルデータから作ったプリセット辞書をファイルに設定する (float, doubleのみ)
+    //@param sample      辞書の元にするデータ (直前のレコードや代表的なデータ)
+    //@param nmemb       サンプルデータの要素数
+    //@param key         出力先ファイルを識別するためのID番号
+    //@param tolerance   許容誤差
+    //@param is_relative 許容誤差を相対値で指定するかどうかのフラグ
+    //@param enc         使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+    //@ret   0:  正常終了
+    //       -1: keyに対応するファイルが無い、またはサンプルデータが空
+    //       -2: 既にレコードや辞書を出力している
+    //       -3: 圧縮形式が辞書に対応していない (gzip以外)
+    //       -4: 辞書の出力に失敗した
+    //
+    //サンプルデータを以降の出力と同じ設定でエンコードし、上位bit側、下位bit側それぞれの辞書とする
+    //辞書はファイルの先頭に1回だけ格納され、以降のレコードは全て辞書を使って圧縮される
+    //数十KB程度の小さいレコードを多数出力する場合に、各レコードの先頭部分の圧縮率が改善する
+    //読み込み時は辞書を自動的に読み込むので、特別な操作は不要
+    //fopenの直後、最初のレコードを出力する前に呼ぶこと
+    template <typename T>
+    int set_dictionary(const T* sample, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative=true, const std::string& enc="binary_search");
+
+
+    //@brief 構造格子上の配列を、Lorenzo予測との残差としてエンコードしてファイルに出力する (float, doubleのみ)
+    //@param ptr         出力するデータ
+    //@param nx          x方向の要素数 (最も速く変化する方向)
+    //@param ny          y方向の要素数 (2次元配列の時はny, 1次元配列の時はny, nzに1を指定する)
+    //@param nz          z方向の要素数
+    //@param key         出力先ファイルを識別するためのID番号
+    //@param tolerance   許容誤差
+    //@param is_relative 許容誤差を相対値で指定するかどうかのフラグ
+    //@ret   出力したデータサイズ
+    //
+    //各要素を再構成済の近傍の値から予測し、予測値との残差を許容誤差以内で切り詰めて上位bit側に出力する
+    //滑らかな場では残差が0に近くなるため、fwriteより高い圧縮率が得られる
+    //下位bit側も合わせて読み込めば元データに戻る
+    //出力したデータはJHPCNDF::fread_lorenzoで読み込む必要がある
+    template <typename T>
+    size_t fwrite_lorenzo(const T* ptr, const size_t& nx, const size_t& ny, const size_t& nz, const int& key, const float& tolerance, const bool& is_relative=true);
+
+
+    //@brief JHPCNDF::fwrite_lorenzoで出力したデータを読み込む (float, doubleのみ)
+    //@param ptr  読み込んだデータを格納する領域 (nx*ny*nz要素)
+    //@param nx   x方向の要素数
+    //@param ny   y方向の要素数
+    //@param nz   z方向の要素数
+    //@param key  読み込むファイルを識別するためのID番号
+    //@ret   読み込んだ要素数 レコードの形式や要素数が一致しない場合は0
+    template <typename T>
+    size_t fread_lorenzo(T* ptr, const size_t& nx, const size_t& ny, const size_t& nz, const int& key);
+
+
+    //@brief 固定レートモードでエンコードしてファイルに出力する (float, doubleのみ)
+    //@param ptr         出力するデータ
+    //@param nmemb       出力するデータの要素数
+    //@param key         出力先ファイルを識別するためのID番号
+    //@param rate        1要素あたりのbit数 (2以上 8*sizeof(T)以下)
+    //@ret   上位bit側に出力したデータサイズ 常に24+fixed_rate_size(nmemb, rate)となる
+    //
+    //64要素毎のブロックを共通指数と固定長の仮数で表すので、上位bit側のサイズは値によらず要素数とrateだけで決まる
+    //許容誤差は保証しないが、下位bit側も合わせて読み込めば元データに戻る
+    //出力したデータはJHPCNDF::fread_fixed_rateで読み込む必要がある
+    template <typename T>
+    size_t fwrite_fixed_rate(const T* ptr, size_t nmemb, const int& key, const unsigned int& rate);
+
+
+    //@brief JHPCNDF::fwrite_fixed_rateで出力したデータを読み込む (float, doubleのみ)
+    //@param ptr   読み込んだデータを格納する領域
+    //@param nmemb 読み込む要素数
+    //@param key   読み込むファイルを識別するためのID番号
+    //@ret   読み込んだ要素数 レコードの形式や要素数が一致しない場合は0
+    template <typename T>
+    size_t fread_fixed_rate(T* ptr, size_t nmemb, const int& key);
+
+
+    //@brief 独立に圧縮したチャンクの並びとしてエンコードしてファイルに出力する (float, doubleのみ)
+    //@param ptr            出力するデータ
+    //@param nmemb          出力するデータの要素数
+    //@param key            出力先ファイルを識別するためのID番号 (JHPCNDF::fopenで開いたファイルのみ)
+    //@param tolerance      許容誤差
+    //@param is_relative    許容誤差を相対値で指定するかどうかのフラグ
+    //@param chunk_elements 1チャンクあたりの要素数
+    //@param enc            使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+    //@ret   上位bit側に出力したデータサイズ
+    //
+    //JHPCNDF::mpi_fwriteと同じコンテナ形式のレコードを出力する
+    //出力したレコードはJHPCNDF::ReadViewで必要なチャンクだけを読み込むことができる (JHPCNDF::freadでは読み込めない)
+    template <typename T>
+    size_t fwrite_chunked(const T* ptr, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative=true, const size_t& chunk_elements=65536, const std::string& enc="binary_search");
+
+
     //@brief メモリ上でJHPCN-DFによるデータのエンコードを行う
     //@param length         元データの要素数
     //@param src            元データ
@@ -103,6 +548,14 @@ namespace JHPCNDF
     void encode(const size_t& length, const T* const src, T* const dst, T* const dst_lower, const float& tolerance, const bool& is_relative=true, const std::string& enc = "binary_search", const bool time_measuring = false);
 
 
+    //@brief 統計情報を集計しながらメモリ上でエンコードする (float, doubleのみ)
+    //@param statistics 今回の呼び出しの統計情報で上書きする (出力サイズはエンコード前のサイズと同じ値になる)
+    //
+    //その他の引数はJHPCNDF::encodeと同じ
+    template<typename T>
+    void encode(const size_t& length, const T* const src, T* const dst, T* const dst_lower, const float& tolerance, const bool& is_relative, const std::string& enc, EncodeStatistics* statistics);
+
+
     //@beief メモリ上でJHPCN-DFによるデータのデコードを行う
     //@param length         元データの要素数
     //@param src_upper      エンコード済の上位bit側データ
@@ -110,6 +563,404 @@ namespace JHPCNDF
     //@param dst            デコード後のデータ
     template<typename T>
     void decode(const size_t& length, const T* const src_upper, const T* const src_lower, T* const dst);
+
+
+    //@brief メモリ上で構造格子上の配列をLorenzo予測との残差としてエンコードする
+    //@param nx, ny, nz     各方向の要素数 (JHPCNDF::fwrite_lorenzoの項を参照のこと)
+    //@param src            元データ
+    //@param dst            エンコード後の上位bit側データ
+    //@param dst_lower      エンコード後の下位bit側データ (NULLの場合は出力しない)
+    //@param tolerance      許容誤差
+    //@param is_relative    許容誤差を相対値で指定するかどうかのフラグ
+    template<typename T>
+    void encode_lorenzo(const size_t& nx, const size_t& ny, const size_t& nz, const T* const src, T* const dst, T* const dst_lower, const float& tolerance, const bool& is_relative=true);
+
+
+    //@brief encode_lorenzoでエンコードしたデータをデコードする
+    //@param nx, ny, nz     各方向の要素数
+    //@param src_upper      エンコード済の上位bit側データ
+    //@param src_lower      エンコード済の下位bit側データ (NULLの場合は上位bit側のみからデコードする)
+    //@param dst            デコード後のデータ
+    template<typename T>
+    void decode_lorenzo(const size_t& nx, const size_t& ny, const size_t& nz, const T* const src_upper, const T* const src_lower, T* const dst);
+
+
+    //@brief メモリ上で構造格子上の配列を4x4x4のブロック毎に直交変換してエンコードする
+    //@param nx, ny, nz     各方向の要素数 (x方向が最も速く変化する順に並んでいるものとする 2次元の場合はnz=1, 1次元の場合はny=nz=1)
+    //@param src            元データ
+    //@param dst            エンコード後の上位bit側データ (ブロック毎の変換係数)
+    //@param dst_lower      エンコード後の下位bit側データ (NULLの場合は出力しない)
+    //@param tolerance      許容誤差
+    //@param is_relative    許容誤差を相対値で指定するかどうかのフラグ
+    //
+    //変換係数は許容誤差を満たす範囲でブロック毎に共通のbit位置より下を0にして出力するので
+    //滑らかな場では要素毎に切り詰めるエンコーダより良く圧縮できる
+    //dst, dst_lowerの要素はブロック順に並ぶので、デコードにはdecode_block_transformかdecode_transform_blockを使うこと
+    template<typename T>
+    void encode_block_transform(const size_t& nx, const size_t& ny, const size_t& nz, const T* const src, T* const dst, T* const dst_lower, const float& tolerance, const bool& is_relative=true);
+
+
+    //@brief encode_block_transformでエンコードしたデータをデコードする
+    //@param nx, ny, nz     各方向の要素数
+    //@param src_upper      エンコード済の上位bit側データ
+    //@param src_lower      エンコード済の下位bit側データ (NULLの場合は上位bit側のみからデコードする)
+    //@param dst            デコード後のデータ (src_upperとは別の領域を指定すること)
+    template<typename T>
+    void decode_block_transform(const size_t& nx, const size_t& ny, const size_t& nz, const T* const src_upper, const T* const src_lower, T* const dst);
+
+
+    //@brief encode_block_transformでエンコードしたデータのうち、1つのブロックだけをデコードする
+    //@param nx, ny, nz     各方向の要素数
+    //@param bi, bj, bk     デコードするブロックの各方向の番号 (要素の番号/4)
+    //@param src_upper      エンコード済の上位bit側データ
+    //@param src_lower      エンコード済の下位bit側データ (NULLの場合は上位bit側のみからデコードする)
+    //@param dst            デコード後のデータ (nx*ny*nzの配列のうち、ブロックに含まれる要素だけを書き換える)
+    //@ret   ブロックの番号が範囲外の場合はfalse
+    template<typename T>
+    bool decode_transform_block(const size_t& nx, const size_t& ny, const size_t& nz, const size_t& bi, const size_t& bj, const size_t& bk, const T* const src_upper, const T* const src_lower, T* const dst);
+
+
+    //@brief 固定レートモードでエンコードした時のデータサイズを返す
+    //@param nmemb 元データの要素数
+    //@param rate  1要素あたりのbit数
+    //@ret   エンコード後のサイズ(byte) rateが範囲外の場合は0
+    //
+    //i番目の要素は先頭から(i/64)*8*rate byteの位置にあるブロックに含まれる
+    size_t fixed_rate_size(const size_t& nmemb, const unsigned int& rate);
+
+
+    //@brief メモリ上で固定レートモードのエンコードを行う
+    //@param src            元データ
+    //@param nmemb          元データの要素数
+    //@param rate           1要素あたりのbit数 (2以上 8*sizeof(T)以下)
+    //@param dst            エンコード後のデータ (fixed_rate_size(nmemb, rate) byte以上の領域を確保しておくこと)
+    //@param dst_lower      エンコード後の下位bit側データ (NULLの場合は出力しない)
+    //@ret   dstに書き込んだサイズ(byte) rateが範囲外の場合は0
+    template<typename T>
+    size_t encode_fixed_rate(const T* src, const size_t& nmemb, const unsigned int& rate, void* dst, T* dst_lower=NULL);
+
+
+    //@brief encode_fixed_rateでエンコードしたデータをデコードする
+    //@param src            エンコード済のデータ
+    //@param nmemb          元データの要素数
+    //@param rate           エンコード時に指定したbit数
+    //@param src_lower      エンコード済の下位bit側データ (NULLの場合はsrcのみからデコードする)
+    //@param dst            デコード後のデータ
+    //@ret   デコードした要素数
+    template<typename T>
+    size_t decode_fixed_rate(const void* src, const size_t& nmemb, const unsigned int& rate, const T* src_lower, T* dst);
+
+
+    //@brief encode_fixed_rateでエンコードしたデータのうち、指定した範囲の要素だけをデコードする
+    //@param src            エンコード済のデータ
+    //@param nmemb          元データの要素数
+    //@param rate           エンコード時に指定したbit数
+    //@param first          デコードする範囲の先頭の要素番号
+    //@param count          デコードする要素数
+    //@param src_lower      エンコード済の下位bit側データ (元データと同じ要素番号で参照する NULLの場合はsrcのみからデコードする)
+    //@param dst            デコード後のデータ (count要素)
+    //@ret   デコードした要素数 範囲が不正な場合は0
+    //
+    //範囲を含むブロックだけをデコードする
+    template<typename T>
+    size_t decode_fixed_rate_range(const void* src, const size_t& nmemb, const unsigned int& rate, const size_t& first, const size_t& count, const T* src_lower, T* dst);
+
+
+    //@brief compressが出力するデータサイズの上限を返す
+    //@param nmemb       元データの要素数
+    //@param size        元データの1要素あたりのサイズ
+    //@param comp        圧縮形式(JHPCNDF::fopenの項を参照のこと)
+    //@param with_lower  下位bit側のデータも出力するかどうかのフラグ
+    size_t compress_bound(const size_t& nmemb, const size_t& size, const std::string& comp = "gzip", const bool& with_lower = true);
+
+
+    //@brief データをエンコード、圧縮した時の出力サイズを推定する (float, doubleのみ)
+    //@param src          元データ
+    //@param nmemb        元データの要素数
+    //@param tolerance    許容誤差
+    //@param is_relative  許容誤差を相対値で指定するかどうかのフラグ
+    //@param enc          使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+    //@param comp         圧縮形式(JHPCNDF::fopenの項を参照のこと)
+    //@param lower_size   下位bit側の推定サイズを返す (NULLの場合は推定しない)
+    //@ret   上位bit側の推定サイズ(byte)
+    //
+    //配列を等分した区間毎に1つずつ選んだチャンク(8192要素 x 32個)だけをエンコード、圧縮して配列全体のサイズに換算する
+    //処理時間は配列の大きさによらずほぼ一定なので、大きな配列ほどfwriteに比べて安価になる
+    //配列がサンプルの合計より小さい時は配列全体を使うので、推定値はJHPCNDF::fwriteの出力サイズと一致する
+    template<typename T>
+    size_t estimate_compressed_size(const T* src, const size_t& nmemb, const float& tolerance, const bool& is_relative=true, const std::string& enc = "binary_search", const std::string& comp = "gzip", size_t* lower_size = NULL);
+
+
+    //@brief JHPCNDF::sweep_tolerancesが許容誤差毎に返す結果
+    struct ToleranceSweepResult
+    {
+      float tolerance;                   //許容誤差
+      std::vector<size_t> histogram;     //histogram[n]: 下位nbitを0埋めしても許容誤差を満たす要素数 (nは0から仮数部のbit数まで)
+      double mean_truncated_bits;        //0埋めする下位bit数の平均
+      size_t estimated_upper_size;       //上位bit側の推定サイズ(byte)
+      size_t estimated_lower_size;       //下位bit側の推定サイズ(byte)
+    };
+
+    //@brief 複数の許容誤差について、分割位置のヒストグラムと出力サイズの推定値を1回の走査でまとめて求める (float, doubleのみ)
+    //@param src          元データ
+    //@param nmemb        元データの要素数
+    //@param tolerances   調べる許容誤差のリスト (順不同)
+    //@param results      tolerancesと同じ順に結果を格納する
+    //@param is_relative  許容誤差を相対値で指定するかどうかのフラグ
+    //@param enc          サイズの推定に使うエンコーダの種類(nbit_filter, dummy以外)
+    //@param comp         圧縮形式(JHPCNDF::fopenの項を参照のこと)
+    //@ret   結果を格納した許容誤差の数 エラー時は0
+    //
+    //ヒストグラムはbinary_searchエンコーダが選ぶ分割位置を全要素について数えたもの
+    //推定サイズはJHPCNDF::estimate_compressed_sizeと同じく、配列から抜き出したサンプルから求める
+    //許容誤差毎にファイルへ出力して比べる代わりに使う
+    template<typename T>
+    size_t sweep_tolerances(const T* src, const size_t& nmemb, const std::vector<float>& tolerances, std::vector<ToleranceSweepResult>* results, const bool& is_relative=true, const std::string& enc = "binary_search", const std::string& comp = "gzip");
+
+
+    //@brief メモリ上のデータをエンコード、圧縮して1つのバッファに出力する (float, doubleのみ)
+    //@param src          元データ
+    //@param nmemb        元データの要素数
+    //@param dst          出力先の領域
+    //@param dst_capacity 出力先の領域のサイズ(byte)
+    //@param tolerance    許容誤差
+    //@param is_relative  許容誤差を相対値で指定するかどうかのフラグ
+    //@param enc          使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+    //@param comp         圧縮形式(JHPCNDF::fopenの項を参照のこと)
+    //@param with_lower   下位bit側のデータも出力するかどうかのフラグ(falseの時は上位bit側のみ出力する)
+    //@ret   出力したサイズ(byte) 出力先の容量が不足した場合やエラー時は0
+    //
+    //出力したバッファには伸長に必要な情報が全て含まれるので、ファイルを介さずに転送や保存ができる
+    //dst_capacityにcompress_boundの値以上を指定しておけば容量不足にはならない
+    template<typename T>
+    size_t compress(const T* src, const size_t& nmemb, void* dst, const size_t& dst_capacity, const float& tolerance, const bool& is_relative=true, const std::string& enc = "binary_search", const std::string& comp = "gzip", const bool& with_lower = true);
+
+
+    //@brief compressで出力したバッファを伸長、デコードする (float, doubleのみ)
+    //@param src      compressで出力したバッファ
+    //@param src_size srcのサイズ(byte)
+    //@param dst      伸長後のデータを格納する領域
+    //@param nmemb    dstの要素数
+    //@ret   伸長した要素数 エラー時や、dstの要素数が不足する場合は0
+    template<typename T>
+    size_t decompress(const void* src, const size_t& src_size, T* dst, const size_t& nmemb);
+
+
+    //@brief compressで出力したバッファに含まれる要素数を返す
+    //@param src      compressで出力したバッファ
+    //@param src_size srcのサイズ(byte)
+    //@ret   要素数 バッファが不正な場合は0
+    size_t get_decompressed_elements(const void* src, const size_t& src_size);
+
+
+    //@brief 同じファイルに同じ設定で繰り返し入出力を行うためのコンテキスト
+    //
+    //コンストラクタでエンコーダ、IOクラス、作業領域、ファイル情報を解決しておき
+    //fwrite/fread/encodeの呼び出し毎に文字列の解釈やテーブルの検索を行わないようにする
+    //keyに対応するファイルをfcloseする前にインスタンスを破棄すること
+    class Context
+    {
+      public:
+        //@param key            入出力先ファイルを識別するためのID番号(負の値を指定した場合はencode/decodeのみ使用可)
+        //@param tolerance      許容誤差
+        //@param is_relative    許容誤差を相対値で指定するかどうかのフラグ
+        //@param enc            使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+        //@param num_threads    エンコード時に使用するスレッド数(0以下の時はOpenMPの設定に従う)
+        //@param byte_swap      ファイル入出力時にエンディアン変換を行う
+        Context(const int& key, const float& tolerance, const bool& is_relative=true, const std::string& enc="binary_search", const int& num_threads=0, const bool& byte_swap=false);
+        ~Context();
+
+        //@brief 渡されたデータをエンコード、圧縮してファイルに出力する(float, doubleのみ)
+        //@param ptr    出力するデータ
+        //@param nmemb  出力するデータの要素数
+        //@ret   出力したデータサイズ
+        template <typename T>
+        size_t fwrite(const T* ptr, size_t nmemb);
+
+        //@brief ファイルからデータを読み込んでデコードする(float, doubleのみ)
+        //@param ptr    読み込んだデータを格納する領域
+        //@param nmemb  読み込むデータの要素数
+        template <typename T>
+        size_t fread(T* ptr, size_t nmemb);
+
+        //@brief メモリ上でエンコードを行う(float, doubleのみ)
+        //
+        //引数はJHPCNDF::encodeと同じ
+        template <typename T>
+        void encode(const size_t& length, const T* const src, T* const dst, T* const dst_lower);
+
+        //@brief コンストラクタでの設定の解決に成功したかどうかを返す
+        bool is_valid(void) const;
+
+      private:
+        Context(const Context&);
+        Context& operator=(const Context&);
+        class Impl;
+        Impl* impl;
+    };
+
+
+    //@brief コンテナ形式のレコードを、アクセスされたチャンクだけ読み込んでデコードする読み込み専用のビュー (float, doubleのみ)
+    //
+    //JHPCNDF::fopenで"rb"で開いたファイルの現在位置にある、fwrite_chunkedまたはmpi_fwriteで出力したレコードを対象とする
+    //生成時にはヘッダとインデックスだけを読み込み、ファイルの読み込み位置は次のレコードへ進める
+    //デコードしたチャンクは最近使ったcache_chunks個まで保持し、アクセスしたチャンクに続くprefetch_chunks個を
+    //バックグラウンドのスレッドで先読みする
+    //ファイルは内部で開き直して読み込むので、生成後はkeyを閉じても良い
+    //複数のスレッドから同時に使っても良い
+    template <typename T>
+    class ReadView
+    {
+      public:
+        //@param key             読み込むファイルを識別するためのID番号
+        //@param cache_chunks    デコードした状態で保持するチャンク数 (prefetch_chunksより大きくすること)
+        //@param prefetch_chunks 先読みするチャンク数 (0の時は先読みしない)
+        ReadView(const int& key, const size_t& cache_chunks=16, const size_t& prefetch_chunks=1);
+        ~ReadView();
+
+        //@brief レコードの読み込みに成功したかどうかを返す
+        bool is_valid(void) const;
+
+        //@brief レコード全体の要素数
+        size_t size(void) const;
+
+        size_t num_chunks(void) const;
+
+        //@brief これまでにデコードしたチャンクの延べ数 (先読みしたものを含む)
+        size_t decoded_chunks(void) const;
+
+        //@brief [first, first+count)の範囲の要素をdstへ読み込む
+        //@ret   読み込んだ要素数 範囲外やエラーの場合は0
+        size_t read(const size_t& first, const size_t& count, T* dst);
+
+        //@brief index番目の要素を返す (範囲外の時は0)
+        T get(const size_t& index);
+
+      private:
+        ReadView(const ReadView&);
+        ReadView& operator=(const ReadView&);
+        class Impl;
+        Impl* impl;
+    };
+
+
+    //@brief メモリ上で独立に圧縮したブロックの並びとしてデータを保持する配列 (float, doubleのみ)
+    //
+    //各ブロックはJHPCNDF::compressでエンコード、圧縮して保持し、最近使ったcache_blocks個のブロックだけを
+    //伸長した状態でキャッシュする
+    //set/set_blockで書き換えたブロックはキャッシュから追い出される時かflushを呼んだ時に再圧縮する
+    //with_lower=falseの時は非可逆になり、書き戻す度に最後に書き込んだ値に対して許容誤差以内で丸められる
+    //スレッドセーフではない
+    template <typename T>
+    class CompressedArray
+    {
+      public:
+        //@brief 先頭から順にブロック単位で伸長しながら要素を読み出す反復子
+        class const_iterator
+        {
+          public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef T         value_type;
+            typedef ptrdiff_t difference_type;
+            typedef const T*  pointer;
+            typedef T         reference;
+
+            const_iterator():array(NULL), index(0) {}
+            const_iterator(const CompressedArray* arg_array, const size_t& arg_index):array(arg_array), index(arg_index) {}
+            T operator*() const
+            {
+              return array->get(index);
+            }
+            const_iterator& operator++()
+            {
+              ++index;
+              return *this;
+            }
+            const_iterator operator++(int)
+            {
+              const_iterator tmp(*this);
+              ++index;
+              return tmp;
+            }
+            bool operator==(const const_iterator& other) const
+            {
+              return array == other.array && index == other.index;
+            }
+            bool operator!=(const const_iterator& other) const
+            {
+              return !(*this == other);
+            }
+
+          private:
+            const CompressedArray* array;
+            size_t index;
+        };
+
+        //@param size           配列の要素数 (初期値は全て0)
+        //@param tolerance      許容誤差
+        //@param is_relative    許容誤差を相対値で指定するかどうかのフラグ
+        //@param enc            使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+        //@param comp           圧縮形式(JHPCNDF::fopenの項を参照のこと)
+        //@param with_lower     下位bit側も保持して可逆にするかどうかのフラグ
+        //@param block_size     1ブロックの要素数
+        //@param cache_blocks   伸長した状態で保持するブロック数
+        CompressedArray(const size_t& size, const float& tolerance, const bool& is_relative=true, const std::string& enc="binary_search", const std::string& comp="gzip", const bool& with_lower=true, const size_t& block_size=65536, const size_t& cache_blocks=4);
+        ~CompressedArray();
+
+        size_t size(void) const;
+        size_t block_size(void) const;
+        size_t num_blocks(void) const;
+
+        //@brief 指定したブロックの要素数を返す (最後のブロックはblock_sizeより小さい場合がある)
+        size_t block_length(const size_t& block) const;
+
+        //@brief ブロック全体を書き換えて直ちに圧縮する
+        //@param block  ブロックの番号
+        //@param src    block_length(block)要素のデータ
+        //@ret   ブロックの番号が範囲外か圧縮に失敗した時はfalse
+        bool set_block(const size_t& block, const T* src);
+
+        //@brief ブロック全体を伸長してdstへ書き込む
+        //@param block  ブロックの番号
+        //@param dst    block_length(block)要素の領域
+        //@ret   ブロックの番号が範囲外か伸長に失敗した時はfalse
+        bool get_block(const size_t& block, T* dst) const;
+
+        //@brief 配列全体(size()要素)を書き換える
+        bool assign(const T* src);
+
+        //@brief 配列全体(size()要素)をdstへ伸長する
+        bool copy_to(T* dst) const;
+
+        //@brief index番目の要素を返す (範囲外やエラーの時は0)
+        T get(const size_t& index) const;
+
+        //@brief index番目の要素を書き換える
+        //@ret   範囲外の時や、キャッシュから追い出すブロックの再圧縮に失敗した時はfalse (この時は何もしない)
+        bool set(const size_t& index, const T& value);
+
+        //@brief キャッシュ上で書き換えたブロックを全て再圧縮する
+        //@ret   圧縮に失敗したブロックがあればfalse
+        bool flush(void);
+
+        //@brief 圧縮済ブロックの合計サイズ(byte) (キャッシュ上の未反映の変更は含まない)
+        size_t compressed_size(void) const;
+
+        const_iterator begin(void) const
+        {
+          return const_iterator(this, 0);
+        }
+        const_iterator end(void) const
+        {
+          return const_iterator(this, size());
+        }
+
+      private:
+        CompressedArray(const CompressedArray&);
+        CompressedArray& operator=(const CompressedArray&);
+        class Impl;
+        Impl* impl;
+    };
 } //end of namespace JHPCNDF
 extern "C"
 {
@@ -122,9 +973,21 @@ extern "C"
 //@brief JHPCNDF::fopenに対する C言語用インターフェース
 int JHPCNDF_fopen(const char* filename_upper, const char* filename_lower, const char* mode, const char* comp, const size_t buff_size);
 
+//@brief JHPCNDF::fopen_asyncに対する C言語用インターフェース
+int JHPCNDF_fopen_async(const char* filename_upper, const char* filename_lower, const char* mode, const char* comp, const size_t buff_size, const size_t queue_depth, const size_t block_size, const int direct_io);
+
+//@brief JHPCNDF::fopen_callbacksに対する C言語用インターフェース
+int JHPCNDF_fopen_callbacks(const JHPCNDF_Callbacks* upper, const JHPCNDF_Callbacks* lower, const char* comp, const size_t buff_size);
+
 //@brief JHPCNDF::fcloseに対する C言語用インターフェース
 void JHPCNDF_fclose(const int key);
 
+//@brief JHPCNDF::set_scratch_capacityに対する C言語用インターフェース
+void JHPCNDF_set_scratch_capacity(const int key, const size_t size);
+
+//@brief JHPCNDF::release_scratchに対する C言語用インターフェース
+void JHPCNDF_release_scratch(const int key);
+
 //@brief JHPCNDF::fwriteに対する C言語用インターフェース(float版)
 size_t JHPCNDF_fwrite_float(const float* ptr, size_t size, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc);
 
@@ -134,6 +997,12 @@ size_t JHPCNDF_fwrite_double(const double * ptr, size_t size, size_t nmemb, cons
 //@brief JHPCNDF::fwriteに対する C言語用インターフェース(その他版)
 size_t JHPCNDF_fwrite(const void* ptr, size_t size, size_t nmemb, const int key, const char* enc);
 
+//@brief 統計情報を集計するJHPCNDF::fwriteに対する C言語用インターフェース(float版)
+size_t JHPCNDF_fwrite_statistics_float(const float* ptr, size_t size, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc, JHPCNDF_EncodeStatistics* statistics);
+
+//@brief 統計情報を集計するJHPCNDF::fwriteに対する C言語用インターフェース(double版)
+size_t JHPCNDF_fwrite_statistics_double(const double* ptr, size_t size, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc, JHPCNDF_EncodeStatistics* statistics);
+
 //@brief JHPCNDF::freadに対する C言語用インターフェース(float版)
 size_t JHPCNDF_fread_float(float* ptr, size_t size, size_t nmemb, const int key);
 
@@ -143,6 +1012,36 @@ size_t JHPCNDF_fread_double(double* ptr, size_t size, size_t nmemb, const int ke
 //@brief JHPCNDF::freadに対する C言語用インターフェース(その他版)
 size_t JHPCNDF_fread(void* ptr, size_t size, size_t nmemb, const int key);
 
+//@brief JHPCNDF::fwrite_temporal<float>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_temporal_float(const float* ptr, size_t nmemb, const int key, const char* variable, const float tolerance, const int is_relative, const char* enc, const int keyframe_interval);
+
+//@brief JHPCNDF::fwrite_temporal<double>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_temporal_double(const double* ptr, size_t nmemb, const int key, const char* variable, const float tolerance, const int is_relative, const char* enc, const int keyframe_interval);
+
+//@brief JHPCNDF::fread_temporal<float>に対する C言語用インターフェース
+size_t JHPCNDF_fread_temporal_float(float* ptr, size_t nmemb, const int key, const char* variable);
+
+//@brief JHPCNDF::fread_temporal<double>に対する C言語用インターフェース
+size_t JHPCNDF_fread_temporal_double(double* ptr, size_t nmemb, const int key, const char* variable);
+
+//@brief JHPCNDF::set_dictionary<float>に対する C言語用インターフェース
+int JHPCNDF_set_dictionary_float(const float* sample, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::set_dictionary<double>に対する C言語用インターフェース
+int JHPCNDF_set_dictionary_double(const double* sample, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fwrite_lorenzo<float>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_lorenzo_float(const float* ptr, const size_t nx, const size_t ny, const size_t nz, const int key, const float tolerance, const int is_relative);
+
+//@brief JHPCNDF::fwrite_lorenzo<double>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_lorenzo_double(const double* ptr, const size_t nx, const size_t ny, const size_t nz, const int key, const float tolerance, const int is_relative);
+
+//@brief JHPCNDF::fread_lorenzo<float>に対する C言語用インターフェース
+size_t JHPCNDF_fread_lorenzo_float(float* ptr, const size_t nx, const size_t ny, const size_t nz, const int key);
+
+//@brief JHPCNDF::fread_lorenzo<double>に対する C言語用インターフェース
+size_t JHPCNDF_fread_lorenzo_double(double* ptr, const size_t nx, const size_t ny, const size_t nz, const int key);
+
 //@brief JHPCNDF::encode<float>に対する C言語用インターフェース
 void JHPCNDF_encode_float(const size_t length, const float* const src, float* const dst, float* const dst_lower, const float tolerance, const int is_relative, const char* enc);
 
@@ -154,6 +1053,268 @@ void JHPCNDF_decode_float(const size_t length, const float* const src_upper, con
 
 //@brief JHPCNDF::decode<double>に対する C言語用インターフェース
 void JHPCNDF_decode_double(const size_t length, const double* const src_upper, const double* const src_lower, double* const dst);
+
+//@brief JHPCNDF::encode_lorenzo<float>に対する C言語用インターフェース
+void JHPCNDF_encode_lorenzo_float(const size_t nx, const size_t ny, const size_t nz, const float* const src, float* const dst, float* const dst_lower, const float tolerance, const int is_relative);
+
+//@brief JHPCNDF::encode_lorenzo<double>に対する C言語用インターフェース
+void JHPCNDF_encode_lorenzo_double(const size_t nx, const size_t ny, const size_t nz, const double* const src, double* const dst, double* const dst_lower, const float tolerance, const int is_relative);
+
+//@brief JHPCNDF::decode_lorenzo<float>に対する C言語用インターフェース
+void JHPCNDF_decode_lorenzo_float(const size_t nx, const size_t ny, const size_t nz, const float* const src_upper, const float* const src_lower, float* const dst);
+
+//@brief JHPCNDF::decode_lorenzo<double>に対する C言語用インターフェース
+void JHPCNDF_decode_lorenzo_double(const size_t nx, const size_t ny, const size_t nz, const double* const src_upper, const double* const src_lower, double* const dst);
+
+//@brief JHPCNDF::encode_block_transform<float>に対する C言語用インターフェース
+void JHPCNDF_encode_block_transform_float(const size_t nx, const size_t ny, const size_t nz, const float* const src, float* const dst, float* const dst_lower, const float tolerance, const int is_relative);
+
+//@brief JHPCNDF::encode_block_transform<double>に対する C言語用インターフェース
+void JHPCNDF_encode_block_transform_double(const size_t nx, const size_t ny, const size_t nz, const double* const src, double* const dst, double* const dst_lower, const float tolerance, const int is_relative);
+
+//@brief JHPCNDF::decode_block_transform<float>に対する C言語用インターフェース
+void JHPCNDF_decode_block_transform_float(const size_t nx, const size_t ny, const size_t nz, const float* const src_upper, const float* const src_lower, float* const dst);
+
+//@brief JHPCNDF::decode_block_transform<double>に対する C言語用インターフェース
+void JHPCNDF_decode_block_transform_double(const size_t nx, const size_t ny, const size_t nz, const double* const src_upper, const double* const src_lower, double* const dst);
+
+//@brief JHPCNDF::fixed_rate_sizeに対する C言語用インターフェース
+size_t JHPCNDF_fixed_rate_size(const size_t nmemb, const unsigned int rate);
+
+//@brief JHPCNDF::encode_fixed_rate<float>に対する C言語用インターフェース
+size_t JHPCNDF_encode_fixed_rate_float(const float* src, const size_t nmemb, const unsigned int rate, void* dst, float* dst_lower);
+
+//@brief JHPCNDF::encode_fixed_rate<double>に対する C言語用インターフェース
+size_t JHPCNDF_encode_fixed_rate_double(const double* src, const size_t nmemb, const unsigned int rate, void* dst, double* dst_lower);
+
+//@brief JHPCNDF::decode_fixed_rate<float>に対する C言語用インターフェース
+size_t JHPCNDF_decode_fixed_rate_float(const void* src, const size_t nmemb, const unsigned int rate, const float* src_lower, float* dst);
+
+//@brief JHPCNDF::decode_fixed_rate<double>に対する C言語用インターフェース
+size_t JHPCNDF_decode_fixed_rate_double(const void* src, const size_t nmemb, const unsigned int rate, const double* src_lower, double* dst);
+
+//@brief JHPCNDF::decode_fixed_rate_range<float>に対する C言語用インターフェース
+size_t JHPCNDF_decode_fixed_rate_range_float(const void* src, const size_t nmemb, const unsigned int rate, const size_t first, const size_t count, const float* src_lower, float* dst);
+
+//@brief JHPCNDF::decode_fixed_rate_range<double>に対する C言語用インターフェース
+size_t JHPCNDF_decode_fixed_rate_range_double(const void* src, const size_t nmemb, const unsigned int rate, const size_t first, const size_t count, const double* src_lower, double* dst);
+
+//@brief JHPCNDF::fwrite_fixed_rate<float>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_fixed_rate_float(const float* ptr, size_t nmemb, const int key, const unsigned int rate);
+
+//@brief JHPCNDF::fwrite_fixed_rate<double>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_fixed_rate_double(const double* ptr, size_t nmemb, const int key, const unsigned int rate);
+
+//@brief JHPCNDF::fread_fixed_rate<float>に対する C言語用インターフェース
+size_t JHPCNDF_fread_fixed_rate_float(float* ptr, size_t nmemb, const int key);
+
+//@brief JHPCNDF::fread_fixed_rate<double>に対する C言語用インターフェース
+size_t JHPCNDF_fread_fixed_rate_double(double* ptr, size_t nmemb, const int key);
+
+//@brief JHPCNDF::fwrite_batchに対する C言語用インターフェース
+size_t JHPCNDF_fwrite_batch(const JHPCNDF_WriteRequest* requests, const size_t num_requests, const int key);
+
+//@brief JHPCNDF::fwrite_tolerance_field<float>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_tolerance_field_float(const float* ptr, size_t nmemb, const int key, const float* tolerances, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fwrite_tolerance_field<double>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_tolerance_field_double(const double* ptr, size_t nmemb, const int key, const float* tolerances, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fwrite_tolerance_mask<float>に対する C言語用インターフェース
+//@param table_size tableの要素数
+size_t JHPCNDF_fwrite_tolerance_mask_float(const float* ptr, size_t nmemb, const int key, const unsigned char* mask, const float* table, const size_t table_size, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fwrite_tolerance_mask<double>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_tolerance_mask_double(const double* ptr, size_t nmemb, const int key, const unsigned char* mask, const float* table, const size_t table_size, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fwrite_subarray<float>に対する C言語用インターフェース
+//
+//stridesにNULLを指定した時は全て1とする
+size_t JHPCNDF_fwrite_subarray_float(const float* ptr, const size_t ndims, const size_t* extents, const size_t* offsets, const size_t* counts, const size_t* strides, const int key, const float tolerance, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fwrite_subarray<double>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_subarray_double(const double* ptr, const size_t ndims, const size_t* extents, const size_t* offsets, const size_t* counts, const size_t* strides, const int key, const float tolerance, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fread_subarray<float>に対する C言語用インターフェース
+size_t JHPCNDF_fread_subarray_float(float* ptr, const size_t ndims, const size_t* extents, const size_t* offsets, const size_t* counts, const size_t* strides, const int key);
+
+//@brief JHPCNDF::fread_subarray<double>に対する C言語用インターフェース
+size_t JHPCNDF_fread_subarray_double(double* ptr, const size_t ndims, const size_t* extents, const size_t* offsets, const size_t* counts, const size_t* strides, const int key);
+
+//@brief JHPCNDF::fwrite_target_size<float>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_target_size_float(const float* ptr, size_t nmemb, const int key, const size_t target_size, float* tolerance_used, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fwrite_target_size<double>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_target_size_double(const double* ptr, size_t nmemb, const int key, const size_t target_size, float* tolerance_used, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fwrite_target_ratio<float>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_target_ratio_float(const float* ptr, size_t nmemb, const int key, const double target_ratio, float* tolerance_used, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fwrite_target_ratio<double>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_target_ratio_double(const double* ptr, size_t nmemb, const int key, const double target_ratio, float* tolerance_used, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fwrite_components<float>に対する C言語用インターフェース
+//
+//tolerancesにはnum_components個の許容誤差を渡すこと
+size_t JHPCNDF_fwrite_components_float(const float* ptr, const size_t num_components, size_t nmemb, const int key, const float* tolerances, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fwrite_components<double>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_components_double(const double* ptr, const size_t num_components, size_t nmemb, const int key, const float* tolerances, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::fread_components<float>に対する C言語用インターフェース
+size_t JHPCNDF_fread_components_float(float* ptr, const size_t num_components, size_t nmemb, const int key);
+
+//@brief JHPCNDF::fread_components<double>に対する C言語用インターフェース
+size_t JHPCNDF_fread_components_double(double* ptr, const size_t num_components, size_t nmemb, const int key);
+
+//@brief JHPCNDF::fwrite_chunked<float>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_chunked_float(const float* ptr, size_t nmemb, const int key, const float tolerance, const int is_relative, const size_t chunk_elements, const char* enc);
+
+//@brief JHPCNDF::fwrite_chunked<double>に対する C言語用インターフェース
+size_t JHPCNDF_fwrite_chunked_double(const double* ptr, size_t nmemb, const int key, const float tolerance, const int is_relative, const size_t chunk_elements, const char* enc);
+
+//@brief JHPCNDF::ReadViewに対する C言語用のハンドル
+typedef struct JHPCNDF_ReadView_float_ JHPCNDF_ReadView_float;
+typedef struct JHPCNDF_ReadView_double_ JHPCNDF_ReadView_double;
+
+//@brief JHPCNDF::ReadView<float>を生成する C言語用インターフェース
+//@ret 生成に失敗した場合はNULL
+JHPCNDF_ReadView_float* JHPCNDF_open_view_float(const int key, const size_t cache_chunks, const size_t prefetch_chunks);
+
+//@brief JHPCNDF_open_view_floatで生成したビューを破棄する
+void JHPCNDF_close_view_float(JHPCNDF_ReadView_float* view);
+
+//@brief JHPCNDF::ReadView<float>::sizeに対する C言語用インターフェース
+size_t JHPCNDF_view_size_float(const JHPCNDF_ReadView_float* view);
+
+//@brief JHPCNDF::ReadView<float>::readに対する C言語用インターフェース
+size_t JHPCNDF_view_read_float(JHPCNDF_ReadView_float* view, const size_t first, const size_t count, float* dst);
+
+//@brief JHPCNDF::ReadView<double>を生成する C言語用インターフェース
+//@ret 生成に失敗した場合はNULL
+JHPCNDF_ReadView_double* JHPCNDF_open_view_double(const int key, const size_t cache_chunks, const size_t prefetch_chunks);
+
+//@brief JHPCNDF_open_view_doubleで生成したビューを破棄する
+void JHPCNDF_close_view_double(JHPCNDF_ReadView_double* view);
+
+//@brief JHPCNDF::ReadView<double>::sizeに対する C言語用インターフェース
+size_t JHPCNDF_view_size_double(const JHPCNDF_ReadView_double* view);
+
+//@brief JHPCNDF::ReadView<double>::readに対する C言語用インターフェース
+size_t JHPCNDF_view_read_double(JHPCNDF_ReadView_double* view, const size_t first, const size_t count, double* dst);
+
+//@brief JHPCNDF::CompressedArrayに対する C言語用のハンドル
+typedef struct JHPCNDF_CompressedArray_float_ JHPCNDF_CompressedArray_float;
+typedef struct JHPCNDF_CompressedArray_double_ JHPCNDF_CompressedArray_double;
+
+//@brief JHPCNDF::CompressedArray<float>を生成する C言語用インターフェース
+JHPCNDF_CompressedArray_float* JHPCNDF_create_compressed_array_float(const size_t size, const float tolerance, const int is_relative, const char* enc, const char* comp, const int with_lower, const size_t block_size, const size_t cache_blocks);
+
+//@brief JHPCNDF_create_compressed_array_floatで生成した配列を破棄する
+void JHPCNDF_destroy_compressed_array_float(JHPCNDF_CompressedArray_float* array);
+
+//@brief JHPCNDF::CompressedArray<float>::set_blockに対する C言語用インターフェース
+int JHPCNDF_compressed_array_set_block_float(JHPCNDF_CompressedArray_float* array, const size_t block, const float* src);
+
+//@brief JHPCNDF::CompressedArray<float>::get_blockに対する C言語用インターフェース
+int JHPCNDF_compressed_array_get_block_float(const JHPCNDF_CompressedArray_float* array, const size_t block, float* dst);
+
+//@brief JHPCNDF::CompressedArray<float>::getに対する C言語用インターフェース
+float JHPCNDF_compressed_array_get_float(const JHPCNDF_CompressedArray_float* array, const size_t index);
+
+//@brief JHPCNDF::CompressedArray<float>::setに対する C言語用インターフェース
+//@ret 書き換えた場合は1、範囲外やエラーの場合は0
+int JHPCNDF_compressed_array_set_float(JHPCNDF_CompressedArray_float* array, const size_t index, const float value);
+
+//@brief JHPCNDF::CompressedArray<float>::flushに対する C言語用インターフェース
+int JHPCNDF_compressed_array_flush_float(JHPCNDF_CompressedArray_float* array);
+
+//@brief JHPCNDF::CompressedArray<float>::compressed_sizeに対する C言語用インターフェース
+size_t JHPCNDF_compressed_array_compressed_size_float(const JHPCNDF_CompressedArray_float* array);
+
+//@brief JHPCNDF::CompressedArray<double>を生成する C言語用インターフェース
+JHPCNDF_CompressedArray_double* JHPCNDF_create_compressed_array_double(const size_t size, const float tolerance, const int is_relative, const char* enc, const char* comp, const int with_lower, const size_t block_size, const size_t cache_blocks);
+
+//@brief JHPCNDF_create_compressed_array_doubleで生成した配列を破棄する
+void JHPCNDF_destroy_compressed_array_double(JHPCNDF_CompressedArray_double* array);
+
+//@brief JHPCNDF::CompressedArray<double>::set_blockに対する C言語用インターフェース
+int JHPCNDF_compressed_array_set_block_double(JHPCNDF_CompressedArray_double* array, const size_t block, const double* src);
+
+//@brief JHPCNDF::CompressedArray<double>::get_blockに対する C言語用インターフェース
+int JHPCNDF_compressed_array_get_block_double(const JHPCNDF_CompressedArray_double* array, const size_t block, double* dst);
+
+//@brief JHPCNDF::CompressedArray<double>::getに対する C言語用インターフェース
+double JHPCNDF_compressed_array_get_double(const JHPCNDF_CompressedArray_double* array, const size_t index);
+
+//@brief JHPCNDF::CompressedArray<double>::setに対する C言語用インターフェース
+//@ret 書き換えた場合は1、範囲外やエラーの場合は0
+int JHPCNDF_compressed_array_set_double(JHPCNDF_CompressedArray_double* array, const size_t index, const double value);
+
+//@brief JHPCNDF::CompressedArray<double>::flushに対する C言語用インターフェース
+int JHPCNDF_compressed_array_flush_double(JHPCNDF_CompressedArray_double* array);
+
+//@brief JHPCNDF::CompressedArray<double>::compressed_sizeに対する C言語用インターフェース
+size_t JHPCNDF_compressed_array_compressed_size_double(const JHPCNDF_CompressedArray_double* array);
+
+//@brief JHPCNDF::compress_boundに対する C言語用インターフェース
+size_t JHPCNDF_compress_bound(const size_t nmemb, const size_t size, const char* comp, const int with_lower);
+
+//@brief JHPCNDF::estimate_compressed_size<float>に対する C言語用インターフェース
+size_t JHPCNDF_estimate_compressed_size_float(const float* src, const size_t nmemb, const float tolerance, const int is_relative, const char* enc, const char* comp, size_t* lower_size);
+
+//@brief JHPCNDF::estimate_compressed_size<double>に対する C言語用インターフェース
+size_t JHPCNDF_estimate_compressed_size_double(const double* src, const size_t nmemb, const float tolerance, const int is_relative, const char* enc, const char* comp, size_t* lower_size);
+
+//@brief JHPCNDF::sweep_tolerances<float>に対する C言語用インターフェース
+//
+//histogramsにはnum_tolerances*24要素の領域を渡す(NULLの場合は返さない)
+//k番目の許容誤差に対するヒストグラムはhistograms[k*24]から格納される
+//upper_sizes, lower_sizesにはnum_tolerances要素の領域を渡す(NULLの場合は返さない)
+size_t JHPCNDF_sweep_tolerances_float(const float* src, const size_t nmemb, const float* tolerances, const size_t num_tolerances, const int is_relative, const char* enc, const char* comp, size_t* histograms, size_t* upper_sizes, size_t* lower_sizes);
+
+//@brief JHPCNDF::sweep_tolerances<double>に対する C言語用インターフェース
+//
+//histogramsにはnum_tolerances*53要素の領域を渡す
+//その他の引数はJHPCNDF_sweep_tolerances_floatと同じ
+size_t JHPCNDF_sweep_tolerances_double(const double* src, const size_t nmemb, const float* tolerances, const size_t num_tolerances, const int is_relative, const char* enc, const char* comp, size_t* histograms, size_t* upper_sizes, size_t* lower_sizes);
+
+//@brief JHPCNDF::compress<float>に対する C言語用インターフェース
+size_t JHPCNDF_compress_float(const float* src, const size_t nmemb, void* dst, const size_t dst_capacity, const float tolerance, const int is_relative, const char* enc, const char* comp, const int with_lower);
+
+//@brief JHPCNDF::compress<double>に対する C言語用インターフェース
+size_t JHPCNDF_compress_double(const double* src, const size_t nmemb, void* dst, const size_t dst_capacity, const float tolerance, const int is_relative, const char* enc, const char* comp, const int with_lower);
+
+//@brief JHPCNDF::decompress<float>に対する C言語用インターフェース
+size_t JHPCNDF_decompress_float(const void* src, const size_t src_size, float* dst, const size_t nmemb);
+
+//@brief JHPCNDF::decompress<double>に対する C言語用インターフェース
+size_t JHPCNDF_decompress_double(const void* src, const size_t src_size, double* dst, const size_t nmemb);
+
+//@brief JHPCNDF::get_decompressed_elementsに対する C言語用インターフェース
+size_t JHPCNDF_get_decompressed_elements(const void* src, const size_t src_size);
+
+//@brief JHPCNDF::Contextに対する C言語用のハンドル
+typedef struct JHPCNDF_Context_ JHPCNDF_Context;
+
+//@brief JHPCNDF::Contextを生成する C言語用インターフェース
+//@ret 生成に失敗した場合はNULL
+JHPCNDF_Context* JHPCNDF_create_context(const int key, const float tolerance, const int is_relative, const char* enc, const int num_threads);
+
+//@brief JHPCNDF_create_contextで生成したコンテキストを破棄する
+void JHPCNDF_destroy_context(JHPCNDF_Context* context);
+
+//@brief JHPCNDF::Context::fwriteに対する C言語用インターフェース(float版)
+size_t JHPCNDF_context_fwrite_float(JHPCNDF_Context* context, const float* ptr, size_t nmemb);
+
+//@brief JHPCNDF::Context::fwriteに対する C言語用インターフェース(double版)
+size_t JHPCNDF_context_fwrite_double(JHPCNDF_Context* context, const double* ptr, size_t nmemb);
+
+//@brief JHPCNDF::Context::freadに対する C言語用インターフェース(float版)
+size_t JHPCNDF_context_fread_float(JHPCNDF_Context* context, float* ptr, size_t nmemb);
+
+//@brief JHPCNDF::Context::freadに対する C言語用インターフェース(double版)
+size_t JHPCNDF_context_fread_double(JHPCNDF_Context* context, double* ptr, size_t nmemb);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,155 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file jhpcndf_mpi.h
+
+
+#ifndef JHPCNDF_MPI_H
+#define JHPCNDF_MPI_H
+#include <mpi.h>
+#include "jhpcndf.h"
+
+#ifdef __cplusplus
+
+//
+// Interface routines for C++ (MPI-IO)
+//
+// 全プロセスのデータを1組の上位bit/下位bit側ファイルに出力するためのルーチン群
+// ビルド時に-DUSE_MPIを指定した時(cmakeでは-Dwith_MPI=yes)のみ使用可能
+//
+// 各プロセスはデータをエンコード、チャンク単位で圧縮した後、圧縮後のサイズを
+// prefix scanで交換して出力位置を決め、MPI-IOの集団出力で共有ファイルへ書き込む
+// ファイルにはレコード毎に全プロセス分のチャンクのインデックスが格納されるので
+// 出力時と異なるプロセス数で読み込むことができる
+//
+namespace JHPCNDF
+{
+    //@brief 全プロセスで共有するファイルを開く (集団操作)
+    //@param comm           ファイルを共有するプロセスのコミュニケータ
+    //@param filename_upper 上位bit側のデータを格納するファイルの名前
+    //@param filename_lower 下位bit側のデータを格納するファイルの名前
+    //@param mode           "r"を含む場合は読み込み用、"w"を含む場合は書き込み用に開く
+    //@param comp           圧縮形式 (JHPCNDF::fopenの項を参照のこと)
+    //@param buff_size      圧縮/伸張する際のバッファサイズ(単位はbyte)
+    //@param chunk_elements 1チャンクあたりの要素数(書き込み時のみ有効)
+    //@ret   開いたファイルを識別するためのID番号 (JHPCNDF::fopenのID番号とは別に管理される)
+    //
+    //エラー時は負の値を返す
+    int mpi_fopen(MPI_Comm comm, const std::string& filename_upper, const std::string& filename_lower = "", const char* mode = "rb", const std::string& comp = "gzip", const size_t& buff_size=32768, const size_t& chunk_elements=1048576);
+
+
+    //@brief JHPCNDF::mpi_fopenで開いたファイルを閉じる (集団操作)
+    //@param key 閉じるファイルを識別するためのID番号
+    void mpi_fclose(const int& key);
+
+
+    //@brief 各プロセスのデータをエンコード、圧縮して共有ファイルに出力する (集団操作, float, doubleのみ)
+    //@param ptr         出力するデータ
+    //@param nmemb       このプロセスが出力するデータの要素数(プロセス毎に異なっていても良い)
+    //@param key         出力先ファイルを識別するためのID番号
+    //@param tolerance   許容誤差
+    //@param is_relative 許容誤差を相対値で指定するかどうかのフラグ
+    //@param enc         使用するエンコーダの種類(JHPCNDF::fwriteの項を参照のこと)
+    //@ret   このプロセスが出力した上位bit側データのサイズ
+    //
+    //1回の呼び出しでランク順に全プロセスのデータを連結した1つのレコードを出力する
+    template <typename T>
+    size_t mpi_fwrite(const T* ptr, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative=true, const std::string& enc = "binary_search");
+
+
+    //@brief 共有ファイルからデータを読み込んでデコードする (集団操作, float, doubleのみ)
+    //@param ptr    読み込んだデータを格納する領域
+    //@param nmemb  このプロセスが読み込むデータの要素数
+    //@param key    入力元ファイルを識別するためのID番号
+    //@ret   このプロセスが読み込んだ要素数
+    //
+    //1回の呼び出しで1レコードを読み込み、レコードの先頭からランク順にnmemb個ずつ割り当てる
+    //各プロセスのnmembの合計がレコードの要素数と一致しない場合は、範囲外の部分は読み込まない
+    template <typename T>
+    size_t mpi_fread(T* ptr, size_t nmemb, const int& key);
+
+
+    //@brief 次に読み込むレコードに含まれる要素数を返す (集団操作)
+    //@param key    入力元ファイルを識別するためのID番号
+    //
+    //読み込み位置は進めない。エラー時は0を返す
+    size_t mpi_get_record_elements(const int& key);
+
+
+    //@brief 共有ファイルからレコード内の任意の範囲の要素を読み込んでデコードする (集団操作, float, doubleのみ)
+    //@param ptr    読み込んだデータを格納する領域
+    //@param first  このプロセスが読み込む範囲のレコード内での先頭位置
+    //@param nmemb  このプロセスが読み込むデータの要素数
+    //@param key    入力元ファイルを識別するためのID番号
+    //@ret   このプロセスが読み込んだ要素数
+    //
+    //範囲と重なるチャンクだけを読み込むので、出力時と異なる分割で再開する場合に使う
+    //各プロセスの範囲は重なっていても、レコード全体を覆っていなくても良い
+    template <typename T>
+    size_t mpi_fread_range(T* ptr, size_t first, size_t nmemb, const int& key);
+
+
+    //@brief レコードを3次元配列とみなして部分領域を読み込んでデコードする (集団操作, float, doubleのみ)
+    //@param ptr    読み込んだデータを格納する領域 (count[0]*count[1]*count[2]要素)
+    //@param dims   レコード全体の配列の大きさ (dims[0]の方向が最も速く変化する)
+    //@param start  このプロセスが読み込む部分領域の先頭位置
+    //@param count  このプロセスが読み込む部分領域の大きさ
+    //@param key    入力元ファイルを識別するためのID番号
+    //@ret   このプロセスが読み込んだ要素数
+    //
+    //dimsの要素数の積がレコードの要素数と一致しない場合はエラーとなる
+    template <typename T>
+    size_t mpi_fread_subarray(T* ptr, const size_t dims[3], const size_t start[3], const size_t count[3], const int& key);
+} //end of namespace JHPCNDF
+extern "C"
+{
+#endif
+
+//
+// Interface routines for C (MPI-IO)
+//
+
+//@brief JHPCNDF::mpi_fopenに対する C言語用インターフェース
+int JHPCNDF_mpi_fopen(MPI_Comm comm, const char* filename_upper, const char* filename_lower, const char* mode, const char* comp, const size_t buff_size, const size_t chunk_elements);
+
+//@brief JHPCNDF::mpi_fcloseに対する C言語用インターフェース
+void JHPCNDF_mpi_fclose(const int key);
+
+//@brief JHPCNDF::mpi_fwriteに対する C言語用インターフェース(float版)
+size_t JHPCNDF_mpi_fwrite_float(const float* ptr, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::mpi_fwriteに対する C言語用インターフェース(double版)
+size_t JHPCNDF_mpi_fwrite_double(const double* ptr, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc);
+
+//@brief JHPCNDF::mpi_freadに対する C言語用インターフェース(float版)
+size_t JHPCNDF_mpi_fread_float(float* ptr, size_t nmemb, const int key);
+
+//@brief JHPCNDF::mpi_freadに対する C言語用インターフェース(double版)
+size_t JHPCNDF_mpi_fread_double(double* ptr, size_t nmemb, const int key);
+
+//@brief JHPCNDF::mpi_get_record_elementsに対する C言語用インターフェース
+size_t JHPCNDF_mpi_get_record_elements(const int key);
+
+//@brief JHPCNDF::mpi_fread_rangeに対する C言語用インターフェース(float版)
+size_t JHPCNDF_mpi_fread_range_float(float* ptr, size_t first, size_t nmemb, const int key);
+
+//@brief JHPCNDF::mpi_fread_rangeに対する C言語用インターフェース(double版)
+size_t JHPCNDF_mpi_fread_range_double(double* ptr, size_t first, size_t nmemb, const int key);
+
+//@brief JHPCNDF::mpi_fread_subarrayに対する C言語用インターフェース(float版)
+size_t JHPCNDF_mpi_fread_subarray_float(float* ptr, const size_t dims[3], const size_t start[3], const size_t count[3], const int key);
+
+//@brief JHPCNDF::mpi_fread_subarrayに対する C言語用インターフェース(double版)
+size_t JHPCNDF_mpi_fread_subarray_double(double* ptr, const size_t dims[3], const size_t start[3], const size_t count[3], const int key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,612 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file AsyncFileStream.h
+#ifndef JHPCNDF_ASYNC_FILE_STREAM_H
+#define JHPCNDF_ASYNC_FILE_STREAM_H
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <string>
+#include <vector>
+#ifdef USE_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+//<linux/fs.h>が定義するBLOCK_SIZEマクロが、このヘッダを読み込んだ側の識別子と衝突しないようにする
+#ifdef BLOCK_SIZE
+#undef BLOCK_SIZE
+#endif
+#endif
+#include "Stream.h"
+
+namespace JHPCNDF
+{
+#ifdef USE_IO_URING
+  //@brief io_uringの投入キュー/完了キューを扱うクラス
+  //
+  //liburingには依存せず、システムコールを直接呼び出す
+  //カーネルがio_uringに対応していない場合はis_valid()がfalseを返す
+  class UringQueue
+  {
+    public:
+      explicit UringQueue(const unsigned& entries)
+        :ring_fd(-1), sq_ptr(MAP_FAILED), sq_size(0), cq_ptr(MAP_FAILED), cq_size(0), sqes(NULL), sqes_size(0)
+      {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        ring_fd=(int)syscall(__NR_io_uring_setup, entries, &params);
+        if(ring_fd < 0)
+        {
+          return;
+        }
+        sq_size=params.sq_off.array+params.sq_entries*sizeof(unsigned);
+        cq_size=params.cq_off.cqes+params.cq_entries*sizeof(io_uring_cqe);
+        bool single_mmap=false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+        single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+#endif
+        if(single_mmap)
+        {
+          sq_size = sq_size > cq_size ? sq_size : cq_size;
+        }
+        sq_ptr=mmap(NULL, sq_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+        if(sq_ptr == MAP_FAILED)
+        {
+          destroy();
+          return;
+        }
+        if(single_mmap)
+        {
+          cq_ptr=sq_ptr;
+          cq_size=0;
+        }else{
+          cq_ptr=mmap(NULL, cq_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+          if(cq_ptr == MAP_FAILED)
+          {
+            destroy();
+            return;
+          }
+        }
+        sqes_size=params.sq_entries*sizeof(io_uring_sqe);
+        void* sqes_ptr=mmap(NULL, sqes_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+        if(sqes_ptr == MAP_FAILED)
+        {
+          destroy();
+          return;
+        }
+        sqes=static_cast<io_uring_sqe*>(sqes_ptr);
+
+        char* sq=static_cast<char*>(sq_ptr);
+        sq_tail  = reinterpret_cast<unsigned*>(sq+params.sq_off.tail);
+        sq_mask  = reinterpret_cast<unsigned*>(sq+params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq+params.sq_off.array);
+        char* cq=static_cast<char*>(cq_ptr);
+        cq_head  = reinterpret_cast<unsigned*>(cq+params.cq_off.head);
+        cq_tail  = reinterpret_cast<unsigned*>(cq+params.cq_off.tail);
+        cq_mask  = reinterpret_cast<unsigned*>(cq+params.cq_off.ring_mask);
+        cqes     = reinterpret_cast<io_uring_cqe*>(cq+params.cq_off.cqes);
+      }
+      ~UringQueue()
+      {
+        destroy();
+      }
+      bool is_valid(void) const
+      {
+        return ring_fd >= 0;
+      }
+
+      //@brief readv/writevの要求を1つ投入する
+      //
+      //投入キューの長さ以上の要求を同時に発行しないことは呼び出し側で保証する
+      bool submit(const int& opcode, const int& fd, const iovec* iov, const off_t& offset, const uint64_t& user_data)
+      {
+        const unsigned tail=*sq_tail;
+        const unsigned index=tail & *sq_mask;
+        io_uring_sqe* sqe=&(sqes[index]);
+        memset(sqe, 0, sizeof(io_uring_sqe));
+        sqe->opcode=(uint8_t)opcode;
+        sqe->fd=fd;
+        sqe->addr=(uint64_t)(uintptr_t)iov;
+        sqe->len=1;
+        sqe->off=(uint64_t)offset;
+        sqe->user_data=user_data;
+        sq_array[index]=index;
+        __atomic_store_n(sq_tail, tail+1, __ATOMIC_RELEASE);
+        for(;;)
+        {
+          const long rt=syscall(__NR_io_uring_enter, ring_fd, 1, 0, 0, NULL, 0);
+          if(rt >= 0)
+          {
+            return rt == 1;
+          }
+          if(errno != EINTR)
+          {
+            return false;
+          }
+        }
+      }
+
+      //@brief 完了した要求を1つ取り出す(完了するまで待つ)
+      bool wait(uint64_t* user_data, int* result)
+      {
+        for(;;)
+        {
+          const unsigned head=*cq_head;
+          if(head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE))
+          {
+            const io_uring_cqe* cqe=&(cqes[head & *cq_mask]);
+            *user_data=cqe->user_data;
+            *result=cqe->res;
+            __atomic_store_n(cq_head, head+1, __ATOMIC_RELEASE);
+            return true;
+          }
+          const long rt=syscall(__NR_io_uring_enter, ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+          if(rt < 0 && errno != EINTR)
+          {
+            return false;
+          }
+        }
+      }
+    private:
+      UringQueue(const UringQueue&);
+      UringQueue& operator=(const UringQueue&);
+
+      void destroy(void)
+      {
+        if(sqes != NULL)
+        {
+          munmap(sqes, sqes_size);
+          sqes=NULL;
+        }
+        if(cq_ptr != MAP_FAILED && cq_ptr != sq_ptr)
+        {
+          munmap(cq_ptr, cq_size);
+        }
+        cq_ptr=MAP_FAILED;
+        if(sq_ptr != MAP_FAILED)
+        {
+          munmap(sq_ptr, sq_size);
+          sq_ptr=MAP_FAILED;
+        }
+        if(ring_fd >= 0)
+        {
+          ::close(ring_fd);
+          ring_fd=-1;
+        }
+      }
+
+      int ring_fd;
+      void*  sq_ptr;
+      size_t sq_size;
+      void*  cq_ptr;
+      size_t cq_size;
+      io_uring_sqe* sqes;
+      size_t sqes_size;
+      unsigned* sq_tail;
+      unsigned* sq_mask;
+      unsigned* sq_array;
+      unsigned* cq_head;
+      unsigned* cq_tail;
+      unsigned* cq_mask;
+      io_uring_cqe* cqes;
+  };
+#endif
+
+  //@brief 大きなブロック単位で複数の要求を同時に発行してファイルの入出力を行うクラス
+  //
+  //書き込み時はwrite()で渡されたデータをブロックサイズ分溜めてから非同期に出力し
+  //読み込み時は先の方のブロックを先読みしておく
+  //-DUSE_IO_URINGを指定してビルドした場合はio_uringを使い、それ以外の場合や
+  //カーネルがio_uringに対応していない場合はpwrite/preadで同期的に入出力する
+  //
+  //O_DIRECTを指定した場合、ブロックサイズとバッファは4KiB単位に揃える
+  //書き込みの最後の端数ブロックは揃えた長さで出力した後、ftruncateで元の長さに戻す
+  //O_DIRECTでopenできなかった場合はO_DIRECT無しで開き直す
+  class AsyncFileStream :public Stream
+  {
+    public:
+      //@param filename    ファイル名
+      //@param for_write   trueなら書き込み用(既存のファイルは切り詰める)、falseなら読み込み用に開く
+      //@param queue_depth 同時に発行する要求の数
+      //@param block_size  1要求あたりのサイズ(単位はbyte)
+      //@param direct_io   O_DIRECTを指定して開く
+      AsyncFileStream(const std::string& filename, const bool& for_write, const size_t& queue_depth, const size_t& block_size, const bool& direct_io)
+        :fd(-1), writing(for_write), direct(false), block_size(align_up(block_size > 0 ? block_size : 1, ALIGNMENT)),
+         file_size(0), current(0), position_in_block(0), next_offset(0), has_error(false)
+#ifdef USE_IO_URING
+         , queue(NULL)
+#endif
+      {
+        const int flags = for_write ? O_WRONLY|O_CREAT|O_TRUNC : O_RDONLY;
+#ifdef O_DIRECT
+        if(direct_io)
+        {
+          fd=::open(filename.c_str(), flags|O_DIRECT, 0666);
+          direct = fd >= 0;
+        }
+#endif
+        if(fd < 0)
+        {
+          fd=::open(filename.c_str(), flags, 0666);
+        }
+        if(fd < 0)
+        {
+          return;
+        }
+        if(!writing)
+        {
+          struct stat st;
+          if(fstat(fd, &st) == 0)
+          {
+            file_size=st.st_size;
+          }
+        }
+
+        const size_t depth = queue_depth > 0 ? queue_depth : 1;
+        blocks.resize(depth);
+        for(size_t i=0; i<depth; i++)
+        {
+          void* ptr=NULL;
+          if(posix_memalign(&ptr, ALIGNMENT, this->block_size) != 0)
+          {
+            has_error=true;
+            ptr=NULL;
+          }
+          blocks[i].buffer=static_cast<char*>(ptr);
+        }
+        if(has_error)
+        {
+          return;
+        }
+#ifdef USE_IO_URING
+        queue=new UringQueue((unsigned)depth);
+        if(!queue->is_valid())
+        {
+          delete queue;
+          queue=NULL;
+        }
+#endif
+        if(!writing)
+        {
+          start_prefetch(0);
+        }
+      }
+
+      ~AsyncFileStream()
+      {
+        if(writing && fd >= 0 && !blocks.empty())
+        {
+          flush();
+        }
+        wait_all();
+#ifdef USE_IO_URING
+        delete queue;
+#endif
+        for(size_t i=0; i<blocks.size(); i++)
+        {
+          free(blocks[i].buffer);
+        }
+        if(fd >= 0)
+        {
+          ::close(fd);
+        }
+      }
+
+      //@brief ファイルを開けたかどうか
+      bool is_open(void) const
+      {
+        return fd >= 0 && !has_error;
+      }
+
+      //@brief io_uringを使って入出力しているかどうか
+      bool is_async(void) const
+      {
+#ifdef USE_IO_URING
+        return queue != NULL;
+#else
+        return false;
+#endif
+      }
+
+      size_t read(void* ptr, size_t size)
+      {
+        if(writing || !is_open())
+        {
+          return 0;
+        }
+        char* dst=static_cast<char*>(ptr);
+        size_t read_size=0;
+        while(read_size < size)
+        {
+          Block& block=blocks[current];
+          if(!wait_block(current) || block.length == 0)
+          {
+            break;
+          }
+          const size_t length = size-read_size < block.length-position_in_block ? size-read_size : block.length-position_in_block;
+          memcpy(dst+read_size, block.buffer+position_in_block, length);
+          read_size+=length;
+          position_in_block+=length;
+          if(position_in_block == block.length)
+          {
+            if(block.length < this->block_size)
+            {
+              break;
+            }
+            // 読み終えたブロックを次の先読みに使う
+            submit_read(current);
+            current=(current+1)%blocks.size();
+            position_in_block=0;
+          }
+        }
+        return read_size;
+      }
+
+      size_t write(const void* ptr, size_t size)
+      {
+        if(!writing || !is_open())
+        {
+          return 0;
+        }
+        const char* src=static_cast<const char*>(ptr);
+        size_t written=0;
+        while(written < size)
+        {
+          Block& block=blocks[current];
+          const size_t length = size-written < block_size-block.length ? size-written : block_size-block.length;
+          memcpy(block.buffer+block.length, src+written, length);
+          block.length+=length;
+          written+=length;
+          if(block.length == block_size)
+          {
+            submit_write(current, block_size);
+            current=(current+1)%blocks.size();
+            if(!wait_block(current))
+            {
+              return written;
+            }
+            blocks[current].length=0;
+          }
+        }
+        return written;
+      }
+
+      bool error(void) const
+      {
+        return has_error;
+      }
+
+      bool eof(void) const
+      {
+        if(writing || blocks.empty())
+        {
+          return false;
+        }
+        const Block& block=blocks[current];
+        return !block.busy && block.offset+(off_t)position_in_block >= file_size;
+      }
+
+      void unread(size_t size)
+      {
+        if(writing || !is_open())
+        {
+          return;
+        }
+        if(size <= position_in_block)
+        {
+          position_in_block-=size;
+          return;
+        }
+        // 既に先読み用に再利用したブロックまで戻る場合は、その位置から読み直す
+        const off_t position=blocks[current].offset+(off_t)position_in_block-(off_t)size;
+        start_prefetch(position > 0 ? position : 0);
+      }
+
+    private:
+      AsyncFileStream(const AsyncFileStream&);
+      AsyncFileStream& operator=(const AsyncFileStream&);
+
+      static const size_t ALIGNMENT=4096;
+
+      struct Block
+      {
+        Block():buffer(NULL), length(0), request_size(0), offset(0), busy(false){}
+        char*  buffer;
+        size_t length;       // 有効なデータのサイズ
+        size_t request_size; // 発行中の要求のサイズ
+        off_t  offset;       // ファイル内での先頭位置
+        bool   busy;
+        iovec  iov;
+      };
+
+      static size_t align_up(size_t size, size_t alignment)
+      {
+        return (size+alignment-1)/alignment*alignment;
+      }
+
+      //@brief 指定した位置から先読みをやり直す
+      void start_prefetch(const off_t& position)
+      {
+        wait_all();
+        const off_t aligned=position/(off_t)block_size*(off_t)block_size;
+        next_offset=aligned;
+        for(size_t i=0; i<blocks.size(); i++)
+        {
+          submit_read(i);
+        }
+        current=0;
+        position_in_block=position-aligned;
+        if(position_in_block > 0 && wait_block(0) && position_in_block > blocks[0].length)
+        {
+          position_in_block=blocks[0].length;
+        }
+      }
+
+      void submit_read(const size_t& index)
+      {
+        Block& block=blocks[index];
+        block.offset=next_offset;
+        block.length=0;
+        if(next_offset >= file_size)
+        {
+          block.request_size=0;
+          return;
+        }
+        block.request_size=block_size;
+        next_offset+=block_size;
+        submit(index, false);
+      }
+
+      void submit_write(const size_t& index, const size_t& size)
+      {
+        Block& block=blocks[index];
+        block.offset=next_offset;
+        block.request_size=size;
+        next_offset+=size;
+        submit(index, true);
+      }
+
+      void submit(const size_t& index, const bool& is_write)
+      {
+        Block& block=blocks[index];
+        block.iov.iov_base=block.buffer;
+        block.iov.iov_len=block.request_size;
+#ifdef USE_IO_URING
+        if(queue != NULL)
+        {
+          if(queue->submit(is_write ? IORING_OP_WRITEV : IORING_OP_READV, fd, &(block.iov), block.offset, index))
+          {
+            block.busy=true;
+            return;
+          }
+        }
+#else
+        (void)is_write; //同期的に処理する時は、completeがwritingで読み書きを判断する
+#endif
+        complete(index, -EAGAIN);
+      }
+
+      //@brief 要求の完了処理を行う
+      //
+      //途中までしか処理されなかった場合や非同期に発行できなかった場合は残りを同期的に処理する
+      void complete(const size_t& index, const int& result)
+      {
+        Block& block=blocks[index];
+        block.busy=false;
+        size_t done = result > 0 ? (size_t)result : 0;
+        if(result < 0 && result != -EAGAIN && result != -EINVAL && result != -EOPNOTSUPP)
+        {
+          has_error=true;
+        }
+        while(!has_error && done < block.request_size)
+        {
+          ssize_t rt;
+          if(writing)
+          {
+            rt=pwrite(fd, block.buffer+done, block.request_size-done, block.offset+(off_t)done);
+          }else{
+            rt=pread(fd, block.buffer+done, block.request_size-done, block.offset+(off_t)done);
+          }
+          if(rt < 0 && errno == EINTR)
+          {
+            continue;
+          }
+          if(rt < 0)
+          {
+            has_error=true;
+          }
+          if(rt <= 0)
+          {
+            break;
+          }
+          done+=rt;
+        }
+        if(!writing)
+        {
+          block.length = block.offset+(off_t)done > file_size ? (size_t)(file_size-block.offset) : done;
+        }
+      }
+
+      //@brief 指定したブロックへの要求が完了するまで待つ
+      bool wait_block(const size_t& index)
+      {
+#ifdef USE_IO_URING
+        while(blocks[index].busy)
+        {
+          uint64_t user_data=0;
+          int result=0;
+          if(!queue->wait(&user_data, &result))
+          {
+            has_error=true;
+            return false;
+          }
+          complete((size_t)user_data, result);
+        }
+#else
+        (void)index; //io_uringを使わない場合は、要求は発行時に完了している
+#endif
+        return !has_error;
+      }
+
+      void wait_all(void)
+      {
+        for(size_t i=0; i<blocks.size(); i++)
+        {
+          wait_block(i);
+        }
+      }
+
+      //@brief 書き込み途中のブロックを出力する
+      void flush(void)
+      {
+        Block& block=blocks[current];
+        if(block.length == 0)
+        {
+          return;
+        }
+        const off_t total=next_offset+(off_t)block.length;
+        if(direct)
+        {
+          const size_t aligned=align_up(block.length, ALIGNMENT);
+          memset(block.buffer+block.length, 0, aligned-block.length);
+          submit_write(current, aligned);
+          wait_all();
+          if(ftruncate(fd, total) != 0)
+          {
+            has_error=true;
+          }
+        }else{
+          submit_write(current, block.length);
+        }
+        block.length=0;
+      }
+
+      int    fd;
+      bool   writing;
+      bool   direct;
+      const size_t block_size;
+      off_t  file_size;         // 読み込み時のファイルサイズ
+      std::vector<Block> blocks;
+      size_t current;           // 現在読み書きしているブロック
+      size_t position_in_block; // 読み込み時のブロック内の位置
+      off_t  next_offset;       // 次に発行する要求のファイル内での位置
+      bool   has_error;
+#ifdef USE_IO_URING
+      UringQueue* queue;
+#endif
+  };
+}//end of namespace JHPCNDF
+#endif
@@ -11,6 +11,7 @@
 #ifndef JHPCNDF_BASE_IO_H
 #define JHPCNDF_BASE_IO_H
 #include <stdio.h>
+#include "Stream.h"
 
 namespace JHPCNDF
 {
@@ -22,18 +23,46 @@ namespace JHPCNDF
       //@param ptr     読み込んだデータを格納する領域へのポインタ
       //@param size    データの1要素あたりのサイズ
       //@param nmemb   確保済の領域サイズ
-      //@param stream  ファイル入力元のポインタ
+      //@param stream  入力元
       //@ret 読み取ったデータサイズ
-      virtual size_t fread(void *ptr, size_t size, size_t nmemb, FILE *stream)=0;
+      virtual size_t fread(void *ptr, size_t size, size_t nmemb, Stream *stream)=0;
 
       //@brief ファイルへデータを書き込む
       //@param ptr     データを格納した領域へのポインタ
       //@param size    データの1要素あたりのサイズ
       //@param nmemb   データの要素数
-      //@param stream  ファイル出力先のポインタ
+      //@param stream  出力先
       //
       //@ret 出力したデータの圧縮前のサイズ
-      virtual size_t fwrite(const void *ptr, size_t size, size_t nmemb, FILE *stream)=0;
+      virtual size_t fwrite(const void *ptr, size_t size, size_t nmemb, Stream *stream)=0;
+
+      //@brief stdioのファイルポインタから読み取る
+      size_t fread(void *ptr, size_t size, size_t nmemb, FILE *fp)
+      {
+        FileStream stream(fp);
+        return fread(ptr, size, nmemb, &stream);
+      }
+
+      //@brief stdioのファイルポインタへ書き込む
+      size_t fwrite(const void *ptr, size_t size, size_t nmemb, FILE *fp)
+      {
+        FileStream stream(fp);
+        return fwrite(ptr, size, nmemb, &stream);
+      }
+
+      //@brief 以降の入出力に使うプリセット辞書を設定する
+      //@param dictionary 辞書 (NULLの時は辞書を使わない)
+      //@param size       辞書のサイズ(byte)
+      //
+      //渡された領域はコピーしないので、辞書を使う入出力が終わるまで保持すること
+      //辞書に対応しないIOクラスでは何もしない
+      virtual void set_dictionary(const void* /*dictionary*/, size_t /*size*/){}
+
+      //@brief プリセット辞書に対応しているかどうかを返す
+      virtual bool supports_dictionary(void) const
+      {
+        return false;
+      }
 
       virtual ~IO(){};
   };
@@ -42,13 +71,15 @@ namespace JHPCNDF
   class stdIO :public IO
   {
     public:
-      size_t fread(void *ptr, size_t size, size_t nmemb, FILE *stream)
+      using IO::fread;
+      using IO::fwrite;
+      size_t fread(void *ptr, size_t size, size_t nmemb, Stream *stream)
       {
-        return ::fread(ptr, size, nmemb, stream);
+        return size > 0 ? stream->read(ptr, size*nmemb)/size : 0;
       }
-      size_t fwrite(const void *ptr, size_t size, size_t nmemb, FILE *stream)
+      size_t fwrite(const void *ptr, size_t size, size_t nmemb, Stream *stream)
       {
-        return ::fwrite(ptr, size, nmemb, stream);
+        return size > 0 ? stream->write(ptr, size*nmemb)/size : 0;
       }
   };
 
@@ -0,0 +1,149 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file BlockCache.h
+
+#ifndef JHPCNDF_BLOCK_CACHE_H
+#define JHPCNDF_BLOCK_CACHE_H
+#include <list>
+#include <map>
+#include <vector>
+
+namespace JHPCNDF
+{
+  //@brief 伸長済ブロックを最近使った順に保持するLRUキャッシュ
+  //
+  //書き戻しは利用側が渡すwriter (bool writer(const size_t& index, const T* data)) で行い、
+  //writerが失敗したエントリはdirtyのまま残して、書き込み内容を失わないようにする
+  //スレッドセーフではない
+  template <typename T>
+  class BlockCache
+  {
+    public:
+      struct Entry
+      {
+        size_t index;
+        std::vector<T> data;
+        bool dirty;
+      };
+
+      explicit BlockCache(const size_t& arg_capacity):capacity(arg_capacity > 0 ? arg_capacity : 1) {}
+
+      //@brief 指定したブロックを探し、見つかった場合は最も新しいエントリにする
+      //@ret   見つからない場合はNULL
+      Entry* find(const size_t& index)
+      {
+        if(!entries.empty() && entries.front().index == index)
+        {
+          return &(entries.front());
+        }
+        typename std::map<size_t, typename std::list<Entry>::iterator>::iterator it=positions.find(index);
+        if(it == positions.end())
+        {
+          return NULL;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        return &(entries.front());
+      }
+
+      //@brief 指定したブロックを探す (使用順は変更しない)
+      //@ret   見つからない場合はNULL
+      Entry* peek(const size_t& index)
+      {
+        typename std::map<size_t, typename std::list<Entry>::iterator>::iterator it=positions.find(index);
+        return it != positions.end() ? &(*(it->second)) : NULL;
+      }
+
+      //@brief 新しいエントリを先頭に追加する
+      //
+      //既にキャッシュされているブロックや、容量一杯の時に呼んではいけない
+      Entry* push(const size_t& index)
+      {
+        entries.push_front(Entry());
+        entries.front().index=index;
+        entries.front().dirty=false;
+        positions[index]=entries.begin();
+        return &(entries.front());
+      }
+
+      bool full(void) const
+      {
+        return entries.size() >= capacity;
+      }
+
+      Entry& oldest(void)
+      {
+        return entries.back();
+      }
+
+      void pop_oldest(void)
+      {
+        positions.erase(entries.back().index);
+        entries.pop_back();
+      }
+
+      //@brief 指定したブロックを書き戻さずに破棄する
+      void erase(const size_t& index)
+      {
+        typename std::map<size_t, typename std::list<Entry>::iterator>::iterator it=positions.find(index);
+        if(it != positions.end())
+        {
+          entries.erase(it->second);
+          positions.erase(it);
+        }
+      }
+
+      void clear(void)
+      {
+        entries.clear();
+        positions.clear();
+      }
+
+      //@brief 最も古いエントリを追い出す dirtyなエントリはwriterで書き戻してから追い出す
+      //@ret   書き戻しに失敗した場合は追い出さずにfalse
+      template <typename Writer>
+      bool evict_oldest(Writer& writer)
+      {
+        Entry& victim=entries.back();
+        if(victim.dirty && !writer(victim.index, &(victim.data[0])))
+        {
+          return false;
+        }
+        pop_oldest();
+        return true;
+      }
+
+      //@brief 全てのdirtyなエントリをwriterで書き戻す
+      //@ret   1つでも書き戻しに失敗した場合はfalse (失敗したエントリはdirtyのまま残す)
+      template <typename Writer>
+      bool write_back(Writer& writer)
+      {
+        bool result=true;
+        for(typename std::list<Entry>::iterator it=entries.begin(); it != entries.end(); ++it)
+        {
+          if(it->dirty)
+          {
+            if(writer(it->index, &(it->data[0])))
+            {
+              it->dirty=false;
+            }else{
+              result=false;
+            }
+          }
+        }
+        return result;
+      }
+
+    private:
+      const size_t capacity;
+      std::list<Entry> entries;
+      std::map<size_t, typename std::list<Entry>::iterator> positions;
+  };
+}//end of namespace JHPCNDF
+#endif
@@ -0,0 +1,386 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file BlockTransform.h
+
+#ifndef JHPCNDF_BLOCK_TRANSFORM_H
+#define JHPCNDF_BLOCK_TRANSFORM_H
+#include <cmath>
+#include <vector>
+#include "Encoder.h"
+#include "Utility.h"
+
+//
+//BlockTransformEncoderが出力するデータの配置
+//
+//配列(index = i + nx*(j + ny*k))を4x4x4のブロックに分割し、ブロック毎に直交変換(DCT-II)した係数を
+//ブロックの順(x方向のブロック番号が最も速く変化する順)に並べて出力する
+//端のブロックは4要素に満たない方向の変換長を短くするので、出力の要素数は元データと同じになる
+//各ブロックの係数は連続した領域に格納され、BlockTransform::block_offsetで先頭位置が求まるので
+//ブロック単位で独立にデコードできる
+//
+//下位bit側も同じ順に並べた、元データと上位bit側から再構成した値のXORを出力する
+//
+namespace JHPCNDF
+{
+  namespace BlockTransform
+  {
+    const size_t TRANSFORM_BLOCK_SIZE=4;
+    const size_t MAX_BLOCK_ELEMENTS=TRANSFORM_BLOCK_SIZE*TRANSFORM_BLOCK_SIZE*TRANSFORM_BLOCK_SIZE;
+
+    //@brief 長さ1〜4の正規直交DCT-IIの基底
+    class Basis
+    {
+      public:
+        Basis()
+        {
+          const double pi=3.14159265358979323846;
+          for(size_t n=1; n<=TRANSFORM_BLOCK_SIZE; n++)
+          {
+            for(size_t k=0; k<n; k++)
+            {
+              const double scale = k == 0 ? std::sqrt(1.0/n) : std::sqrt(2.0/n);
+              for(size_t i=0; i<n; i++)
+              {
+                matrix[n][k][i]=scale*std::cos(pi*(2*i+1)*k/(2.0*n));
+              }
+            }
+          }
+        }
+
+        //@brief strideおきに並んだn要素に変換(inverse=trueの時は逆変換)を適用する
+        void apply(double* data, const size_t& n, const size_t& stride, const bool& inverse) const
+        {
+          double work[TRANSFORM_BLOCK_SIZE];
+          for(size_t k=0; k<n; k++)
+          {
+            double sum=0.0;
+            for(size_t i=0; i<n; i++)
+            {
+              sum+= inverse ? matrix[n][i][k]*data[i*stride] : matrix[n][k][i]*data[i*stride];
+            }
+            work[k]=sum;
+          }
+          for(size_t k=0; k<n; k++)
+          {
+            data[k*stride]=work[k];
+          }
+        }
+
+        //@brief sx*sy*szのブロックに3次元の変換を適用する
+        void transform(double* data, const size_t& sx, const size_t& sy, const size_t& sz, const bool& inverse) const
+        {
+          for(size_t k=0; k<sz; k++)
+            for(size_t j=0; j<sy; j++)
+              apply(data+sx*(j+sy*k), sx, 1, inverse);
+          for(size_t k=0; k<sz; k++)
+            for(size_t i=0; i<sx; i++)
+              apply(data+i+sx*sy*k, sy, sx, inverse);
+          for(size_t j=0; j<sy; j++)
+            for(size_t i=0; i<sx; i++)
+              apply(data+i+sx*j, sz, sx*sy, inverse);
+        }
+
+      private:
+        double matrix[TRANSFORM_BLOCK_SIZE+1][TRANSFORM_BLOCK_SIZE][TRANSFORM_BLOCK_SIZE];
+    };
+
+    inline size_t num_blocks(const size_t& n)
+    {
+      return (n+TRANSFORM_BLOCK_SIZE-1)/TRANSFORM_BLOCK_SIZE;
+    }
+
+    //@brief b番目のブロックのn方向の要素数
+    inline size_t block_extent(const size_t& n, const size_t& b)
+    {
+      const size_t rest=n-b*TRANSFORM_BLOCK_SIZE;
+      return rest < TRANSFORM_BLOCK_SIZE ? rest : TRANSFORM_BLOCK_SIZE;
+    }
+
+    //@brief (bi, bj, bk)番目のブロックの係数が格納されている先頭位置
+    inline size_t block_offset(const size_t& nx, const size_t& ny, const size_t& nz, const size_t& bi, const size_t& bj, const size_t& bk)
+    {
+      const size_t sy=block_extent(ny, bj);
+      const size_t sz=block_extent(nz, bk);
+      return TRANSFORM_BLOCK_SIZE*bk*nx*ny+TRANSFORM_BLOCK_SIZE*bj*nx*sz+TRANSFORM_BLOCK_SIZE*bi*sy*sz;
+    }
+
+    //@brief 係数の2^plane未満の桁を0に切り詰める
+    inline double truncate(const double& coefficient, const int& plane)
+    {
+      const double q=ldexp(coefficient, -plane);
+      return ldexp(q < 0.0 ? std::ceil(q) : std::floor(q), plane);
+    }
+
+    //@brief ブロック内の要素を巡回するためのクラス
+    class Block
+    {
+      public:
+        Block(const size_t& arg_nx, const size_t& arg_ny, const size_t& arg_nz, const size_t& block_index)
+          :nx(arg_nx), ny(arg_ny)
+        {
+          const size_t nbx=num_blocks(arg_nx);
+          const size_t nby=num_blocks(arg_ny);
+          const size_t bi=block_index%nbx;
+          const size_t bj=(block_index/nbx)%nby;
+          const size_t bk=block_index/(nbx*nby);
+          sx=block_extent(arg_nx, bi);
+          sy=block_extent(arg_ny, bj);
+          sz=block_extent(arg_nz, bk);
+          offset=block_offset(arg_nx, arg_ny, arg_nz, bi, bj, bk);
+          origin=TRANSFORM_BLOCK_SIZE*(bi+arg_nx*(bj+arg_ny*bk));
+        }
+        size_t size(void) const
+        {
+          return sx*sy*sz;
+        }
+        //@brief ブロック内のn番目の要素の、元の配列上での位置
+        size_t index(const size_t& n) const
+        {
+          return origin+n%sx+nx*((n/sx)%sy+ny*(n/(sx*sy)));
+        }
+
+        const size_t nx;
+        const size_t ny;
+        size_t sx;
+        size_t sy;
+        size_t sz;
+        size_t offset;
+        size_t origin;
+    };
+
+    inline size_t total_blocks(const size_t& nx, const size_t& ny, const size_t& nz)
+    {
+      return num_blocks(nx)*num_blocks(ny)*num_blocks(nz);
+    }
+
+    //@brief ブロックの係数から値を再構成する
+    template <typename T>
+    inline void reconstruct(const Basis& basis, const Block& block, const T* const coefficients, T* const values)
+    {
+      const size_t size=block.size();
+      double work[MAX_BLOCK_ELEMENTS];
+      bool is_finite=true;
+      for(size_t n=0; n<size; n++)
+      {
+        work[n]=coefficients[n];
+        is_finite = is_finite && work[n]-work[n] == 0.0;
+      }
+      // 有限でない値を含むブロックは変換せずに格納されている
+      if(is_finite)
+      {
+        basis.transform(work, block.sx, block.sy, block.sz, true);
+      }
+      for(size_t n=0; n<size; n++)
+      {
+        values[n] = is_finite ? (T)work[n] : coefficients[n];
+      }
+    }
+  }//end of namespace BlockTransform
+
+  //@brief BlockTransformEncoderでエンコードしたデータをデコードするクラス
+  //
+  //src_lowerにNULLを指定した場合は上位bit側のみから再構成する
+  //入力と出力で要素の並びが異なるので、dstにsrc_upperと同じ領域を指定することはできない
+  template <typename T>
+  class BlockTransformDecoder
+  {
+    public:
+      BlockTransformDecoder(const size_t& arg_nx, const size_t& arg_ny, const size_t& arg_nz)
+        :nx(arg_nx), ny(arg_ny), nz(arg_nz) {}
+
+      void operator()(const size_t& /*length*/, const T* const src_upper, const T* const src_lower, T* const dst) const
+      {
+        const long num_blocks=(long)BlockTransform::total_blocks(nx, ny, nz);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for(long b=0; b<num_blocks; b++)
+        {
+          decode_block(b, src_upper, src_lower, dst);
+        }
+      }
+
+      //@brief block_index番目のブロックだけをデコードしてdst上の対応する位置に格納する
+      void decode_block(const size_t& block_index, const T* const src_upper, const T* const src_lower, T* const dst) const
+      {
+        const BlockTransform::Block block(nx, ny, nz, block_index);
+        T values[BlockTransform::MAX_BLOCK_ELEMENTS];
+        BlockTransform::reconstruct(basis, block, src_upper+block.offset, values);
+        for(size_t n=0; n<block.size(); n++)
+        {
+          dst[block.index(n)] = src_lower != NULL ? real_xor(values[n], src_lower[block.offset+n]) : values[n];
+        }
+      }
+
+    private:
+      const size_t nx;
+      const size_t ny;
+      const size_t nz;
+      const BlockTransform::Basis basis;
+  };
+
+  //@brief 構造格子上の配列をブロック毎に直交変換してエンコードするエンコーダ
+  //
+  //各ブロックの係数を共通のbit位置(bit plane)より下の桁を0にして出力する
+  //bit planeは、上位bit側から再構成した値がブロック内の全要素で許容誤差を満たす範囲で最も上の位置を二分探索で探す
+  //滑らかな場では係数のほとんどが0か有効桁の短い値になるので、要素毎に切り詰めるより良く圧縮できる
+  //有限でない値を含むブロックは変換せずにそのまま出力する
+  //許容誤差が変換の丸め誤差より小さい場合は、上位bit側のみでは許容誤差を満たせないことがある
+  template <typename T>
+  class BlockTransformEncoder:public Encoder<T>
+  {
+    public:
+      BlockTransformEncoder(const size_t& arg_nx, const size_t& arg_ny, const size_t& arg_nz, const float& arg_tolerance, const bool& arg_is_relative)
+        :nx(arg_nx), ny(arg_ny), nz(arg_nz), tolerance(arg_tolerance), is_relative(arg_is_relative) {}
+
+      void operator()(const size_t& /*length*/, const T* const src, T* const dst, T* const dst_lower=NULL) const
+      {
+        const long num_blocks=(long)BlockTransform::total_blocks(nx, ny, nz);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for(long b=0; b<num_blocks; b++)
+        {
+          encode_block(b, src, dst, dst_lower);
+        }
+      }
+      void make_upper_bits(const size_t& length, const T* const src, T* const dst) const
+      {
+        (*this)(length, src, dst, NULL);
+      }
+      void make_lower_bits(const size_t& /*length*/, const T* const src, T* const dst, T* const dst_lower) const
+      {
+        const long num_blocks=(long)BlockTransform::total_blocks(nx, ny, nz);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for(long b=0; b<num_blocks; b++)
+        {
+          const BlockTransform::Block block(nx, ny, nz, b);
+          T values[BlockTransform::MAX_BLOCK_ELEMENTS];
+          BlockTransform::reconstruct(basis, block, dst+block.offset, values);
+          for(size_t n=0; n<block.size(); n++)
+          {
+            dst_lower[block.offset+n]=real_xor(src[block.index(n)], values[n]);
+          }
+        }
+      }
+
+    private:
+      void encode_block(const size_t& block_index, const T* const src, T* const dst, T* const dst_lower) const
+      {
+        const BlockTransform::Block block(nx, ny, nz, block_index);
+        const size_t size=block.size();
+        T values[BlockTransform::MAX_BLOCK_ELEMENTS];
+        double allowed[BlockTransform::MAX_BLOCK_ELEMENTS];
+        double coefficients[BlockTransform::MAX_BLOCK_ELEMENTS];
+        bool is_finite=true;
+        double min_allowed=std::fabs((double)tolerance);
+        for(size_t n=0; n<size; n++)
+        {
+          values[n]=src[block.index(n)];
+          coefficients[n]=values[n];
+          is_finite = is_finite && coefficients[n]-coefficients[n] == 0.0;
+          allowed[n] = is_relative ? std::fabs(tolerance*(double)values[n]) : std::fabs((double)tolerance);
+          if(allowed[n] < min_allowed || n == 0)
+          {
+            min_allowed=allowed[n];
+          }
+        }
+        T* const upper=dst+block.offset;
+        if(!is_finite)
+        {
+          for(size_t n=0; n<size; n++)
+          {
+            upper[n]=values[n];
+          }
+        }else{
+          basis.transform(coefficients, block.sx, block.sy, block.sz, false);
+          double max_coefficient=0.0;
+          for(size_t n=0; n<size; n++)
+          {
+            max_coefficient = std::fabs(coefficients[n]) > max_coefficient ? std::fabs(coefficients[n]) : max_coefficient;
+          }
+          int plane=0;
+          bool truncated=false;
+          if(min_allowed > 0.0 && max_coefficient > 0.0)
+          {
+            // 各係数の切り捨て誤差は2^plane未満なので、再構成誤差は高々sqrt(size)*2^plane
+            int exp_max, exp_allowed;
+            frexp(max_coefficient, &exp_max);
+            frexp(min_allowed/std::sqrt((double)size), &exp_allowed);
+            int lo=exp_allowed-2;
+            int hi=exp_max+1;
+            if(is_converged(block, coefficients, values, allowed, hi, upper))
+            {
+              lo=hi;
+              truncated=true;
+            }else if(is_converged(block, coefficients, values, allowed, lo, upper)){
+              truncated=true;
+              while(hi-lo > 1)
+              {
+                const int mid=lo+(hi-lo)/2;
+                if(is_converged(block, coefficients, values, allowed, mid, upper))
+                {
+                  lo=mid;
+                }else{
+                  hi=mid;
+                }
+              }
+            }
+            plane=lo;
+          }
+          for(size_t n=0; n<size; n++)
+          {
+            upper[n]=(T)(truncated ? BlockTransform::truncate(coefficients[n], plane) : coefficients[n]);
+          }
+        }
+        if(dst_lower != NULL)
+        {
+          T recon[BlockTransform::MAX_BLOCK_ELEMENTS];
+          BlockTransform::reconstruct(basis, block, upper, recon);
+          for(size_t n=0; n<size; n++)
+          {
+            dst_lower[block.offset+n]=real_xor(values[n], recon[n]);
+          }
+        }
+      }
+
+      //@brief 係数をplaneで切り詰めた時に、再構成した値が全要素で許容誤差を満たすかどうか
+      //
+      //workは作業領域として使う
+      bool is_converged(const BlockTransform::Block& block, const double* coefficients, const T* values, const double* allowed, const int& plane, T* work) const
+      {
+        const size_t size=block.size();
+        for(size_t n=0; n<size; n++)
+        {
+          work[n]=(T)BlockTransform::truncate(coefficients[n], plane);
+        }
+        T recon[BlockTransform::MAX_BLOCK_ELEMENTS];
+        BlockTransform::reconstruct(basis, block, work, recon);
+        for(size_t n=0; n<size; n++)
+        {
+          if(!(std::fabs((double)recon[n]-(double)values[n]) <= allowed[n]))
+          {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      const size_t nx;
+      const size_t ny;
+      const size_t nz;
+      const float tolerance;
+      const bool  is_relative;
+      const BlockTransform::Basis basis;
+  };
+}//end of namespace JHPCNDF
+#endif
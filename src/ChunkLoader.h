@@ -0,0 +1,172 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file ChunkLoader.h
+
+#ifndef JHPCNDF_CHUNK_LOADER_H
+#define JHPCNDF_CHUNK_LOADER_H
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "Container.h"
+#include "Decoder.h"
+
+namespace JHPCNDF
+{
+  //@brief コンテナ形式のレコードから任意のチャンクを読み込んで伸長、デコードするクラス
+  //
+  //ファイルは独自に開き直してpreadで読み込むので、複数のスレッドから同時にloadを呼んでも良い
+  //(IOクラスはスレッド毎に別のインスタンスを渡すこと)
+  class ChunkLoader
+  {
+    public:
+      //@param filename_upper  上位bit側のファイル名
+      //@param filename_lower  下位bit側のファイル名 (""の場合は上位bit側のみからデコードする)
+      //@param record_position 上位bit側ファイル内でのレコードの先頭位置
+      ChunkLoader(const std::string& filename_upper, const std::string& filename_lower, const uint64_t& record_position)
+        :fd_upper(-1), fd_lower(-1), upper_base(0), valid(false)
+      {
+        fd_upper=::open(filename_upper.c_str(), O_RDONLY);
+        if(fd_upper < 0)
+        {
+          std::cerr<<"can't open "<<filename_upper<<std::endl;
+          return;
+        }
+        if(filename_lower != "")
+        {
+          fd_lower=::open(filename_lower.c_str(), O_RDONLY);
+          if(fd_lower < 0)
+          {
+            std::cerr<<"can't open "<<filename_lower<<std::endl;
+            return;
+          }
+        }
+        if(!read_at(fd_upper, record_position, &header, sizeof(ContainerHeader)) || !Container::is_valid_header(header))
+        {
+          std::cerr<<"invalid record header"<<std::endl;
+          return;
+        }
+        chunks.resize(header.num_chunks);
+        if(header.num_chunks > 0 && !read_at(fd_upper, record_position+sizeof(ContainerHeader), &(chunks[0]), sizeof(ContainerChunk)*header.num_chunks))
+        {
+          std::cerr<<"record index read failed"<<std::endl;
+          return;
+        }
+        upper_base=record_position+Container::index_size(header.num_chunks);
+        valid=true;
+      }
+
+      ~ChunkLoader()
+      {
+        if(fd_upper >= 0)
+        {
+          ::close(fd_upper);
+        }
+        if(fd_lower >= 0)
+        {
+          ::close(fd_lower);
+        }
+      }
+
+      bool is_valid(void) const
+      {
+        return valid;
+      }
+
+      const ContainerHeader& get_header(void) const
+      {
+        return header;
+      }
+
+      const std::vector<ContainerChunk>& get_chunks(void) const
+      {
+        return chunks;
+      }
+
+      //@brief 下位bit側も読み込んで元データを復元するかどうか
+      bool has_lower(void) const
+      {
+        return fd_lower >= 0 && header.lower_data_size > 0;
+      }
+
+      //@brief i番目のチャンクを読み込んでdstへデコードする
+      //@param io   伸長に使うIOクラス
+      //@param dst  チャンクの要素数以上の領域
+      //@param work 作業領域 (呼び出しをまたいで使い回す)
+      template <typename T>
+      bool load(IO* io, const size_t& i, T* dst, std::vector<char>* work) const
+      {
+        const ContainerChunk& chunk=chunks[i];
+        const size_t nmemb=chunk.num_elements;
+        if(header.element_size != sizeof(T))
+        {
+          return false;
+        }
+        if(nmemb == 0)
+        {
+          return true;
+        }
+        work->resize(chunk.upper_size);
+        if(!read_at(fd_upper, upper_base+chunk.upper_offset, &((*work)[0]), chunk.upper_size) ||
+           Container::decompress_from_memory(io, &((*work)[0]), chunk.upper_size, dst, sizeof(T), nmemb) != sizeof(T)*nmemb)
+        {
+          std::cerr<<"upper bits chunk read failed"<<std::endl;
+          return false;
+        }
+        if(has_lower())
+        {
+          std::vector<T> lower(nmemb);
+          work->resize(chunk.lower_size);
+          if(!read_at(fd_lower, header.lower_base+chunk.lower_offset, &((*work)[0]), chunk.lower_size) ||
+             Container::decompress_from_memory(io, &((*work)[0]), chunk.lower_size, &(lower[0]), sizeof(T), nmemb) != sizeof(T)*nmemb)
+          {
+            std::cerr<<"lower bits chunk read failed"<<std::endl;
+            return false;
+          }
+          Decoder<T> decoder;
+          decoder(nmemb, dst, &(lower[0]), dst);
+        }
+        return true;
+      }
+
+    private:
+      ChunkLoader(const ChunkLoader&);
+      ChunkLoader& operator=(const ChunkLoader&);
+
+      static bool read_at(const int& fd, const uint64_t& position, void* ptr, const size_t& size)
+      {
+        size_t done=0;
+        while(done < size)
+        {
+          const ssize_t rt=pread(fd, static_cast<char*>(ptr)+done, size-done, (off_t)(position+done));
+          if(rt < 0 && errno == EINTR)
+          {
+            continue;
+          }
+          if(rt <= 0)
+          {
+            return false;
+          }
+          done+=rt;
+        }
+        return true;
+      }
+
+      int fd_upper;
+      int fd_lower;
+      ContainerHeader header;
+      std::vector<ContainerChunk> chunks;
+      uint64_t upper_base;
+      bool valid;
+  };
+}//end of namespace JHPCNDF
+#endif
@@ -0,0 +1,103 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file CompressedBuffer.h
+
+#ifndef JHPCNDF_COMPRESSED_BUFFER_H
+#define JHPCNDF_COMPRESSED_BUFFER_H
+#include <string.h>
+#include <stdint.h>
+#include <string>
+
+//
+//JHPCNDF::compressが出力するバッファの形式
+//
+//  CompressedBufferHeader       (32 byte)
+//  圧縮済上位bitデータ          (upper_size byte)
+//  圧縮済下位bitデータ          (lower_size byte, 下位bitを含まない場合は無し)
+//
+//伸長に必要な情報は全てヘッダに含まれるので、バッファ単体で元のデータに戻せる
+//数値は全て出力した環境のバイトオーダーで格納する
+//
+namespace JHPCNDF
+{
+  struct CompressedBufferHeader
+  {
+    char     magic[4];        // "JHCB"
+    uint8_t  version;
+    uint8_t  element_size;    // 1要素のサイズ(float=4, double=8)
+    uint8_t  codec;           // 圧縮形式 (CompressedBuffer::Codec)
+    uint8_t  flags;           // CompressedBuffer::HAS_LOWER
+    uint64_t num_elements;
+    uint64_t upper_size;
+    uint64_t lower_size;
+  };
+
+  namespace CompressedBuffer
+  {
+    enum Codec
+    {
+      NONE=0,
+      GZIP,
+      LZ4
+    };
+    const uint8_t VERSION=1;
+    const uint8_t HAS_LOWER=1;
+
+    //圧縮/伸長時にIOクラスへ渡すバッファサイズ
+    const size_t IO_BUFFER_SIZE=32768;
+
+    inline const char* magic(void)
+    {
+      return "JHCB";
+    }
+
+    //@brief 圧縮形式の文字列(JHPCNDF::fopenのcomp引数)からヘッダに格納する値を決める
+    inline uint8_t codec(const std::string& comp)
+    {
+      if(comp.substr(0,4) == "gzip") return GZIP;
+      if(comp.substr(0,3) == "lz4")  return LZ4;
+      return NONE;
+    }
+
+    //@brief ヘッダに格納された値から伸長時に使うIOクラスの名前を返す
+    inline const char* codec_name(const uint8_t& codec)
+    {
+      if(codec == GZIP) return "gzip";
+      if(codec == LZ4)  return "lz4";
+      return "none";
+    }
+
+    inline void init_header(CompressedBufferHeader* header, const uint8_t& element_size)
+    {
+      memset(header, 0, sizeof(CompressedBufferHeader));
+      memcpy(header->magic, magic(), 4);
+      header->version=VERSION;
+      header->element_size=element_size;
+    }
+
+    //@brief バッファの先頭からヘッダを読み出して検証する
+    //@ret   ヘッダが不正か、バッファが途中で切れている場合はfalse
+    inline bool read_header(const void* src, const size_t& src_size, CompressedBufferHeader* header)
+    {
+      if(src == NULL || src_size < sizeof(CompressedBufferHeader))
+      {
+        return false;
+      }
+      memcpy(header, src, sizeof(CompressedBufferHeader));
+      if(memcmp(header->magic, magic(), 4) != 0 || header->version != VERSION)
+      {
+        return false;
+      }
+      return header->upper_size <= src_size-sizeof(CompressedBufferHeader)
+          && header->lower_size <= src_size-sizeof(CompressedBufferHeader)-header->upper_size;
+    }
+  }//end of namespace CompressedBuffer
+}//end of namespace JHPCNDF
+#endif
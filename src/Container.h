@@ -0,0 +1,245 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file Container.h
+
+#ifndef JHPCNDF_CONTAINER_H
+#define JHPCNDF_CONTAINER_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <iostream>
+#include "BaseIO.h"
+
+//
+//複数のチャンクを1つのファイルにまとめて格納するコンテナ形式の定義
+//
+//上位bit側のファイルはレコードの並びで、1つのレコードは以下の構成となる
+//  ContainerHeader                 (64 byte)
+//  ContainerChunk * num_chunks     (48 byte * num_chunks)
+//  各チャンクの圧縮済上位bitデータ (upper_data_size byte)
+//
+//下位bit側のファイルには各チャンクの圧縮済下位bitデータのみを格納し
+//その位置はContainerHeader::lower_base, ContainerChunk::lower_offsetで示す
+//
+//チャンク毎に独立して圧縮しているので、任意のチャンクだけを読み出して伸長できる
+//数値は全て出力した環境のバイトオーダーの固定長整数で格納する
+//
+namespace JHPCNDF
+{
+  struct ContainerHeader
+  {
+    char     magic[8];        // "JHPCNDFC"
+    uint32_t version;
+    uint32_t element_size;    // 1要素のサイズ(float=4, double=8)
+    uint64_t num_chunks;      // レコードに含まれるチャンク数
+    uint64_t num_elements;    // レコード全体の要素数
+    uint64_t upper_data_size; // インデックスの後ろに続く上位bitデータのサイズ
+    uint64_t lower_base;      // 下位bit側ファイル内でのこのレコードの先頭位置
+    uint64_t lower_data_size; // 下位bit側ファイル内でのこのレコードのサイズ
+    uint64_t reserved;
+  };
+
+  struct ContainerChunk
+  {
+    uint64_t element_offset;  // レコード全体の中でのチャンク先頭要素の位置
+    uint64_t num_elements;    // チャンクの要素数
+    uint64_t upper_offset;    // 上位bitデータ領域の先頭からのオフセット
+    uint64_t upper_size;      // 圧縮済上位bitデータのサイズ
+    uint64_t lower_offset;    // lower_baseからのオフセット
+    uint64_t lower_size;      // 圧縮済下位bitデータのサイズ
+  };
+
+  //@brief 読み込み対象となるレコード内の連続した要素の範囲
+  struct ContainerRange
+  {
+    uint64_t first;           // レコード内での先頭要素の位置
+    uint64_t count;           // 要素数
+    uint64_t dst_offset;      // 読み込み先領域での先頭要素の位置
+  };
+
+  namespace Container
+  {
+    inline const char* magic(void)
+    {
+      return "JHPCNDFC";
+    }
+    const uint32_t VERSION=1;
+
+    inline void init_header(ContainerHeader* header, const uint32_t& element_size)
+    {
+      memset(header, 0, sizeof(ContainerHeader));
+      memcpy(header->magic, magic(), 8);
+      header->version=VERSION;
+      header->element_size=element_size;
+    }
+
+    inline bool is_valid_header(const ContainerHeader& header)
+    {
+      return memcmp(header.magic, magic(), 8) == 0 && header.version == VERSION;
+    }
+
+    //@brief ヘッダとインデックスを合わせたサイズを返す
+    inline uint64_t index_size(const uint64_t& num_chunks)
+    {
+      return sizeof(ContainerHeader)+sizeof(ContainerChunk)*num_chunks;
+    }
+
+    //@brief レコード全体(上位bit側)のサイズを返す
+    inline uint64_t record_size(const ContainerHeader& header)
+    {
+      return index_size(header.num_chunks)+header.upper_data_size;
+    }
+
+    //@brief [first, first+count)の範囲の要素を含むチャンクの範囲を返す
+    //@param chunks      element_offsetの昇順に並んだチャンクのインデックス
+    //@param begin_chunk 範囲内の最初のチャンク番号
+    //@param end_chunk   範囲内の最後のチャンク番号+1
+    inline void find_chunks(const std::vector<ContainerChunk>& chunks, const uint64_t& first, const uint64_t& count, size_t* begin_chunk, size_t* end_chunk)
+    {
+      const uint64_t last=first+count;
+      //first を含むチャンクを二分探索で探す
+      size_t left=0;
+      size_t right=chunks.size();
+      while(left < right)
+      {
+        size_t center=(left+right)/2;
+        if(chunks[center].element_offset+chunks[center].num_elements <= first)
+        {
+          left=center+1;
+        }else{
+          right=center;
+        }
+      }
+      *begin_chunk=left;
+      size_t end=left;
+      while(end < chunks.size() && chunks[end].element_offset < last)
+      {
+        ++end;
+      }
+      *end_chunk=end;
+    }
+
+    //@brief 昇順に並んだ範囲のうち、positionより後ろに終端がある最初のものを返す
+    inline size_t find_range(const std::vector<ContainerRange>& ranges, const uint64_t& position)
+    {
+      size_t left=0;
+      size_t right=ranges.size();
+      while(left < right)
+      {
+        size_t center=(left+right)/2;
+        if(ranges[center].first+ranges[center].count <= position)
+        {
+          left=center+1;
+        }else{
+          right=center;
+        }
+      }
+      return left;
+    }
+
+    //@brief 昇順に並んだ範囲のいずれかと重なるチャンクの番号を昇順に返す
+    inline void find_chunks(const std::vector<ContainerChunk>& chunks, const std::vector<ContainerRange>& ranges, std::vector<size_t>* chunk_ids)
+    {
+      chunk_ids->clear();
+      for(size_t i=0; i<ranges.size(); i++)
+      {
+        size_t begin_chunk=0;
+        size_t end_chunk=0;
+        find_chunks(chunks, ranges[i].first, ranges[i].count, &begin_chunk, &end_chunk);
+        for(size_t j=begin_chunk; j<end_chunk; j++)
+        {
+          if(chunk_ids->empty() || chunk_ids->back() < j)
+          {
+            chunk_ids->push_back(j);
+          }
+        }
+      }
+    }
+
+    //@brief レコードを3次元配列とみなした時の部分領域を、連続した要素の範囲の並びに変換する
+    //@param dims   配列全体の大きさ (dims[0]の方向が最も速く変化する)
+    //@param start  部分領域の先頭位置
+    //@param count  部分領域の大きさ
+    //@param ranges 部分領域に含まれる範囲 (隣接する範囲は結合し、昇順に並べる)
+    //@ret   部分領域が配列の外にはみ出す時はfalse
+    //
+    //読み込み先の領域は部分領域の大きさの3次元配列とする
+    inline bool subarray_to_ranges(const size_t dims[3], const size_t start[3], const size_t count[3], std::vector<ContainerRange>* ranges)
+    {
+      ranges->clear();
+      for(int i=0; i<3; i++)
+      {
+        if(start[i]+count[i] > dims[i])
+        {
+          return false;
+        }
+      }
+      uint64_t dst_offset=0;
+      for(size_t k=start[2]; k<start[2]+count[2]; k++)
+      {
+        for(size_t j=start[1]; j<start[1]+count[1]; j++)
+        {
+          if(count[0] == 0)
+          {
+            continue;
+          }
+          const uint64_t first=((uint64_t)k*dims[1]+j)*dims[0]+start[0];
+          if(!ranges->empty() && ranges->back().first+ranges->back().count == first)
+          {
+            ranges->back().count+=count[0];
+          }else{
+            ContainerRange range;
+            range.first=first;
+            range.count=count[0];
+            range.dst_offset=dst_offset;
+            ranges->push_back(range);
+          }
+          dst_offset+=count[0];
+        }
+      }
+      return true;
+    }
+
+    //@brief IOクラスを使ってメモリ上のバッファへ圧縮したデータを出力する
+    //@param io      使用するIOクラス
+    //@param ptr     圧縮するデータ
+    //@param size    データの1要素あたりのサイズ
+    //@param nmemb   データの要素数
+    //@param output  圧縮後のデータを格納する領域
+    //@ret   圧縮後のサイズ (エラー時は0)
+    inline size_t compress_to_memory(IO* io, const void* ptr, const size_t& size, const size_t& nmemb, std::vector<char>* output)
+    {
+      MemoryOutputStream stream;
+      io->fwrite(ptr, size, nmemb, &stream);
+      output->swap(stream.get_storage());
+      return output->size();
+    }
+
+    //@brief メモリ上の圧縮済データをIOクラスを使って伸長する
+    //@param io          使用するIOクラス
+    //@param buffer      圧縮済データ
+    //@param buffer_size 圧縮済データのサイズ
+    //@param ptr         伸長後のデータを格納する領域
+    //@param size        データの1要素あたりのサイズ
+    //@param nmemb       データの要素数
+    inline size_t decompress_from_memory(IO* io, const char* buffer, const size_t& buffer_size, void* ptr, const size_t& size, const size_t& nmemb)
+    {
+      if(buffer_size == 0)
+      {
+        return 0;
+      }
+      MemoryInputStream stream(buffer, buffer_size);
+      return io->fread(ptr, size, nmemb, &stream);
+    }
+  }//end of namespace Container
+}//end of namespace JHPCNDF
+#endif
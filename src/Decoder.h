@@ -16,6 +16,9 @@
 
 namespace JHPCNDF
 {
+    //@brief 上位bit側と下位bit側のXORを取って元データに戻すデコーダ
+    //
+    //下位bit側は元データと上位bit側のXORなので、上位bit側が元データを切り詰めた値でない場合(quantizeエンコーダ)も元に戻る
     template <typename T>
     class Decoder 
     {
@@ -24,7 +27,7 @@ namespace JHPCNDF
             {
                 for (size_t i=0;i<length;i++)
                 {
-                    real_or<1>(&(src_upper[i]), &(src_lower[i]), &(dst[i]));
+                    real_xor<1>(&(src_upper[i]), &(src_lower[i]), &(dst[i]));
                 }
 #ifdef DEBUG
                 debug_write(0, dst, src_upper, src_lower);
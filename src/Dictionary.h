@@ -0,0 +1,136 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file Dictionary.h
+
+#ifndef JHPCNDF_DICTIONARY_H
+#define JHPCNDF_DICTIONARY_H
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <zlib.h>
+#include "Stream.h"
+
+//
+//JHPCNDF::set_dictionaryが出力するレコードの形式
+//
+//  DictionaryRecordHeader   (20 byte, 無圧縮)
+//  辞書                     (header.compressed_size byte, zlib形式で圧縮)
+//
+//辞書レコードはファイルの先頭に1回だけ出力し、上位bit側、下位bit側それぞれのファイルに
+//そのファイル用の辞書を格納する
+//辞書レコードを含むファイルの圧縮済データは、gzip形式の代わりに辞書を使ったzlib形式で出力する
+//数値は全て出力した環境のバイトオーダーで格納する
+//
+namespace JHPCNDF
+{
+  struct DictionaryRecordHeader
+  {
+    char     magic[4];        // "JHDC"
+    uint8_t  version;
+    uint8_t  reserved[3];
+    uint32_t size;            // 辞書のサイズ(byte)
+    uint32_t compressed_size; // 圧縮後の辞書のサイズ(byte)
+    uint32_t adler;           // 辞書のadler32 (zlib形式のヘッダに格納される辞書IDと同じ値)
+  };
+
+  namespace Dictionary
+  {
+    const uint8_t VERSION=1;
+
+    //@brief 辞書の最大サイズ (deflateの窓サイズ)
+    const size_t MAX_SIZE=32768;
+
+    inline const char* magic(void)
+    {
+      return "JHDC";
+    }
+
+    //@brief エンコード済のサンプルデータから辞書を作る
+    //
+    //deflateは辞書の末尾ほど短い距離で参照できるので、サンプルが大きい場合は末尾のMAX_SIZE分を使う
+    inline void build(const void* sample, const size_t& size, std::vector<unsigned char>* dictionary)
+    {
+      const size_t length = size < MAX_SIZE ? size : MAX_SIZE;
+      const unsigned char* src=static_cast<const unsigned char*>(sample)+(size-length);
+      dictionary->assign(src, src+length);
+    }
+
+    inline uint32_t checksum(const std::vector<unsigned char>& dictionary)
+    {
+      return adler32(adler32(0L, Z_NULL, 0), dictionary.empty() ? Z_NULL : &(dictionary[0]), dictionary.size());
+    }
+
+    //@brief 辞書レコードを出力する
+    //@ret   出力に成功したかどうか
+    //
+    //辞書自体は元データ1レコード分と同程度に縮むので、圧縮して格納する
+    inline bool write(Stream* stream, const std::vector<unsigned char>& dictionary)
+    {
+      std::vector<unsigned char> compressed(compressBound(dictionary.size()));
+      uLongf compressed_size=compressed.size();
+      if(compress2(&(compressed[0]), &compressed_size, dictionary.empty() ? Z_NULL : &(dictionary[0]), dictionary.size(), Z_BEST_COMPRESSION) != Z_OK)
+      {
+        return false;
+      }
+      DictionaryRecordHeader header;
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, magic(), 4);
+      header.version=VERSION;
+      header.size=dictionary.size();
+      header.compressed_size=compressed_size;
+      header.adler=checksum(dictionary);
+      if(stream->write(&header, sizeof(header)) != sizeof(header))
+      {
+        return false;
+      }
+      return stream->write(&(compressed[0]), compressed_size) == compressed_size;
+    }
+
+    //@brief 入力元の先頭に辞書レコードがあれば読み込む
+    //@ret   辞書レコードが無かった場合と読み込みに成功した場合はtrue
+    //
+    //辞書レコードが無かった場合は読み込んだ分を戻し、dictionaryを空にする
+    inline bool read(Stream* stream, std::vector<unsigned char>* dictionary)
+    {
+      dictionary->clear();
+      DictionaryRecordHeader header;
+      const size_t header_size=stream->read(&header, sizeof(header));
+      if(header_size != sizeof(header) || memcmp(header.magic, magic(), 4) != 0)
+      {
+        stream->unread(header_size);
+        return true;
+      }
+      if(header.version != VERSION || header.size > MAX_SIZE || header.compressed_size > compressBound(MAX_SIZE))
+      {
+        return false;
+      }
+      std::vector<unsigned char> compressed(header.compressed_size+1);
+      if(stream->read(&(compressed[0]), header.compressed_size) != header.compressed_size)
+      {
+        return false;
+      }
+      dictionary->resize(header.size+1);
+      uLongf size=header.size;
+      if(uncompress(&((*dictionary)[0]), &size, &(compressed[0]), header.compressed_size) != Z_OK || size != header.size)
+      {
+        dictionary->clear();
+        return false;
+      }
+      dictionary->resize(header.size);
+      if(header.adler != checksum(*dictionary))
+      {
+        dictionary->clear();
+        return false;
+      }
+      return true;
+    }
+  }//end of namespace Dictionary
+}//end of namespace JHPCNDF
+#endif
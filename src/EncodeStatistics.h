@@ -0,0 +1,142 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file EncodeStatistics.h
+
+#ifndef JHPCNDF_ENCODE_STATISTICS_H
+#define JHPCNDF_ENCODE_STATISTICS_H
+#include <cmath>
+#include <vector>
+#include "Subarray.h"
+#ifdef USE_OPENMP
+#include <omp.h>
+#else
+#include <sys/time.h>
+#endif
+
+namespace JHPCNDF
+{
+  //@brief 経過時間計測用の時刻(sec)
+  inline double wall_time(void)
+  {
+#ifdef USE_OPENMP
+    return omp_get_wtime();
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec+(double)tv.tv_usec*1e-6;
+#endif
+  }
+
+  //@brief エンコード結果の分割位置のヒストグラムと誤差を集計するクラス
+  //
+  //エンコーダのループ内では要素毎の分割位置を1byteずつ記録するだけにして、スレッドの特定や排他制御を行わない
+  //集計はエンコード後に1回だけ、スレッド毎のカウンタを使って並列に行う
+  template <typename T>
+  class StatisticsCollector
+  {
+    public:
+      //@param num_bins 分割位置の種類数 (仮数部のbit数+1)
+      //@param length   エンコードする要素数
+      //@param dst      上位bit側の出力先 (エンコーダに渡す連続領域の先頭)
+      StatisticsCollector(const unsigned int& arg_num_bins, const size_t& length, const T* const dst)
+        :num_bins(arg_num_bins), positions(length, (unsigned char)NO_SPLIT_POSITION), base(dst) {}
+
+      //@brief 上位bit側の出力先がupperの要素の分割位置を記録する
+      void record(const unsigned int& split_position, const T* const upper)
+      {
+        positions[upper-base]=(unsigned char)split_position;
+      }
+
+      //@brief 記録した分割位置と、元データと上位bit側データの差を集計する
+      //@param src               元データ (layoutを指定した場合は部分領域を含む配列の先頭)
+      //@param layout            NULL以外が指定された場合は、srcのうちlayoutで指定した部分領域をエンコードしたものとして扱う
+      //@param histogram         分割位置毎の要素数 (分割位置を記録した要素が無い場合は空にする)
+      //@param max_error         誤差の絶対値の最大値
+      //@param sum_squared_error 誤差の2乗和
+      void summarize(const T* const src, const SubarrayLayout* layout, std::vector<size_t>* histogram, double* max_error, double* sum_squared_error) const
+      {
+        const size_t length=positions.size();
+        //layout指定時は1行ずつ、それ以外はSUMMARIZE_BLOCK要素ずつ処理する
+        const size_t block = layout != NULL ? layout->row_length() : (size_t)SUMMARIZE_BLOCK;
+        const long   num_items = block > 0 ? (long)((length+block-1)/block) : 0;
+        histogram->assign(num_bins, 0);
+        *max_error=0.0;
+        *sum_squared_error=0.0;
+#ifdef USE_OPENMP
+#pragma omp parallel
+#endif
+        {
+          std::vector<size_t> local(2*num_bins, 0);
+          double local_max=0.0;
+          double local_sum=0.0;
+          std::vector<T> row(layout != NULL ? block : 0);
+#ifdef USE_OPENMP
+#pragma omp for
+#endif
+          for(long n=0; n<num_items; n++)
+          {
+            const size_t first=n*block;
+            const size_t count = length-first < block ? length-first : block;
+            const T* org=src+first;
+            if(layout != NULL)
+            {
+              layout->gather_row(n, 0, count, src, &(row[0]));
+              org=&(row[0]);
+            }
+            //同じ分割位置が続くことが多いので、カウンタを2組に分けて加算の依存関係を断つ
+            for(size_t j=0; j<count; j++)
+            {
+              const unsigned char split_position=positions[first+j];
+              if(split_position < num_bins)
+              {
+                local[(j&1)*num_bins+split_position]++;
+              }
+            }
+            for(size_t j=0; j<count; j++)
+            {
+              const double error=std::fabs((double)org[j]-(double)base[first+j]);
+              local_max = error > local_max ? error : local_max;
+              // NaN, infの差は2乗和に含めない
+              local_sum += error-error == 0.0 ? error*error : 0.0;
+            }
+          }
+#ifdef USE_OPENMP
+#pragma omp critical
+#endif
+          {
+            for(size_t n=0; n<num_bins; n++)
+            {
+              (*histogram)[n]+=local[n]+local[num_bins+n];
+            }
+            *max_error = local_max > *max_error ? local_max : *max_error;
+            *sum_squared_error+=local_sum;
+          }
+        }
+        size_t num_recorded=0;
+        for(size_t n=0; n<num_bins; n++)
+        {
+          num_recorded+=(*histogram)[n];
+        }
+        if(num_recorded == 0)
+        {
+          histogram->clear();
+        }
+      }
+
+    private:
+      static const unsigned char NO_SPLIT_POSITION=0xff;
+      //@brief layoutを指定しない場合に、summarizeで1度に処理する要素数
+      static const size_t SUMMARIZE_BLOCK=4096;
+      const unsigned int num_bins;
+      std::vector<unsigned char> positions;
+      const T* const base;
+  };
+}//end of namespace JHPCNDF
+#endif
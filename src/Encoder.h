@@ -13,9 +13,46 @@
 #define ENCODER_H
 #include <cmath>
 #include "Utility.h"
+#include "Quantize.h"
+#include "Subarray.h"
+#include "EncodeStatistics.h"
 
 namespace JHPCNDF
 {
+    //@brief 要素毎に異なる許容誤差
+    //
+    //valuesが指定された場合はvalues[i]、maskが指定された場合はtable[mask[i]]をi番目の要素の許容誤差とする
+    //どちらも指定されていない場合はエンコーダに指定したスカラー値を使う
+    struct ToleranceField
+    {
+        ToleranceField():values(NULL), mask(NULL), table(NULL) {}
+        bool empty(void) const
+        {
+            return values == NULL && mask == NULL;
+        }
+        float operator[](const size_t& i) const
+        {
+            return values != NULL ? values[i] : table[mask[i]];
+        }
+        //@brief 先頭からlength要素の許容誤差のうち絶対値が最小のもの
+        float min_value(const size_t& length) const
+        {
+            float result=0.0f;
+            for(size_t i=0; i<length; i++)
+            {
+                const float value=std::fabs((*this)[i]);
+                if(i == 0 || value < result)
+                {
+                    result=value;
+                }
+            }
+            return result;
+        }
+        const float*         values;
+        const unsigned char* mask;
+        const float*         table;
+    };
+
     //@ エンコーダのインターフェースを規定する抽象クラス
     //
     //下位bit側の生成はあまりバリエーションが無いのでデフォルト実装も提供する
@@ -23,6 +60,7 @@ namespace JHPCNDF
     class Encoder
     {
         public:
+            Encoder():statistics(NULL) {}
             virtual ~Encoder(){};
             virtual void operator()(const size_t& length, const T* const src, T* const dst, T* const dst_lower=NULL) const=0;
             virtual void make_upper_bits(const size_t& length, const T* const src, T* const dst) const=0;
@@ -36,7 +74,81 @@ namespace JHPCNDF
                     real_xor<1>(&(src[i]), &(dst[i]), &(dst_lower[i]));
                 }
             }
+
+            //@brief baseを先頭とする配列のうち、layoutで指定した部分領域を連続領域dst, dst_lowerへエンコードする
+            //
+            //行内の要素が連続している場合は元の配列を直接エンコードし、そうでない場合もSUBARRAY_SEGMENT要素ずつしか作業領域に集めない
+            //処理単位(行または行の断片)が少ない時は単位内のループ並列、多い時は単位毎に並列化する
+            virtual void encode_subarray(const SubarrayLayout& layout, const T* const base, T* const dst, T* const dst_lower=NULL) const
+            {
+                const size_t length=layout.row_length();
+                const size_t stride=layout.row_stride();
+                const size_t segment = stride != 1 ? (size_t)SUBARRAY_SEGMENT : length;
+                const size_t num_segments = segment > 0 ? (length+segment-1)/segment : 0;
+                const long   num_items=(long)(layout.num_rows()*num_segments);
+#ifdef USE_OPENMP
+#pragma omp parallel if(num_items >= SUBARRAY_PARALLEL_ITEMS)
+#endif
+                {
+                    std::vector<T> work(stride != 1 ? segment : 0);
+#ifdef USE_OPENMP
+#pragma omp for
+#endif
+                    for(long n=0; n<num_items; n++)
+                    {
+                        const size_t row=n/num_segments;
+                        const size_t first=(n%num_segments)*segment;
+                        const size_t count = length-first < segment ? length-first : segment;
+                        const T* src=base+layout.row_offset(row)+first*stride;
+                        if(!work.empty())
+                        {
+                            layout.gather_row(row, first, count, base, &(work[0]));
+                            src=&(work[0]);
+                        }
+                        T* const upper=dst+row*length+first;
+                        make_upper_bits(count, src, upper);
+                        if(dst_lower != NULL) make_lower_bits(count, src, upper, dst_lower+row*length+first);
+                    }
+                }
+            }
+            //@brief 要素毎の許容誤差を設定する (許容誤差を使わないエンコーダでは無視される)
+            //
+            //fieldの添字はoperator()やmake_upper_bitsに渡すsrcの添字と一致させること (encode_subarrayとは併用できない)
+            void set_tolerance_field(const ToleranceField& arg_field)
+            {
+                field=arg_field;
+            }
+            //@brief 要素毎の分割位置を記録する (NULLを渡すと記録しない)
+            //
+            //分割位置を持たないエンコーダでは何も記録しない
+            //集計先はエンコード結果に影響しないのでconstメンバとするが、集計中のエンコーダを他のスレッドと共有しないこと
+            void set_statistics(StatisticsCollector<T>* arg_statistics) const
+            {
+                statistics=arg_statistics;
+            }
         protected:
+            //@brief i番目の要素の許容誤差 (要素毎の許容誤差が設定されていない場合はtolerance)
+            double tolerance_at(const size_t& i, const float& tolerance) const
+            {
+                return field.empty() ? tolerance : field[i];
+            }
+            ToleranceField field;
+
+            //@brief 集計が有効な場合に、上位bit側の出力先がdstの要素の分割位置を記録する
+            void record(const unsigned int& split_position, const T* const dst) const
+            {
+                if(statistics != NULL)
+                {
+                    statistics->record(split_position, dst);
+                }
+            }
+            mutable StatisticsCollector<T>* statistics;
+
+            //@brief encode_subarrayで行内の要素が連続していない時に、一度に作業領域へ集める要素数
+            static const size_t SUBARRAY_SEGMENT=4096;
+            //@brief encode_subarrayで処理単位毎の並列化に切り替える単位数
+            static const long SUBARRAY_PARALLEL_ITEMS=64;
+
             void debug_write(const size_t& index, const T* const org, const T* const upper) const
             {
                 std::cerr<<"original["<<index<<"]   = ";
@@ -89,7 +201,7 @@ namespace JHPCNDF
 #endif
                 for (size_t i=0; i<length; i++)
                 {
-                    double tolerance=this->tolerance;
+                    double tolerance=this->tolerance_at(i, this->tolerance);
                     if(is_relative)
                     {
                         tolerance*=src[i];
@@ -107,6 +219,7 @@ namespace JHPCNDF
                         update_split_position(&split_position);
                         n_bit_zero_padding<1>(&(src[i]), &(dst[i]), split_position);
                     }
+                    this->record(split_position, &(dst[i]));
 #ifdef DEBUG
                     if(i==0 || i==length/2)
                     {
@@ -161,7 +274,7 @@ namespace JHPCNDF
 #endif
                 for (size_t i=0; i<length; i++)
                 {
-                    double tolerance=this->tolerance;
+                    double tolerance=this->tolerance_at(i, this->tolerance);
                     if(is_relative)
                     {
                         tolerance*=src[i];
@@ -179,6 +292,7 @@ namespace JHPCNDF
                         update_split_position(&split_position);
                         n_bit_zero_padding<1>(&(src[i]), &(dst[i]), split_position);
                     }
+                    this->record(split_position, &(dst[i]));
 #ifdef DEBUG
                     if(i==0 || i==length/2)
                     {
@@ -246,7 +360,7 @@ namespace JHPCNDF
 #endif
                 for (size_t i=0; i<length; i++)
                 {
-                    double tolerance=this->tolerance;
+                    double tolerance=this->tolerance_at(i, this->tolerance);
                     if(is_relative)
                     {
                         tolerance*=src[i];
@@ -265,6 +379,7 @@ namespace JHPCNDF
                         split_position=split_positions[++j];
                         n_bit_zero_padding<1>(&(src[i]), &(dst[i]), split_position);
                     }
+                    this->record(split_position, &(dst[i]));
 #ifdef DEBUG
                     if(i==0 || i==length/2)
                     {
@@ -298,7 +413,7 @@ namespace JHPCNDF
 #endif
                 for (size_t i=0; i<length; i++)
                 {
-                    double tolerance=this->tolerance;
+                    double tolerance=this->tolerance_at(i, this->tolerance);
                     if(is_relative)
                     {
                         tolerance*=src[i];
@@ -331,6 +446,7 @@ namespace JHPCNDF
                         split_position=(left+right)/2;
                         n_bit_zero_padding<1>(&(src[i]), &(dst[i]), split_position);
                     }
+                    this->record(split_position, &(dst[i]));
 
 #ifdef DEBUG
                     if(i==0 || i==length/2)
@@ -374,11 +490,102 @@ namespace JHPCNDF
                 for (int i=0;i<length; i++)
                 {
                     n_bit_zero_padding<1>(&(src[i]), &(dst[i]), split_position);
+                    this->record(split_position, &(dst[i]));
                 }
             }
             unsigned int split_position;
     };
 
+    //@brief 値を幅2*toleranceのビンの中央値に量子化するエンコーダ
+    //
+    //上位bit側には量子化後の値を出力する(誤差はbinary_searchと同じくtolerance以内)
+    //fwriteで出力する場合は、上位bit側をzlib等で圧縮する代わりにビン番号をエントロピー符号化する(Quantize.h参照)
+    //相対誤差指定時のビン幅は、0でない有限値のうち絶対値が最小の値に対する許容誤差から決める
+    //量子化すると許容誤差を満たせない値(NaN, Infなど)は元の値をそのまま出力する
+    template <typename T>
+    class QuantizeEncoder:public Encoder<T>
+    {
+        public:
+            QuantizeEncoder(const float& arg_tolerance, const bool& arg_is_relative): tolerance(arg_tolerance), is_relative(arg_is_relative), fixed_step(0.0) {}
+            //@brief 配列の一部だけをエンコードする時などに、ビン幅を外部で決めて固定する (arg_stepが0以下の時は固定しない)
+            QuantizeEncoder(const float& arg_tolerance, const bool& arg_is_relative, const double& arg_step): tolerance(arg_tolerance), is_relative(arg_is_relative), fixed_step(arg_step) {}
+            void operator()(const size_t& length, const T* const src, T* const dst, T* const dst_lower=NULL) const
+            {
+                make_upper_bits(length, src, dst);
+                if(dst_lower != NULL) this->make_lower_bits(length, src, dst, dst_lower);
+            }
+            //@brief srcをエンコードする時のビン幅を返す
+            double step(const size_t& length, const T* const src) const
+            {
+                if(fixed_step > 0.0)
+                {
+                    return fixed_step;
+                }
+                // 要素毎に許容誤差が異なる場合は、最も厳しい許容誤差からビン幅を決める
+                return Quantize::step(length, src, this->field.empty() ? tolerance : this->field.min_value(length), is_relative);
+            }
+            //@brief baseのうちlayoutで指定した部分領域をエンコードする時のビン幅を返す
+            //
+            //部分領域を連続領域に集めてからstep()を呼んだ場合と同じ値になる
+            double step(const SubarrayLayout& layout, const T* const base) const
+            {
+                if(fixed_step > 0.0 || !is_relative)
+                {
+                    return step(0, base);
+                }
+                double width=0.0;
+                for(size_t r=0; r<layout.num_rows(); r++)
+                {
+                    const double row_width=Quantize::step(layout.row_length(), base+layout.row_offset(r), tolerance, is_relative, layout.row_stride());
+                    if(row_width > 0.0 && (width == 0.0 || row_width < width))
+                    {
+                        width=row_width;
+                    }
+                }
+                return width;
+            }
+            //行毎にビン幅を決めないように、部分領域全体から求めたビン幅を固定してエンコードする
+            void encode_subarray(const SubarrayLayout& layout, const T* const base, T* const dst, T* const dst_lower=NULL) const
+            {
+                const double step=this->step(layout, base);
+                if(step > 0.0)
+                {
+                    QuantizeEncoder<T>(tolerance, is_relative, step).Encoder<T>::encode_subarray(layout, base, dst, dst_lower);
+                }else{
+                    Encoder<T>::encode_subarray(layout, base, dst, dst_lower);
+                }
+            }
+        private:
+            void make_upper_bits(const size_t& length, const T* const src, T* const dst) const
+            {
+                const double step=this->step(length, src);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+                for (long i=0; i<(long)length; i++)
+                {
+                    double tolerance=std::fabs(this->tolerance_at(i, this->tolerance));
+                    if(is_relative)
+                    {
+                        tolerance*=std::fabs((double)src[i]);
+                    }
+                    int64_t bin;
+                    dst[i]=src[i];
+                    if(Quantize::quantize(src[i], step, &bin))
+                    {
+                        const T value=Quantize::dequantize<T>(bin, step);
+                        if(std::fabs((double)value-(double)src[i]) <= tolerance)
+                        {
+                            dst[i]=value;
+                        }
+                    }
+                }
+            }
+            const float tolerance;
+            const bool  is_relative;
+            const double fixed_step;  // 0より大きい場合はこのビン幅を使う
+    };
+
     template <typename T>
     Encoder<T>* EncoderFactory(const std::string& name, const float& tolerance, const bool& is_relative)
     {
@@ -392,6 +599,8 @@ namespace JHPCNDF
             enc=new LinearSearchEncoder<T>(tolerance, is_relative);
         }else if(name == "binary_search"){
             enc=new BinarySearchEncoder<T>(tolerance, is_relative);
+        }else if(name == "quantize"){
+            enc=new QuantizeEncoder<T>(tolerance, is_relative);
         }else if(name == "dummy"){
             enc=new DummyEncoder<T>;
         }else if(name == "nbit_filter"){
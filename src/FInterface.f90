@@ -13,6 +13,19 @@ integer(4)       :: unit
 call jhpcndf_close_(unit)
 end subroutine jhpcndf_close
 
+subroutine jhpcndf_set_scratch_capacity(unit, size)
+implicit none
+integer(4)       :: unit
+integer(8)       :: size
+call jhpcndf_set_scratch_capacity_(unit, size)
+end subroutine jhpcndf_set_scratch_capacity
+
+subroutine jhpcndf_release_scratch(unit)
+implicit none
+integer(4)       :: unit
+call jhpcndf_release_scratch_(unit)
+end subroutine jhpcndf_release_scratch
+
 subroutine jhpcndf_write_real4(unit, recl, data, tol, is_rel, enc)
 implicit none
 integer(4)        :: unit
@@ -110,6 +123,314 @@ character(len=1), parameter  :: null = char(0)
 call jhpcndf_read_character_(unit, recl, data//null)
 end subroutine jhpcndf_read_character
 
+subroutine jhpcndf_write_temporal_real4(unit, recl, data, var, tol, is_rel, enc, interval)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(4)           :: data(:)
+character(len=*)  :: var
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+integer(4)        :: interval
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_temporal_real4_(unit, recl, data, var//null, tol, is_rel, enc//null, interval)
+end subroutine jhpcndf_write_temporal_real4
+
+subroutine jhpcndf_write_temporal_real8(unit, recl, data, var, tol, is_rel, enc, interval)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(8)           :: data(:)
+character(len=*)  :: var
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+integer(4)        :: interval
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_temporal_real8_(unit, recl, data, var//null, tol, is_rel, enc//null, interval)
+end subroutine jhpcndf_write_temporal_real8
+
+subroutine jhpcndf_read_temporal_real4(unit, recl, data, var)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(4)           :: data(:)
+character(len=*)  :: var
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_read_temporal_real4_(unit, recl, data, var//null)
+end subroutine jhpcndf_read_temporal_real4
+
+subroutine jhpcndf_read_temporal_real8(unit, recl, data, var)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(8)           :: data(:)
+character(len=*)  :: var
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_read_temporal_real8_(unit, recl, data, var//null)
+end subroutine jhpcndf_read_temporal_real8
+
+subroutine jhpcndf_set_dictionary_real4(unit, recl, data, tol, is_rel, enc, ierr)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(4)           :: data(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+integer(4)        :: ierr
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_set_dictionary_real4_(unit, recl, data, tol, is_rel, enc//null, ierr)
+end subroutine jhpcndf_set_dictionary_real4
+
+subroutine jhpcndf_set_dictionary_real8(unit, recl, data, tol, is_rel, enc, ierr)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(8)           :: data(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+integer(4)        :: ierr
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_set_dictionary_real8_(unit, recl, data, tol, is_rel, enc//null, ierr)
+end subroutine jhpcndf_set_dictionary_real8
+
+subroutine jhpcndf_write_lorenzo_real4(unit, nx, ny, nz, data, tol, is_rel)
+implicit none
+integer(4)        :: unit
+integer(8)        :: nx, ny, nz
+real(4)           :: data(:)
+real(4)           :: tol
+logical           :: is_rel
+call jhpcndf_write_lorenzo_real4_(unit, nx, ny, nz, data, tol, is_rel)
+end subroutine jhpcndf_write_lorenzo_real4
+
+subroutine jhpcndf_write_lorenzo_real8(unit, nx, ny, nz, data, tol, is_rel)
+implicit none
+integer(4)        :: unit
+integer(8)        :: nx, ny, nz
+real(8)           :: data(:)
+real(4)           :: tol
+logical           :: is_rel
+call jhpcndf_write_lorenzo_real8_(unit, nx, ny, nz, data, tol, is_rel)
+end subroutine jhpcndf_write_lorenzo_real8
+
+subroutine jhpcndf_read_lorenzo_real4(unit, nx, ny, nz, data)
+implicit none
+integer(4)        :: unit
+integer(8)        :: nx, ny, nz
+real(4)           :: data(:)
+call jhpcndf_read_lorenzo_real4_(unit, nx, ny, nz, data)
+end subroutine jhpcndf_read_lorenzo_real4
+
+subroutine jhpcndf_read_lorenzo_real8(unit, nx, ny, nz, data)
+implicit none
+integer(4)        :: unit
+integer(8)        :: nx, ny, nz
+real(8)           :: data(:)
+call jhpcndf_read_lorenzo_real8_(unit, nx, ny, nz, data)
+end subroutine jhpcndf_read_lorenzo_real8
+
+subroutine jhpcndf_write_fixed_rate_real4(unit, recl, data, rate)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(4)           :: data(:)
+integer(4)        :: rate
+call jhpcndf_write_fixed_rate_real4_(unit, recl, data, rate)
+end subroutine jhpcndf_write_fixed_rate_real4
+
+subroutine jhpcndf_write_fixed_rate_real8(unit, recl, data, rate)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(8)           :: data(:)
+integer(4)        :: rate
+call jhpcndf_write_fixed_rate_real8_(unit, recl, data, rate)
+end subroutine jhpcndf_write_fixed_rate_real8
+
+subroutine jhpcndf_read_fixed_rate_real4(unit, recl, data)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(4)           :: data(:)
+call jhpcndf_read_fixed_rate_real4_(unit, recl, data)
+end subroutine jhpcndf_read_fixed_rate_real4
+
+subroutine jhpcndf_read_fixed_rate_real8(unit, recl, data)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(8)           :: data(:)
+call jhpcndf_read_fixed_rate_real8_(unit, recl, data)
+end subroutine jhpcndf_read_fixed_rate_real8
+
+subroutine jhpcndf_write_tolerance_field_real4(unit, recl, data, tol, is_rel, enc)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(4)           :: data(:)
+real(4)           :: tol(:)
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_tolerance_field_real4_(unit, recl, data, tol, is_rel, enc//null)
+end subroutine jhpcndf_write_tolerance_field_real4
+
+subroutine jhpcndf_write_tolerance_field_real8(unit, recl, data, tol, is_rel, enc)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(8)           :: data(:)
+real(4)           :: tol(:)
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_tolerance_field_real8_(unit, recl, data, tol, is_rel, enc//null)
+end subroutine jhpcndf_write_tolerance_field_real8
+
+subroutine jhpcndf_write_subarray_real4(unit, ndims, extents, offsets, counts, strides, data, tol, is_rel, enc)
+implicit none
+integer(4)        :: unit
+integer(4)        :: ndims
+integer(8)        :: extents(:), offsets(:), counts(:), strides(:)
+real(4)           :: data(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_subarray_real4_(unit, ndims, extents, offsets, counts, strides, data, tol, is_rel, enc//null)
+end subroutine jhpcndf_write_subarray_real4
+
+subroutine jhpcndf_write_subarray_real8(unit, ndims, extents, offsets, counts, strides, data, tol, is_rel, enc)
+implicit none
+integer(4)        :: unit
+integer(4)        :: ndims
+integer(8)        :: extents(:), offsets(:), counts(:), strides(:)
+real(8)           :: data(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_subarray_real8_(unit, ndims, extents, offsets, counts, strides, data, tol, is_rel, enc//null)
+end subroutine jhpcndf_write_subarray_real8
+
+subroutine jhpcndf_read_subarray_real4(unit, ndims, extents, offsets, counts, strides, data)
+implicit none
+integer(4)        :: unit
+integer(4)        :: ndims
+integer(8)        :: extents(:), offsets(:), counts(:), strides(:)
+real(4)           :: data(:)
+call jhpcndf_read_subarray_real4_(unit, ndims, extents, offsets, counts, strides, data)
+end subroutine jhpcndf_read_subarray_real4
+
+subroutine jhpcndf_read_subarray_real8(unit, ndims, extents, offsets, counts, strides, data)
+implicit none
+integer(4)        :: unit
+integer(4)        :: ndims
+integer(8)        :: extents(:), offsets(:), counts(:), strides(:)
+real(8)           :: data(:)
+call jhpcndf_read_subarray_real8_(unit, ndims, extents, offsets, counts, strides, data)
+end subroutine jhpcndf_read_subarray_real8
+
+subroutine jhpcndf_write_target_size_real4(unit, recl, data, target, tol_used, is_rel, enc)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(4)           :: data(:)
+integer(8)        :: target
+real(4)           :: tol_used
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_target_size_real4_(unit, recl, data, target, tol_used, is_rel, enc//null)
+end subroutine jhpcndf_write_target_size_real4
+
+subroutine jhpcndf_write_target_size_real8(unit, recl, data, target, tol_used, is_rel, enc)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(8)           :: data(:)
+integer(8)        :: target
+real(4)           :: tol_used
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_target_size_real8_(unit, recl, data, target, tol_used, is_rel, enc//null)
+end subroutine jhpcndf_write_target_size_real8
+
+subroutine jhpcndf_write_target_ratio_real4(unit, recl, data, target, tol_used, is_rel, enc)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(4)           :: data(:)
+real(8)           :: target
+real(4)           :: tol_used
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_target_ratio_real4_(unit, recl, data, target, tol_used, is_rel, enc//null)
+end subroutine jhpcndf_write_target_ratio_real4
+
+subroutine jhpcndf_write_target_ratio_real8(unit, recl, data, target, tol_used, is_rel, enc)
+implicit none
+integer(4)        :: unit
+integer(8)        :: recl
+real(8)           :: data(:)
+real(8)           :: target
+real(4)           :: tol_used
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_target_ratio_real8_(unit, recl, data, target, tol_used, is_rel, enc//null)
+end subroutine jhpcndf_write_target_ratio_real8
+
+subroutine jhpcndf_write_components_real4(unit, ncomp, recl, data, tol, is_rel, enc)
+implicit none
+integer(4)        :: unit
+integer(4)        :: ncomp
+integer(8)        :: recl
+real(4)           :: data(:)
+real(4)           :: tol(:)
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_components_real4_(unit, ncomp, recl, data, tol, is_rel, enc//null)
+end subroutine jhpcndf_write_components_real4
+
+subroutine jhpcndf_write_components_real8(unit, ncomp, recl, data, tol, is_rel, enc)
+implicit none
+integer(4)        :: unit
+integer(4)        :: ncomp
+integer(8)        :: recl
+real(8)           :: data(:)
+real(4)           :: tol(:)
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_write_components_real8_(unit, ncomp, recl, data, tol, is_rel, enc//null)
+end subroutine jhpcndf_write_components_real8
+
+subroutine jhpcndf_read_components_real4(unit, ncomp, recl, data)
+implicit none
+integer(4)        :: unit
+integer(4)        :: ncomp
+integer(8)        :: recl
+real(4)           :: data(:)
+call jhpcndf_read_components_real4_(unit, ncomp, recl, data)
+end subroutine jhpcndf_read_components_real4
+
+subroutine jhpcndf_read_components_real8(unit, ncomp, recl, data)
+implicit none
+integer(4)        :: unit
+integer(4)        :: ncomp
+integer(8)        :: recl
+real(8)           :: data(:)
+call jhpcndf_read_components_real8_(unit, ncomp, recl, data)
+end subroutine jhpcndf_read_components_real8
+
 subroutine jhpcndf_encode_real4(length, src, dst, dst_lower, tol, is_rel, enc)
 implicit none
 integer(8)        :: length
@@ -153,3 +474,176 @@ real(4)           :: src_lower(:)
 real(4)           :: dst(:)
 call jhpcndf_decode_real8_(length, src_upper, src_lower, dst)
 end subroutine jhpcndf_decode_real8
+
+subroutine jhpcndf_compress_bound(nmemb, size, comp, with_lower, bound)
+implicit none
+integer(8)        :: nmemb
+integer(8)        :: size
+character(len=*)  :: comp
+logical           :: with_lower
+integer(8)        :: bound
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_compress_bound_(nmemb, size, comp//null, with_lower, bound)
+end subroutine jhpcndf_compress_bound
+
+subroutine jhpcndf_estimate_size_real4(nmemb, src, tol, is_rel, enc, comp, upper_size, lower_size)
+implicit none
+integer(8)        :: nmemb
+real(4)           :: src(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+integer(8)        :: upper_size
+integer(8)        :: lower_size
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_estimate_size_real4_(nmemb, src, tol, is_rel, enc//null, comp//null, upper_size, lower_size)
+end subroutine jhpcndf_estimate_size_real4
+
+subroutine jhpcndf_estimate_size_real8(nmemb, src, tol, is_rel, enc, comp, upper_size, lower_size)
+implicit none
+integer(8)        :: nmemb
+real(8)           :: src(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+integer(8)        :: upper_size
+integer(8)        :: lower_size
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_estimate_size_real8_(nmemb, src, tol, is_rel, enc//null, comp//null, upper_size, lower_size)
+end subroutine jhpcndf_estimate_size_real8
+
+subroutine jhpcndf_sweep_tolerances_real4(nmemb, src, ntol, tols, is_rel, enc, comp, hist, upper_sizes, lower_sizes)
+implicit none
+integer(8)        :: nmemb
+real(4)           :: src(:)
+integer(8)        :: ntol
+real(4)           :: tols(:)
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+integer(8)        :: hist(:,:)
+integer(8)        :: upper_sizes(:)
+integer(8)        :: lower_sizes(:)
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_sweep_tolerances_real4_(nmemb, src, ntol, tols, is_rel, enc//null, comp//null, hist, upper_sizes, lower_sizes)
+end subroutine jhpcndf_sweep_tolerances_real4
+
+subroutine jhpcndf_sweep_tolerances_real8(nmemb, src, ntol, tols, is_rel, enc, comp, hist, upper_sizes, lower_sizes)
+implicit none
+integer(8)        :: nmemb
+real(8)           :: src(:)
+integer(8)        :: ntol
+real(4)           :: tols(:)
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+integer(8)        :: hist(:,:)
+integer(8)        :: upper_sizes(:)
+integer(8)        :: lower_sizes(:)
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_sweep_tolerances_real8_(nmemb, src, ntol, tols, is_rel, enc//null, comp//null, hist, upper_sizes, lower_sizes)
+end subroutine jhpcndf_sweep_tolerances_real8
+
+subroutine jhpcndf_compress_real4(nmemb, src, capacity, dst, tol, is_rel, enc, comp, with_lower, dst_size)
+implicit none
+integer(8)        :: nmemb
+real(4)           :: src(:)
+integer(8)        :: capacity
+integer(1)        :: dst(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+logical           :: with_lower
+integer(8)        :: dst_size
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_compress_real4_(nmemb, src, capacity, dst, tol, is_rel, enc//null, comp//null, with_lower, dst_size)
+end subroutine jhpcndf_compress_real4
+
+subroutine jhpcndf_compress_real8(nmemb, src, capacity, dst, tol, is_rel, enc, comp, with_lower, dst_size)
+implicit none
+integer(8)        :: nmemb
+real(8)           :: src(:)
+integer(8)        :: capacity
+integer(1)        :: dst(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+logical           :: with_lower
+integer(8)        :: dst_size
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_compress_real8_(nmemb, src, capacity, dst, tol, is_rel, enc//null, comp//null, with_lower, dst_size)
+end subroutine jhpcndf_compress_real8
+
+subroutine jhpcndf_decompress_real4(src_size, src, nmemb, dst, num_elements)
+implicit none
+integer(8)        :: src_size
+integer(1)        :: src(:)
+integer(8)        :: nmemb
+real(4)           :: dst(:)
+integer(8)        :: num_elements
+call jhpcndf_decompress_real4_(src_size, src, nmemb, dst, num_elements)
+end subroutine jhpcndf_decompress_real4
+
+subroutine jhpcndf_decompress_real8(src_size, src, nmemb, dst, num_elements)
+implicit none
+integer(8)        :: src_size
+integer(1)        :: src(:)
+integer(8)        :: nmemb
+real(8)           :: dst(:)
+integer(8)        :: num_elements
+call jhpcndf_decompress_real8_(src_size, src, nmemb, dst, num_elements)
+end subroutine jhpcndf_decompress_real8
+
+subroutine jhpcndf_create_context(context, unit, tol, is_rel, enc, num_threads)
+implicit none
+integer(8)        :: context
+integer(4)        :: unit
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+integer(4)        :: num_threads
+character(len=1), parameter  :: null = char(0)
+call jhpcndf_create_context_(context, unit, tol, is_rel, enc//null, num_threads)
+end subroutine jhpcndf_create_context
+
+subroutine jhpcndf_destroy_context(context)
+implicit none
+integer(8)        :: context
+call jhpcndf_destroy_context_(context)
+end subroutine jhpcndf_destroy_context
+
+subroutine jhpcndf_context_write_real4(context, recl, data)
+implicit none
+integer(8)        :: context
+integer(8)        :: recl
+real(4)           :: data(:)
+call jhpcndf_context_write_real4_(context, recl, data)
+end subroutine jhpcndf_context_write_real4
+
+subroutine jhpcndf_context_write_real8(context, recl, data)
+implicit none
+integer(8)        :: context
+integer(8)        :: recl
+real(8)           :: data(:)
+call jhpcndf_context_write_real8_(context, recl, data)
+end subroutine jhpcndf_context_write_real8
+
+subroutine jhpcndf_context_read_real4(context, recl, data)
+implicit none
+integer(8)        :: context
+integer(8)        :: recl
+real(4)           :: data(:)
+call jhpcndf_context_read_real4_(context, recl, data)
+end subroutine jhpcndf_context_read_real4
+
+subroutine jhpcndf_context_read_real8(context, recl, data)
+implicit none
+integer(8)        :: context
+integer(8)        :: recl
+real(8)           :: data(:)
+call jhpcndf_context_read_real8_(context, recl, data)
+end subroutine jhpcndf_context_read_real8
@@ -13,8 +13,16 @@
 #define FILE_MANAGER_H
 #include <string>
 #include <iostream>
+#include <vector>
+#include <set>
 #include <map>
 #include <stdio.h>
+#include "IO.h"
+#include "ScratchArena.h"
+#include "Mutex.h"
+#include "AsyncFileStream.h"
+#include "Temporal.h"
+#include "Dictionary.h"
 namespace JHPCNDF
 {
   class FileInfo
@@ -25,18 +33,40 @@ namespace JHPCNDF
       FileInfo & operator = (const FileInfo &);
     public:
       FileInfo(const std::string& arg_filename_upper, const std::string& arg_filename_lower, const char* mode, const size_t& arg_buffer_size, const std::string& arg_compression_method)
-        :filename_upper(arg_filename_upper),filename_lower(arg_filename_lower), fp_upper(NULL), fp_lower(NULL), buffer_size(arg_buffer_size), compression_method(arg_compression_method)
+        :filename_upper(arg_filename_upper),filename_lower(arg_filename_lower), fp_upper(NULL), fp_lower(NULL), upper_stream(NULL), lower_stream(NULL), buffer_size(arg_buffer_size), compression_method(arg_compression_method), stream_started(false), io(NULL)
       {
         this->fp_upper=::fopen(filename_upper.c_str(), mode);
         this->filename_upper=filename_upper;
+        if(fp_upper != NULL)
+        {
+          upper_stream=new FileStream(fp_upper);
+        }
         if(filename_lower!="")
         {
           this->fp_lower=::fopen(filename_lower.c_str(), mode);
           this->filename_lower=filename_lower;
+          if(fp_lower != NULL)
+          {
+            lower_stream=new FileStream(fp_lower);
+          }
         }
       }
+
+      //@brief stdio以外の入出力先を使う
+      //@param arg_upper_stream 上位bit側の入出力先
+      //@param arg_lower_stream 下位bit側の入出力先(下位bit側を使わない時はNULL)
+      //@param arg_filename_upper 上位bit側のファイル名(ファイル以外の場合は"")
+      //@param arg_filename_lower 下位bit側のファイル名(ファイル以外の場合は"")
+      //
+      //渡されたStreamはFileInfoが破棄される時にdeleteする
+      FileInfo(Stream* arg_upper_stream, Stream* arg_lower_stream, const size_t& arg_buffer_size, const std::string& arg_compression_method, const std::string& arg_filename_upper="", const std::string& arg_filename_lower="")
+        :fp_upper(NULL), fp_lower(NULL), upper_stream(arg_upper_stream), lower_stream(arg_lower_stream), filename_upper(arg_filename_upper), filename_lower(arg_filename_lower), buffer_size(arg_buffer_size), compression_method(arg_compression_method), stream_started(false), io(NULL)
+      {
+      }
       ~FileInfo()
       {
+        delete upper_stream;
+        delete lower_stream;
         if(fp_upper !=NULL)
         {
           fclose(fp_upper);
@@ -47,27 +77,55 @@ namespace JHPCNDF
           fclose(fp_lower);
           fp_lower=NULL;
         }
+        delete io;
+      }
+
+      //@brief このファイルへの入出力に使うIOクラスのインスタンスを返す
+      //
+      //IOクラスが内部で持つバッファを使い回すため、インスタンスは最初に使われた時に生成し
+      //ファイルが閉じられるまで保持する
+      IO* get_io(void)
+      {
+        if(io == NULL)
+        {
+          io=IOFactory(compression_method, buffer_size);
+        }
+        return io;
       }
       FILE* fp_upper;
       FILE* fp_lower;
+      //入出力先 (fp_upper, fp_lowerを使う場合はそれらを参照するFileStream)
+      Stream* upper_stream;
+      Stream* lower_stream;
       std::string filename_upper;
       std::string filename_lower;
       size_t buffer_size;
       std::string compression_method;
+      ScratchArena arena;
+      //fwrite_temporal/fread_temporalで使う変数名毎の直前のステップの上位bit
+      std::map<std::string, TemporalReference> temporal_references;
+      //set_dictionaryで設定した、またはファイルの先頭から読み込んだプリセット辞書
+      std::vector<unsigned char> upper_dictionary;
+      std::vector<unsigned char> lower_dictionary;
+      //最初のレコード(または辞書レコード)を入出力したかどうか
+      bool stream_started;
+    private:
+      IO* io;
   };
+  //@brief JHPCNDF::fopenで開いたファイルの情報を管理するテーブル
+  //
+  //テーブルへのアクセスは内部でロックしているので、異なるスレッドから
+  //別々のファイルをopen/closeしたり入出力したりすることができる
+  //(同じファイルに対する入出力を複数スレッドから同時に行うことはできない)
   class FileInfoManager
   {
     private:
-    FileInfoManager() 
+    FileInfoManager():next_free_key(FIRST_AUTO_KEY)
     {
     }
     ~FileInfoManager()
     {
-      for(std::map<int, FileInfo*>::iterator it =table.begin(); it!= table.end(); ++it)
-      {
-        delete it->second;
-        table.erase(it);
-      }
+      destroy_all();
     }
     FileInfoManager(const FileInfoManager& obj);
     FileInfoManager& operator=(const FileInfoManager& obj);
@@ -94,23 +152,6 @@ namespace JHPCNDF
     //
     int create_new_entry(const std::string& filename_upper, const std::string& filename_lower="", int key=-1, const char * mode="w+b", const std::string& compression_method="stdio", const size_t& buffer_size=32768)
     {
-      // 名前の重複チェック
-      for(std::map<int, FileInfo*>::iterator it=table.begin(); it!=table.end(); ++it)
-      {
-        if(filename_upper == it->second->filename_upper)
-        {
-          std::cerr << filename_upper <<" is already opend"<<std::endl;
-          return -100;
-        }
-      }
-
-      // keyの重複チェック
-      if(table.find(key)!=table.end())
-      {
-        std::cerr <<"key number "<<key <<" is already opend"<<std::endl;
-        return -200;
-      }
-
       // 名前の有効性チェック
       if(filename_upper.empty())
       {
@@ -143,30 +184,134 @@ namespace JHPCNDF
         return -500;
       }
 
+      key=reserve_entry(filename_upper, key);
+      if(key < 0)
+      {
+        return key;
+      }
+
+      // ファイルのopenには時間がかかることがあるので、ロックの外で行う
       FileInfo* tmp = new FileInfo(filename_upper, filename_lower, mode, buffer_size, compression_method);
+      {
+        ScopedLock lock(mutex);
+        table[key].info=tmp;
+      }
+      return key;
+    }
+
+    //@brief AsyncFileStreamを使って入出力するエントリを追加する
+    //@param filename_upper     上位bit側のデータを出力するファイルの名前
+    //@param filename_lower     下位bit側のデータを出力するファイルの名前(下位bit側のデータを出力しない時は""を指定する
+    //@param mode               ファイルopen時のモード("r", "rb", "w", "wb"のみ)
+    //@param compression_method 圧縮方式の指定
+    //@param buff_size          圧縮時のIOバッファサイズ
+    //@param queue_depth        同時に発行する要求の数
+    //@param block_size         1要求あたりのサイズ
+    //@param direct_io          O_DIRECTを指定して開く
+    //@ret   -100以下           エラーコード (create_new_entryと同じ)
+    //@ret   -1                 ファイルのopenに失敗した
+    //@ret   0以上              作成されたエントリに対応するkey
+    int create_new_async_entry(const std::string& filename_upper, const std::string& filename_lower, const char* mode, const std::string& compression_method, const size_t& buffer_size, const size_t& queue_depth, const size_t& block_size, const bool& direct_io)
+    {
+      // 名前の有効性チェック
+      if(filename_upper.empty())
+      {
+        std::cerr <<"Invalid file name"<<std::endl;
+        return -300;
+      }
+      //
+      if(filename_upper == filename_lower)
+      {
+        std::cerr <<"filename for upper bits and lower bits must be different"<<std::endl;
+        return -400;
+      }
+
+      // modeの正当性チェック (読み込み専用または書き込み専用のみ)
+      std::string str_mode(mode);
+      if (str_mode != "r"  &&
+          str_mode != "rb" &&
+          str_mode != "w"  &&
+          str_mode != "wb")
+      {
+        std::cerr <<"Invalid mode specified"<<std::endl;
+        return -500;
+      }
 
+      int key=reserve_entry(filename_upper, -1);
       if(key < 0)
       {
-        key=100;
-        while(table.find(key) != table.end())
+        return key;
+      }
+
+      const bool for_write = str_mode[0] == 'w';
+      AsyncFileStream* upper_stream=new AsyncFileStream(filename_upper, for_write, queue_depth, block_size, direct_io);
+      AsyncFileStream* lower_stream=NULL;
+      bool is_open=upper_stream->is_open();
+      if(filename_lower != "")
+      {
+        lower_stream=new AsyncFileStream(filename_lower, for_write, queue_depth, block_size, direct_io);
+        is_open = is_open && lower_stream->is_open();
+      }
+      FileInfo* tmp = new FileInfo(upper_stream, lower_stream, buffer_size, compression_method, filename_upper, filename_lower);
+      {
+        ScopedLock lock(mutex);
+        table[key].info=tmp;
+        if(!is_open)
         {
-          key++;
+          release_key(key);
         }
       }
-      table.insert(std::make_pair(key,tmp));
+      if(!is_open)
+      {
+        std::cerr <<"file open failed: "<<filename_upper<<std::endl;
+        delete tmp;
+        return -1;
+      }
+      return key;
+    }
+
+    //@brief ファイル以外の入出力先を使うエントリを追加する
+    //@param upper_stream       上位bit側の入出力先
+    //@param lower_stream       下位bit側の入出力先(下位bit側のデータを入出力しない時はNULL)
+    //@param compression_method 圧縮方式の指定
+    //@param buff_size          圧縮時のIOバッファサイズ
+    //@ret   作成されたエントリに対応するkey
+    //
+    //keyは100以上で空いている値を使う。渡されたStreamはエントリの削除時にdeleteする
+    int create_new_entry(Stream* upper_stream, Stream* lower_stream, const std::string& compression_method, const size_t& buffer_size)
+    {
+      FileInfo* tmp = new FileInfo(upper_stream, lower_stream, buffer_size, compression_method);
+      ScopedLock lock(mutex);
+      int key=next_free_key;
+      while(is_used(key))
+      {
+        key++;
+      }
+      next_free_key=key+1;
+      if((size_t)key >= table.size())
+      {
+        table.resize(key+1);
+      }
+      table[key].used=true;
+      table[key].info=tmp;
       return key;
     }
 
     //@brief 指定されたkeyに対応するエントリをテーブルから削除する
     bool destroy_entry(const int& key)
     {
-      FileInfo* tmp=get_entry(key);
-      if(tmp==NULL)
+      FileInfo* tmp=NULL;
       {
-        return false;
+        ScopedLock lock(mutex);
+        tmp=find(key);
+        if(tmp==NULL)
+        {
+          std::cerr <<"key number "<<key <<" is not found"<<std::endl;
+          return false;
+        }
+        release_key(key);
       }
       delete tmp;
-      table.erase(key);
       return true;
     }
 
@@ -192,13 +337,48 @@ namespace JHPCNDF
       return tmp->fp_lower;
     }
 
+    //@brief 指定されたkeyに対応する上位ビット側の入出力先を返す
+    Stream* get_upper_stream(const int& key)
+    {
+      FileInfo* tmp=get_entry(key);
+      if(tmp==NULL)
+      {
+        return NULL;
+      }
+      return tmp->upper_stream;
+    }
+
+    //@brief 指定されたkeyに対応する下位ビット側の入出力先を返す
+    Stream* get_lower_stream(const int& key)
+    {
+      FileInfo* tmp=get_entry(key);
+      if(tmp==NULL)
+      {
+        return NULL;
+      }
+      return tmp->lower_stream;
+    }
+
     //@brief 登録済の全てのエントリを削除する
     void destroy_all(void)
     {
-      for(std::map<int, FileInfo*>::iterator it =table.begin(); it!= table.end(); ++it)
+      std::vector<FileInfo*> opened;
       {
-        delete it->second;
-        table.erase(it);
+        ScopedLock lock(mutex);
+        for(size_t i=0; i<table.size(); i++)
+        {
+          if(table[i].info != NULL)
+          {
+            opened.push_back(table[i].info);
+          }
+        }
+        table.clear();
+        names.clear();
+        next_free_key=FIRST_AUTO_KEY;
+      }
+      for(size_t i=0; i<opened.size(); i++)
+      {
+        delete opened[i];
       }
     }
 
@@ -214,6 +394,37 @@ namespace JHPCNDF
       return tmp->buffer_size;
     }
 
+    //@brief 指定されたkeyに対応するFileInfoへのポインタを返す
+    //
+    //同じファイルへ繰り返しアクセスする時に、呼び出し毎にテーブルを検索しないために使う
+    //返されたポインタはdestroy_entryが呼ばれるまで有効
+    FileInfo* get_file_info(const int& key)
+    {
+      return get_entry(key);
+    }
+
+    //@brief 指定されたkeyに対応するファイルへの入出力に使うIOクラスを取得する
+    IO* get_io(const int& key)
+    {
+      FileInfo* tmp=get_entry(key);
+      if(tmp==NULL)
+      {
+        return NULL;
+      }
+      return tmp->get_io();
+    }
+
+    //@brief 指定されたkeyに対応するファイル用の作業領域を取得する
+    ScratchArena* get_scratch_arena(const int& key)
+    {
+      FileInfo* tmp=get_entry(key);
+      if(tmp==NULL)
+      {
+        return NULL;
+      }
+      return &(tmp->arena);
+    }
+
     //@ brief 指定されたkeyに対応するファイルへの圧縮方式を取得する
     const std::string get_compression_method(const int& key)
     {
@@ -233,15 +444,94 @@ namespace JHPCNDF
     //NULLを返す（呼び出し側でNULLかどうかのチェックをすること）
     FileInfo* get_entry(const int& key)
     {
-      std::map<int, FileInfo*>::iterator it=table.find(key);
-      if(it==table.end())
+      FileInfo* tmp=NULL;
+      {
+        ScopedLock lock(mutex);
+        tmp=find(key);
+      }
+      if(tmp==NULL)
       {
         std::cerr <<"key number "<<key <<" is not found"<<std::endl;
+      }
+      return tmp;
+    }
+
+    //@brief 名前とkeyの重複チェックをしてエントリを予約する
+    //@ret   予約したkey (重複していた場合はエラーコード)
+    int reserve_entry(const std::string& filename_upper, int key)
+    {
+      ScopedLock lock(mutex);
+      if(names.find(filename_upper) != names.end())
+      {
+        std::cerr << filename_upper <<" is already opend"<<std::endl;
+        return -100;
+      }
+      if(key >= 0 && is_used(key))
+      {
+        std::cerr <<"key number "<<key <<" is already opend"<<std::endl;
+        return -200;
+      }
+      if(key < 0)
+      {
+        key=next_free_key;
+        while(is_used(key))
+        {
+          key++;
+        }
+        next_free_key=key+1;
+      }
+      if((size_t)key >= table.size())
+      {
+        table.resize(key+1);
+      }
+      table[key].used=true;
+      table[key].info=NULL;
+      names.insert(filename_upper);
+      return key;
+    }
+
+    //以下のルーチンはmutexを取得した状態で呼び出すこと
+    bool is_used(const int& key) const
+    {
+      return key >= 0 && (size_t)key < table.size() && table[key].used;
+    }
+    FileInfo* find(const int& key) const
+    {
+      if(key < 0 || (size_t)key >= table.size())
+      {
         return NULL;
       }
-      return it->second;
+      return table[key].info;
     }
-    std::map<int, FileInfo*> table;
+    void release_key(const int& key)
+    {
+      if(!table[key].info->filename_upper.empty())
+      {
+        names.erase(table[key].info->filename_upper);
+      }
+      table[key].used=false;
+      table[key].info=NULL;
+      if(key >= FIRST_AUTO_KEY && key < next_free_key)
+      {
+        next_free_key=key;
+      }
+    }
+
+    struct Entry
+    {
+      Entry():info(NULL), used(false){}
+      FileInfo* info;
+      bool used; // open処理中のエントリはinfo==NULLかつused==trueとなる
+    };
+    static const int FIRST_AUTO_KEY=100;
+
+    //keyをindexとして直接参照するテーブル
+    std::vector<Entry> table;
+    //openされているファイル名(上位bit側)
+    std::set<std::string> names;
+    //自動でkeyを割り当てる時に探索を開始する値
+    int next_free_key;
+    Mutex mutex;
   };
 }//end of namespace JHPCNDF
 #endif
@@ -0,0 +1,226 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file FixedRate.h
+
+#ifndef JHPCNDF_FIXED_RATE_H
+#define JHPCNDF_FIXED_RATE_H
+#include <string.h>
+#include <stdint.h>
+#include <cmath>
+
+//
+//固定レートモードのデータ形式
+//
+//元データを先頭からBLOCK_VALUES(64)要素ずつのブロックに分け、各ブロックを8*rate byteに符号化して並べる
+//最後のブロックが64要素に満たない場合も同じサイズで出力するので、符号化後のサイズとブロックの位置は
+//要素数とrateだけから決まる
+//
+//ブロックの形式 (先頭byteの最下位bitから順に詰める)
+//  共通指数     (16 bit, 符号付き ブロック内の有限値の絶対値が全て2^指数未満)
+//  各要素の仮数 (2の補数 要素あたり(64*rate-16)/64 bit 割り切れない分は先頭の要素に1bitずつ追加する)
+//
+//JHPCNDF::fwrite_fixed_rateが出力するレコードの形式
+//
+//上位bit側ファイル
+//  FixedRateRecordHeader  (24 byte, 無圧縮)
+//  符号化済データ         (FixedRate::compressed_size(num_elements, rate) byte, 無圧縮)
+//下位bit側ファイル
+//  圧縮済下位bitデータ    (元データと上位bit側から再構成した値のXOR)
+//
+//ヘッダの数値は出力した環境のバイトオーダーで格納する
+//
+namespace JHPCNDF
+{
+  struct FixedRateRecordHeader
+  {
+    char     magic[4];        // "JHFR"
+    uint8_t  version;
+    uint8_t  element_size;    // 1要素のサイズ(float=4, double=8)
+    uint8_t  rate;            // 1要素あたりのbit数
+    uint8_t  reserved[9];
+    uint64_t num_elements;
+  };
+
+  namespace FixedRate
+  {
+    const uint8_t VERSION=1;
+    const size_t BLOCK_VALUES=64;
+    const unsigned int EXPONENT_BITS=16;
+    //@brief 全要素が0か有限でない値のブロックを表す共通指数
+    const int16_t EMPTY_EXPONENT=-32768;
+    const unsigned int MIN_RATE=2;
+    //@brief 1要素に割り当てる仮数の最大bit数
+    const unsigned int MAX_MANTISSA_BITS=62;
+
+    inline const char* magic(void)
+    {
+      return "JHFR";
+    }
+
+    inline void init_header(FixedRateRecordHeader* header, const uint8_t& element_size, const uint8_t& rate, const uint64_t& num_elements)
+    {
+      memset(header, 0, sizeof(FixedRateRecordHeader));
+      memcpy(header->magic, magic(), 4);
+      header->version=VERSION;
+      header->element_size=element_size;
+      header->rate=rate;
+      header->num_elements=num_elements;
+    }
+
+    inline bool is_valid_header(const FixedRateRecordHeader& header)
+    {
+      return memcmp(header.magic, magic(), 4) == 0 && header.version == VERSION;
+    }
+
+    //@brief T型に対して指定できるrateかどうか
+    template <typename T>
+    inline bool is_valid_rate(const unsigned int& rate)
+    {
+      return MIN_RATE <= rate && rate <= 8*sizeof(T);
+    }
+
+    inline size_t block_bytes(const unsigned int& rate)
+    {
+      return BLOCK_VALUES*rate/8;
+    }
+
+    inline size_t num_blocks(const size_t& nmemb)
+    {
+      return (nmemb+BLOCK_VALUES-1)/BLOCK_VALUES;
+    }
+
+    inline size_t compressed_size(const size_t& nmemb, const unsigned int& rate)
+    {
+      return num_blocks(nmemb)*block_bytes(rate);
+    }
+
+    //@brief ブロック内のn番目の要素に割り当てる仮数のbit数
+    inline unsigned int mantissa_bits(const unsigned int& rate, const size_t& n)
+    {
+      const size_t payload=BLOCK_VALUES*rate-EXPONENT_BITS;
+      const size_t bits=payload/BLOCK_VALUES + (n < payload%BLOCK_VALUES ? 1 : 0);
+      return bits < MAX_MANTISSA_BITS ? (unsigned int)bits : MAX_MANTISSA_BITS;
+    }
+
+    //@brief byte列に下位bitから順にbit列を書き込むクラス
+    class BitWriter
+    {
+      public:
+        explicit BitWriter(unsigned char* arg_buffer):buffer(arg_buffer), position(0) {}
+        void write(uint64_t value, unsigned int bits)
+        {
+          while(bits > 0)
+          {
+            const unsigned int offset=position%8;
+            const unsigned int n = 8-offset < bits ? 8-offset : bits;
+            buffer[position/8]|=(unsigned char)((value&((1u<<n)-1))<<offset);
+            value>>=n;
+            bits-=n;
+            position+=n;
+          }
+        }
+      private:
+        unsigned char* buffer;
+        size_t position;
+    };
+
+    //@brief BitWriterで書き込んだbit列を読み込むクラス
+    class BitReader
+    {
+      public:
+        explicit BitReader(const unsigned char* arg_buffer):buffer(arg_buffer), position(0) {}
+        uint64_t read(const unsigned int& bits)
+        {
+          uint64_t value=0;
+          unsigned int done=0;
+          while(done < bits)
+          {
+            const unsigned int offset=position%8;
+            const unsigned int n = 8-offset < bits-done ? 8-offset : bits-done;
+            value|=(uint64_t)((buffer[position/8]>>offset)&((1u<<n)-1))<<done;
+            done+=n;
+            position+=n;
+          }
+          return value;
+        }
+      private:
+        const unsigned char* buffer;
+        size_t position;
+    };
+
+    //@brief count(<=BLOCK_VALUES)要素を1ブロックに符号化する
+    //
+    //有限でない値は0として符号化する
+    template <typename T>
+    void encode_block(const T* const src, const size_t& count, const unsigned int& rate, unsigned char* const dst)
+    {
+      memset(dst, 0, block_bytes(rate));
+      int exponent=EMPTY_EXPONENT;
+      for(size_t n=0; n<count; n++)
+      {
+        const double value=src[n];
+        if(value != 0.0 && value-value == 0.0)
+        {
+          int e;
+          frexp(value, &e);
+          exponent = e > exponent ? e : exponent;
+        }
+      }
+      BitWriter writer(dst);
+      writer.write((uint16_t)(int16_t)exponent, EXPONENT_BITS);
+      if(exponent == EMPTY_EXPONENT)
+      {
+        return;
+      }
+      for(size_t n=0; n<count; n++)
+      {
+        const unsigned int bits=mantissa_bits(rate, n);
+        if(bits == 0)
+        {
+          continue;
+        }
+        const double value=src[n];
+        const int64_t limit=((int64_t)1<<(bits-1))-1;
+        int64_t mantissa=0;
+        if(value-value == 0.0)
+        {
+          const double scaled=std::floor(ldexp(value, (int)bits-1-exponent)+0.5);
+          mantissa = scaled > limit ? limit : (scaled < -limit ? -limit : (int64_t)scaled);
+        }
+        writer.write((uint64_t)mantissa, bits);
+      }
+    }
+
+    //@brief encode_blockで符号化した1ブロックからcount要素を復元する
+    template <typename T>
+    void decode_block(const unsigned char* const src, const size_t& count, const unsigned int& rate, T* const dst)
+    {
+      BitReader reader(src);
+      const int exponent=(int16_t)(uint16_t)reader.read(EXPONENT_BITS);
+      for(size_t n=0; n<count; n++)
+      {
+        const unsigned int bits=mantissa_bits(rate, n);
+        if(exponent == EMPTY_EXPONENT || bits == 0)
+        {
+          dst[n]=0;
+          continue;
+        }
+        uint64_t raw=reader.read(bits);
+        // 符号拡張
+        if(bits < 64 && ((raw>>(bits-1))&1))
+        {
+          raw|=~(uint64_t)0<<bits;
+        }
+        dst[n]=(T)ldexp((double)(int64_t)raw, exponent-((int)bits-1));
+      }
+    }
+  }//end of namespace FixedRate
+}//end of namespace JHPCNDF
+#endif
@@ -29,7 +29,7 @@ namespace JHPCNDF
     //    stdio stdioによる通常のIOを行うクラスを生成
     //    lz4   lz4形式での圧縮伸長を行うIOクラスを生成(USE_LZ4が定義されている時のみ有効
     //@param buff_size  stdio以外のIOクラス内部で使用するバッファサイズ(Byte単位)
-    IO* IOFactory(const std::string& name, const size_t& buff_size)
+    inline IO* IOFactory(const std::string& name, const size_t& buff_size)
     {
         IO* io=NULL;
         if(name.substr(0,4) == "gzip")
@@ -87,5 +87,26 @@ namespace JHPCNDF
         return io;
     };
 
+    //@brief IOFactoryで生成したIOクラスで圧縮した時の出力サイズの上限を返す
+    //@param name          圧縮形式 (IOFactoryの引数と同じ)
+    //@param size_in_byte  圧縮前のデータサイズ(Byte単位)
+    //@param buff_size     IOクラス内部で使用するバッファサイズ(Byte単位)
+    inline size_t IOBound(const std::string& name, const size_t& size_in_byte, const size_t& buff_size)
+    {
+        (void)buff_size; //lz4以外の形式では使わない
+        if(name.substr(0,4) == "gzip")
+        {
+          // compressBound()はzlib形式のヘッダ(6byte)を含むので、gzip形式との差分(12byte)を加える
+          return compressBound(size_in_byte)+12;
+#ifdef USE_LZ4
+        }else if(name.substr(0,3) == "lz4"){
+          // lz4IOはbuff_size毎にLZ4F_compressUpdateを呼ぶ
+          const size_t num_blocks=(size_in_byte+buff_size-1)/buff_size;
+          return (num_blocks+1)*LZ4F_compressBound(buff_size, NULL)+19; // 19: フレームヘッダの最大長
+#endif
+        }
+        return size_in_byte;
+    }
+
 }//end of namespace JHPCNDF
 #endif
@@ -16,7 +16,22 @@
 #include "Encoder.h"
 #include "Decoder.h"
 #include "IO.h"
-#ifdef TIME_MEASURE
+#include "CompressedBuffer.h"
+#include "Temporal.h"
+#include "Lorenzo.h"
+#include "Quantize.h"
+#include "BlockTransform.h"
+#include "FixedRate.h"
+#include "BlockCache.h"
+#include "ChunkLoader.h"
+#include "Subarray.h"
+#include "RateControl.h"
+#include "ToleranceSweep.h"
+#include "EncodeStatistics.h"
+#include <pthread.h>
+#include <deque>
+#include <set>
+#if defined(TIME_MEASURE) || defined(USE_OPENMP)
 #include <omp.h>
 #endif
 
@@ -28,8 +43,38 @@ namespace JHPCNDF
 {
   namespace
   {
+    //@brief スコープ内でOpenMPのスレッド数を一時的に変更するクラス
+    //
+    //num_threadsに0以下の値が指定された時は何もしない
+    class ThreadSetting
+    {
+      public:
+        ThreadSetting(const int& num_threads):org_num_threads(0)
+        {
+#ifdef USE_OPENMP
+          if(num_threads > 0)
+          {
+            org_num_threads=omp_get_max_threads();
+            omp_set_num_threads(num_threads);
+          }
+#endif
+        }
+        ~ThreadSetting()
+        {
+#ifdef USE_OPENMP
+          if(org_num_threads > 0)
+          {
+            omp_set_num_threads(org_num_threads);
+          }
+#endif
+        }
+      private:
+        int org_num_threads;
+    };
+
+    //@param statistics NULL以外が指定された場合は、分割位置のヒストグラムと誤差、エンコードにかかった時間を集計する
     template <typename T>
-      size_t fwrite_helper(const T* data, size_t size, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc, const bool& time_measuring, const bool& byte_swap)
+      void encode_helper(const Encoder<T>& encoder, const size_t& length, const T* const src, T* const dst, T* const dst_lower, const bool time_measuring, const SubarrayLayout* layout=NULL, EncodeStatistics* statistics=NULL)
       {
 #ifdef TIME_MEASURE
         double t0=0.0;
@@ -39,30 +84,102 @@ namespace JHPCNDF
           t0=omp_get_wtime();
         }
 #endif
-        size_t output_size=0;
-        T* work_upper = NULL;
-        T* work_lower = NULL;
-        try
+        StatisticsCollector<T>* collector=NULL;
+        double start=0.0;
+        if(statistics != NULL)
+        {
+          collector=new StatisticsCollector<T>(ToleranceSweep::fraction_length<T>()+1, length, dst);
+          encoder.set_statistics(collector);
+          start=wall_time();
+        }
+        if(layout != NULL)
+        {
+          encoder.encode_subarray(*layout, src, dst, dst_lower);
+        }else{
+          encoder(length, src, dst, dst_lower);
+        }
+#ifdef TIME_MEASURE
+        if(time_measuring)
+        {
+          t1=omp_get_wtime()-t0;
+          std::cerr<<"elapsed time for encode: "<<t1<<" sec"<<std::endl;
+        }
+#endif
+        if(statistics != NULL)
+        {
+          statistics->encode_time=wall_time()-start;
+          encoder.set_statistics(NULL);
+          double sum_squared_error=0.0;
+          collector->summarize(src, layout, &(statistics->histogram), &(statistics->max_error), &sum_squared_error);
+          delete collector;
+          statistics->num_elements=length;
+          statistics->num_full_mantissa=statistics->histogram.empty() ? 0 : statistics->histogram[0];
+          statistics->rms_error = length > 0 ? std::sqrt(sum_squared_error/length) : 0.0;
+          statistics->upper_bytes_in=sizeof(T)*length;
+          statistics->upper_bytes_out=statistics->upper_bytes_in;
+          statistics->lower_bytes_in = dst_lower != NULL ? sizeof(T)*length : 0;
+          statistics->lower_bytes_out=statistics->lower_bytes_in;
+        }
+      }
+
+    //@brief IOクラスにプリセット辞書を設定する (辞書が空の時は辞書を使わない)
+    void use_dictionary(IO* io, const std::vector<unsigned char>& dictionary)
+    {
+      io->set_dictionary(dictionary.empty() ? NULL : &(dictionary[0]), dictionary.size());
+    }
+
+    //@brief ファイルから最初に読み込む前に、先頭にある辞書レコードを読み込む
+    //@ret   辞書レコードが不正だった場合はfalse
+    bool begin_read(FileInfo* info)
+    {
+      if(info->stream_started)
+      {
+        return true;
+      }
+      info->stream_started=true;
+      if(!Dictionary::read(info->upper_stream, &(info->upper_dictionary)) ||
+         (info->lower_stream != NULL && !Dictionary::read(info->lower_stream, &(info->lower_dictionary))))
+      {
+        std::cerr<<"invalid dictionary record"<<std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    //@brief エンコードしたデータをファイルに出力する
+    //@param reference   NULL以外が指定された場合は、上位bitをreferenceとのXORに置き換えてレコードヘッダと共に出力する
+    //@param is_keyframe referenceを指定した時に、このレコードをキーフレームとして出力するかどうか
+    //@param layout      NULL以外が指定された場合は、dataのうちlayoutで指定した部分領域(nmemb要素)を出力する
+    //@param statistics  NULL以外が指定された場合は、エンコードの統計情報に加えてストリーム毎の出力サイズと時間を集計する
+    template <typename T>
+      size_t fwrite_helper(const T* data, size_t size, size_t nmemb, FileInfo* info, const Encoder<T>& encoder, const bool& time_measuring, const bool& byte_swap, TemporalReference* reference=NULL, const bool& is_keyframe=true, const SubarrayLayout* layout=NULL, EncodeStatistics* statistics=NULL)
+      {
+#ifdef TIME_MEASURE
+        double t0=0.0;
+        double t1=0.0;
+        if(time_measuring)
         {
-          work_upper = new T[nmemb];
+          t0=omp_get_wtime();
         }
-        catch (std::bad_alloc)
+#endif
+        size_t output_size=0;
+        ScratchArena* arena=&(info->arena);
+        T* work_upper = static_cast<T*>(arena->get(ScratchArena::UPPER, sizeof(T)*nmemb));
+        if(work_upper == NULL)
         {
           std::cerr<<"can't allocate working memory for encode"<<std::endl;
           return 0;
         }
 
-        FILE* fp_lower= FileInfoManager::GetInstance().get_lower_file_pointer(key);
-        if(fp_lower != NULL)
+        T* work_lower = NULL;
+        Stream* lower_stream= info->lower_stream;
+        if(lower_stream != NULL)
         {
-          try
-          {
-            work_lower = new T[nmemb];
-          }
-          catch (std::bad_alloc)
+          work_lower = static_cast<T*>(arena->get(ScratchArena::LOWER, sizeof(T)*nmemb));
+          if(work_lower == NULL)
           {
             std::cerr<<"can't allocate working memory for encode"<<std::endl;
-            delete [] work_upper;
+            arena->trim();
             return 0;
           }
         }
@@ -75,22 +192,59 @@ namespace JHPCNDF
           t0=omp_get_wtime();
         }
 #endif
-        // encode関数内部で計時しているので、この部分は計時しない
-        encode<T>(nmemb, data, work_upper, work_lower, tolerance, is_relative, enc, time_measuring);
+        // encode_helper内部で計時しているので、この部分は計時しない
+        encode_helper<T>(encoder, nmemb, data, work_upper, work_lower, time_measuring, layout, statistics);
 #ifdef TIME_MEASURE
         if(time_measuring)
         {
           t0=omp_get_wtime();
         }
 #endif
-        FILE* fp_upper = FileInfoManager::GetInstance().get_upper_file_pointer(key);
-        if(byte_swap)
+        double start = statistics != NULL ? wall_time() : 0.0;
+        info->stream_started=true;
+        if(reference != NULL)
+        {
+          TemporalRecordHeader header;
+          Temporal::init_header(&header, sizeof(T), nmemb, is_keyframe);
+          if(info->upper_stream->write(&header, sizeof(header)) != sizeof(header))
+          {
+            std::cerr<<"file output failed! "<<std::endl;
+            arena->trim();
+            return 0;
+          }
+          if(is_keyframe)
+          {
+            reference->set_keyframe(work_upper, nmemb);
+          }else{
+            reference->to_residual(work_upper, nmemb);
+          }
+        }
+        IO* io=info->get_io();
+        // quantizeエンコーダの上位bit側は、IOクラスで圧縮する代わりにビン番号をエントロピー符号化して出力する
+        const QuantizeEncoder<T>* quantizer = reference == NULL ? dynamic_cast<const QuantizeEncoder<T>*>(&encoder) : NULL;
+        if(quantizer != NULL)
+        {
+          output_size=Quantize::write_record(info->upper_stream, work_upper, nmemb, layout != NULL ? quantizer->step(*layout, data) : quantizer->step(nmemb, data));
+          if(output_size == 0)
+          {
+            std::cerr<<"file output failed! "<<std::endl;
+            arena->trim();
+            return 0;
+          }
+        }else{
+          if(byte_swap)
+          {
+            convert_endian<sizeof(T)>((char*)work_upper, nmemb);
+          }
+          use_dictionary(io, info->upper_dictionary);
+          output_size=io->fwrite(work_upper, size, nmemb, info->upper_stream);
+        }
+        if(statistics != NULL)
         {
-          convert_endian<sizeof(T)>((char*)work_upper, nmemb);
+          statistics->upper_bytes_out=output_size;
+          statistics->upper_output_time=wall_time()-start;
+          start=wall_time();
         }
-        FileInfoManager& FIM=FileInfoManager::GetInstance();
-        IO* io=IOFactory(FIM.get_compression_method(key), FIM.get_buff_size(key));
-        output_size=io->fwrite(work_upper, size, nmemb, fp_upper);
 #ifdef TIME_MEASURE
         if(time_measuring)
         {
@@ -99,13 +253,19 @@ namespace JHPCNDF
           t0=omp_get_wtime();
         }
 #endif
-        if(fp_lower != NULL)
+        if(lower_stream != NULL)
         {
           if(byte_swap)
           {
             convert_endian<sizeof(T)>((char*)work_lower, nmemb);
           }
-          io->fwrite(work_lower, size, nmemb, fp_lower);
+          use_dictionary(io, info->lower_dictionary);
+          const size_t lower_size=io->fwrite(work_lower, size, nmemb, lower_stream);
+          if(statistics != NULL)
+          {
+            statistics->lower_bytes_out=lower_size;
+            statistics->lower_output_time=wall_time()-start;
+          }
 #ifdef TIME_MEASURE
           if(time_measuring)
           {
@@ -114,81 +274,250 @@ namespace JHPCNDF
           }
 #endif
         }
-        delete [] work_lower;
-        delete [] work_upper;
-        delete io;
+        io->set_dictionary(NULL, 0);
+        arena->trim();
         return output_size;
       }
 
+    //@brief ファイルからデータを読み込んでデコードする
+    //@param reference NULL以外が指定された場合は、fwrite_helperでreferenceを指定して出力したレコードとして読み込む
+    //@param layout    NULL以外が指定された場合は、読み込んだsize要素をdataのうちlayoutで指定した部分領域へ書き戻す
     template <typename T>
-      size_t fread_helper(T *data, size_t size, const int& key, const bool& byte_swap)
+      size_t fread_helper(T *data, size_t size, FileInfo* info, const bool& byte_swap, TemporalReference* reference=NULL, const SubarrayLayout* layout=NULL)
       {
-        FileInfoManager& FIM=FileInfoManager::GetInstance();
-        IO* io=IOFactory(FIM.get_compression_method(key), FileInfoManager::GetInstance().get_buff_size(key));
-        FILE* fp_upper = FileInfoManager::GetInstance().get_upper_file_pointer(key);
-        size_t read_size=io->fread(data, sizeof(T), size, fp_upper);
-
-        FILE* fp_lower= FileInfoManager::GetInstance().get_lower_file_pointer(key);
-        if(fp_lower!=NULL)
+        if(!begin_read(info))
         {
-          T* work;
-          T* lower;
-          try
+          return 0;
+        }
+        bool is_keyframe=true;
+        if(reference != NULL)
+        {
+          TemporalRecordHeader header;
+          if(info->upper_stream->read(&header, sizeof(header)) != sizeof(header) || !Temporal::is_valid_header(header))
+          {
+            std::cerr<<"invalid temporal record header"<<std::endl;
+            return 0;
+          }
+          is_keyframe = (header.flags & Temporal::KEYFRAME) != 0;
+          if(header.element_size != sizeof(T) || header.num_elements != size || (!is_keyframe && !reference->has_reference(sizeof(T), size)))
           {
-            work=new T [size];
+            std::cerr<<"temporal record does not match the requested type, size or reference"<<std::endl;
+            return 0;
           }
-          catch (std::bad_alloc)
+        }
+        // 部分領域へ書き戻す場合は、連続領域に読み込んでデコードしてから書き戻す
+        ScratchArena* arena=&(info->arena);
+        T* upper=data;
+        if(layout != NULL)
+        {
+          upper=static_cast<T*>(arena->get(ScratchArena::UPPER, sizeof(T)*size));
+          if(upper == NULL)
           {
             std::cerr<<"can't allocate working memory for decode"<<std::endl;
-            return read_size;
+            return 0;
           }
-          try
+        }
+        IO* io=info->get_io();
+        size_t read_size=0;
+        if(reference == NULL && Quantize::is_record<T>(info->upper_stream, size))
+        {
+          if(!Quantize::read_record(info->upper_stream, upper, size))
           {
-            lower=new T [size];
+            std::cerr<<"invalid quantized record"<<std::endl;
+            arena->trim();
+            return 0;
           }
-          catch (std::bad_alloc)
+          read_size=sizeof(T)*size;
+          // 量子化レコードは出力した環境のバイトオーダーで格納されているので、下位bit側のバイトオーダーに合わせる
+          if(byte_swap)
           {
-            std::cerr<<"can't allocate working memory for decode"<<std::endl;
-            delete lower;
-            return read_size;
+            convert_endian<sizeof(T)>((char*)upper, size);
           }
-          io->fread(lower, sizeof(T), size, fp_lower);
-          decode<T>(size, data, lower, work);
-          delete lower;
-          for(size_t i=0;i<size;i++)
+        }else{
+          use_dictionary(io, info->upper_dictionary);
+          read_size=io->fread(upper, sizeof(T), size, info->upper_stream);
+        }
+        if(reference != NULL)
+        {
+          if(is_keyframe)
           {
-            data[i]=work[i];
+            reference->set_keyframe(upper, size);
+          }else{
+            reference->from_residual(upper, size);
           }
-          delete work;
         }
-        delete io;
+
+        Stream* lower_stream= info->lower_stream;
+        if(lower_stream!=NULL)
+        {
+          T* lower = static_cast<T*>(arena->get(ScratchArena::LOWER, sizeof(T)*size));
+          if(lower == NULL)
+          {
+            std::cerr<<"can't allocate working memory for decode"<<std::endl;
+            return read_size;
+          }
+          use_dictionary(io, info->lower_dictionary);
+          io->fread(lower, sizeof(T), size, lower_stream);
+          // Decoderは要素毎に処理するので、上位bit側の領域へ直接書き戻す
+          decode<T>(size, upper, lower, upper);
+        }
+        io->set_dictionary(NULL, 0);
         if(byte_swap)
         {
-          convert_endian<sizeof(T)>((char*)data, size);
+          convert_endian<sizeof(T)>((char*)upper, size);
+        }
+        if(layout != NULL)
+        {
+          layout->scatter(upper, data);
         }
+        arena->trim();
         return read_size;
       }
+
+    template <typename T>
+      size_t fwrite_helper(const T* data, size_t size, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc, const bool& time_measuring, const bool& byte_swap, EncodeStatistics* statistics=NULL)
+      {
+        FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+        if(info == NULL)
+        {
+          return 0;
+        }
+        Encoder<T>* encoder=EncoderFactory<T>(enc, tolerance, is_relative);
+        const size_t output_size=fwrite_helper(data, size, nmemb, info, *encoder, time_measuring, byte_swap, NULL, true, NULL, statistics);
+        delete encoder;
+        return output_size;
+      }
+
+    template <typename T>
+      size_t fread_helper(T *data, size_t size, const int& key, const bool& byte_swap)
+      {
+        FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+        if(info == NULL)
+        {
+          return 0;
+        }
+        return fread_helper(data, size, info, byte_swap);
+      }
+
+    //@brief fwrite_batchでタスク化する前にループ並列でエンコードする配列のサイズ(byte)
+    const size_t BATCH_PARALLEL_ENCODE_SIZE=16*1024*1024;
+
+    //@brief fwrite_batchで1つの出力指定を処理する時の作業領域
+    struct BatchSlot
+    {
+      BatchSlot():encoder(NULL), output_size(0), failed(false) {}
+      void* encoder;                   //Encoder<float>またはEncoder<double>
+      std::vector<char> upper;         //エンコード済の上位bit
+      std::vector<char> lower;         //エンコード済の下位bit
+      MemoryOutputStream upper_output; //圧縮済の上位bit側レコード
+      MemoryOutputStream lower_output; //圧縮済の下位bit側レコード
+      size_t output_size;
+      bool failed;
+    };
+
+    template <typename T>
+      void batch_encode(const WriteRequest& request, BatchSlot* slot, const bool& has_lower)
+      {
+        const size_t nmemb=request.nmemb;
+        slot->upper.resize(sizeof(T)*nmemb);
+        slot->lower.resize(has_lower ? sizeof(T)*nmemb : 0);
+        if(nmemb == 0)
+        {
+          return;
+        }
+        const Encoder<T>* encoder=static_cast<Encoder<T>*>(slot->encoder);
+        (*encoder)(nmemb, static_cast<const T*>(request.ptr), reinterpret_cast<T*>(&(slot->upper[0])), has_lower ? reinterpret_cast<T*>(&(slot->lower[0])) : NULL);
+      }
+
+    //@brief エンコード済のデータを、fwrite_helperと同じ形式のレコードとしてメモリ上に圧縮する
+    template <typename T>
+      void batch_compress(const WriteRequest& request, BatchSlot* slot, IO* io, FileInfo* info)
+      {
+        const size_t nmemb=request.nmemb;
+        const T* upper = slot->upper.empty() ? NULL : reinterpret_cast<const T*>(&(slot->upper[0]));
+        const Encoder<T>* encoder=static_cast<Encoder<T>*>(slot->encoder);
+        const QuantizeEncoder<T>* quantizer=dynamic_cast<const QuantizeEncoder<T>*>(encoder);
+        if(quantizer != NULL)
+        {
+          slot->output_size=Quantize::write_record(&(slot->upper_output), upper, nmemb, quantizer->step(nmemb, static_cast<const T*>(request.ptr)));
+          slot->failed = slot->output_size == 0;
+        }else{
+          use_dictionary(io, info->upper_dictionary);
+          slot->output_size=io->fwrite(upper, sizeof(T), nmemb, &(slot->upper_output));
+        }
+        if(info->lower_stream != NULL)
+        {
+          use_dictionary(io, info->lower_dictionary);
+          io->fwrite(slot->lower.empty() ? NULL : &(slot->lower[0]), sizeof(T), nmemb, &(slot->lower_output));
+        }
+        io->set_dictionary(NULL, 0);
+        std::vector<char>().swap(slot->upper);
+        std::vector<char>().swap(slot->lower);
+      }
   }//end of unnamed namespace
 
   int fopen(const std::string& filename_upper, const std::string& filename_lower, const char* mode, const std::string& comp, const size_t& buff_size)
   {
     return FileInfoManager::GetInstance().create_new_entry(filename_upper, filename_lower, -1, mode, comp, buff_size);
   }
+  int fopen_async(const std::string& filename_upper, const std::string& filename_lower, const char* mode, const std::string& comp, const size_t& buff_size, const size_t& queue_depth, const size_t& block_size, const bool& direct_io)
+  {
+    return FileInfoManager::GetInstance().create_new_async_entry(filename_upper, filename_lower, mode, comp, buff_size, queue_depth, block_size, direct_io);
+  }
+  int fopen_callbacks(const JHPCNDF_Callbacks* upper, const JHPCNDF_Callbacks* lower, const std::string& comp, const size_t& buff_size)
+  {
+    if(upper == NULL)
+    {
+      std::cerr<<"callbacks for upper bits are not specified"<<std::endl;
+      return -1;
+    }
+    Stream* upper_stream=new CallbackStream(upper->write, upper->read, upper->context);
+    Stream* lower_stream= lower != NULL ? new CallbackStream(lower->write, lower->read, lower->context) : NULL;
+    return FileInfoManager::GetInstance().create_new_entry(upper_stream, lower_stream, comp, buff_size);
+  }
   void fclose(const int& key)
   {
     FileInfoManager::GetInstance().destroy_entry(key);
   }
+  void set_scratch_capacity(const int& key, const size_t& size)
+  {
+    ScratchArena* arena=FileInfoManager::GetInstance().get_scratch_arena(key);
+    if(arena != NULL)
+    {
+      arena->set_capacity(size);
+    }
+  }
+  void release_scratch(const int& key)
+  {
+    ScratchArena* arena=FileInfoManager::GetInstance().get_scratch_arena(key);
+    if(arena != NULL)
+    {
+      arena->release();
+    }
+  }
 
   template <typename T>
     size_t fwrite(const T* ptr, size_t size, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc, const bool& time_measuring, const bool& byte_swap)
     {
       FileInfoManager& FIM=FileInfoManager::GetInstance();
-      FILE* fp_upper = FIM.get_upper_file_pointer(key);
+      FileInfo* info=FIM.get_file_info(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      info->stream_started=true;
+      Stream* upper_stream = info->upper_stream;
+      ScratchArena* arena=&(info->arena);
       T* work;
       if(byte_swap)
       {
-        work = new T[nmemb];
-        for(int i =0; i<nmemb; i++)
+        work = static_cast<T*>(arena->get(ScratchArena::WORK, sizeof(T)*nmemb));
+        if(work == NULL)
+        {
+          std::cerr<<"can't allocate working memory for byte swap"<<std::endl;
+          return 0;
+        }
+        for(size_t i =0; i<nmemb; i++)
         {
           work[i]=ptr[i];
         }
@@ -197,15 +526,17 @@ namespace JHPCNDF
         work=const_cast<T *>(ptr);
       }
 
-      IO* io=IOFactory(FIM.get_compression_method(key), FIM.get_buff_size(key));
-      const size_t output_size=io->fwrite(work, size, nmemb, fp_upper);
+      // 任意の型のデータにはプリセット辞書を使わない
+      IO* io=FIM.get_io(key);
+      io->set_dictionary(NULL, 0);
+      const size_t output_size=io->fwrite(work, size, nmemb, upper_stream);
 
-      FILE* fp_lower= FileInfoManager::GetInstance().get_lower_file_pointer(key);
-      if(fp_lower != NULL)
+      Stream* lower_stream= FIM.get_lower_stream(key);
+      if(lower_stream != NULL)
       {
-        io->fwrite(work, size, nmemb, fp_lower);
+        io->fwrite(work, size, nmemb, lower_stream);
       }
-      delete io;
+      arena->trim();
       return output_size;
     }
   template <>
@@ -219,21 +550,35 @@ namespace JHPCNDF
       return fwrite_helper(ptr, size, nmemb, key, tolerance, is_relative, enc, time_measuring, byte_swap);
     }
 
+  template <typename T>
+    size_t fwrite(const T* ptr, size_t size, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc, EncodeStatistics* statistics)
+    {
+      if(statistics != NULL)
+      {
+        statistics->clear();
+      }
+      return fwrite_helper(ptr, size, nmemb, key, tolerance, is_relative, enc, false, false, statistics);
+    }
+
   template <typename T>
     size_t fread(T* ptr, size_t size, size_t nmemb, const int& key, const bool& byte_swap)
     {
       FileInfoManager& FIM=FileInfoManager::GetInstance();
-      //seek位置を保存
-      FILE* fp_upper = FIM.get_upper_file_pointer(key);
-      long org_upper_position=ftell(fp_upper);
+      FileInfo* info=FIM.get_file_info(key);
+      if(info == NULL || !begin_read(info))
+      {
+        return 0;
+      }
+      Stream* upper_stream = info->upper_stream;
 
-      //先頭2byte分を読み込んでヘッダを判定(gzip or not)
-      unsigned char work[2];
-      if(::fread(work, 1, 2, fp_upper)!=2)
+      //先頭2byte分を読み込んでヘッダを判定(gzip or not)した後、読み込み位置を戻す
+      unsigned char work[2]={0, 0};
+      const size_t header_size=upper_stream->read(work, 2);
+      if(header_size!=2)
       {
         std::cerr<<"upper bits file read failed"<<std::endl;
       }
-      fseek(fp_upper, org_upper_position, 0);
+      upper_stream->unread(header_size);
 
       //読み込んだヘッダを元にIOクラスを作成
       IO* io;
@@ -244,7 +589,7 @@ namespace JHPCNDF
         io=IOFactory("stdio", FIM.get_buff_size(key));
       }
 
-      size_t read_size=io->fread(ptr, size, nmemb, fp_upper);
+      size_t read_size=io->fread(ptr, size, nmemb, upper_stream);
       if(byte_swap)
       {
         convert_endian<sizeof(T)>((char*)ptr, size);
@@ -265,88 +610,2118 @@ namespace JHPCNDF
     }
 
   template <typename T>
-    void encode(const size_t& length, const T* const src, T* const dst, T* const dst_lower, const float& tolerance, const bool& is_relative, const std::string& enc, const bool time_measuring)
+    size_t fwrite_temporal(const T* ptr, size_t nmemb, const int& key, const std::string& variable, const float& tolerance, const bool& is_relative, const std::string& enc, const int& keyframe_interval)
     {
-#ifdef TIME_MEASURE
-      double t0=0.0;
-      double t1=0.0;
-      if(time_measuring)
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL)
       {
-        t0=omp_get_wtime();
+        return 0;
       }
-#endif
-      Encoder<T>* tmp=EncoderFactory<T>(enc, tolerance, is_relative);
-      Encoder<T>& encoder = *tmp;
-      encoder(length, src, dst, dst_lower);
-#ifdef TIME_MEASURE
-      if(time_measuring)
+      TemporalReference* reference=&(info->temporal_references[variable]);
+      const bool is_keyframe=reference->needs_keyframe(sizeof(T), nmemb, keyframe_interval);
+      Encoder<T>* encoder=EncoderFactory<T>(enc, tolerance, is_relative);
+      const size_t output_size=fwrite_helper(ptr, sizeof(T), nmemb, info, *encoder, false, false, reference, is_keyframe);
+      delete encoder;
+      return output_size;
+    }
+
+  size_t fwrite_batch(const std::vector<WriteRequest>& requests, const int& key)
+  {
+    FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+    if(info == NULL)
+    {
+      return 0;
+    }
+    for(size_t i=0; i<requests.size(); i++)
+    {
+      if((requests[i].size != sizeof(float) && requests[i].size != sizeof(double)) || (requests[i].ptr == NULL && requests[i].nmemb > 0))
+      {
+        std::cerr<<"invalid write request: "<<i<<std::endl;
+        return 0;
+      }
+    }
+    const bool has_lower = info->lower_stream != NULL;
+    const size_t num_requests=requests.size();
+    BatchSlot* slots=new BatchSlot[num_requests];
+    std::vector<std::pair<size_t, size_t> > order(num_requests);
+    for(size_t i=0; i<num_requests; i++)
+    {
+      const WriteRequest& request=requests[i];
+      if(request.size == sizeof(float))
+      {
+        slots[i].encoder=EncoderFactory<float>(request.enc, request.tolerance, request.is_relative);
+      }else{
+        slots[i].encoder=EncoderFactory<double>(request.enc, request.tolerance, request.is_relative);
+      }
+      order[i]=std::make_pair(request.size*request.nmemb, i);
+    }
+    //大きい配列から順にタスクを生成して負荷を均等にする
+    std::sort(order.rbegin(), order.rend());
+
+    //大きな配列はエンコーダ内部のループ並列で先にエンコードしておく
+    //(タスク内では入れ子の並列領域が1スレッドで実行されるため)
+    for(size_t n=0; n<num_requests && order[n].first >= BATCH_PARALLEL_ENCODE_SIZE; n++)
+    {
+      const size_t i=order[n].second;
+      if(requests[i].size == sizeof(float))
       {
-        t1=omp_get_wtime()-t0;
-        std::cerr<<"elapsed time for encode: "<<t1<<" sec"<<std::endl;
+        batch_encode<float>(requests[i], &(slots[i]), has_lower);
+      }else{
+        batch_encode<double>(requests[i], &(slots[i]), has_lower);
       }
+    }
+
+    //残りのエンコードと全ての圧縮を1つの並列領域内のタスクとして実行する
+#ifdef USE_OPENMP
+    std::vector<IO*> ios(omp_get_max_threads(), NULL);
+#pragma omp parallel
+#pragma omp single
+#else
+    std::vector<IO*> ios(1, NULL);
+#endif
+    {
+      for(size_t n=0; n<num_requests; n++)
+      {
+        const size_t i=order[n].second;
+        const bool encoded = order[n].first >= BATCH_PARALLEL_ENCODE_SIZE;
+#ifdef USE_OPENMP
+#pragma omp task firstprivate(i, encoded)
+#endif
+        {
+#ifdef USE_OPENMP
+          IO*& io=ios[omp_get_thread_num()];
+#else
+          IO*& io=ios[0];
 #endif
-      delete tmp;
+          if(io == NULL)
+          {
+            io=IOFactory(info->compression_method, info->buffer_size);
+          }
+          if(requests[i].size == sizeof(float))
+          {
+            if(!encoded)
+            {
+              batch_encode<float>(requests[i], &(slots[i]), has_lower);
+            }
+            batch_compress<float>(requests[i], &(slots[i]), io, info);
+          }else{
+            if(!encoded)
+            {
+              batch_encode<double>(requests[i], &(slots[i]), has_lower);
+            }
+            batch_compress<double>(requests[i], &(slots[i]), io, info);
+          }
+        }
+      }
+    }
+    for(size_t t=0; t<ios.size(); t++)
+    {
+      delete ios[t];
+    }
+
+    //指定された順にファイルへ出力する
+    bool failed=false;
+    for(size_t i=0; i<num_requests; i++)
+    {
+      failed = failed || slots[i].failed;
+    }
+    size_t output_size=0;
+    if(!failed)
+    {
+      info->stream_started=true;
+      for(size_t i=0; i<num_requests && !failed; i++)
+      {
+        const std::vector<char>& upper=slots[i].upper_output.get_storage();
+        const std::vector<char>& lower=slots[i].lower_output.get_storage();
+        failed = (!upper.empty() && info->upper_stream->write(&(upper[0]), upper.size()) != upper.size()) ||
+                 (has_lower && !lower.empty() && info->lower_stream->write(&(lower[0]), lower.size()) != lower.size());
+        output_size+=slots[i].output_size;
+      }
+    }
+    for(size_t i=0; i<num_requests; i++)
+    {
+      if(requests[i].size == sizeof(float))
+      {
+        delete static_cast<Encoder<float>*>(slots[i].encoder);
+      }else{
+        delete static_cast<Encoder<double>*>(slots[i].encoder);
+      }
     }
+    delete [] slots;
+    if(failed)
+    {
+      std::cerr<<"file output failed! "<<std::endl;
+      return 0;
+    }
+    return output_size;
+  }
+
+  namespace
+  {
+    template <typename T>
+      size_t fwrite_tolerance_helper(const T* ptr, size_t nmemb, const int& key, const ToleranceField& field, const bool& is_relative, const std::string& enc)
+      {
+        FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+        if(info == NULL)
+        {
+          return 0;
+        }
+        // 要素毎の許容誤差を使わないエンコーダには最も厳しい値を渡す
+        Encoder<T>* encoder=EncoderFactory<T>(enc, field.min_value(nmemb), is_relative);
+        encoder->set_tolerance_field(field);
+        const size_t output_size=fwrite_helper(ptr, sizeof(T), nmemb, info, *encoder, false, false);
+        delete encoder;
+        return output_size;
+      }
+  }
 
   template <typename T>
-    void decode(const size_t& length, const T* const src_upper, const T* const src_lower, T* const dst)
+    size_t fwrite_tolerance_field(const T* ptr, size_t nmemb, const int& key, const float* tolerances, const bool& is_relative, const std::string& enc)
     {
-      Decoder<T> decoder;
-      decoder(length, src_upper, src_lower, dst);
+      if(tolerances == NULL && nmemb > 0)
+      {
+        return 0;
+      }
+      ToleranceField field;
+      field.values=tolerances;
+      return fwrite_tolerance_helper(ptr, nmemb, key, field, is_relative, enc);
     }
-}//end of namespace JHPCNDF
 
-//
-// implementation of C Interface routines
-//
-int JHPCNDF_fopen(const char* filename_upper, const char* filename_lower, const char* mode, const char* comp, const size_t buff_size)
-{
-  return JHPCNDF::fopen(filename_upper, filename_lower, mode, comp, buff_size);
-}
-void JHPCNDF_fclose(const int key)
-{
-  JHPCNDF::fclose(key);
-}
+  template <typename T>
+    size_t fwrite_tolerance_mask(const T* ptr, size_t nmemb, const int& key, const unsigned char* mask, const std::vector<float>& table, const bool& is_relative, const std::string& enc)
+    {
+      if(mask == NULL && nmemb > 0)
+      {
+        return 0;
+      }
+      for(size_t i=0; i<nmemb; i++)
+      {
+        if(mask[i] >= table.size())
+        {
+          std::cerr<<"mask value out of range of tolerance table: "<<(int)mask[i]<<std::endl;
+          return 0;
+        }
+      }
+      ToleranceField field;
+      field.mask=mask;
+      field.table = table.empty() ? NULL : &(table[0]);
+      return fwrite_tolerance_helper(ptr, nmemb, key, field, is_relative, enc);
+    }
 
-size_t JHPCNDF_fwrite_float(const float* ptr, size_t size, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc)
-{
+  namespace
+  {
+    SubarrayLayout make_layout(const Subarray& subarray)
+    {
+      const size_t ndims=subarray.extents.size();
+      if(ndims == 0 || subarray.offsets.size() != ndims || subarray.counts.size() != ndims || subarray.strides.size() != ndims)
+      {
+        return SubarrayLayout(0, NULL, NULL, NULL);
+      }
+      return SubarrayLayout(ndims, &(subarray.extents[0]), &(subarray.offsets[0]), &(subarray.counts[0]), &(subarray.strides[0]));
+    }
+  }
+
+  template <typename T>
+    size_t fwrite_subarray(const T* ptr, const Subarray& subarray, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      const SubarrayLayout layout=make_layout(subarray);
+      if(!layout.is_valid())
+      {
+        std::cerr<<"invalid subarray specified"<<std::endl;
+        return 0;
+      }
+      Encoder<T>* encoder=EncoderFactory<T>(enc, tolerance, is_relative);
+      const size_t output_size=fwrite_helper(ptr, sizeof(T), layout.size(), info, *encoder, false, false, NULL, true, &layout);
+      delete encoder;
+      return output_size;
+    }
+
+  template <typename T>
+    size_t fread_subarray(T* ptr, const Subarray& subarray, const int& key)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      const SubarrayLayout layout=make_layout(subarray);
+      if(!layout.is_valid())
+      {
+        std::cerr<<"invalid subarray specified"<<std::endl;
+        return 0;
+      }
+      return fread_helper(ptr, layout.size(), info, false, NULL, &layout);
+    }
+
+  template <typename T>
+    size_t fwrite_target_size(const T* ptr, size_t nmemb, const int& key, const size_t& target_size, float* tolerance_used, const bool& is_relative, const std::string& enc)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      if(enc == "nbit_filter" || enc == "dummy")
+      {
+        std::cerr<<enc<<" encoder can't be used with target size"<<std::endl;
+        return 0;
+      }
+      IO* io=info->get_io();
+      use_dictionary(io, info->upper_dictionary);
+      const float tolerance=SizeEstimator<T>(ptr, nmemb).search_tolerance(enc, is_relative, io, target_size);
+      io->set_dictionary(NULL, 0);
+      if(tolerance_used != NULL)
+      {
+        *tolerance_used=tolerance;
+      }
+      Encoder<T>* encoder=EncoderFactory<T>(enc, tolerance, is_relative);
+      const size_t output_size=fwrite_helper(ptr, sizeof(T), nmemb, info, *encoder, false, false);
+      delete encoder;
+      return output_size;
+    }
+
+  template <typename T>
+    size_t fwrite_target_ratio(const T* ptr, size_t nmemb, const int& key, const double& target_ratio, float* tolerance_used, const bool& is_relative, const std::string& enc)
+    {
+      if(!(target_ratio > 0.0))
+      {
+        std::cerr<<"invalid target ratio: "<<target_ratio<<std::endl;
+        return 0;
+      }
+      return fwrite_target_size(ptr, nmemb, key, (size_t)(sizeof(T)*nmemb/target_ratio), tolerance_used, is_relative, enc);
+    }
+
+  template <typename T>
+    size_t fwrite_components(const T* ptr, const size_t& num_components, size_t nmemb, const int& key, const std::vector<float>& tolerances, const bool& is_relative, const std::string& enc)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      if(num_components == 0 || (tolerances.size() != 1 && tolerances.size() != num_components))
+      {
+        std::cerr<<"number of components and tolerances does not match"<<std::endl;
+        return 0;
+      }
+      // c番目の成分は、配列全体からc番目以降をnum_components要素おきに取り出した部分領域として扱う
+      const size_t extent=num_components*nmemb;
+      size_t output_size=0;
+      for(size_t c=0; c<num_components; c++)
+      {
+        const SubarrayLayout layout(1, &extent, &c, &nmemb, &num_components);
+        Encoder<T>* encoder=EncoderFactory<T>(enc, tolerances[tolerances.size() == 1 ? 0 : c], is_relative);
+        const size_t component_size=fwrite_helper(ptr, sizeof(T), nmemb, info, *encoder, false, false, NULL, true, &layout);
+        delete encoder;
+        if(component_size == 0 && nmemb > 0)
+        {
+          return 0;
+        }
+        output_size+=component_size;
+      }
+      return output_size;
+    }
+
+  template <typename T>
+    size_t fwrite_components(const T* ptr, const size_t& num_components, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc)
+    {
+      return fwrite_components(ptr, num_components, nmemb, key, std::vector<float>(1, tolerance), is_relative, enc);
+    }
+
+  template <typename T>
+    size_t fread_components(T* ptr, const size_t& num_components, size_t nmemb, const int& key)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL || num_components == 0)
+      {
+        return 0;
+      }
+      const size_t extent=num_components*nmemb;
+      size_t read_size=0;
+      for(size_t c=0; c<num_components; c++)
+      {
+        const SubarrayLayout layout(1, &extent, &c, &nmemb, &num_components);
+        read_size+=fread_helper(ptr, nmemb, info, false, NULL, &layout);
+      }
+      return read_size;
+    }
+
+  template <typename T>
+    size_t fwrite_chunked(const T* ptr, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const size_t& chunk_elements, const std::string& enc)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      const bool has_lower = info->lower_stream != NULL;
+      if(info->fp_upper == NULL || (has_lower && info->fp_lower == NULL))
+      {
+        std::cerr<<"chunked records can only be written to files opened by JHPCNDF::fopen"<<std::endl;
+        return 0;
+      }
+      if(chunk_elements == 0)
+      {
+        std::cerr<<"chunk_elements must be positive"<<std::endl;
+        return 0;
+      }
+
+      //エンコード
+      ScratchArena* arena=&(info->arena);
+      T* work_upper=NULL;
+      T* work_lower=NULL;
+      if(nmemb > 0)
+      {
+        work_upper=static_cast<T*>(arena->get(ScratchArena::UPPER, sizeof(T)*nmemb));
+        work_lower = has_lower ? static_cast<T*>(arena->get(ScratchArena::LOWER, sizeof(T)*nmemb)) : NULL;
+        if(work_upper == NULL || (has_lower && work_lower == NULL))
+        {
+          std::cerr<<"can't allocate working memory for encode"<<std::endl;
+          arena->trim();
+          return 0;
+        }
+        Encoder<T>* encoder=EncoderFactory<T>(enc, tolerance, is_relative);
+        (*encoder)(nmemb, ptr, work_upper, work_lower);
+        delete encoder;
+      }
+
+      //チャンク毎に独立して圧縮
+      const size_t num_chunks=(nmemb+chunk_elements-1)/chunk_elements;
+      std::vector<std::vector<char> > upper_chunks(num_chunks);
+      std::vector<std::vector<char> > lower_chunks(has_lower ? num_chunks : 0);
+      int num_errors=0;
+#ifdef USE_OPENMP
+#pragma omp parallel reduction(+:num_errors)
+#endif
+      {
+        IO* io=IOFactory(info->compression_method, info->buffer_size);
+#ifdef USE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for(long i=0; i<(long)num_chunks; i++)
+        {
+          const size_t offset=i*chunk_elements;
+          const size_t length=std::min(chunk_elements, nmemb-offset);
+          if(Container::compress_to_memory(io, work_upper+offset, sizeof(T), length, &(upper_chunks[i])) == 0)
+          {
+            num_errors++;
+          }
+          if(has_lower && Container::compress_to_memory(io, work_lower+offset, sizeof(T), length, &(lower_chunks[i])) == 0)
+          {
+            num_errors++;
+          }
+        }
+        delete io;
+      }
+      arena->trim();
+      if(num_errors > 0)
+      {
+        std::cerr<<"chunk compression failed"<<std::endl;
+        return 0;
+      }
+
+      //ヘッダとインデックスを作成して出力する
+      std::vector<ContainerChunk> index(num_chunks);
+      ContainerHeader header;
+      Container::init_header(&header, sizeof(T));
+      header.num_chunks=num_chunks;
+      header.num_elements=nmemb;
+      header.lower_base = has_lower ? (uint64_t)ftell(info->fp_lower) : 0;
+      for(size_t i=0; i<num_chunks; i++)
+      {
+        index[i].element_offset=i*chunk_elements;
+        index[i].num_elements=std::min(chunk_elements, nmemb-i*chunk_elements);
+        index[i].upper_offset=header.upper_data_size;
+        index[i].upper_size=upper_chunks[i].size();
+        header.upper_data_size+=upper_chunks[i].size();
+        if(has_lower)
+        {
+          index[i].lower_offset=header.lower_data_size;
+          index[i].lower_size=lower_chunks[i].size();
+          header.lower_data_size+=lower_chunks[i].size();
+        }
+      }
+      info->stream_started=true;
+      bool failed = info->upper_stream->write(&header, sizeof(header)) != sizeof(header) ||
+                    (num_chunks > 0 && info->upper_stream->write(&(index[0]), sizeof(ContainerChunk)*num_chunks) != sizeof(ContainerChunk)*num_chunks);
+      for(size_t i=0; i<num_chunks && !failed; i++)
+      {
+        failed = info->upper_stream->write(&(upper_chunks[i][0]), upper_chunks[i].size()) != upper_chunks[i].size() ||
+                 (has_lower && info->lower_stream->write(&(lower_chunks[i][0]), lower_chunks[i].size()) != lower_chunks[i].size());
+      }
+      if(failed)
+      {
+        std::cerr<<"file output failed! "<<std::endl;
+        return 0;
+      }
+      return Container::record_size(header);
+    }
+
+  template <typename T>
+    size_t fread_temporal(T* ptr, size_t nmemb, const int& key, const std::string& variable)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      return fread_helper(ptr, nmemb, info, false, &(info->temporal_references[variable]))/sizeof(T);
+    }
+
+  template <typename T>
+    int set_dictionary(const T* sample, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL || sample == NULL || nmemb == 0)
+      {
+        return -1;
+      }
+      if(info->stream_started)
+      {
+        std::cerr<<"dictionary must be set before the first record is written"<<std::endl;
+        return -2;
+      }
+      if(!info->get_io()->supports_dictionary())
+      {
+        std::cerr<<"compression method "<<info->compression_method<<" does not support preset dictionary"<<std::endl;
+        return -3;
+      }
+      std::vector<T> work_upper(nmemb);
+      std::vector<T> work_lower(info->lower_stream != NULL ? nmemb : 0);
+      encode(nmemb, sample, &(work_upper[0]), info->lower_stream != NULL ? &(work_lower[0]) : NULL, tolerance, is_relative, enc);
+
+      info->stream_started=true;
+      Dictionary::build(&(work_upper[0]), sizeof(T)*nmemb, &(info->upper_dictionary));
+      if(!Dictionary::write(info->upper_stream, info->upper_dictionary))
+      {
+        std::cerr<<"dictionary output failed"<<std::endl;
+        return -4;
+      }
+      if(info->lower_stream != NULL)
+      {
+        Dictionary::build(&(work_lower[0]), sizeof(T)*nmemb, &(info->lower_dictionary));
+        if(!Dictionary::write(info->lower_stream, info->lower_dictionary))
+        {
+          std::cerr<<"dictionary output failed"<<std::endl;
+          return -4;
+        }
+      }
+      return 0;
+    }
+
+  template <typename T>
+    void encode(const size_t& length, const T* const src, T* const dst, T* const dst_lower, const float& tolerance, const bool& is_relative, const std::string& enc, const bool time_measuring)
+    {
+      Encoder<T>* encoder=EncoderFactory<T>(enc, tolerance, is_relative);
+      encode_helper<T>(*encoder, length, src, dst, dst_lower, time_measuring);
+      delete encoder;
+    }
+
+  template <typename T>
+    void encode(const size_t& length, const T* const src, T* const dst, T* const dst_lower, const float& tolerance, const bool& is_relative, const std::string& enc, EncodeStatistics* statistics)
+    {
+      if(statistics != NULL)
+      {
+        statistics->clear();
+      }
+      Encoder<T>* encoder=EncoderFactory<T>(enc, tolerance, is_relative);
+      encode_helper<T>(*encoder, length, src, dst, dst_lower, false, NULL, statistics);
+      delete encoder;
+    }
+
+  template <typename T>
+    void decode(const size_t& length, const T* const src_upper, const T* const src_lower, T* const dst)
+    {
+      Decoder<T> decoder;
+      decoder(length, src_upper, src_lower, dst);
+    }
+
+  template <typename T>
+    void encode_lorenzo(const size_t& nx, const size_t& ny, const size_t& nz, const T* const src, T* const dst, T* const dst_lower, const float& tolerance, const bool& is_relative)
+    {
+      LorenzoEncoder<T> encoder(nx, ny, nz, tolerance, is_relative);
+      encoder(nx*ny*nz, src, dst, dst_lower);
+    }
+
+  template <typename T>
+    void decode_lorenzo(const size_t& nx, const size_t& ny, const size_t& nz, const T* const src_upper, const T* const src_lower, T* const dst)
+    {
+      LorenzoDecoder<T> decoder(nx, ny, nz);
+      decoder(nx*ny*nz, src_upper, src_lower, dst);
+    }
+
+  template <typename T>
+    void encode_block_transform(const size_t& nx, const size_t& ny, const size_t& nz, const T* const src, T* const dst, T* const dst_lower, const float& tolerance, const bool& is_relative)
+    {
+      BlockTransformEncoder<T> encoder(nx, ny, nz, tolerance, is_relative);
+      encoder(nx*ny*nz, src, dst, dst_lower);
+    }
+
+  template <typename T>
+    void decode_block_transform(const size_t& nx, const size_t& ny, const size_t& nz, const T* const src_upper, const T* const src_lower, T* const dst)
+    {
+      BlockTransformDecoder<T> decoder(nx, ny, nz);
+      decoder(nx*ny*nz, src_upper, src_lower, dst);
+    }
+
+  template <typename T>
+    bool decode_transform_block(const size_t& nx, const size_t& ny, const size_t& nz, const size_t& bi, const size_t& bj, const size_t& bk, const T* const src_upper, const T* const src_lower, T* const dst)
+    {
+      if(bi >= BlockTransform::num_blocks(nx) || bj >= BlockTransform::num_blocks(ny) || bk >= BlockTransform::num_blocks(nz))
+      {
+        return false;
+      }
+      BlockTransformDecoder<T> decoder(nx, ny, nz);
+      decoder.decode_block(bi+BlockTransform::num_blocks(nx)*(bj+BlockTransform::num_blocks(ny)*bk), src_upper, src_lower, dst);
+      return true;
+    }
+
+  template <typename T>
+    size_t fwrite_lorenzo(const T* ptr, const size_t& nx, const size_t& ny, const size_t& nz, const int& key, const float& tolerance, const bool& is_relative)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      info->stream_started=true;
+      LorenzoRecordHeader header;
+      Lorenzo::init_header(&header, sizeof(T), nx, ny, nz);
+      if(info->upper_stream->write(&header, sizeof(header)) != sizeof(header))
+      {
+        std::cerr<<"file output failed! "<<std::endl;
+        return 0;
+      }
+      LorenzoEncoder<T> encoder(nx, ny, nz, tolerance, is_relative);
+      return fwrite_helper(ptr, sizeof(T), nx*ny*nz, info, encoder, false, false);
+    }
+
+  //fread_helperとほぼ同じだが、デコードに近傍の値を使うので下位bit側が無い場合もデコードが必要
+  template <typename T>
+    size_t fread_lorenzo(T* ptr, const size_t& nx, const size_t& ny, const size_t& nz, const int& key)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL || !begin_read(info))
+      {
+        return 0;
+      }
+      LorenzoRecordHeader header;
+      if(info->upper_stream->read(&header, sizeof(header)) != sizeof(header) || !Lorenzo::is_valid_header(header))
+      {
+        std::cerr<<"invalid lorenzo record header"<<std::endl;
+        return 0;
+      }
+      if(header.element_size != sizeof(T) || header.nx != nx || header.ny != ny || header.nz != nz)
+      {
+        std::cerr<<"lorenzo record does not match the requested type or dimensions"<<std::endl;
+        return 0;
+      }
+      const size_t nmemb=nx*ny*nz;
+      IO* io=info->get_io();
+      use_dictionary(io, info->upper_dictionary);
+      const size_t read_size=io->fread(ptr, sizeof(T), nmemb, info->upper_stream);
+
+      ScratchArena* arena=&(info->arena);
+      T* lower=NULL;
+      if(info->lower_stream != NULL)
+      {
+        lower = static_cast<T*>(arena->get(ScratchArena::LOWER, sizeof(T)*nmemb));
+        if(lower == NULL)
+        {
+          std::cerr<<"can't allocate working memory for decode"<<std::endl;
+        }else{
+          use_dictionary(io, info->lower_dictionary);
+          io->fread(lower, sizeof(T), nmemb, info->lower_stream);
+        }
+      }
+      io->set_dictionary(NULL, 0);
+      decode_lorenzo(nx, ny, nz, ptr, lower, ptr);
+      arena->trim();
+      return read_size/sizeof(T);
+    }
+
+  size_t fixed_rate_size(const size_t& nmemb, const unsigned int& rate)
+  {
+    if(rate < FixedRate::MIN_RATE || rate > 8*sizeof(double))
+    {
+      return 0;
+    }
+    return FixedRate::compressed_size(nmemb, rate);
+  }
+
+  template <typename T>
+    size_t encode_fixed_rate(const T* src, const size_t& nmemb, const unsigned int& rate, void* dst, T* dst_lower)
+    {
+      if(src == NULL || dst == NULL || !FixedRate::is_valid_rate<T>(rate))
+      {
+        return 0;
+      }
+      unsigned char* const output=static_cast<unsigned char*>(dst);
+      const size_t block_bytes=FixedRate::block_bytes(rate);
+      const long num_blocks=(long)FixedRate::num_blocks(nmemb);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+      for(long b=0; b<num_blocks; b++)
+      {
+        const size_t first=b*FixedRate::BLOCK_VALUES;
+        const size_t count = nmemb-first < FixedRate::BLOCK_VALUES ? nmemb-first : FixedRate::BLOCK_VALUES;
+        FixedRate::encode_block(src+first, count, rate, output+b*block_bytes);
+        if(dst_lower != NULL)
+        {
+          T recon[FixedRate::BLOCK_VALUES];
+          FixedRate::decode_block(output+b*block_bytes, count, rate, recon);
+          for(size_t n=0; n<count; n++)
+          {
+            dst_lower[first+n]=real_xor(src[first+n], recon[n]);
+          }
+        }
+      }
+      return FixedRate::compressed_size(nmemb, rate);
+    }
+
+  template <typename T>
+    size_t decode_fixed_rate_range(const void* src, const size_t& nmemb, const unsigned int& rate, const size_t& first, const size_t& count, const T* src_lower, T* dst)
+    {
+      if(src == NULL || dst == NULL || !FixedRate::is_valid_rate<T>(rate) || first > nmemb || count > nmemb-first)
+      {
+        return 0;
+      }
+      if(count == 0)
+      {
+        return 0;
+      }
+      const unsigned char* const input=static_cast<const unsigned char*>(src);
+      const size_t block_bytes=FixedRate::block_bytes(rate);
+      const long first_block=(long)(first/FixedRate::BLOCK_VALUES);
+      const long last_block=(long)((first+count-1)/FixedRate::BLOCK_VALUES);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+      for(long b=first_block; b<=last_block; b++)
+      {
+        const size_t block_first=b*FixedRate::BLOCK_VALUES;
+        const size_t block_count = nmemb-block_first < FixedRate::BLOCK_VALUES ? nmemb-block_first : FixedRate::BLOCK_VALUES;
+        T recon[FixedRate::BLOCK_VALUES];
+        FixedRate::decode_block(input+b*block_bytes, block_count, rate, recon);
+        const size_t begin = block_first > first ? block_first : first;
+        const size_t end   = block_first+block_count < first+count ? block_first+block_count : first+count;
+        for(size_t i=begin; i<end; i++)
+        {
+          const T value=recon[i-block_first];
+          dst[i-first] = src_lower != NULL ? real_xor(value, src_lower[i]) : value;
+        }
+      }
+      return count;
+    }
+
+  template <typename T>
+    size_t decode_fixed_rate(const void* src, const size_t& nmemb, const unsigned int& rate, const T* src_lower, T* dst)
+    {
+      return decode_fixed_rate_range(src, nmemb, rate, 0, nmemb, src_lower, dst);
+    }
+
+  template <typename T>
+    size_t fwrite_fixed_rate(const T* ptr, size_t nmemb, const int& key, const unsigned int& rate)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      if(!FixedRate::is_valid_rate<T>(rate))
+      {
+        std::cerr<<"invalid rate for fixed-rate mode: "<<rate<<std::endl;
+        return 0;
+      }
+      ScratchArena* arena=&(info->arena);
+      const size_t body_size=FixedRate::compressed_size(nmemb, rate);
+      unsigned char* work_upper = static_cast<unsigned char*>(arena->get(ScratchArena::UPPER, body_size));
+      T* work_lower = info->lower_stream != NULL ? static_cast<T*>(arena->get(ScratchArena::LOWER, sizeof(T)*nmemb)) : NULL;
+      if((body_size > 0 && work_upper == NULL) || (info->lower_stream != NULL && nmemb > 0 && work_lower == NULL))
+      {
+        std::cerr<<"can't allocate working memory for encode"<<std::endl;
+        arena->trim();
+        return 0;
+      }
+      encode_fixed_rate(ptr, nmemb, rate, work_upper, work_lower);
+
+      info->stream_started=true;
+      FixedRateRecordHeader header;
+      FixedRate::init_header(&header, sizeof(T), rate, nmemb);
+      if(info->upper_stream->write(&header, sizeof(header)) != sizeof(header) ||
+         (body_size > 0 && info->upper_stream->write(work_upper, body_size) != body_size))
+      {
+        std::cerr<<"file output failed! "<<std::endl;
+        arena->trim();
+        return 0;
+      }
+      if(info->lower_stream != NULL)
+      {
+        IO* io=info->get_io();
+        use_dictionary(io, info->lower_dictionary);
+        io->fwrite(work_lower, sizeof(T), nmemb, info->lower_stream);
+        io->set_dictionary(NULL, 0);
+      }
+      arena->trim();
+      return sizeof(header)+body_size;
+    }
+
+  template <typename T>
+    size_t fread_fixed_rate(T* ptr, size_t nmemb, const int& key)
+    {
+      FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+      if(info == NULL || !begin_read(info))
+      {
+        return 0;
+      }
+      FixedRateRecordHeader header;
+      if(info->upper_stream->read(&header, sizeof(header)) != sizeof(header) || !FixedRate::is_valid_header(header))
+      {
+        std::cerr<<"invalid fixed-rate record header"<<std::endl;
+        return 0;
+      }
+      if(header.element_size != sizeof(T) || header.num_elements != nmemb || !FixedRate::is_valid_rate<T>(header.rate))
+      {
+        std::cerr<<"fixed-rate record does not match the requested type or size"<<std::endl;
+        return 0;
+      }
+      ScratchArena* arena=&(info->arena);
+      const size_t body_size=FixedRate::compressed_size(nmemb, header.rate);
+      unsigned char* work_upper = static_cast<unsigned char*>(arena->get(ScratchArena::UPPER, body_size));
+      T* lower = info->lower_stream != NULL ? static_cast<T*>(arena->get(ScratchArena::LOWER, sizeof(T)*nmemb)) : NULL;
+      if((body_size > 0 && work_upper == NULL) || (info->lower_stream != NULL && nmemb > 0 && lower == NULL))
+      {
+        std::cerr<<"can't allocate working memory for decode"<<std::endl;
+        arena->trim();
+        return 0;
+      }
+      if(body_size > 0 && info->upper_stream->read(work_upper, body_size) != body_size)
+      {
+        std::cerr<<"upper bits file read failed"<<std::endl;
+        arena->trim();
+        return 0;
+      }
+      if(lower != NULL)
+      {
+        IO* io=info->get_io();
+        use_dictionary(io, info->lower_dictionary);
+        io->fread(lower, sizeof(T), nmemb, info->lower_stream);
+        io->set_dictionary(NULL, 0);
+      }
+      const size_t read_size=decode_fixed_rate(work_upper, nmemb, header.rate, lower, ptr);
+      arena->trim();
+      return read_size;
+    }
+
+  size_t compress_bound(const size_t& nmemb, const size_t& size, const std::string& comp, const bool& with_lower)
+  {
+    const size_t stream_bound=IOBound(comp, nmemb*size, CompressedBuffer::IO_BUFFER_SIZE);
+    return sizeof(CompressedBufferHeader)+(with_lower ? 2*stream_bound : stream_bound);
+  }
+
+  template <typename T>
+    size_t estimate_compressed_size(const T* src, const size_t& nmemb, const float& tolerance, const bool& is_relative, const std::string& enc, const std::string& comp, size_t* lower_size)
+    {
+      if(lower_size != NULL)
+      {
+        *lower_size=0;
+      }
+      if(src == NULL || nmemb == 0)
+      {
+        return 0;
+      }
+      IO* io=IOFactory(comp, CompressedBuffer::IO_BUFFER_SIZE);
+      size_t upper_size=0;
+      SizeEstimator<T>(src, nmemb).estimate(enc, tolerance, is_relative, io, &upper_size, lower_size);
+      delete io;
+      return upper_size;
+    }
+
+  template <typename T>
+    size_t sweep_tolerances(const T* src, const size_t& nmemb, const std::vector<float>& tolerances, std::vector<ToleranceSweepResult>* results, const bool& is_relative, const std::string& enc, const std::string& comp)
+    {
+      results->clear();
+      if(src == NULL || nmemb == 0 || tolerances.empty())
+      {
+        return 0;
+      }
+      if(enc == "nbit_filter" || enc == "dummy")
+      {
+        std::cerr<<enc<<" encoder can't be used with tolerance sweep"<<std::endl;
+        return 0;
+      }
+      const size_t num_bins=ToleranceSweep::fraction_length<T>()+1;
+      std::vector<std::vector<size_t> > histograms(tolerances.size(), std::vector<size_t>(num_bins, 0));
+      ToleranceSweep::count_split_positions(nmemb, src, tolerances, is_relative, &histograms);
+
+      IO* io=IOFactory(comp, CompressedBuffer::IO_BUFFER_SIZE);
+      const SizeEstimator<T> estimator(src, nmemb);
+      results->resize(tolerances.size());
+      for(size_t k=0; k<tolerances.size(); k++)
+      {
+        ToleranceSweepResult& result=(*results)[k];
+        result.tolerance=tolerances[k];
+        result.histogram.swap(histograms[k]);
+        double truncated_bits=0.0;
+        for(size_t n=0; n<num_bins; n++)
+        {
+          truncated_bits+=(double)n*result.histogram[n];
+        }
+        result.mean_truncated_bits=truncated_bits/nmemb;
+        estimator.estimate(enc, tolerances[k], is_relative, io, &(result.estimated_upper_size), &(result.estimated_lower_size));
+      }
+      delete io;
+      return results->size();
+    }
+
+  template <typename T>
+    size_t compress(const T* src, const size_t& nmemb, void* dst, const size_t& dst_capacity, const float& tolerance, const bool& is_relative, const std::string& enc, const std::string& comp, const bool& with_lower)
+    {
+      if(dst == NULL || dst_capacity < sizeof(CompressedBufferHeader))
+      {
+        return 0;
+      }
+      std::vector<T> work_upper(nmemb);
+      std::vector<T> work_lower(with_lower ? nmemb : 0);
+      if(nmemb > 0)
+      {
+        encode(nmemb, src, &(work_upper[0]), with_lower ? &(work_lower[0]) : NULL, tolerance, is_relative, enc);
+      }
+
+      //容量が十分にある時は出力先へ直接書き込み、そうでなければ一旦内部の領域へ書き込む
+      char* const body=static_cast<char*>(dst)+sizeof(CompressedBufferHeader);
+      const size_t body_capacity=dst_capacity-sizeof(CompressedBufferHeader);
+      const bool direct = dst_capacity >= compress_bound(nmemb, sizeof(T), comp, with_lower);
+      MemoryOutputStream direct_stream(body, body_capacity);
+      MemoryOutputStream work_stream;
+      MemoryOutputStream* stream = direct ? &direct_stream : &work_stream;
+
+      CompressedBufferHeader header;
+      CompressedBuffer::init_header(&header, sizeof(T));
+      header.codec=CompressedBuffer::codec(comp);
+      header.num_elements=nmemb;
+      IO* io=IOFactory(comp, CompressedBuffer::IO_BUFFER_SIZE);
+      if(nmemb > 0)
+      {
+        io->fwrite(&(work_upper[0]), sizeof(T), nmemb, stream);
+      }
+      header.upper_size=stream->tell();
+      if(with_lower)
+      {
+        header.flags|=CompressedBuffer::HAS_LOWER;
+        if(nmemb > 0)
+        {
+          io->fwrite(&(work_lower[0]), sizeof(T), nmemb, stream);
+        }
+        header.lower_size=stream->tell()-header.upper_size;
+      }
+      delete io;
+
+      const size_t body_size=stream->tell();
+      if(!direct)
+      {
+        if(body_size > body_capacity)
+        {
+          return 0;
+        }
+        if(body_size > 0)
+        {
+          memcpy(body, &(work_stream.get_storage()[0]), body_size);
+        }
+      }
+      memcpy(dst, &header, sizeof(CompressedBufferHeader));
+      return sizeof(CompressedBufferHeader)+body_size;
+    }
+
+  template <typename T>
+    size_t decompress(const void* src, const size_t& src_size, T* dst, const size_t& nmemb)
+    {
+      CompressedBufferHeader header;
+      if(!CompressedBuffer::read_header(src, src_size, &header))
+      {
+        std::cerr<<"invalid compressed buffer"<<std::endl;
+        return 0;
+      }
+      if(header.element_size != sizeof(T) || header.num_elements > nmemb)
+      {
+        std::cerr<<"element size or number of elements mismatch"<<std::endl;
+        return 0;
+      }
+      const size_t num_elements=header.num_elements;
+      if(num_elements == 0)
+      {
+        return 0;
+      }
+      const char* const body=static_cast<const char*>(src)+sizeof(CompressedBufferHeader);
+      IO* io=IOFactory(CompressedBuffer::codec_name(header.codec), CompressedBuffer::IO_BUFFER_SIZE);
+      MemoryInputStream upper_stream(body, header.upper_size);
+      io->fread(dst, sizeof(T), num_elements, &upper_stream);
+      if(header.flags & CompressedBuffer::HAS_LOWER)
+      {
+        std::vector<T> lower(num_elements);
+        MemoryInputStream lower_stream(body+header.upper_size, header.lower_size);
+        io->fread(&(lower[0]), sizeof(T), num_elements, &lower_stream);
+        decode(num_elements, dst, &(lower[0]), dst);
+      }
+      delete io;
+      return num_elements;
+    }
+
+  size_t get_decompressed_elements(const void* src, const size_t& src_size)
+  {
+    CompressedBufferHeader header;
+    if(!CompressedBuffer::read_header(src, src_size, &header))
+    {
+      return 0;
+    }
+    return header.num_elements;
+  }
+
+  //
+  // implementation of Context
+  //
+  class Context::Impl
+  {
+    public:
+      Impl(const int& key, const float& tolerance, const bool& is_relative, const std::string& enc, const int& arg_num_threads, const bool& arg_byte_swap)
+        :info(NULL), num_threads(arg_num_threads), byte_swap(arg_byte_swap)
+      {
+        if(key >= 0)
+        {
+          info=FileInfoManager::GetInstance().get_file_info(key);
+          if(info != NULL)
+          {
+            // IOクラスのインスタンスはここで生成しておく
+            info->get_io();
+          }
+        }
+        encoder_float=EncoderFactory<float>(enc, tolerance, is_relative);
+        encoder_double=EncoderFactory<double>(enc, tolerance, is_relative);
+      }
+      ~Impl()
+      {
+        delete encoder_float;
+        delete encoder_double;
+      }
+      const Encoder<float>&  get_encoder(const float*) const  { return *encoder_float;  }
+      const Encoder<double>& get_encoder(const double*) const { return *encoder_double; }
+
+      FileInfo* info;
+      Encoder<float>*  encoder_float;
+      Encoder<double>* encoder_double;
+      const int  num_threads;
+      const bool byte_swap;
+  };
+
+  Context::Context(const int& key, const float& tolerance, const bool& is_relative, const std::string& enc, const int& num_threads, const bool& byte_swap)
+    :impl(new Impl(key, tolerance, is_relative, enc, num_threads, byte_swap)) {}
+
+  Context::~Context()
+  {
+    delete impl;
+  }
+
+  bool Context::is_valid(void) const
+  {
+    return impl->info != NULL;
+  }
+
+  template <typename T>
+    size_t Context::fwrite(const T* ptr, size_t nmemb)
+    {
+      if(impl->info == NULL)
+      {
+        std::cerr<<"file is not associated with this context"<<std::endl;
+        return 0;
+      }
+      ThreadSetting thread_setting(impl->num_threads);
+      return fwrite_helper(ptr, sizeof(T), nmemb, impl->info, impl->get_encoder(ptr), false, impl->byte_swap);
+    }
+
+  template <typename T>
+    size_t Context::fread(T* ptr, size_t nmemb)
+    {
+      if(impl->info == NULL)
+      {
+        std::cerr<<"file is not associated with this context"<<std::endl;
+        return 0;
+      }
+      ThreadSetting thread_setting(impl->num_threads);
+      return fread_helper(ptr, nmemb, impl->info, impl->byte_swap);
+    }
+
+  template <typename T>
+    void Context::encode(const size_t& length, const T* const src, T* const dst, T* const dst_lower)
+    {
+      ThreadSetting thread_setting(impl->num_threads);
+      encode_helper<T>(impl->get_encoder(src), length, src, dst, dst_lower, false);
+    }
+
+  //
+  // implementation of ReadView
+  //
+  template <typename T>
+  class ReadView<T>::Impl
+  {
+    public:
+      Impl(FileInfo* info, const uint64_t& record_position, const size_t& cache_chunks, const size_t& arg_prefetch_chunks)
+        :loader(info->filename_upper, info->lower_stream != NULL ? info->filename_lower : "", record_position),
+         compression_method(info->compression_method), buffer_size(info->buffer_size), cache(cache_chunks),
+         prefetch_chunks(arg_prefetch_chunks), valid(false), decoded_chunks(0), stopping(false), has_worker(false)
+      {
+        pthread_mutex_init(&mutex, NULL);
+        pthread_cond_init(&cond, NULL);
+        if(!loader.is_valid() || loader.get_header().element_size != sizeof(T))
+        {
+          return;
+        }
+        Workspace* workspace=new Workspace(IOFactory(compression_method, buffer_size));
+        idle_workspaces.push_back(workspace);
+        valid = workspace->io != NULL;
+        if(valid && prefetch_chunks > 0)
+        {
+          has_worker = pthread_create(&worker, NULL, prefetch_main, this) == 0;
+        }
+      }
+
+      ~Impl()
+      {
+        if(has_worker)
+        {
+          pthread_mutex_lock(&mutex);
+          stopping=true;
+          pthread_cond_broadcast(&cond);
+          pthread_mutex_unlock(&mutex);
+          pthread_join(worker, NULL);
+        }
+        for(size_t n=0; n<idle_workspaces.size(); n++)
+        {
+          delete idle_workspaces[n];
+        }
+        pthread_cond_destroy(&cond);
+        pthread_mutex_destroy(&mutex);
+      }
+
+      bool is_valid(void) const
+      {
+        return valid;
+      }
+
+      //@brief i番目のチャンクを含むキャッシュエントリを探し、無ければ読み込む
+      //
+      //mutexをロックした状態で呼ぶこと 返り値のエントリはmutexを解放するまで有効
+      typename BlockCache<T>::Entry* fetch(const size_t& i)
+      {
+        typename BlockCache<T>::Entry* entry=cache.find(i);
+        while(entry == NULL && in_flight.count(i) > 0)
+        {
+          //プリフェッチ中のチャンクは読み込み完了を待つ
+          pthread_cond_wait(&cond, &mutex);
+          entry=cache.find(i);
+        }
+        if(entry == NULL)
+        {
+          std::vector<T> data(loader.get_chunks()[i].num_elements);
+          in_flight.insert(i);
+          //読み込み中はmutexを解放するので、他のスレッドと共有しないIOクラスと作業領域を使う
+          Workspace* workspace=acquire_workspace();
+          pthread_mutex_unlock(&mutex);
+          const bool loaded=loader.load(workspace->io, i, data.empty() ? NULL : &(data[0]), &(workspace->work));
+          pthread_mutex_lock(&mutex);
+          idle_workspaces.push_back(workspace);
+          in_flight.erase(i);
+          pthread_cond_broadcast(&cond);
+          if(!loaded)
+          {
+            return NULL;
+          }
+          entry=insert(i, &data);
+        }
+        request_prefetch(i);
+        return entry;
+      }
+
+      static void* prefetch_main(void* arg)
+      {
+        static_cast<Impl*>(arg)->prefetch_loop();
+        return NULL;
+      }
+
+      ChunkLoader loader;
+      std::string compression_method;
+      size_t buffer_size;
+      BlockCache<T> cache;
+      const size_t prefetch_chunks;
+      bool valid;
+      size_t decoded_chunks;
+      pthread_mutex_t mutex;
+
+    private:
+      //@brief チャンクの読み込みに使うIOクラスと作業領域
+      struct Workspace
+      {
+        explicit Workspace(IO* arg_io):io(arg_io) {}
+        ~Workspace()
+        {
+          delete io;
+        }
+        IO* io;
+        std::vector<char> work;
+        private:
+          Workspace(const Workspace&);
+          Workspace& operator=(const Workspace&);
+      };
+
+      //@brief 使われていない作業領域を取り出す 無ければ新たに生成する (mutexをロックした状態で呼ぶこと)
+      Workspace* acquire_workspace(void)
+      {
+        if(idle_workspaces.empty())
+        {
+          return new Workspace(IOFactory(compression_method, buffer_size));
+        }
+        Workspace* workspace=idle_workspaces.back();
+        idle_workspaces.pop_back();
+        return workspace;
+      }
+
+      //@brief 読み込んだチャンクをキャッシュへ追加する (mutexをロックした状態で呼ぶこと)
+      typename BlockCache<T>::Entry* insert(const size_t& i, std::vector<T>* data)
+      {
+        typename BlockCache<T>::Entry* entry=cache.find(i);
+        if(entry != NULL)
+        {
+          return entry;
+        }
+        if(cache.full())
+        {
+          cache.pop_oldest();
+        }
+        entry=cache.push(i);
+        entry->data.swap(*data);
+        decoded_chunks++;
+        return entry;
+      }
+
+      //@brief i番目のチャンクに続くチャンクをプリフェッチ対象に加える (mutexをロックした状態で呼ぶこと)
+      void request_prefetch(const size_t& i)
+      {
+        if(!has_worker)
+        {
+          return;
+        }
+        const size_t num_chunks=loader.get_chunks().size();
+        bool added=false;
+        for(size_t n=i+1; n<=i+prefetch_chunks && n<num_chunks; n++)
+        {
+          if(in_flight.count(n) == 0 && cache.peek(n) == NULL &&
+             std::find(queue.begin(), queue.end(), n) == queue.end())
+          {
+            queue.push_back(n);
+            added=true;
+          }
+        }
+        if(added)
+        {
+          pthread_cond_broadcast(&cond);
+        }
+      }
+
+      void prefetch_loop(void)
+      {
+        IO* worker_io=IOFactory(compression_method, buffer_size);
+        std::vector<char> worker_work;
+        pthread_mutex_lock(&mutex);
+        while(true)
+        {
+          while(!stopping && queue.empty())
+          {
+            pthread_cond_wait(&cond, &mutex);
+          }
+          if(stopping)
+          {
+            break;
+          }
+          const size_t i=queue.front();
+          queue.pop_front();
+          if(in_flight.count(i) > 0 || cache.peek(i) != NULL)
+          {
+            continue;
+          }
+          in_flight.insert(i);
+          pthread_mutex_unlock(&mutex);
+          std::vector<T> data(loader.get_chunks()[i].num_elements);
+          const bool loaded=loader.load(worker_io, i, data.empty() ? NULL : &(data[0]), &worker_work);
+          pthread_mutex_lock(&mutex);
+          in_flight.erase(i);
+          if(loaded && !stopping)
+          {
+            insert(i, &data);
+          }
+          pthread_cond_broadcast(&cond);
+        }
+        pthread_mutex_unlock(&mutex);
+        delete worker_io;
+      }
+
+      pthread_cond_t cond;
+      std::deque<size_t> queue;
+      std::set<size_t> in_flight;
+      std::vector<Workspace*> idle_workspaces;
+      bool stopping;
+      bool has_worker;
+      pthread_t worker;
+  };
+
+  template <typename T>
+    ReadView<T>::ReadView(const int& key, const size_t& cache_chunks, const size_t& prefetch_chunks)
+    :impl(NULL)
+  {
+    FileInfo* info=FileInfoManager::GetInstance().get_file_info(key);
+    if(info == NULL)
+    {
+      return;
+    }
+    if(info->fp_upper == NULL || (info->lower_stream != NULL && info->fp_lower == NULL))
+    {
+      std::cerr<<"ReadView can only be created for files opened by JHPCNDF::fopen"<<std::endl;
+      return;
+    }
+    if(!begin_read(info))
+    {
+      return;
+    }
+    const long position=ftell(info->fp_upper);
+    if(position < 0)
+    {
+      return;
+    }
+    impl=new Impl(info, position, cache_chunks, prefetch_chunks);
+    if(!impl->is_valid())
+    {
+      delete impl;
+      impl=NULL;
+      return;
+    }
+    //ファイルの読み込み位置を次のレコードへ進める
+    const ContainerHeader& header=impl->loader.get_header();
+    fseek(info->fp_upper, (long)(position+Container::record_size(header)), SEEK_SET);
+    if(info->fp_lower != NULL)
+    {
+      fseek(info->fp_lower, (long)(header.lower_base+header.lower_data_size), SEEK_SET);
+    }
+  }
+  template <typename T>
+    ReadView<T>::~ReadView()
+    {
+      delete impl;
+    }
+  template <typename T>
+    bool ReadView<T>::is_valid(void) const
+    {
+      return impl != NULL;
+    }
+  template <typename T>
+    size_t ReadView<T>::size(void) const
+    {
+      return impl != NULL ? impl->loader.get_header().num_elements : 0;
+    }
+  template <typename T>
+    size_t ReadView<T>::num_chunks(void) const
+    {
+      return impl != NULL ? impl->loader.get_chunks().size() : 0;
+    }
+  template <typename T>
+    size_t ReadView<T>::decoded_chunks(void) const
+    {
+      if(impl == NULL)
+      {
+        return 0;
+      }
+      pthread_mutex_lock(&(impl->mutex));
+      const size_t count=impl->decoded_chunks;
+      pthread_mutex_unlock(&(impl->mutex));
+      return count;
+    }
+  template <typename T>
+    size_t ReadView<T>::read(const size_t& first, const size_t& count, T* dst)
+    {
+      if(impl == NULL || dst == NULL || first > size() || count > size()-first)
+      {
+        return 0;
+      }
+      const std::vector<ContainerChunk>& chunks=impl->loader.get_chunks();
+      size_t begin_chunk=0;
+      size_t end_chunk=0;
+      Container::find_chunks(chunks, first, count, &begin_chunk, &end_chunk);
+      pthread_mutex_lock(&(impl->mutex));
+      for(size_t i=begin_chunk; i<end_chunk; i++)
+      {
+        const typename BlockCache<T>::Entry* entry=impl->fetch(i);
+        if(entry == NULL)
+        {
+          pthread_mutex_unlock(&(impl->mutex));
+          return 0;
+        }
+        const size_t chunk_first=chunks[i].element_offset;
+        const size_t begin=std::max<size_t>(chunk_first, first);
+        const size_t end=std::min<size_t>(chunk_first+chunks[i].num_elements, first+count);
+        std::copy(entry->data.begin()+(begin-chunk_first), entry->data.begin()+(end-chunk_first), dst+(begin-first));
+      }
+      pthread_mutex_unlock(&(impl->mutex));
+      return count;
+    }
+  template <typename T>
+    T ReadView<T>::get(const size_t& index)
+    {
+      T value=T(0);
+      read(index, 1, &value);
+      return value;
+    }
+
+  //
+  // implementation of CompressedArray
+  //
+  template <typename T>
+  class CompressedArray<T>::Impl
+  {
+    public:
+      Impl(const size_t& arg_size, const float& arg_tolerance, const bool& arg_is_relative, const std::string& arg_enc, const std::string& arg_comp, const bool& arg_with_lower, const size_t& arg_block_size, const size_t& cache_blocks)
+        :size(arg_size), block_size(arg_block_size > 0 ? arg_block_size : 1), tolerance(arg_tolerance), is_relative(arg_is_relative),
+         enc(arg_enc), comp(arg_comp), with_lower(arg_with_lower), blocks((size+block_size-1)/block_size), cache(cache_blocks)
+      {}
+
+      size_t block_length(const size_t& block) const
+      {
+        if(block >= blocks.size())
+        {
+          return 0;
+        }
+        return size-block*block_size < block_size ? size-block*block_size : block_size;
+      }
+
+      //@brief BlockCacheから書き戻す時にstoreを呼ぶ
+      struct BlockWriter
+      {
+        explicit BlockWriter(Impl* arg_impl):impl(arg_impl){}
+        bool operator()(const size_t& block, const T* src)
+        {
+          return impl->store(block, src);
+        }
+        Impl* impl;
+      };
+
+      //@brief ブロックを圧縮してblocksに格納する
+      bool store(const size_t& block, const T* src)
+      {
+        const size_t length=block_length(block);
+        std::vector<char> work(compress_bound(length, sizeof(T), comp, with_lower));
+        const size_t compressed=compress(src, length, &(work[0]), work.size(), tolerance, is_relative, enc, comp, with_lower);
+        if(compressed == 0)
+        {
+          std::cerr<<"block compression failed"<<std::endl;
+          return false;
+        }
+        std::vector<char>(work.begin(), work.begin()+compressed).swap(blocks[block]);
+        return true;
+      }
+
+      //@brief blocksから伸長する 一度も書き込んでいないブロックは0で埋める
+      bool load(const size_t& block, T* dst) const
+      {
+        const size_t length=block_length(block);
+        if(blocks[block].empty())
+        {
+          std::fill(dst, dst+length, T(0));
+          return true;
+        }
+        return length == 0 || decompress(&(blocks[block][0]), blocks[block].size(), dst, length) == length;
+      }
+
+      //@brief 指定したブロックのキャッシュエントリを返す 無ければ最も古いエントリを追い出して伸長する
+      //@ret   追い出すエントリの再圧縮や伸長に失敗した場合はNULL
+      typename BlockCache<T>::Entry* fetch(const size_t& block)
+      {
+        typename BlockCache<T>::Entry* entry=cache.find(block);
+        if(entry != NULL)
+        {
+          return entry;
+        }
+        if(cache.full())
+        {
+          //再圧縮に失敗した時は書き込み内容を失わないように追い出さない
+          BlockWriter writer(this);
+          if(!cache.evict_oldest(writer))
+          {
+            return NULL;
+          }
+        }
+        entry=cache.push(block);
+        entry->data.resize(block_length(block));
+        if(!load(block, &(entry->data[0])))
+        {
+          cache.erase(block);
+          return NULL;
+        }
+        return entry;
+      }
+
+      //@brief キャッシュ中の書き換えたブロックを再圧縮する 失敗したブロックは書き換えたままの扱いで残す
+      bool flush(void)
+      {
+        BlockWriter writer(this);
+        return cache.write_back(writer);
+      }
+
+      const size_t size;
+      const size_t block_size;
+      const float tolerance;
+      const bool is_relative;
+      const std::string enc;
+      const std::string comp;
+      const bool with_lower;
+      std::vector<std::vector<char> > blocks;
+      BlockCache<T> cache;
+  };
+
+  template <typename T>
+    CompressedArray<T>::CompressedArray(const size_t& size, const float& tolerance, const bool& is_relative, const std::string& enc, const std::string& comp, const bool& with_lower, const size_t& block_size, const size_t& cache_blocks)
+    :impl(new Impl(size, tolerance, is_relative, enc, comp, with_lower, block_size, cache_blocks))
+  {}
+  template <typename T>
+    CompressedArray<T>::~CompressedArray()
+    {
+      delete impl;
+    }
+  template <typename T>
+    size_t CompressedArray<T>::size(void) const
+    {
+      return impl->size;
+    }
+  template <typename T>
+    size_t CompressedArray<T>::block_size(void) const
+    {
+      return impl->block_size;
+    }
+  template <typename T>
+    size_t CompressedArray<T>::num_blocks(void) const
+    {
+      return impl->blocks.size();
+    }
+  template <typename T>
+    size_t CompressedArray<T>::block_length(const size_t& block) const
+    {
+      return impl->block_length(block);
+    }
+  template <typename T>
+    bool CompressedArray<T>::set_block(const size_t& block, const T* src)
+    {
+      if(block >= impl->blocks.size() || src == NULL)
+      {
+        return false;
+      }
+      impl->cache.erase(block);
+      return impl->store(block, src);
+    }
+  template <typename T>
+    bool CompressedArray<T>::get_block(const size_t& block, T* dst) const
+    {
+      if(block >= impl->blocks.size() || dst == NULL)
+      {
+        return false;
+      }
+      typename BlockCache<T>::Entry* entry=impl->cache.find(block);
+      if(entry != NULL)
+      {
+        std::copy(entry->data.begin(), entry->data.end(), dst);
+        return true;
+      }
+      return impl->load(block, dst);
+    }
+  template <typename T>
+    bool CompressedArray<T>::assign(const T* src)
+    {
+      if(src == NULL)
+      {
+        return false;
+      }
+      impl->cache.clear();
+      bool result=true;
+      for(size_t b=0; b<impl->blocks.size(); b++)
+      {
+        result = impl->store(b, src+b*impl->block_size) && result;
+      }
+      return result;
+    }
+  template <typename T>
+    bool CompressedArray<T>::copy_to(T* dst) const
+    {
+      if(dst == NULL)
+      {
+        return false;
+      }
+      bool result=true;
+      for(size_t b=0; b<impl->blocks.size(); b++)
+      {
+        result = get_block(b, dst+b*impl->block_size) && result;
+      }
+      return result;
+    }
+  template <typename T>
+    T CompressedArray<T>::get(const size_t& index) const
+    {
+      if(index >= impl->size)
+      {
+        return T(0);
+      }
+      const typename BlockCache<T>::Entry* entry=impl->fetch(index/impl->block_size);
+      return entry != NULL ? entry->data[index%impl->block_size] : T(0);
+    }
+  template <typename T>
+    bool CompressedArray<T>::set(const size_t& index, const T& value)
+    {
+      if(index >= impl->size)
+      {
+        return false;
+      }
+      typename BlockCache<T>::Entry* entry=impl->fetch(index/impl->block_size);
+      if(entry == NULL)
+      {
+        return false;
+      }
+      entry->data[index%impl->block_size]=value;
+      entry->dirty=true;
+      return true;
+    }
+  template <typename T>
+    bool CompressedArray<T>::flush(void)
+    {
+      return impl->flush();
+    }
+  template <typename T>
+    size_t CompressedArray<T>::compressed_size(void) const
+    {
+      size_t total=0;
+      for(size_t b=0; b<impl->blocks.size(); b++)
+      {
+        total+=impl->blocks[b].size();
+      }
+      return total;
+    }
+}//end of namespace JHPCNDF
+
+//
+// implementation of C Interface routines
+//
+int JHPCNDF_fopen(const char* filename_upper, const char* filename_lower, const char* mode, const char* comp, const size_t buff_size)
+{
+  return JHPCNDF::fopen(filename_upper, filename_lower, mode, comp, buff_size);
+}
+int JHPCNDF_fopen_async(const char* filename_upper, const char* filename_lower, const char* mode, const char* comp, const size_t buff_size, const size_t queue_depth, const size_t block_size, const int direct_io)
+{
+  return JHPCNDF::fopen_async(filename_upper, filename_lower, mode, comp, buff_size, queue_depth, block_size, direct_io != 0);
+}
+int JHPCNDF_fopen_callbacks(const JHPCNDF_Callbacks* upper, const JHPCNDF_Callbacks* lower, const char* comp, const size_t buff_size)
+{
+  return JHPCNDF::fopen_callbacks(upper, lower, comp, buff_size);
+}
+void JHPCNDF_fclose(const int key)
+{
+  JHPCNDF::fclose(key);
+}
+void JHPCNDF_set_scratch_capacity(const int key, const size_t size)
+{
+  JHPCNDF::set_scratch_capacity(key, size);
+}
+void JHPCNDF_release_scratch(const int key)
+{
+  JHPCNDF::release_scratch(key);
+}
+
+size_t JHPCNDF_fwrite_float(const float* ptr, size_t size, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite(ptr, size, nmemb, key, tolerance, is_relative, enc);
+}
+size_t JHPCNDF_fwrite_double(const double *ptr, size_t size, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc)
+{
   return JHPCNDF::fwrite(ptr, size, nmemb, key, tolerance, is_relative, enc);
 }
-size_t JHPCNDF_fwrite_double(const double *ptr, size_t size, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc)
+namespace
+{
+  template <typename T>
+    size_t fwrite_statistics_helper(const T* ptr, size_t size, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc, JHPCNDF_EncodeStatistics* statistics)
+    {
+      JHPCNDF::EncodeStatistics result;
+      const size_t output_size=JHPCNDF::fwrite(ptr, size, nmemb, key, tolerance, is_relative != 0, enc != NULL ? enc : "binary_search", statistics != NULL ? &result : NULL);
+      if(statistics != NULL)
+      {
+        std::fill(statistics->histogram, statistics->histogram+sizeof(statistics->histogram)/sizeof(size_t), 0);
+        std::copy(result.histogram.begin(), result.histogram.end(), statistics->histogram);
+        statistics->num_bins=result.histogram.size();
+        statistics->num_elements=result.num_elements;
+        statistics->num_full_mantissa=result.num_full_mantissa;
+        statistics->max_error=result.max_error;
+        statistics->rms_error=result.rms_error;
+        statistics->upper_bytes_in=result.upper_bytes_in;
+        statistics->upper_bytes_out=result.upper_bytes_out;
+        statistics->lower_bytes_in=result.lower_bytes_in;
+        statistics->lower_bytes_out=result.lower_bytes_out;
+        statistics->encode_time=result.encode_time;
+        statistics->upper_output_time=result.upper_output_time;
+        statistics->lower_output_time=result.lower_output_time;
+      }
+      return output_size;
+    }
+}
+size_t JHPCNDF_fwrite_statistics_float(const float* ptr, size_t size, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc, JHPCNDF_EncodeStatistics* statistics)
+{
+  return fwrite_statistics_helper(ptr, size, nmemb, key, tolerance, is_relative, enc, statistics);
+}
+size_t JHPCNDF_fwrite_statistics_double(const double* ptr, size_t size, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc, JHPCNDF_EncodeStatistics* statistics)
+{
+  return fwrite_statistics_helper(ptr, size, nmemb, key, tolerance, is_relative, enc, statistics);
+}
+size_t JHPCNDF_fwrite(const void *ptr, size_t size, size_t nmemb, const int key, const char* enc)
+{
+  return JHPCNDF::fwrite((char*)ptr, 1, size*nmemb, key, 0.1, enc);
+}
+size_t JHPCNDF_fread_float(float* ptr, size_t size, size_t nmemb, const int key)
+{
+  return JHPCNDF::fread(ptr, size, nmemb, key);
+}
+size_t JHPCNDF_fread_double(double *ptr, size_t size, size_t nmemb, const int key)
+{
+  return JHPCNDF::fread(ptr, size, nmemb, key);
+}
+size_t JHPCNDF_fread(void *ptr, size_t size, size_t nmemb, const int key)
+{
+  return JHPCNDF::fread((char*)ptr, 1, size*nmemb, key);
+}
+size_t JHPCNDF_fwrite_temporal_float(const float* ptr, size_t nmemb, const int key, const char* variable, const float tolerance, const int is_relative, const char* enc, const int keyframe_interval)
+{
+  return JHPCNDF::fwrite_temporal(ptr, nmemb, key, variable, tolerance, is_relative, enc, keyframe_interval);
+}
+size_t JHPCNDF_fwrite_temporal_double(const double* ptr, size_t nmemb, const int key, const char* variable, const float tolerance, const int is_relative, const char* enc, const int keyframe_interval)
+{
+  return JHPCNDF::fwrite_temporal(ptr, nmemb, key, variable, tolerance, is_relative, enc, keyframe_interval);
+}
+size_t JHPCNDF_fread_temporal_float(float* ptr, size_t nmemb, const int key, const char* variable)
+{
+  return JHPCNDF::fread_temporal(ptr, nmemb, key, variable);
+}
+size_t JHPCNDF_fread_temporal_double(double* ptr, size_t nmemb, const int key, const char* variable)
+{
+  return JHPCNDF::fread_temporal(ptr, nmemb, key, variable);
+}
+int JHPCNDF_set_dictionary_float(const float* sample, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc)
+{
+  return JHPCNDF::set_dictionary(sample, nmemb, key, tolerance, is_relative, enc);
+}
+int JHPCNDF_set_dictionary_double(const double* sample, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc)
+{
+  return JHPCNDF::set_dictionary(sample, nmemb, key, tolerance, is_relative, enc);
+}
+size_t JHPCNDF_fwrite_lorenzo_float(const float* ptr, const size_t nx, const size_t ny, const size_t nz, const int key, const float tolerance, const int is_relative)
+{
+  return JHPCNDF::fwrite_lorenzo(ptr, nx, ny, nz, key, tolerance, is_relative);
+}
+size_t JHPCNDF_fwrite_lorenzo_double(const double* ptr, const size_t nx, const size_t ny, const size_t nz, const int key, const float tolerance, const int is_relative)
+{
+  return JHPCNDF::fwrite_lorenzo(ptr, nx, ny, nz, key, tolerance, is_relative);
+}
+size_t JHPCNDF_fread_lorenzo_float(float* ptr, const size_t nx, const size_t ny, const size_t nz, const int key)
+{
+  return JHPCNDF::fread_lorenzo(ptr, nx, ny, nz, key);
+}
+size_t JHPCNDF_fread_lorenzo_double(double* ptr, const size_t nx, const size_t ny, const size_t nz, const int key)
+{
+  return JHPCNDF::fread_lorenzo(ptr, nx, ny, nz, key);
+}
+void JHPCNDF_encode_float(const size_t length, const float* const src, float* const dst, float* const dst_lower, const float tolerance, const int is_relative, const char* enc)
+{
+  JHPCNDF::encode<float>(length, src, dst, dst_lower, tolerance, is_relative, enc);
+}
+void JHPCNDF_encode_double(const size_t length, const double* const src, double* const dst, double* const dst_lower, const float tolerance, const int is_relative, const char* enc)
+{
+  JHPCNDF::encode<double>(length, src, dst, dst_lower, tolerance, is_relative, enc);
+}
+void JHPCNDF_decode_float(const size_t length, const float* const src_upper, const float* const src_lower, float* const dst)
+{
+  JHPCNDF::decode<float>(length, src_upper, src_lower, dst);
+}
+void JHPCNDF_decode_double(const size_t length, const double* const src_upper, const double* const src_lower, double* const dst)
+{
+  JHPCNDF::decode<double>(length, src_upper, src_lower, dst);
+}
+void JHPCNDF_encode_lorenzo_float(const size_t nx, const size_t ny, const size_t nz, const float* const src, float* const dst, float* const dst_lower, const float tolerance, const int is_relative)
+{
+  JHPCNDF::encode_lorenzo<float>(nx, ny, nz, src, dst, dst_lower, tolerance, is_relative);
+}
+void JHPCNDF_encode_lorenzo_double(const size_t nx, const size_t ny, const size_t nz, const double* const src, double* const dst, double* const dst_lower, const float tolerance, const int is_relative)
+{
+  JHPCNDF::encode_lorenzo<double>(nx, ny, nz, src, dst, dst_lower, tolerance, is_relative);
+}
+void JHPCNDF_decode_lorenzo_float(const size_t nx, const size_t ny, const size_t nz, const float* const src_upper, const float* const src_lower, float* const dst)
+{
+  JHPCNDF::decode_lorenzo<float>(nx, ny, nz, src_upper, src_lower, dst);
+}
+void JHPCNDF_decode_lorenzo_double(const size_t nx, const size_t ny, const size_t nz, const double* const src_upper, const double* const src_lower, double* const dst)
+{
+  JHPCNDF::decode_lorenzo<double>(nx, ny, nz, src_upper, src_lower, dst);
+}
+void JHPCNDF_encode_block_transform_float(const size_t nx, const size_t ny, const size_t nz, const float* const src, float* const dst, float* const dst_lower, const float tolerance, const int is_relative)
+{
+  JHPCNDF::encode_block_transform<float>(nx, ny, nz, src, dst, dst_lower, tolerance, is_relative);
+}
+void JHPCNDF_encode_block_transform_double(const size_t nx, const size_t ny, const size_t nz, const double* const src, double* const dst, double* const dst_lower, const float tolerance, const int is_relative)
+{
+  JHPCNDF::encode_block_transform<double>(nx, ny, nz, src, dst, dst_lower, tolerance, is_relative);
+}
+void JHPCNDF_decode_block_transform_float(const size_t nx, const size_t ny, const size_t nz, const float* const src_upper, const float* const src_lower, float* const dst)
+{
+  JHPCNDF::decode_block_transform<float>(nx, ny, nz, src_upper, src_lower, dst);
+}
+void JHPCNDF_decode_block_transform_double(const size_t nx, const size_t ny, const size_t nz, const double* const src_upper, const double* const src_lower, double* const dst)
+{
+  JHPCNDF::decode_block_transform<double>(nx, ny, nz, src_upper, src_lower, dst);
+}
+size_t JHPCNDF_fixed_rate_size(const size_t nmemb, const unsigned int rate)
+{
+  return JHPCNDF::fixed_rate_size(nmemb, rate);
+}
+size_t JHPCNDF_encode_fixed_rate_float(const float* src, const size_t nmemb, const unsigned int rate, void* dst, float* dst_lower)
+{
+  return JHPCNDF::encode_fixed_rate(src, nmemb, rate, dst, dst_lower);
+}
+size_t JHPCNDF_encode_fixed_rate_double(const double* src, const size_t nmemb, const unsigned int rate, void* dst, double* dst_lower)
+{
+  return JHPCNDF::encode_fixed_rate(src, nmemb, rate, dst, dst_lower);
+}
+size_t JHPCNDF_decode_fixed_rate_float(const void* src, const size_t nmemb, const unsigned int rate, const float* src_lower, float* dst)
+{
+  return JHPCNDF::decode_fixed_rate(src, nmemb, rate, src_lower, dst);
+}
+size_t JHPCNDF_decode_fixed_rate_double(const void* src, const size_t nmemb, const unsigned int rate, const double* src_lower, double* dst)
+{
+  return JHPCNDF::decode_fixed_rate(src, nmemb, rate, src_lower, dst);
+}
+size_t JHPCNDF_decode_fixed_rate_range_float(const void* src, const size_t nmemb, const unsigned int rate, const size_t first, const size_t count, const float* src_lower, float* dst)
+{
+  return JHPCNDF::decode_fixed_rate_range(src, nmemb, rate, first, count, src_lower, dst);
+}
+size_t JHPCNDF_decode_fixed_rate_range_double(const void* src, const size_t nmemb, const unsigned int rate, const size_t first, const size_t count, const double* src_lower, double* dst)
+{
+  return JHPCNDF::decode_fixed_rate_range(src, nmemb, rate, first, count, src_lower, dst);
+}
+size_t JHPCNDF_fwrite_fixed_rate_float(const float* ptr, size_t nmemb, const int key, const unsigned int rate)
+{
+  return JHPCNDF::fwrite_fixed_rate(ptr, nmemb, key, rate);
+}
+size_t JHPCNDF_fwrite_fixed_rate_double(const double* ptr, size_t nmemb, const int key, const unsigned int rate)
+{
+  return JHPCNDF::fwrite_fixed_rate(ptr, nmemb, key, rate);
+}
+size_t JHPCNDF_fread_fixed_rate_float(float* ptr, size_t nmemb, const int key)
+{
+  return JHPCNDF::fread_fixed_rate(ptr, nmemb, key);
+}
+size_t JHPCNDF_fread_fixed_rate_double(double* ptr, size_t nmemb, const int key)
+{
+  return JHPCNDF::fread_fixed_rate(ptr, nmemb, key);
+}
+size_t JHPCNDF_fwrite_batch(const JHPCNDF_WriteRequest* requests, const size_t num_requests, const int key)
+{
+  std::vector<JHPCNDF::WriteRequest> list;
+  list.reserve(num_requests);
+  for(size_t i=0; i<num_requests; i++)
+  {
+    list.push_back(JHPCNDF::WriteRequest(requests[i].ptr, requests[i].size, requests[i].nmemb, requests[i].tolerance, requests[i].is_relative != 0, requests[i].enc != NULL ? requests[i].enc : "binary_search"));
+  }
+  return JHPCNDF::fwrite_batch(list, key);
+}
+size_t JHPCNDF_fwrite_tolerance_field_float(const float* ptr, size_t nmemb, const int key, const float* tolerances, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_tolerance_field(ptr, nmemb, key, tolerances, is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fwrite_tolerance_field_double(const double* ptr, size_t nmemb, const int key, const float* tolerances, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_tolerance_field(ptr, nmemb, key, tolerances, is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fwrite_tolerance_mask_float(const float* ptr, size_t nmemb, const int key, const unsigned char* mask, const float* table, const size_t table_size, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_tolerance_mask(ptr, nmemb, key, mask, std::vector<float>(table, table+table_size), is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fwrite_tolerance_mask_double(const double* ptr, size_t nmemb, const int key, const unsigned char* mask, const float* table, const size_t table_size, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_tolerance_mask(ptr, nmemb, key, mask, std::vector<float>(table, table+table_size), is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fwrite_subarray_float(const float* ptr, const size_t ndims, const size_t* extents, const size_t* offsets, const size_t* counts, const size_t* strides, const int key, const float tolerance, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_subarray(ptr, JHPCNDF::Subarray(ndims, extents, offsets, counts, strides), key, tolerance, is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fwrite_subarray_double(const double* ptr, const size_t ndims, const size_t* extents, const size_t* offsets, const size_t* counts, const size_t* strides, const int key, const float tolerance, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_subarray(ptr, JHPCNDF::Subarray(ndims, extents, offsets, counts, strides), key, tolerance, is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fread_subarray_float(float* ptr, const size_t ndims, const size_t* extents, const size_t* offsets, const size_t* counts, const size_t* strides, const int key)
+{
+  return JHPCNDF::fread_subarray(ptr, JHPCNDF::Subarray(ndims, extents, offsets, counts, strides), key);
+}
+size_t JHPCNDF_fread_subarray_double(double* ptr, const size_t ndims, const size_t* extents, const size_t* offsets, const size_t* counts, const size_t* strides, const int key)
+{
+  return JHPCNDF::fread_subarray(ptr, JHPCNDF::Subarray(ndims, extents, offsets, counts, strides), key);
+}
+size_t JHPCNDF_fwrite_target_size_float(const float* ptr, size_t nmemb, const int key, const size_t target_size, float* tolerance_used, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_target_size(ptr, nmemb, key, target_size, tolerance_used, is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fwrite_target_size_double(const double* ptr, size_t nmemb, const int key, const size_t target_size, float* tolerance_used, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_target_size(ptr, nmemb, key, target_size, tolerance_used, is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fwrite_target_ratio_float(const float* ptr, size_t nmemb, const int key, const double target_ratio, float* tolerance_used, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_target_ratio(ptr, nmemb, key, target_ratio, tolerance_used, is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fwrite_target_ratio_double(const double* ptr, size_t nmemb, const int key, const double target_ratio, float* tolerance_used, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_target_ratio(ptr, nmemb, key, target_ratio, tolerance_used, is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fwrite_components_float(const float* ptr, const size_t num_components, size_t nmemb, const int key, const float* tolerances, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_components(ptr, num_components, nmemb, key, std::vector<float>(tolerances, tolerances+num_components), is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fwrite_components_double(const double* ptr, const size_t num_components, size_t nmemb, const int key, const float* tolerances, const int is_relative, const char* enc)
+{
+  return JHPCNDF::fwrite_components(ptr, num_components, nmemb, key, std::vector<float>(tolerances, tolerances+num_components), is_relative != 0, enc != NULL ? enc : "binary_search");
+}
+size_t JHPCNDF_fread_components_float(float* ptr, const size_t num_components, size_t nmemb, const int key)
+{
+  return JHPCNDF::fread_components(ptr, num_components, nmemb, key);
+}
+size_t JHPCNDF_fread_components_double(double* ptr, const size_t num_components, size_t nmemb, const int key)
+{
+  return JHPCNDF::fread_components(ptr, num_components, nmemb, key);
+}
+size_t JHPCNDF_fwrite_chunked_float(const float* ptr, size_t nmemb, const int key, const float tolerance, const int is_relative, const size_t chunk_elements, const char* enc)
+{
+  return JHPCNDF::fwrite_chunked(ptr, nmemb, key, tolerance, is_relative != 0, chunk_elements, enc);
+}
+size_t JHPCNDF_fwrite_chunked_double(const double* ptr, size_t nmemb, const int key, const float tolerance, const int is_relative, const size_t chunk_elements, const char* enc)
+{
+  return JHPCNDF::fwrite_chunked(ptr, nmemb, key, tolerance, is_relative != 0, chunk_elements, enc);
+}
+JHPCNDF_ReadView_float* JHPCNDF_open_view_float(const int key, const size_t cache_chunks, const size_t prefetch_chunks)
+{
+  JHPCNDF::ReadView<float>* view=new JHPCNDF::ReadView<float>(key, cache_chunks, prefetch_chunks);
+  if(!view->is_valid())
+  {
+    delete view;
+    return NULL;
+  }
+  return reinterpret_cast<JHPCNDF_ReadView_float*>(view);
+}
+void JHPCNDF_close_view_float(JHPCNDF_ReadView_float* view)
+{
+  delete reinterpret_cast<JHPCNDF::ReadView<float>*>(view);
+}
+size_t JHPCNDF_view_size_float(const JHPCNDF_ReadView_float* view)
+{
+  return reinterpret_cast<const JHPCNDF::ReadView<float>*>(view)->size();
+}
+size_t JHPCNDF_view_read_float(JHPCNDF_ReadView_float* view, const size_t first, const size_t count, float* dst)
+{
+  return reinterpret_cast<JHPCNDF::ReadView<float>*>(view)->read(first, count, dst);
+}
+JHPCNDF_ReadView_double* JHPCNDF_open_view_double(const int key, const size_t cache_chunks, const size_t prefetch_chunks)
+{
+  JHPCNDF::ReadView<double>* view=new JHPCNDF::ReadView<double>(key, cache_chunks, prefetch_chunks);
+  if(!view->is_valid())
+  {
+    delete view;
+    return NULL;
+  }
+  return reinterpret_cast<JHPCNDF_ReadView_double*>(view);
+}
+void JHPCNDF_close_view_double(JHPCNDF_ReadView_double* view)
+{
+  delete reinterpret_cast<JHPCNDF::ReadView<double>*>(view);
+}
+size_t JHPCNDF_view_size_double(const JHPCNDF_ReadView_double* view)
+{
+  return reinterpret_cast<const JHPCNDF::ReadView<double>*>(view)->size();
+}
+size_t JHPCNDF_view_read_double(JHPCNDF_ReadView_double* view, const size_t first, const size_t count, double* dst)
 {
-  return JHPCNDF::fwrite(ptr, size, nmemb, key, tolerance, is_relative, enc);
+  return reinterpret_cast<JHPCNDF::ReadView<double>*>(view)->read(first, count, dst);
 }
-size_t JHPCNDF_fwrite(const void *ptr, size_t size, size_t nmemb, const int key, const char* enc)
+JHPCNDF_CompressedArray_float* JHPCNDF_create_compressed_array_float(const size_t size, const float tolerance, const int is_relative, const char* enc, const char* comp, const int with_lower, const size_t block_size, const size_t cache_blocks)
 {
-  return JHPCNDF::fwrite((char*)ptr, 1, size*nmemb, key, 0.1, enc);
+  return reinterpret_cast<JHPCNDF_CompressedArray_float*>(new JHPCNDF::CompressedArray<float>(size, tolerance, is_relative != 0, enc, comp, with_lower != 0, block_size, cache_blocks));
 }
-size_t JHPCNDF_fread_float(float* ptr, size_t size, size_t nmemb, const int key)
+void JHPCNDF_destroy_compressed_array_float(JHPCNDF_CompressedArray_float* array)
 {
-  return JHPCNDF::fread(ptr, size, nmemb, key);
+  delete reinterpret_cast<JHPCNDF::CompressedArray<float>*>(array);
 }
-size_t JHPCNDF_fread_double(double *ptr, size_t size, size_t nmemb, const int key)
+int JHPCNDF_compressed_array_set_block_float(JHPCNDF_CompressedArray_float* array, const size_t block, const float* src)
 {
-  return JHPCNDF::fread(ptr, size, nmemb, key);
+  return reinterpret_cast<JHPCNDF::CompressedArray<float>*>(array)->set_block(block, src) ? 1 : 0;
 }
-size_t JHPCNDF_fread(void *ptr, size_t size, size_t nmemb, const int key)
+int JHPCNDF_compressed_array_get_block_float(const JHPCNDF_CompressedArray_float* array, const size_t block, float* dst)
 {
-  return JHPCNDF::fread((char*)ptr, 1, size*nmemb, key);
+  return reinterpret_cast<const JHPCNDF::CompressedArray<float>*>(array)->get_block(block, dst) ? 1 : 0;
 }
-void JHPCNDF_encode_float(const size_t length, const float* const src, float* const dst, float* const dst_lower, const float tolerance, const int is_relative, const char* enc)
+float JHPCNDF_compressed_array_get_float(const JHPCNDF_CompressedArray_float* array, const size_t index)
 {
-  JHPCNDF::encode<float>(length, src, dst, dst_lower, tolerance, is_relative, enc);
+  return reinterpret_cast<const JHPCNDF::CompressedArray<float>*>(array)->get(index);
 }
-void JHPCNDF_encode_double(const size_t length, const double* const src, double* const dst, double* const dst_lower, const float tolerance, const int is_relative, const char* enc)
+int JHPCNDF_compressed_array_set_float(JHPCNDF_CompressedArray_float* array, const size_t index, const float value)
 {
-  JHPCNDF::encode<double>(length, src, dst, dst_lower, tolerance, is_relative, enc);
+  return reinterpret_cast<JHPCNDF::CompressedArray<float>*>(array)->set(index, value) ? 1 : 0;
 }
-void JHPCNDF_decode_float(const size_t length, const float* const src_upper, const float* const src_lower, float* const dst)
+int JHPCNDF_compressed_array_flush_float(JHPCNDF_CompressedArray_float* array)
 {
-  JHPCNDF::decode<float>(length, src_upper, src_lower, dst);
+  return reinterpret_cast<JHPCNDF::CompressedArray<float>*>(array)->flush() ? 1 : 0;
 }
-void JHPCNDF_decode_double(const size_t length, const double* const src_upper, const double* const src_lower, double* const dst)
+size_t JHPCNDF_compressed_array_compressed_size_float(const JHPCNDF_CompressedArray_float* array)
 {
-  JHPCNDF::decode<double>(length, src_upper, src_lower, dst);
+  return reinterpret_cast<const JHPCNDF::CompressedArray<float>*>(array)->compressed_size();
+}
+JHPCNDF_CompressedArray_double* JHPCNDF_create_compressed_array_double(const size_t size, const float tolerance, const int is_relative, const char* enc, const char* comp, const int with_lower, const size_t block_size, const size_t cache_blocks)
+{
+  return reinterpret_cast<JHPCNDF_CompressedArray_double*>(new JHPCNDF::CompressedArray<double>(size, tolerance, is_relative != 0, enc, comp, with_lower != 0, block_size, cache_blocks));
+}
+void JHPCNDF_destroy_compressed_array_double(JHPCNDF_CompressedArray_double* array)
+{
+  delete reinterpret_cast<JHPCNDF::CompressedArray<double>*>(array);
+}
+int JHPCNDF_compressed_array_set_block_double(JHPCNDF_CompressedArray_double* array, const size_t block, const double* src)
+{
+  return reinterpret_cast<JHPCNDF::CompressedArray<double>*>(array)->set_block(block, src) ? 1 : 0;
+}
+int JHPCNDF_compressed_array_get_block_double(const JHPCNDF_CompressedArray_double* array, const size_t block, double* dst)
+{
+  return reinterpret_cast<const JHPCNDF::CompressedArray<double>*>(array)->get_block(block, dst) ? 1 : 0;
+}
+double JHPCNDF_compressed_array_get_double(const JHPCNDF_CompressedArray_double* array, const size_t index)
+{
+  return reinterpret_cast<const JHPCNDF::CompressedArray<double>*>(array)->get(index);
+}
+int JHPCNDF_compressed_array_set_double(JHPCNDF_CompressedArray_double* array, const size_t index, const double value)
+{
+  return reinterpret_cast<JHPCNDF::CompressedArray<double>*>(array)->set(index, value) ? 1 : 0;
+}
+int JHPCNDF_compressed_array_flush_double(JHPCNDF_CompressedArray_double* array)
+{
+  return reinterpret_cast<JHPCNDF::CompressedArray<double>*>(array)->flush() ? 1 : 0;
+}
+size_t JHPCNDF_compressed_array_compressed_size_double(const JHPCNDF_CompressedArray_double* array)
+{
+  return reinterpret_cast<const JHPCNDF::CompressedArray<double>*>(array)->compressed_size();
+}
+size_t JHPCNDF_compress_bound(const size_t nmemb, const size_t size, const char* comp, const int with_lower)
+{
+  return JHPCNDF::compress_bound(nmemb, size, comp, with_lower);
+}
+size_t JHPCNDF_estimate_compressed_size_float(const float* src, const size_t nmemb, const float tolerance, const int is_relative, const char* enc, const char* comp, size_t* lower_size)
+{
+  return JHPCNDF::estimate_compressed_size(src, nmemb, tolerance, is_relative != 0, enc != NULL ? enc : "binary_search", comp != NULL ? comp : "gzip", lower_size);
+}
+size_t JHPCNDF_estimate_compressed_size_double(const double* src, const size_t nmemb, const float tolerance, const int is_relative, const char* enc, const char* comp, size_t* lower_size)
+{
+  return JHPCNDF::estimate_compressed_size(src, nmemb, tolerance, is_relative != 0, enc != NULL ? enc : "binary_search", comp != NULL ? comp : "gzip", lower_size);
+}
+namespace
+{
+  template <typename T>
+    size_t sweep_tolerances_helper(const T* src, const size_t nmemb, const float* tolerances, const size_t num_tolerances, const int is_relative, const char* enc, const char* comp, size_t* histograms, size_t* upper_sizes, size_t* lower_sizes)
+    {
+      if(tolerances == NULL)
+      {
+        return 0;
+      }
+      std::vector<JHPCNDF::ToleranceSweepResult> results;
+      const size_t num_results=JHPCNDF::sweep_tolerances(src, nmemb, std::vector<float>(tolerances, tolerances+num_tolerances), &results, is_relative != 0, enc != NULL ? enc : "binary_search", comp != NULL ? comp : "gzip");
+      for(size_t k=0; k<num_results; k++)
+      {
+        if(histograms != NULL)
+        {
+          std::copy(results[k].histogram.begin(), results[k].histogram.end(), histograms+k*results[k].histogram.size());
+        }
+        if(upper_sizes != NULL)
+        {
+          upper_sizes[k]=results[k].estimated_upper_size;
+        }
+        if(lower_sizes != NULL)
+        {
+          lower_sizes[k]=results[k].estimated_lower_size;
+        }
+      }
+      return num_results;
+    }
+}
+size_t JHPCNDF_sweep_tolerances_float(const float* src, const size_t nmemb, const float* tolerances, const size_t num_tolerances, const int is_relative, const char* enc, const char* comp, size_t* histograms, size_t* upper_sizes, size_t* lower_sizes)
+{
+  return sweep_tolerances_helper(src, nmemb, tolerances, num_tolerances, is_relative, enc, comp, histograms, upper_sizes, lower_sizes);
+}
+size_t JHPCNDF_sweep_tolerances_double(const double* src, const size_t nmemb, const float* tolerances, const size_t num_tolerances, const int is_relative, const char* enc, const char* comp, size_t* histograms, size_t* upper_sizes, size_t* lower_sizes)
+{
+  return sweep_tolerances_helper(src, nmemb, tolerances, num_tolerances, is_relative, enc, comp, histograms, upper_sizes, lower_sizes);
+}
+size_t JHPCNDF_compress_float(const float* src, const size_t nmemb, void* dst, const size_t dst_capacity, const float tolerance, const int is_relative, const char* enc, const char* comp, const int with_lower)
+{
+  return JHPCNDF::compress(src, nmemb, dst, dst_capacity, tolerance, is_relative, enc, comp, with_lower);
+}
+size_t JHPCNDF_compress_double(const double* src, const size_t nmemb, void* dst, const size_t dst_capacity, const float tolerance, const int is_relative, const char* enc, const char* comp, const int with_lower)
+{
+  return JHPCNDF::compress(src, nmemb, dst, dst_capacity, tolerance, is_relative, enc, comp, with_lower);
+}
+size_t JHPCNDF_decompress_float(const void* src, const size_t src_size, float* dst, const size_t nmemb)
+{
+  return JHPCNDF::decompress(src, src_size, dst, nmemb);
+}
+size_t JHPCNDF_decompress_double(const void* src, const size_t src_size, double* dst, const size_t nmemb)
+{
+  return JHPCNDF::decompress(src, src_size, dst, nmemb);
+}
+size_t JHPCNDF_get_decompressed_elements(const void* src, const size_t src_size)
+{
+  return JHPCNDF::get_decompressed_elements(src, src_size);
+}
+JHPCNDF_Context* JHPCNDF_create_context(const int key, const float tolerance, const int is_relative, const char* enc, const int num_threads)
+{
+  JHPCNDF::Context* context=new JHPCNDF::Context(key, tolerance, is_relative, enc, num_threads);
+  if(key >= 0 && !context->is_valid())
+  {
+    delete context;
+    return NULL;
+  }
+  return reinterpret_cast<JHPCNDF_Context*>(context);
+}
+void JHPCNDF_destroy_context(JHPCNDF_Context* context)
+{
+  delete reinterpret_cast<JHPCNDF::Context*>(context);
+}
+size_t JHPCNDF_context_fwrite_float(JHPCNDF_Context* context, const float* ptr, size_t nmemb)
+{
+  return reinterpret_cast<JHPCNDF::Context*>(context)->fwrite(ptr, nmemb);
+}
+size_t JHPCNDF_context_fwrite_double(JHPCNDF_Context* context, const double* ptr, size_t nmemb)
+{
+  return reinterpret_cast<JHPCNDF::Context*>(context)->fwrite(ptr, nmemb);
+}
+size_t JHPCNDF_context_fread_float(JHPCNDF_Context* context, float* ptr, size_t nmemb)
+{
+  return reinterpret_cast<JHPCNDF::Context*>(context)->fread(ptr, nmemb);
+}
+size_t JHPCNDF_context_fread_double(JHPCNDF_Context* context, double* ptr, size_t nmemb)
+{
+  return reinterpret_cast<JHPCNDF::Context*>(context)->fread(ptr, nmemb);
 }
 
 //
@@ -369,6 +2744,18 @@ extern "C"
     JHPCNDF::fclose(*unit);
   }
 
+  //subroutine jhpcndf_set_scratch_capacity(unit, size)
+  void jhpcndf_set_scratch_capacity__(int* unit, size_t* size)
+  {
+    JHPCNDF::set_scratch_capacity(*unit, *size);
+  }
+
+  //subroutine jhpcndf_release_scratch(unit)
+  void jhpcndf_release_scratch__(int* unit)
+  {
+    JHPCNDF::release_scratch(*unit);
+  }
+
   //subroutine jhpcndf_write_real4(unit, recl, data, tol, enc)
   void jhpcndf_write_real4__(int* unit, size_t* recl, float* data, float* tolerance, bool* is_relative, const char* enc)
   {
@@ -419,6 +2806,146 @@ extern "C"
   {
     JHPCNDF::fread(data, 1, *recl, *unit);
   }
+  //subroutine jhpcndf_write_temporal_real4(unit, recl, data, var, tol, is_rel, enc, interval)
+  void jhpcndf_write_temporal_real4__(int* unit, size_t* recl, float* data, const char* variable, float* tolerance, bool* is_relative, const char* enc, int* interval)
+  {
+    JHPCNDF::fwrite_temporal(data, *recl, *unit, variable, *tolerance, *is_relative, enc, *interval);
+  }
+  //subroutine jhpcndf_write_temporal_real8(unit, recl, data, var, tol, is_rel, enc, interval)
+  void jhpcndf_write_temporal_real8__(int* unit, size_t* recl, double* data, const char* variable, float* tolerance, bool* is_relative, const char* enc, int* interval)
+  {
+    JHPCNDF::fwrite_temporal(data, *recl, *unit, variable, *tolerance, *is_relative, enc, *interval);
+  }
+  //subroutine jhpcndf_read_temporal_real4(unit, recl, data, var)
+  void jhpcndf_read_temporal_real4__(int* unit, size_t* recl, float* data, const char* variable)
+  {
+    JHPCNDF::fread_temporal(data, *recl, *unit, variable);
+  }
+  //subroutine jhpcndf_read_temporal_real8(unit, recl, data, var)
+  void jhpcndf_read_temporal_real8__(int* unit, size_t* recl, double* data, const char* variable)
+  {
+    JHPCNDF::fread_temporal(data, *recl, *unit, variable);
+  }
+  //subroutine jhpcndf_set_dictionary_real4(unit, recl, data, tol, is_rel, enc, ierr)
+  void jhpcndf_set_dictionary_real4__(int* unit, size_t* recl, float* data, float* tolerance, bool* is_relative, const char* enc, int* ierr)
+  {
+    *ierr=JHPCNDF::set_dictionary(data, *recl, *unit, *tolerance, *is_relative, enc);
+  }
+  //subroutine jhpcndf_set_dictionary_real8(unit, recl, data, tol, is_rel, enc, ierr)
+  void jhpcndf_set_dictionary_real8__(int* unit, size_t* recl, double* data, float* tolerance, bool* is_relative, const char* enc, int* ierr)
+  {
+    *ierr=JHPCNDF::set_dictionary(data, *recl, *unit, *tolerance, *is_relative, enc);
+  }
+  //subroutine jhpcndf_write_lorenzo_real4(unit, nx, ny, nz, data, tol, is_rel)
+  void jhpcndf_write_lorenzo_real4__(int* unit, size_t* nx, size_t* ny, size_t* nz, float* data, float* tolerance, bool* is_relative)
+  {
+    JHPCNDF::fwrite_lorenzo(data, *nx, *ny, *nz, *unit, *tolerance, *is_relative);
+  }
+  //subroutine jhpcndf_write_lorenzo_real8(unit, nx, ny, nz, data, tol, is_rel)
+  void jhpcndf_write_lorenzo_real8__(int* unit, size_t* nx, size_t* ny, size_t* nz, double* data, float* tolerance, bool* is_relative)
+  {
+    JHPCNDF::fwrite_lorenzo(data, *nx, *ny, *nz, *unit, *tolerance, *is_relative);
+  }
+  //subroutine jhpcndf_read_lorenzo_real4(unit, nx, ny, nz, data)
+  void jhpcndf_read_lorenzo_real4__(int* unit, size_t* nx, size_t* ny, size_t* nz, float* data)
+  {
+    JHPCNDF::fread_lorenzo(data, *nx, *ny, *nz, *unit);
+  }
+  //subroutine jhpcndf_read_lorenzo_real8(unit, nx, ny, nz, data)
+  void jhpcndf_read_lorenzo_real8__(int* unit, size_t* nx, size_t* ny, size_t* nz, double* data)
+  {
+    JHPCNDF::fread_lorenzo(data, *nx, *ny, *nz, *unit);
+  }
+  //subroutine jhpcndf_write_fixed_rate_real4(unit, recl, data, rate)
+  void jhpcndf_write_fixed_rate_real4__(int* unit, size_t* recl, float* data, int* rate)
+  {
+    JHPCNDF::fwrite_fixed_rate(data, *recl, *unit, *rate);
+  }
+  //subroutine jhpcndf_write_fixed_rate_real8(unit, recl, data, rate)
+  void jhpcndf_write_fixed_rate_real8__(int* unit, size_t* recl, double* data, int* rate)
+  {
+    JHPCNDF::fwrite_fixed_rate(data, *recl, *unit, *rate);
+  }
+  //subroutine jhpcndf_read_fixed_rate_real4(unit, recl, data)
+  void jhpcndf_read_fixed_rate_real4__(int* unit, size_t* recl, float* data)
+  {
+    JHPCNDF::fread_fixed_rate(data, *recl, *unit);
+  }
+  //subroutine jhpcndf_read_fixed_rate_real8(unit, recl, data)
+  void jhpcndf_read_fixed_rate_real8__(int* unit, size_t* recl, double* data)
+  {
+    JHPCNDF::fread_fixed_rate(data, *recl, *unit);
+  }
+  //subroutine jhpcndf_write_tolerance_field_real4(unit, recl, data, tol, is_rel, enc)
+  void jhpcndf_write_tolerance_field_real4__(int* unit, size_t* recl, float* data, float* tolerances, bool* is_relative, const char* enc)
+  {
+    JHPCNDF::fwrite_tolerance_field(data, *recl, *unit, tolerances, *is_relative, enc);
+  }
+  //subroutine jhpcndf_write_tolerance_field_real8(unit, recl, data, tol, is_rel, enc)
+  void jhpcndf_write_tolerance_field_real8__(int* unit, size_t* recl, double* data, float* tolerances, bool* is_relative, const char* enc)
+  {
+    JHPCNDF::fwrite_tolerance_field(data, *recl, *unit, tolerances, *is_relative, enc);
+  }
+  //subroutine jhpcndf_write_subarray_real4(unit, ndims, extents, offsets, counts, strides, data, tol, is_rel, enc)
+  void jhpcndf_write_subarray_real4__(int* unit, int* ndims, size_t* extents, size_t* offsets, size_t* counts, size_t* strides, float* data, float* tolerance, bool* is_relative, const char* enc)
+  {
+    JHPCNDF::fwrite_subarray(data, JHPCNDF::Subarray(*ndims, extents, offsets, counts, strides), *unit, *tolerance, *is_relative, enc);
+  }
+  //subroutine jhpcndf_write_subarray_real8(unit, ndims, extents, offsets, counts, strides, data, tol, is_rel, enc)
+  void jhpcndf_write_subarray_real8__(int* unit, int* ndims, size_t* extents, size_t* offsets, size_t* counts, size_t* strides, double* data, float* tolerance, bool* is_relative, const char* enc)
+  {
+    JHPCNDF::fwrite_subarray(data, JHPCNDF::Subarray(*ndims, extents, offsets, counts, strides), *unit, *tolerance, *is_relative, enc);
+  }
+  //subroutine jhpcndf_read_subarray_real4(unit, ndims, extents, offsets, counts, strides, data)
+  void jhpcndf_read_subarray_real4__(int* unit, int* ndims, size_t* extents, size_t* offsets, size_t* counts, size_t* strides, float* data)
+  {
+    JHPCNDF::fread_subarray(data, JHPCNDF::Subarray(*ndims, extents, offsets, counts, strides), *unit);
+  }
+  //subroutine jhpcndf_read_subarray_real8(unit, ndims, extents, offsets, counts, strides, data)
+  void jhpcndf_read_subarray_real8__(int* unit, int* ndims, size_t* extents, size_t* offsets, size_t* counts, size_t* strides, double* data)
+  {
+    JHPCNDF::fread_subarray(data, JHPCNDF::Subarray(*ndims, extents, offsets, counts, strides), *unit);
+  }
+  //subroutine jhpcndf_write_target_size_real4(unit, recl, data, target, tol_used, is_rel, enc)
+  void jhpcndf_write_target_size_real4__(int* unit, size_t* recl, float* data, size_t* target, float* tolerance_used, bool* is_relative, const char* enc)
+  {
+    JHPCNDF::fwrite_target_size(data, *recl, *unit, *target, tolerance_used, *is_relative, enc);
+  }
+  //subroutine jhpcndf_write_target_size_real8(unit, recl, data, target, tol_used, is_rel, enc)
+  void jhpcndf_write_target_size_real8__(int* unit, size_t* recl, double* data, size_t* target, float* tolerance_used, bool* is_relative, const char* enc)
+  {
+    JHPCNDF::fwrite_target_size(data, *recl, *unit, *target, tolerance_used, *is_relative, enc);
+  }
+  //subroutine jhpcndf_write_target_ratio_real4(unit, recl, data, target, tol_used, is_rel, enc)
+  void jhpcndf_write_target_ratio_real4__(int* unit, size_t* recl, float* data, double* target, float* tolerance_used, bool* is_relative, const char* enc)
+  {
+    JHPCNDF::fwrite_target_ratio(data, *recl, *unit, *target, tolerance_used, *is_relative, enc);
+  }
+  //subroutine jhpcndf_write_target_ratio_real8(unit, recl, data, target, tol_used, is_rel, enc)
+  void jhpcndf_write_target_ratio_real8__(int* unit, size_t* recl, double* data, double* target, float* tolerance_used, bool* is_relative, const char* enc)
+  {
+    JHPCNDF::fwrite_target_ratio(data, *recl, *unit, *target, tolerance_used, *is_relative, enc);
+  }
+  //subroutine jhpcndf_write_components_real4(unit, ncomp, recl, data, tol, is_rel, enc)
+  void jhpcndf_write_components_real4__(int* unit, int* num_components, size_t* recl, float* data, float* tolerances, bool* is_relative, const char* enc)
+  {
+    JHPCNDF::fwrite_components(data, *num_components, *recl, *unit, std::vector<float>(tolerances, tolerances+*num_components), *is_relative, enc);
+  }
+  //subroutine jhpcndf_write_components_real8(unit, ncomp, recl, data, tol, is_rel, enc)
+  void jhpcndf_write_components_real8__(int* unit, int* num_components, size_t* recl, double* data, float* tolerances, bool* is_relative, const char* enc)
+  {
+    JHPCNDF::fwrite_components(data, *num_components, *recl, *unit, std::vector<float>(tolerances, tolerances+*num_components), *is_relative, enc);
+  }
+  //subroutine jhpcndf_read_components_real4(unit, ncomp, recl, data)
+  void jhpcndf_read_components_real4__(int* unit, int* num_components, size_t* recl, float* data)
+  {
+    JHPCNDF::fread_components(data, *num_components, *recl, *unit);
+  }
+  //subroutine jhpcndf_read_components_real8(unit, ncomp, recl, data)
+  void jhpcndf_read_components_real8__(int* unit, int* num_components, size_t* recl, double* data)
+  {
+    JHPCNDF::fread_components(data, *num_components, *recl, *unit);
+  }
 
   void jhpcndf_encode_real4__(const size_t* length, const float* const src, float* const dst, float* const dst_lower, const float* tolerance, bool* is_relative, const char* enc)
   {
@@ -436,6 +2963,88 @@ extern "C"
   {
     JHPCNDF::decode<double>(*length, src_upper, src_lower, dst);
   }
+
+  //subroutine jhpcndf_compress_bound(nmemb, size, comp, with_lower, bound)
+  void jhpcndf_compress_bound__(size_t* nmemb, size_t* size, const char* comp, bool* with_lower, size_t* bound)
+  {
+    *bound=JHPCNDF::compress_bound(*nmemb, *size, comp, *with_lower);
+  }
+  //subroutine jhpcndf_estimate_size_real4(nmemb, src, tol, is_rel, enc, comp, upper_size, lower_size)
+  void jhpcndf_estimate_size_real4__(size_t* nmemb, float* src, float* tolerance, bool* is_relative, const char* enc, const char* comp, size_t* upper_size, size_t* lower_size)
+  {
+    *upper_size=JHPCNDF::estimate_compressed_size(src, *nmemb, *tolerance, *is_relative, enc, comp, lower_size);
+  }
+  //subroutine jhpcndf_estimate_size_real8(nmemb, src, tol, is_rel, enc, comp, upper_size, lower_size)
+  void jhpcndf_estimate_size_real8__(size_t* nmemb, double* src, float* tolerance, bool* is_relative, const char* enc, const char* comp, size_t* upper_size, size_t* lower_size)
+  {
+    *upper_size=JHPCNDF::estimate_compressed_size(src, *nmemb, *tolerance, *is_relative, enc, comp, lower_size);
+  }
+  //subroutine jhpcndf_sweep_tolerances_real4(nmemb, src, ntol, tols, is_rel, enc, comp, hist, upper_sizes, lower_sizes)
+  //histはhist(24, ntol)の配列
+  void jhpcndf_sweep_tolerances_real4__(size_t* nmemb, float* src, size_t* num_tolerances, float* tolerances, bool* is_relative, const char* enc, const char* comp, size_t* histograms, size_t* upper_sizes, size_t* lower_sizes)
+  {
+    sweep_tolerances_helper(src, *nmemb, tolerances, *num_tolerances, *is_relative, enc, comp, histograms, upper_sizes, lower_sizes);
+  }
+  //subroutine jhpcndf_sweep_tolerances_real8(nmemb, src, ntol, tols, is_rel, enc, comp, hist, upper_sizes, lower_sizes)
+  //histはhist(53, ntol)の配列
+  void jhpcndf_sweep_tolerances_real8__(size_t* nmemb, double* src, size_t* num_tolerances, float* tolerances, bool* is_relative, const char* enc, const char* comp, size_t* histograms, size_t* upper_sizes, size_t* lower_sizes)
+  {
+    sweep_tolerances_helper(src, *nmemb, tolerances, *num_tolerances, *is_relative, enc, comp, histograms, upper_sizes, lower_sizes);
+  }
+  //subroutine jhpcndf_compress_real4(nmemb, src, capacity, dst, tol, is_rel, enc, comp, with_lower, dst_size)
+  void jhpcndf_compress_real4__(size_t* nmemb, float* src, size_t* capacity, char* dst, float* tolerance, bool* is_relative, const char* enc, const char* comp, bool* with_lower, size_t* dst_size)
+  {
+    *dst_size=JHPCNDF::compress(src, *nmemb, dst, *capacity, *tolerance, *is_relative, enc, comp, *with_lower);
+  }
+  //subroutine jhpcndf_compress_real8(nmemb, src, capacity, dst, tol, is_rel, enc, comp, with_lower, dst_size)
+  void jhpcndf_compress_real8__(size_t* nmemb, double* src, size_t* capacity, char* dst, float* tolerance, bool* is_relative, const char* enc, const char* comp, bool* with_lower, size_t* dst_size)
+  {
+    *dst_size=JHPCNDF::compress(src, *nmemb, dst, *capacity, *tolerance, *is_relative, enc, comp, *with_lower);
+  }
+  //subroutine jhpcndf_decompress_real4(src_size, src, nmemb, dst, num_elements)
+  void jhpcndf_decompress_real4__(size_t* src_size, char* src, size_t* nmemb, float* dst, size_t* num_elements)
+  {
+    *num_elements=JHPCNDF::decompress(src, *src_size, dst, *nmemb);
+  }
+  //subroutine jhpcndf_decompress_real8(src_size, src, nmemb, dst, num_elements)
+  void jhpcndf_decompress_real8__(size_t* src_size, char* src, size_t* nmemb, double* dst, size_t* num_elements)
+  {
+    *num_elements=JHPCNDF::decompress(src, *src_size, dst, *nmemb);
+  }
+
+  //subroutine jhpcndf_create_context(context, unit, tol, is_rel, enc, num_threads)
+  //contextにはJHPCNDF::Contextへのポインタをinteger(8)として格納する
+  void jhpcndf_create_context__(long long* context, int* unit, float* tolerance, bool* is_relative, const char* enc, int* num_threads)
+  {
+    JHPCNDF::Context* tmp=new JHPCNDF::Context(*unit, *tolerance, *is_relative, enc, *num_threads);
+    *context=reinterpret_cast<long long>(tmp);
+  }
+  //subroutine jhpcndf_destroy_context(context)
+  void jhpcndf_destroy_context__(long long* context)
+  {
+    delete reinterpret_cast<JHPCNDF::Context*>(*context);
+    *context=0;
+  }
+  //subroutine jhpcndf_context_write_real4(context, recl, data)
+  void jhpcndf_context_write_real4__(long long* context, size_t* recl, float* data)
+  {
+    reinterpret_cast<JHPCNDF::Context*>(*context)->fwrite(data, *recl);
+  }
+  //subroutine jhpcndf_context_write_real8(context, recl, data)
+  void jhpcndf_context_write_real8__(long long* context, size_t* recl, double* data)
+  {
+    reinterpret_cast<JHPCNDF::Context*>(*context)->fwrite(data, *recl);
+  }
+  //subroutine jhpcndf_context_read_real4(context, recl, data)
+  void jhpcndf_context_read_real4__(long long* context, size_t* recl, float* data)
+  {
+    reinterpret_cast<JHPCNDF::Context*>(*context)->fread(data, *recl);
+  }
+  //subroutine jhpcndf_context_read_real8(context, recl, data)
+  void jhpcndf_context_read_real8__(long long* context, size_t* recl, double* data)
+  {
+    reinterpret_cast<JHPCNDF::Context*>(*context)->fread(data, *recl);
+  }
 }
 
 
@@ -478,6 +3087,105 @@ namespace JHPCNDF
   template
     size_t fread<unsigned long>(unsigned long* ptr, size_t size, size_t nmemb, const int& key, const bool& byte_swap);
 
+  template
+    size_t fwrite_temporal<float>(const float* ptr, size_t nmemb, const int& key, const std::string& variable, const float& tolerance, const bool& is_relative, const std::string& enc, const int& keyframe_interval);
+  template
+    size_t fwrite_temporal<double>(const double* ptr, size_t nmemb, const int& key, const std::string& variable, const float& tolerance, const bool& is_relative, const std::string& enc, const int& keyframe_interval);
+  template
+    size_t fread_temporal<float>(float* ptr, size_t nmemb, const int& key, const std::string& variable);
+  template
+    size_t fread_temporal<double>(double* ptr, size_t nmemb, const int& key, const std::string& variable);
+
+  template
+    int set_dictionary<float>(const float* sample, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc);
+  template
+    int set_dictionary<double>(const double* sample, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc);
+
+  template
+    size_t fwrite_lorenzo<float>(const float* ptr, const size_t& nx, const size_t& ny, const size_t& nz, const int& key, const float& tolerance, const bool& is_relative);
+  template
+    size_t fwrite_lorenzo<double>(const double* ptr, const size_t& nx, const size_t& ny, const size_t& nz, const int& key, const float& tolerance, const bool& is_relative);
+  template
+    size_t fread_lorenzo<float>(float* ptr, const size_t& nx, const size_t& ny, const size_t& nz, const int& key);
+  template
+    size_t fread_lorenzo<double>(double* ptr, const size_t& nx, const size_t& ny, const size_t& nz, const int& key);
+  template
+    void encode_lorenzo<float>(const size_t& nx, const size_t& ny, const size_t& nz, const float* const src, float* const dst, float* const dst_lower, const float& tolerance, const bool& is_relative);
+  template
+    void encode_lorenzo<double>(const size_t& nx, const size_t& ny, const size_t& nz, const double* const src, double* const dst, double* const dst_lower, const float& tolerance, const bool& is_relative);
+  template
+    void decode_lorenzo<float>(const size_t& nx, const size_t& ny, const size_t& nz, const float* const src_upper, const float* const src_lower, float* const dst);
+  template
+    void decode_lorenzo<double>(const size_t& nx, const size_t& ny, const size_t& nz, const double* const src_upper, const double* const src_lower, double* const dst);
+  template
+    void encode_block_transform<float>(const size_t& nx, const size_t& ny, const size_t& nz, const float* const src, float* const dst, float* const dst_lower, const float& tolerance, const bool& is_relative);
+  template
+    void encode_block_transform<double>(const size_t& nx, const size_t& ny, const size_t& nz, const double* const src, double* const dst, double* const dst_lower, const float& tolerance, const bool& is_relative);
+  template
+    void decode_block_transform<float>(const size_t& nx, const size_t& ny, const size_t& nz, const float* const src_upper, const float* const src_lower, float* const dst);
+  template
+    void decode_block_transform<double>(const size_t& nx, const size_t& ny, const size_t& nz, const double* const src_upper, const double* const src_lower, double* const dst);
+  template
+    bool decode_transform_block<float>(const size_t& nx, const size_t& ny, const size_t& nz, const size_t& bi, const size_t& bj, const size_t& bk, const float* const src_upper, const float* const src_lower, float* const dst);
+  template
+    bool decode_transform_block<double>(const size_t& nx, const size_t& ny, const size_t& nz, const size_t& bi, const size_t& bj, const size_t& bk, const double* const src_upper, const double* const src_lower, double* const dst);
+  template
+    size_t encode_fixed_rate<float>(const float* src, const size_t& nmemb, const unsigned int& rate, void* dst, float* dst_lower);
+  template
+    size_t encode_fixed_rate<double>(const double* src, const size_t& nmemb, const unsigned int& rate, void* dst, double* dst_lower);
+  template
+    size_t decode_fixed_rate<float>(const void* src, const size_t& nmemb, const unsigned int& rate, const float* src_lower, float* dst);
+  template
+    size_t decode_fixed_rate<double>(const void* src, const size_t& nmemb, const unsigned int& rate, const double* src_lower, double* dst);
+  template
+    size_t decode_fixed_rate_range<float>(const void* src, const size_t& nmemb, const unsigned int& rate, const size_t& first, const size_t& count, const float* src_lower, float* dst);
+  template
+    size_t decode_fixed_rate_range<double>(const void* src, const size_t& nmemb, const unsigned int& rate, const size_t& first, const size_t& count, const double* src_lower, double* dst);
+  template
+    size_t fwrite_fixed_rate<float>(const float* ptr, size_t nmemb, const int& key, const unsigned int& rate);
+  template
+    size_t fwrite_fixed_rate<double>(const double* ptr, size_t nmemb, const int& key, const unsigned int& rate);
+  template
+    size_t fread_fixed_rate<float>(float* ptr, size_t nmemb, const int& key);
+  template
+    size_t fread_fixed_rate<double>(double* ptr, size_t nmemb, const int& key);
+  template
+    size_t fwrite_tolerance_field<float>(const float* ptr, size_t nmemb, const int& key, const float* tolerances, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_tolerance_field<double>(const double* ptr, size_t nmemb, const int& key, const float* tolerances, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_tolerance_mask<float>(const float* ptr, size_t nmemb, const int& key, const unsigned char* mask, const std::vector<float>& table, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_tolerance_mask<double>(const double* ptr, size_t nmemb, const int& key, const unsigned char* mask, const std::vector<float>& table, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_subarray<float>(const float* ptr, const Subarray& subarray, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_subarray<double>(const double* ptr, const Subarray& subarray, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc);
+  template
+    size_t fread_subarray<float>(float* ptr, const Subarray& subarray, const int& key);
+  template
+    size_t fread_subarray<double>(double* ptr, const Subarray& subarray, const int& key);
+  template
+    size_t fwrite_target_size<float>(const float* ptr, size_t nmemb, const int& key, const size_t& target_size, float* tolerance_used, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_target_size<double>(const double* ptr, size_t nmemb, const int& key, const size_t& target_size, float* tolerance_used, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_target_ratio<float>(const float* ptr, size_t nmemb, const int& key, const double& target_ratio, float* tolerance_used, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_target_ratio<double>(const double* ptr, size_t nmemb, const int& key, const double& target_ratio, float* tolerance_used, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_components<float>(const float* ptr, const size_t& num_components, size_t nmemb, const int& key, const std::vector<float>& tolerances, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_components<double>(const double* ptr, const size_t& num_components, size_t nmemb, const int& key, const std::vector<float>& tolerances, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_components<float>(const float* ptr, const size_t& num_components, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc);
+  template
+    size_t fwrite_components<double>(const double* ptr, const size_t& num_components, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc);
+  template
+    size_t fread_components<float>(float* ptr, const size_t& num_components, size_t nmemb, const int& key);
+  template
+    size_t fread_components<double>(double* ptr, const size_t& num_components, size_t nmemb, const int& key);
+
   template
     void encode<float>(const size_t& length, const float* const src, float* const dst, float* const dst_lower, const float& tolerance, const bool& is_relative, const std::string& enc, const bool time_measuring);
   template
@@ -487,4 +3195,55 @@ namespace JHPCNDF
     void decode<float>(const size_t& length, const float* const src_upper, const float* const src_lower, float* const dst);
   template
     void decode<double>(const size_t& length, const double* const src_upper, const double* const src_lower, double* const dst);
+
+  template
+    size_t fwrite<float>(const float* ptr, size_t size, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc, EncodeStatistics* statistics);
+  template
+    size_t fwrite<double>(const double* ptr, size_t size, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc, EncodeStatistics* statistics);
+  template
+    void encode<float>(const size_t& length, const float* const src, float* const dst, float* const dst_lower, const float& tolerance, const bool& is_relative, const std::string& enc, EncodeStatistics* statistics);
+  template
+    void encode<double>(const size_t& length, const double* const src, double* const dst, double* const dst_lower, const float& tolerance, const bool& is_relative, const std::string& enc, EncodeStatistics* statistics);
+
+  template
+    size_t estimate_compressed_size<float>(const float* src, const size_t& nmemb, const float& tolerance, const bool& is_relative, const std::string& enc, const std::string& comp, size_t* lower_size);
+  template
+    size_t estimate_compressed_size<double>(const double* src, const size_t& nmemb, const float& tolerance, const bool& is_relative, const std::string& enc, const std::string& comp, size_t* lower_size);
+  template
+    size_t sweep_tolerances<float>(const float* src, const size_t& nmemb, const std::vector<float>& tolerances, std::vector<ToleranceSweepResult>* results, const bool& is_relative, const std::string& enc, const std::string& comp);
+  template
+    size_t sweep_tolerances<double>(const double* src, const size_t& nmemb, const std::vector<float>& tolerances, std::vector<ToleranceSweepResult>* results, const bool& is_relative, const std::string& enc, const std::string& comp);
+  template
+    size_t compress<float>(const float* src, const size_t& nmemb, void* dst, const size_t& dst_capacity, const float& tolerance, const bool& is_relative, const std::string& enc, const std::string& comp, const bool& with_lower);
+  template
+    size_t compress<double>(const double* src, const size_t& nmemb, void* dst, const size_t& dst_capacity, const float& tolerance, const bool& is_relative, const std::string& enc, const std::string& comp, const bool& with_lower);
+  template
+    size_t decompress<float>(const void* src, const size_t& src_size, float* dst, const size_t& nmemb);
+  template
+    size_t decompress<double>(const void* src, const size_t& src_size, double* dst, const size_t& nmemb);
+
+  template
+    size_t Context::fwrite<float>(const float* ptr, size_t nmemb);
+  template
+    size_t Context::fwrite<double>(const double* ptr, size_t nmemb);
+  template
+    size_t Context::fread<float>(float* ptr, size_t nmemb);
+  template
+    size_t Context::fread<double>(double* ptr, size_t nmemb);
+  template
+    void Context::encode<float>(const size_t& length, const float* const src, float* const dst, float* const dst_lower);
+  template
+    void Context::encode<double>(const size_t& length, const double* const src, double* const dst, double* const dst_lower);
+  template
+    class ReadView<float>;
+  template
+    class ReadView<double>;
+  template
+    size_t fwrite_chunked<float>(const float* ptr, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const size_t& chunk_elements, const std::string& enc);
+  template
+    size_t fwrite_chunked<double>(const double* ptr, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const size_t& chunk_elements, const std::string& enc);
+  template
+    class CompressedArray<float>;
+  template
+    class CompressedArray<double>;
 }//end of namespace JHPCNDF
@@ -0,0 +1,256 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file Lorenzo.h
+
+#ifndef JHPCNDF_LORENZO_H
+#define JHPCNDF_LORENZO_H
+#include <string.h>
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+#include "Encoder.h"
+#include "Utility.h"
+
+//
+//JHPCNDF::fwrite_lorenzoが出力するレコードの形式
+//
+//上位bit側ファイル
+//  LorenzoRecordHeader  (32 byte, 無圧縮)
+//  圧縮済上位bitデータ  (Lorenzo予測との残差を許容誤差に応じて切り詰めた値)
+//下位bit側ファイル
+//  圧縮済下位bitデータ  (元データと上位bitから再構成した値のXOR)
+//
+//配列はx方向が最も速く変化する順(index = i + nx*(j + ny*k))に並んでいるものとする
+//数値は全て出力した環境のバイトオーダーで格納する
+//
+namespace JHPCNDF
+{
+  struct LorenzoRecordHeader
+  {
+    char     magic[4];        // "JHLZ"
+    uint8_t  version;
+    uint8_t  element_size;    // 1要素のサイズ(float=4, double=8)
+    uint8_t  reserved[2];
+    uint64_t nx;
+    uint64_t ny;
+    uint64_t nz;
+  };
+
+  namespace Lorenzo
+  {
+    const uint8_t VERSION=1;
+
+    inline const char* magic(void)
+    {
+      return "JHLZ";
+    }
+
+    inline void init_header(LorenzoRecordHeader* header, const uint8_t& element_size, const size_t& nx, const size_t& ny, const size_t& nz)
+    {
+      memset(header, 0, sizeof(LorenzoRecordHeader));
+      memcpy(header->magic, magic(), 4);
+      header->version=VERSION;
+      header->element_size=element_size;
+      header->nx=nx;
+      header->ny=ny;
+      header->nz=nz;
+    }
+
+    inline bool is_valid_header(const LorenzoRecordHeader& header)
+    {
+      return memcmp(header.magic, magic(), 4) == 0 && header.version == VERSION;
+    }
+
+    //@brief 再構成済の近傍の値から(i, j, k)の値を予測する
+    //
+    //領域外の近傍は0として扱うので、nz=1の時は2次元、ny=nz=1の時は1次元のLorenzo予測になる
+    //エンコーダとデコーダで同じ予測値になるよう、必ずこの関数を使うこと
+    //予測値が有限でない場合(近傍にNaNやInfがある場合)は0を返す
+    template <typename T>
+    inline double predict(const T* recon, const size_t& index, const bool& has_i, const bool& has_j, const bool& has_k, const size_t& sy, const size_t& sz)
+    {
+      double pred=0.0;
+      if(has_i)                   pred+=recon[index-1];
+      if(has_j)                   pred+=recon[index-sy];
+      if(has_k)                   pred+=recon[index-sz];
+      if(has_i && has_j)          pred-=recon[index-1-sy];
+      if(has_i && has_k)          pred-=recon[index-1-sz];
+      if(has_j && has_k)          pred-=recon[index-sy-sz];
+      if(has_i && has_j && has_k) pred+=recon[index-1-sy-sz];
+      return pred-pred == 0.0 ? pred : 0.0;
+    }
+
+    //@brief 予測値と残差から値を再構成する
+    template <typename T>
+    inline T reconstruct(const double& pred, const T& residual)
+    {
+      return (T)(pred+(double)residual);
+    }
+
+    //@brief 残差の下位bitを、切り捨てた分が許容誤差未満になるように0にする
+    template <typename T>
+    inline T truncate(const T& residual, const double& tolerance)
+    {
+      if(!(tolerance > 0.0) || residual-residual != 0)
+      {
+        return residual;
+      }
+      if(std::fabs((double)residual) <= tolerance)
+      {
+        return 0;
+      }
+      // 2^(exp_tol-1) <= tolerance なので、2^(exp_tol-1)未満の桁を切り捨てる
+      int exp_tol, exp_res;
+      frexp(tolerance, &exp_tol);
+      frexp((double)residual, &exp_res);
+      if(exp_res-exp_tol > 60)
+      {
+        return residual;
+      }
+      const double step=ldexp(1.0, exp_tol-1);
+      const double quotient=(double)residual/step;
+      return (T)((quotient < 0.0 ? std::ceil(quotient) : std::floor(quotient))*step);
+    }
+  }//end of namespace Lorenzo
+
+  //@brief LorenzoEncoderでエンコードしたデータをデコードするクラス
+  //
+  //src_lowerにNULLを指定した場合は上位bit側のみから再構成する
+  //dstとsrc_upperに同じ領域を指定してもよい
+  template <typename T>
+  class LorenzoDecoder
+  {
+    public:
+      LorenzoDecoder(const size_t& arg_nx, const size_t& arg_ny, const size_t& arg_nz)
+        :nx(arg_nx), ny(arg_ny), nz(arg_nz) {}
+
+      void operator()(const size_t& length, const T* const src_upper, const T* const src_lower, T* const dst) const
+      {
+        const size_t sy=nx;
+        const size_t sz=nx*ny;
+        size_t index=0;
+        for(size_t k=0; k<nz; k++)
+        {
+          for(size_t j=0; j<ny; j++)
+          {
+            for(size_t i=0; i<nx; i++, index++)
+            {
+              dst[index]=Lorenzo::reconstruct(Lorenzo::predict(dst, index, i>0, j>0, k>0, sy, sz), src_upper[index]);
+            }
+          }
+        }
+        if(src_lower == NULL)
+        {
+          return;
+        }
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for(long i=0; i<(long)length; i++)
+        {
+          dst[i]=real_xor(dst[i], src_lower[i]);
+        }
+      }
+
+    private:
+      const size_t nx;
+      const size_t ny;
+      const size_t nz;
+  };
+
+  //@brief 構造格子上の配列をLorenzo予測との残差としてエンコードするエンコーダ
+  //
+  //上位bit側には、元データと、再構成済の近傍からの予測値との残差を許容誤差に応じて切り詰めた値を出力する
+  //切り詰めた残差はほとんどのbitが0になるので、元データを直接切り詰めるより良く圧縮できる
+  //下位bit側には、元データと上位bit側から再構成した値のXORを出力するので、両方を使えば元データに戻る
+  //予測が直前の要素に依存するため、要素毎の処理は並列化しない
+  template <typename T>
+  class LorenzoEncoder:public Encoder<T>
+  {
+    public:
+      LorenzoEncoder(const size_t& arg_nx, const size_t& arg_ny, const size_t& arg_nz, const float& arg_tolerance, const bool& arg_is_relative)
+        :nx(arg_nx), ny(arg_ny), nz(arg_nz), tolerance(arg_tolerance), is_relative(arg_is_relative) {}
+
+      void operator()(const size_t& length, const T* const src, T* const dst, T* const dst_lower=NULL) const
+      {
+        if(dst_lower == NULL)
+        {
+          make_upper_bits(length, src, dst);
+          return;
+        }
+        // 再構成した値をdst_lowerに格納してから、元データとのXORに置き換える
+        encode_residual(src, dst, dst_lower);
+        xor_with_source(length, src, dst_lower);
+      }
+      void make_upper_bits(const size_t& length, const T* const src, T* const dst) const
+      {
+        std::vector<T> recon(length);
+        if(length > 0)
+        {
+          encode_residual(src, dst, &(recon[0]));
+        }
+      }
+      void make_lower_bits(const size_t& length, const T* const src, T* const dst, T* const dst_lower) const
+      {
+        LorenzoDecoder<T> decoder(nx, ny, nz);
+        decoder(length, dst, NULL, dst_lower);
+        xor_with_source(length, src, dst_lower);
+      }
+
+    private:
+      void encode_residual(const T* const src, T* const dst, T* const recon) const
+      {
+        const size_t sy=nx;
+        const size_t sz=nx*ny;
+        size_t index=0;
+        for(size_t k=0; k<nz; k++)
+        {
+          for(size_t j=0; j<ny; j++)
+          {
+            for(size_t i=0; i<nx; i++, index++)
+            {
+              const double pred=Lorenzo::predict(recon, index, i>0, j>0, k>0, sy, sz);
+              const T value=src[index];
+              const T residual=(T)((double)value-pred);
+              const double allowed = is_relative ? std::fabs(tolerance*(double)value) : std::fabs((double)tolerance);
+              T upper=Lorenzo::truncate(residual, allowed);
+              T value_recon=Lorenzo::reconstruct(pred, upper);
+              // 再構成時の丸めで許容誤差を越えた場合は残差を切り詰めない
+              if(!(std::fabs((double)value-(double)value_recon) <= allowed))
+              {
+                upper=residual;
+                value_recon=Lorenzo::reconstruct(pred, upper);
+              }
+              dst[index]=upper;
+              recon[index]=value_recon;
+            }
+          }
+        }
+      }
+
+      void xor_with_source(const size_t& length, const T* const src, T* const dst_lower) const
+      {
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for(long i=0; i<(long)length; i++)
+        {
+          dst_lower[i]=real_xor(src[i], dst_lower[i]);
+        }
+      }
+
+      const size_t nx;
+      const size_t ny;
+      const size_t nz;
+      const float tolerance;
+      const bool  is_relative;
+  };
+}//end of namespace JHPCNDF
+#endif
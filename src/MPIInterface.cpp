@@ -0,0 +1,837 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file MPIInterface.cpp
+
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "jhpcndf_mpi.h"
+#include "Encoder.h"
+#include "IO.h"
+#include "Container.h"
+#include "ScratchArena.h"
+#include "Mutex.h"
+
+
+//
+// implementation of C++ Interface routines (MPI-IO)
+//
+namespace JHPCNDF
+{
+  namespace
+  {
+    //@brief JHPCNDF::mpi_fopenで開いたファイルの情報を保持するクラス
+    struct MPIFileInfo
+    {
+      MPIFileInfo():comm(MPI_COMM_NULL), fh_upper(MPI_FILE_NULL), fh_lower(MPI_FILE_NULL), buffer_size(0), chunk_elements(0), upper_position(0), lower_position(0), has_index(false), index_position(0){}
+
+      MPI_Comm    comm;
+      MPI_File    fh_upper;
+      MPI_File    fh_lower;
+      std::string compression_method;
+      size_t      buffer_size;
+      size_t      chunk_elements;
+      MPI_Offset  upper_position; // 次に読み書きするレコードの先頭位置
+      MPI_Offset  lower_position;
+      ScratchArena arena;
+
+      //最後に読み込んだレコードのヘッダとインデックス
+      bool        has_index;
+      MPI_Offset  index_position;
+      ContainerHeader header;
+      std::vector<ContainerChunk> chunks;
+    };
+
+    //@brief JHPCNDF::mpi_fopenで開いたファイルの情報を管理するテーブル
+    //
+    //JHPCNDF::fopenで開いたファイルとは別のID番号で管理する
+    class MPIFileInfoManager
+    {
+      public:
+        static MPIFileInfoManager& GetInstance(void)
+        {
+          static MPIFileInfoManager instance;
+          return instance;
+        }
+
+        int add(MPIFileInfo* info)
+        {
+          ScopedLock lock(mutex);
+          const int key=next_key++;
+          table[key]=info;
+          return key;
+        }
+
+        MPIFileInfo* find(const int& key)
+        {
+          ScopedLock lock(mutex);
+          std::map<int, MPIFileInfo*>::iterator it=table.find(key);
+          return it != table.end() ? it->second : NULL;
+        }
+
+        MPIFileInfo* remove(const int& key)
+        {
+          ScopedLock lock(mutex);
+          std::map<int, MPIFileInfo*>::iterator it=table.find(key);
+          if(it == table.end())
+          {
+            return NULL;
+          }
+          MPIFileInfo* info=it->second;
+          table.erase(it);
+          return info;
+        }
+
+      private:
+        MPIFileInfoManager():next_key(0){}
+        MPIFileInfoManager(const MPIFileInfoManager&);
+        MPIFileInfoManager& operator=(const MPIFileInfoManager&);
+
+        std::map<int, MPIFileInfo*> table;
+        int next_key;
+        Mutex mutex;
+    };
+
+    template <typename T>
+      T* data_pointer(std::vector<T>& v)
+      {
+        return v.empty() ? NULL : &(v[0]);
+      }
+
+    //MPI-IOの1回の呼び出しで読み書きするサイズの上限
+    const uint64_t MAX_IO_SIZE=1<<30;
+
+    //@brief 全プロセスでsizeバイトずつ集団出力する
+    //
+    //int型で表せないサイズを出力するため、MAX_IO_SIZE毎に分割して出力する
+    //分割数はプロセス間で最大値に揃え、出力するデータが無くなったプロセスはサイズ0で参加する
+    int write_at_all(MPI_File fh, MPI_Comm comm, const MPI_Offset& offset, const char* buffer, const uint64_t& size)
+    {
+      uint64_t num_pieces=(size+MAX_IO_SIZE-1)/MAX_IO_SIZE;
+      uint64_t max_num_pieces=0;
+      MPI_Allreduce(&num_pieces, &max_num_pieces, 1, MPI_UINT64_T, MPI_MAX, comm);
+      int rt=MPI_SUCCESS;
+      for(uint64_t i=0; i<max_num_pieces; i++)
+      {
+        const uint64_t position=i*MAX_IO_SIZE;
+        const int count = position < size ? (int)std::min(MAX_IO_SIZE, size-position) : 0;
+        char* ptr = count > 0 ? const_cast<char*>(buffer)+position : NULL;
+        MPI_Status status;
+        int err=MPI_File_write_at_all(fh, offset+position, ptr, count, MPI_BYTE, &status);
+        if(err != MPI_SUCCESS)
+        {
+          rt=err;
+        }
+      }
+      return rt;
+    }
+
+    //@brief 1プロセスで出力する
+    int write_at(MPI_File fh, const MPI_Offset& offset, const char* buffer, const uint64_t& size)
+    {
+      for(uint64_t position=0; position<size; position+=MAX_IO_SIZE)
+      {
+        const int count=(int)std::min(MAX_IO_SIZE, size-position);
+        MPI_Status status;
+        int err=MPI_File_write_at(fh, offset+position, const_cast<char*>(buffer)+position, count, MPI_BYTE, &status);
+        if(err != MPI_SUCCESS)
+        {
+          return err;
+        }
+      }
+      return MPI_SUCCESS;
+    }
+
+    //@brief 1プロセスで読み込む
+    //@ret 読み込んだサイズがsizeと一致しない時はMPI_ERR_IOを返す
+    int read_at(MPI_File fh, const MPI_Offset& offset, char* buffer, const uint64_t& size)
+    {
+      for(uint64_t position=0; position<size; position+=MAX_IO_SIZE)
+      {
+        const int count=(int)std::min(MAX_IO_SIZE, size-position);
+        MPI_Status status;
+        int err=MPI_File_read_at(fh, offset+position, buffer+position, count, MPI_BYTE, &status);
+        if(err != MPI_SUCCESS)
+        {
+          return err;
+        }
+        int read_count=0;
+        MPI_Get_count(&status, MPI_BYTE, &read_count);
+        if(read_count != count)
+        {
+          return MPI_ERR_IO;
+        }
+      }
+      return MPI_SUCCESS;
+    }
+
+    //@brief 全プロセスのエラー数の合計を返す
+    int count_errors(const int& num_errors, MPI_Comm comm)
+    {
+      int total=0;
+      MPI_Allreduce(const_cast<int*>(&num_errors), &total, 1, MPI_INT, MPI_SUM, comm);
+      return total;
+    }
+
+    template <typename T>
+      size_t mpi_fwrite_helper(const T* data, size_t nmemb, MPIFileInfo* info, const Encoder<T>& encoder)
+      {
+        MPI_Comm comm=info->comm;
+        int rank=0;
+        int nprocs=1;
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_size(comm, &nprocs);
+        const bool has_lower = info->fh_lower != MPI_FILE_NULL;
+        int num_errors=0;
+
+        //エンコード
+        ScratchArena* arena=&(info->arena);
+        T* work_upper=NULL;
+        T* work_lower=NULL;
+        if(nmemb > 0)
+        {
+          work_upper=static_cast<T*>(arena->get(ScratchArena::UPPER, sizeof(T)*nmemb));
+          if(has_lower)
+          {
+            work_lower=static_cast<T*>(arena->get(ScratchArena::LOWER, sizeof(T)*nmemb));
+          }
+          if(work_upper == NULL || (has_lower && work_lower == NULL))
+          {
+            std::cerr<<"can't allocate working memory for encode"<<std::endl;
+            num_errors++;
+          }else{
+            encoder(nmemb, data, work_upper, work_lower);
+          }
+        }
+
+        //チャンク毎に独立して圧縮
+        const size_t chunk_elements=info->chunk_elements;
+        const size_t num_local_chunks = num_errors == 0 ? (nmemb+chunk_elements-1)/chunk_elements : 0;
+        std::vector<std::vector<char> > upper_chunks(num_local_chunks);
+        std::vector<std::vector<char> > lower_chunks(has_lower ? num_local_chunks : 0);
+#ifdef USE_OPENMP
+#pragma omp parallel reduction(+:num_errors)
+#endif
+        {
+          IO* io=IOFactory(info->compression_method, info->buffer_size);
+#ifdef USE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+          for(size_t i=0; i<num_local_chunks; i++)
+          {
+            const size_t offset=i*chunk_elements;
+            const size_t length=std::min(chunk_elements, nmemb-offset);
+            if(Container::compress_to_memory(io, work_upper+offset, sizeof(T), length, &(upper_chunks[i])) == 0)
+            {
+              num_errors++;
+            }
+            if(has_lower && Container::compress_to_memory(io, work_lower+offset, sizeof(T), length, &(lower_chunks[i])) == 0)
+            {
+              num_errors++;
+            }
+          }
+          delete io;
+        }
+        if(count_errors(num_errors, comm) > 0)
+        {
+          arena->trim();
+          return 0;
+        }
+
+        //ローカルなインデックスを作成し、圧縮後のデータを連結する
+        std::vector<ContainerChunk> local_index(num_local_chunks);
+        uint64_t local_upper_size=0;
+        uint64_t local_lower_size=0;
+        for(size_t i=0; i<num_local_chunks; i++)
+        {
+          local_index[i].element_offset=i*chunk_elements;
+          local_index[i].num_elements=std::min(chunk_elements, nmemb-i*chunk_elements);
+          local_index[i].upper_offset=local_upper_size;
+          local_index[i].upper_size=upper_chunks[i].size();
+          local_upper_size+=upper_chunks[i].size();
+          if(has_lower)
+          {
+            local_index[i].lower_offset=local_lower_size;
+            local_index[i].lower_size=lower_chunks[i].size();
+            local_lower_size+=lower_chunks[i].size();
+          }
+        }
+        std::vector<char> upper_data;
+        std::vector<char> lower_data;
+        upper_data.reserve(local_upper_size);
+        lower_data.reserve(local_lower_size);
+        for(size_t i=0; i<num_local_chunks; i++)
+        {
+          upper_data.insert(upper_data.end(), upper_chunks[i].begin(), upper_chunks[i].end());
+          std::vector<char>().swap(upper_chunks[i]);
+          if(has_lower)
+          {
+            lower_data.insert(lower_data.end(), lower_chunks[i].begin(), lower_chunks[i].end());
+            std::vector<char>().swap(lower_chunks[i]);
+          }
+        }
+
+        //prefix scanで各プロセスの出力位置を決める
+        uint64_t local_sizes[4]={nmemb, local_upper_size, local_lower_size, num_local_chunks};
+        uint64_t offsets[4]={0, 0, 0, 0};
+        uint64_t totals[4]={0, 0, 0, 0};
+        MPI_Exscan(local_sizes, offsets, 4, MPI_UINT64_T, MPI_SUM, comm);
+        if(rank == 0)
+        {
+          //MPI_Exscanはrank 0の受信バッファを設定しない
+          memset(offsets, 0, sizeof(offsets));
+        }
+        MPI_Allreduce(local_sizes, totals, 4, MPI_UINT64_T, MPI_SUM, comm);
+        for(size_t i=0; i<num_local_chunks; i++)
+        {
+          local_index[i].element_offset+=offsets[0];
+          local_index[i].upper_offset+=offsets[1];
+          local_index[i].lower_offset+=offsets[2];
+        }
+
+        //rank 0にインデックスを集めてヘッダと共に出力する
+        const int send_size=(int)(num_local_chunks*sizeof(ContainerChunk));
+        std::vector<int> recv_sizes(rank == 0 ? nprocs : 0);
+        std::vector<int> displs(rank == 0 ? nprocs : 0);
+        MPI_Gather(const_cast<int*>(&send_size), 1, MPI_INT, data_pointer(recv_sizes), 1, MPI_INT, 0, comm);
+        std::vector<char> record_index;
+        if(rank == 0)
+        {
+          for(int i=1; i<nprocs; i++)
+          {
+            displs[i]=displs[i-1]+recv_sizes[i-1];
+          }
+          record_index.resize(Container::index_size(totals[3]));
+          ContainerHeader header;
+          Container::init_header(&header, sizeof(T));
+          header.num_chunks=totals[3];
+          header.num_elements=totals[0];
+          header.upper_data_size=totals[1];
+          header.lower_base=info->lower_position;
+          header.lower_data_size=totals[2];
+          memcpy(data_pointer(record_index), &header, sizeof(ContainerHeader));
+        }
+        char* recv_buffer = rank == 0 ? data_pointer(record_index)+sizeof(ContainerHeader) : NULL;
+        MPI_Gatherv(data_pointer(local_index), send_size, MPI_BYTE, recv_buffer, data_pointer(recv_sizes), data_pointer(displs), MPI_BYTE, 0, comm);
+        if(rank == 0)
+        {
+          if(write_at(info->fh_upper, info->upper_position, data_pointer(record_index), record_index.size()) != MPI_SUCCESS)
+          {
+            std::cerr<<"MPI_File_write_at failed (record index)"<<std::endl;
+            num_errors++;
+          }
+        }
+
+        //各プロセスの圧縮済データを集団出力
+        const MPI_Offset upper_data_position=info->upper_position+Container::index_size(totals[3]);
+        if(write_at_all(info->fh_upper, comm, upper_data_position+offsets[1], data_pointer(upper_data), local_upper_size) != MPI_SUCCESS)
+        {
+          std::cerr<<"MPI_File_write_at_all failed (upper bits)"<<std::endl;
+          num_errors++;
+        }
+        if(has_lower)
+        {
+          if(write_at_all(info->fh_lower, comm, info->lower_position+offsets[2], data_pointer(lower_data), local_lower_size) != MPI_SUCCESS)
+          {
+            std::cerr<<"MPI_File_write_at_all failed (lower bits)"<<std::endl;
+            num_errors++;
+          }
+        }
+        info->upper_position=upper_data_position+totals[1];
+        info->lower_position+=totals[2];
+        arena->trim();
+        return num_errors == 0 ? local_upper_size : 0;
+      }
+
+    //@brief 現在位置のレコードのヘッダとインデックスを読み込む (集団操作)
+    //
+    //rank 0が読み込んだものを他のプロセスへ配布する
+    //同じレコードに対して繰り返し呼ばれた時は前回読み込んだものを返す
+    bool load_record_index(MPIFileInfo* info)
+    {
+      if(info->has_index && info->index_position == info->upper_position)
+      {
+        return true;
+      }
+      info->has_index=false;
+      MPI_Comm comm=info->comm;
+      int rank=0;
+      MPI_Comm_rank(comm, &rank);
+      ContainerHeader* header=&(info->header);
+      std::vector<ContainerChunk>* chunks=&(info->chunks);
+      int status=0;
+      if(rank == 0)
+      {
+        if(read_at(info->fh_upper, info->upper_position, (char*)header, sizeof(ContainerHeader)) != MPI_SUCCESS)
+        {
+          std::cerr<<"MPI_File_read_at failed (record header)"<<std::endl;
+          status=-1;
+        }else if(!Container::is_valid_header(*header)){
+          std::cerr<<"invalid record header"<<std::endl;
+          status=-1;
+        }
+      }
+      MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+      if(status != 0)
+      {
+        return false;
+      }
+      MPI_Bcast(header, sizeof(ContainerHeader), MPI_BYTE, 0, comm);
+
+      chunks->resize(header->num_chunks);
+      const uint64_t index_bytes=header->num_chunks*sizeof(ContainerChunk);
+      if(rank == 0)
+      {
+        if(read_at(info->fh_upper, info->upper_position+sizeof(ContainerHeader), (char*)data_pointer(*chunks), index_bytes) != MPI_SUCCESS)
+        {
+          std::cerr<<"MPI_File_read_at failed (record index)"<<std::endl;
+          status=-1;
+        }
+      }
+      MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+      if(status != 0)
+      {
+        return false;
+      }
+      for(uint64_t position=0; position<index_bytes; position+=MAX_IO_SIZE)
+      {
+        const int count=(int)std::min(MAX_IO_SIZE, index_bytes-position);
+        MPI_Bcast((char*)data_pointer(*chunks)+position, count, MPI_BYTE, 0, comm);
+      }
+      info->index_position=info->upper_position;
+      info->has_index=true;
+      return true;
+    }
+
+    //@brief 現在位置のレコードを読み込み済として次のレコードへ進む
+    void skip_record(MPIFileInfo* info)
+    {
+      info->upper_position+=Container::record_size(info->header);
+      info->lower_position=info->header.lower_base+info->header.lower_data_size;
+    }
+
+    //@brief ファイル上で連続しているチャンクの圧縮済データをまとめて読み込む
+    //@param chunk_ids 読み込むチャンクの番号 (昇順)
+    //@param is_upper  上位bit側を読み込む時はtrue
+    //@param buffers   読み込んだデータを格納する領域 (連続したチャンク毎に1つ)
+    //@param pointers  各チャンクの圧縮済データの先頭位置
+    bool read_chunks(MPIFileInfo* info, const std::vector<size_t>& chunk_ids, const bool& is_upper, std::vector<std::vector<char> >* buffers, std::vector<const char*>* pointers)
+    {
+      const ContainerHeader& header=info->header;
+      const std::vector<ContainerChunk>& chunks=info->chunks;
+      MPI_File fh = is_upper ? info->fh_upper : info->fh_lower;
+      const MPI_Offset base = is_upper ? info->upper_position+Container::index_size(header.num_chunks) : header.lower_base;
+
+      //先に連続している範囲を数えて領域を確保しておく
+      std::vector<size_t> span_heads;
+      for(size_t i=0; i<chunk_ids.size(); i++)
+      {
+        if(i == 0 || chunk_ids[i] != chunk_ids[i-1]+1)
+        {
+          span_heads.push_back(i);
+        }
+      }
+      span_heads.push_back(chunk_ids.size());
+      buffers->resize(span_heads.size()-1);
+      pointers->resize(chunk_ids.size());
+
+      for(size_t s=0; s+1<span_heads.size(); s++)
+      {
+        const ContainerChunk& head=chunks[chunk_ids[span_heads[s]]];
+        const ContainerChunk& tail=chunks[chunk_ids[span_heads[s+1]-1]];
+        const uint64_t head_offset = is_upper ? head.upper_offset : head.lower_offset;
+        const uint64_t tail_end    = is_upper ? tail.upper_offset+tail.upper_size : tail.lower_offset+tail.lower_size;
+        std::vector<char>& buffer=(*buffers)[s];
+        buffer.resize(tail_end-head_offset);
+        if(read_at(fh, base+head_offset, data_pointer(buffer), buffer.size()) != MPI_SUCCESS)
+        {
+          std::cerr<<"MPI_File_read_at failed ("<<(is_upper ? "upper" : "lower")<<" bits)"<<std::endl;
+          return false;
+        }
+        for(size_t i=span_heads[s]; i<span_heads[s+1]; i++)
+        {
+          const ContainerChunk& chunk=chunks[chunk_ids[i]];
+          (*pointers)[i]=data_pointer(buffer)+((is_upper ? chunk.upper_offset : chunk.lower_offset)-head_offset);
+        }
+      }
+      return true;
+    }
+
+    //@brief 現在位置のレコードから指定された範囲の要素を読み込んでデコードする
+    //@param ranges 読み込む範囲 (レコード内での位置の昇順)
+    //@param data   読み込んだデータを格納する領域
+    //@ret   エラーが発生したチャンクの数
+    //
+    //必要なチャンクの圧縮済データだけを読み込み、伸長とデコードはチャンク毎に並列に行う
+    template <typename T>
+      int read_ranges(MPIFileInfo* info, const std::vector<ContainerRange>& ranges, T* data)
+      {
+        const std::vector<ContainerChunk>& chunks=info->chunks;
+        std::vector<size_t> chunk_ids;
+        Container::find_chunks(chunks, ranges, &chunk_ids);
+        if(chunk_ids.empty())
+        {
+          return 0;
+        }
+        const bool has_lower = info->fh_lower != MPI_FILE_NULL;
+        std::vector<std::vector<char> > upper_buffers;
+        std::vector<std::vector<char> > lower_buffers;
+        std::vector<const char*> upper_pointers;
+        std::vector<const char*> lower_pointers;
+        if(!read_chunks(info, chunk_ids, true, &upper_buffers, &upper_pointers))
+        {
+          return 1;
+        }
+        if(has_lower && !read_chunks(info, chunk_ids, false, &lower_buffers, &lower_pointers))
+        {
+          return 1;
+        }
+
+        int num_errors=0;
+#ifdef USE_OPENMP
+#pragma omp parallel reduction(+:num_errors)
+#endif
+        {
+          IO* io=IOFactory(info->compression_method, info->buffer_size);
+          std::vector<T> upper_work;
+          std::vector<T> lower_work;
+#ifdef USE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+          for(size_t i=0; i<chunk_ids.size(); i++)
+          {
+            const ContainerChunk& chunk=chunks[chunk_ids[i]];
+            const uint64_t chunk_last=chunk.element_offset+chunk.num_elements;
+            const size_t first_range=Container::find_range(ranges, chunk.element_offset);
+
+            //チャンク全体が1つの範囲に含まれる時は読み込み先の領域へ直接伸長する
+            const ContainerRange& range=ranges[first_range];
+            const bool whole_chunk = range.first <= chunk.element_offset && chunk_last <= range.first+range.count;
+            T* upper=NULL;
+            if(whole_chunk)
+            {
+              upper=data+range.dst_offset+(chunk.element_offset-range.first);
+            }else{
+              upper_work.resize(chunk.num_elements);
+              upper=data_pointer(upper_work);
+            }
+            if(Container::decompress_from_memory(io, upper_pointers[i], chunk.upper_size, upper, sizeof(T), chunk.num_elements) == 0)
+            {
+              num_errors++;
+              continue;
+            }
+            if(has_lower)
+            {
+              lower_work.resize(chunk.num_elements);
+              if(Container::decompress_from_memory(io, lower_pointers[i], chunk.lower_size, data_pointer(lower_work), sizeof(T), chunk.num_elements) == 0)
+              {
+                num_errors++;
+                continue;
+              }
+              decode<T>(chunk.num_elements, upper, data_pointer(lower_work), upper);
+            }
+            if(whole_chunk)
+            {
+              continue;
+            }
+            for(size_t r=first_range; r<ranges.size() && ranges[r].first < chunk_last; r++)
+            {
+              const uint64_t copy_first=std::max(ranges[r].first, chunk.element_offset);
+              const uint64_t copy_last=std::min(ranges[r].first+ranges[r].count, chunk_last);
+              std::copy(upper+(copy_first-chunk.element_offset), upper+(copy_last-chunk.element_offset), data+ranges[r].dst_offset+(copy_first-ranges[r].first));
+            }
+          }
+          delete io;
+        }
+        return num_errors;
+      }
+
+    //@brief 現在位置のレコードを読み込む準備をする (集団操作)
+    template <typename T>
+      bool prepare_read(MPIFileInfo* info)
+      {
+        if(!load_record_index(info))
+        {
+          return false;
+        }
+        if(info->header.element_size != sizeof(T))
+        {
+          std::cerr<<"element size mismatch (file: "<<info->header.element_size<<", argument: "<<sizeof(T)<<")"<<std::endl;
+          skip_record(info);
+          return false;
+        }
+        return true;
+      }
+
+    template <typename T>
+      size_t mpi_fread_range_helper(T* data, const uint64_t& first, const uint64_t& nmemb, MPIFileInfo* info)
+      {
+        if(!prepare_read<T>(info))
+        {
+          return 0;
+        }
+        const uint64_t num_elements=info->header.num_elements;
+        std::vector<ContainerRange> ranges;
+        ContainerRange range;
+        range.first=first;
+        range.count = first < num_elements ? std::min(nmemb, num_elements-first) : 0;
+        range.dst_offset=0;
+        if(range.count > 0)
+        {
+          ranges.push_back(range);
+        }
+        const int num_errors=read_ranges(info, ranges, data);
+        skip_record(info);
+        return num_errors == 0 ? range.count : 0;
+      }
+
+    template <typename T>
+      size_t mpi_fread_helper(T* data, size_t nmemb, MPIFileInfo* info)
+      {
+        //レコードの先頭からランク順にnmemb個ずつ割り当てる
+        MPI_Comm comm=info->comm;
+        int rank=0;
+        MPI_Comm_rank(comm, &rank);
+        uint64_t local_size=nmemb;
+        uint64_t first=0;
+        MPI_Exscan(&local_size, &first, 1, MPI_UINT64_T, MPI_SUM, comm);
+        if(rank == 0)
+        {
+          first=0;
+        }
+        return mpi_fread_range_helper(data, first, local_size, info);
+      }
+
+    template <typename T>
+      size_t mpi_fread_subarray_helper(T* data, const size_t dims[3], const size_t start[3], const size_t count[3], MPIFileInfo* info)
+      {
+        if(!prepare_read<T>(info))
+        {
+          return 0;
+        }
+        std::vector<ContainerRange> ranges;
+        const bool valid_dims = (uint64_t)dims[0]*dims[1]*dims[2] == info->header.num_elements;
+        if(!valid_dims || !Container::subarray_to_ranges(dims, start, count, &ranges))
+        {
+          std::cerr<<"invalid subarray specified"<<std::endl;
+          skip_record(info);
+          return 0;
+        }
+        const int num_errors=read_ranges(info, ranges, data);
+        skip_record(info);
+        return num_errors == 0 ? count[0]*count[1]*count[2] : 0;
+      }
+
+    int open_file(MPI_Comm comm, const std::string& filename, const bool& is_write, MPI_File* fh)
+    {
+      const int amode = is_write ? (MPI_MODE_WRONLY|MPI_MODE_CREATE) : MPI_MODE_RDONLY;
+      int err=MPI_File_open(comm, const_cast<char*>(filename.c_str()), amode, MPI_INFO_NULL, fh);
+      if(err != MPI_SUCCESS)
+      {
+        std::cerr<<"MPI_File_open failed ("<<filename<<")"<<std::endl;
+        *fh=MPI_FILE_NULL;
+        return err;
+      }
+      if(is_write)
+      {
+        err=MPI_File_set_size(*fh, 0);
+      }
+      return err;
+    }
+
+    void close_file(MPIFileInfo* info)
+    {
+      if(info->fh_upper != MPI_FILE_NULL)
+      {
+        MPI_File_close(&(info->fh_upper));
+      }
+      if(info->fh_lower != MPI_FILE_NULL)
+      {
+        MPI_File_close(&(info->fh_lower));
+      }
+      if(info->comm != MPI_COMM_NULL)
+      {
+        MPI_Comm_free(&(info->comm));
+      }
+    }
+  }//end of unnamed namespace
+
+  int mpi_fopen(MPI_Comm comm, const std::string& filename_upper, const std::string& filename_lower, const char* mode, const std::string& comp, const size_t& buff_size, const size_t& chunk_elements)
+  {
+    if(filename_upper == "")
+    {
+      std::cerr<<"filename for upper bits is empty !!"<<std::endl;
+      return -300;
+    }
+    if(filename_upper == filename_lower)
+    {
+      std::cerr<<"same filename specified for upper and lower bits !!"<<std::endl;
+      return -400;
+    }
+    const bool is_read  = strchr(mode, 'r') != NULL;
+    const bool is_write = strchr(mode, 'w') != NULL;
+    if(is_read == is_write)
+    {
+      std::cerr<<"mode must contain either 'r' or 'w' ("<<mode<<")"<<std::endl;
+      return -500;
+    }
+    if(chunk_elements == 0)
+    {
+      std::cerr<<"chunk_elements must be greater than 0"<<std::endl;
+      return -600;
+    }
+
+    MPIFileInfo* info=new MPIFileInfo;
+    info->compression_method=comp;
+    info->buffer_size=buff_size;
+    info->chunk_elements=chunk_elements;
+    MPI_Comm_dup(comm, &(info->comm));
+
+    int err=open_file(info->comm, filename_upper, is_write, &(info->fh_upper));
+    if(err == MPI_SUCCESS && filename_lower != "")
+    {
+      err=open_file(info->comm, filename_lower, is_write, &(info->fh_lower));
+    }
+    if(err != MPI_SUCCESS)
+    {
+      close_file(info);
+      delete info;
+      return -1;
+    }
+    return MPIFileInfoManager::GetInstance().add(info);
+  }
+
+  void mpi_fclose(const int& key)
+  {
+    MPIFileInfo* info=MPIFileInfoManager::GetInstance().remove(key);
+    if(info == NULL)
+    {
+      return;
+    }
+    close_file(info);
+    delete info;
+  }
+
+  template <typename T>
+    size_t mpi_fwrite(const T* ptr, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc)
+    {
+      MPIFileInfo* info=MPIFileInfoManager::GetInstance().find(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      Encoder<T>* encoder=EncoderFactory<T>(enc, tolerance, is_relative);
+      const size_t output_size=mpi_fwrite_helper(ptr, nmemb, info, *encoder);
+      delete encoder;
+      return output_size;
+    }
+
+  template <typename T>
+    size_t mpi_fread(T* ptr, size_t nmemb, const int& key)
+    {
+      MPIFileInfo* info=MPIFileInfoManager::GetInstance().find(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      return mpi_fread_helper(ptr, nmemb, info);
+    }
+
+  size_t mpi_get_record_elements(const int& key)
+  {
+    MPIFileInfo* info=MPIFileInfoManager::GetInstance().find(key);
+    if(info == NULL || !load_record_index(info))
+    {
+      return 0;
+    }
+    return info->header.num_elements;
+  }
+
+  template <typename T>
+    size_t mpi_fread_range(T* ptr, size_t first, size_t nmemb, const int& key)
+    {
+      MPIFileInfo* info=MPIFileInfoManager::GetInstance().find(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      return mpi_fread_range_helper(ptr, first, nmemb, info);
+    }
+
+  template <typename T>
+    size_t mpi_fread_subarray(T* ptr, const size_t dims[3], const size_t start[3], const size_t count[3], const int& key)
+    {
+      MPIFileInfo* info=MPIFileInfoManager::GetInstance().find(key);
+      if(info == NULL)
+      {
+        return 0;
+      }
+      return mpi_fread_subarray_helper(ptr, dims, start, count, info);
+    }
+
+  template size_t mpi_fwrite(const float* ptr, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc);
+  template size_t mpi_fwrite(const double* ptr, size_t nmemb, const int& key, const float& tolerance, const bool& is_relative, const std::string& enc);
+  template size_t mpi_fread(float* ptr, size_t nmemb, const int& key);
+  template size_t mpi_fread(double* ptr, size_t nmemb, const int& key);
+  template size_t mpi_fread_range(float* ptr, size_t first, size_t nmemb, const int& key);
+  template size_t mpi_fread_range(double* ptr, size_t first, size_t nmemb, const int& key);
+  template size_t mpi_fread_subarray(float* ptr, const size_t dims[3], const size_t start[3], const size_t count[3], const int& key);
+  template size_t mpi_fread_subarray(double* ptr, const size_t dims[3], const size_t start[3], const size_t count[3], const int& key);
+}//end of namespace JHPCNDF
+
+
+//
+// implementation of C Interface routines (MPI-IO)
+//
+int JHPCNDF_mpi_fopen(MPI_Comm comm, const char* filename_upper, const char* filename_lower, const char* mode, const char* comp, const size_t buff_size, const size_t chunk_elements)
+{
+  return JHPCNDF::mpi_fopen(comm, filename_upper, filename_lower, mode, comp, buff_size, chunk_elements);
+}
+void JHPCNDF_mpi_fclose(const int key)
+{
+  JHPCNDF::mpi_fclose(key);
+}
+size_t JHPCNDF_mpi_fwrite_float(const float* ptr, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc)
+{
+  return JHPCNDF::mpi_fwrite(ptr, nmemb, key, tolerance, is_relative, enc);
+}
+size_t JHPCNDF_mpi_fwrite_double(const double* ptr, size_t nmemb, const int key, const float tolerance, const int is_relative, const char* enc)
+{
+  return JHPCNDF::mpi_fwrite(ptr, nmemb, key, tolerance, is_relative, enc);
+}
+size_t JHPCNDF_mpi_fread_float(float* ptr, size_t nmemb, const int key)
+{
+  return JHPCNDF::mpi_fread(ptr, nmemb, key);
+}
+size_t JHPCNDF_mpi_fread_double(double* ptr, size_t nmemb, const int key)
+{
+  return JHPCNDF::mpi_fread(ptr, nmemb, key);
+}
+size_t JHPCNDF_mpi_get_record_elements(const int key)
+{
+  return JHPCNDF::mpi_get_record_elements(key);
+}
+size_t JHPCNDF_mpi_fread_range_float(float* ptr, size_t first, size_t nmemb, const int key)
+{
+  return JHPCNDF::mpi_fread_range(ptr, first, nmemb, key);
+}
+size_t JHPCNDF_mpi_fread_range_double(double* ptr, size_t first, size_t nmemb, const int key)
+{
+  return JHPCNDF::mpi_fread_range(ptr, first, nmemb, key);
+}
+size_t JHPCNDF_mpi_fread_subarray_float(float* ptr, const size_t dims[3], const size_t start[3], const size_t count[3], const int key)
+{
+  return JHPCNDF::mpi_fread_subarray(ptr, dims, start, count, key);
+}
+size_t JHPCNDF_mpi_fread_subarray_double(double* ptr, const size_t dims[3], const size_t start[3], const size_t count[3], const int key)
+{
+  return JHPCNDF::mpi_fread_subarray(ptr, dims, start, count, key);
+}
@@ -0,0 +1,65 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file Mutex.h
+
+#ifndef JHPCNDF_MUTEX_H
+#define JHPCNDF_MUTEX_H
+#include <pthread.h>
+
+namespace JHPCNDF
+{
+  //@brief ライブラリ内部の共有データを保護するための排他ロック
+  //
+  //利用者のスレッドやライブラリ内部のスレッド(ReadViewの先読み等)から呼ばれるので、
+  //OpenMPの有無に関わらずpthreadのmutexで実装する
+  class Mutex
+  {
+    public:
+      Mutex()
+      {
+        pthread_mutex_init(&lock_, NULL);
+      }
+      ~Mutex()
+      {
+        pthread_mutex_destroy(&lock_);
+      }
+      void lock(void)
+      {
+        pthread_mutex_lock(&lock_);
+      }
+      void unlock(void)
+      {
+        pthread_mutex_unlock(&lock_);
+      }
+    private:
+      Mutex(const Mutex&);
+      Mutex& operator=(const Mutex&);
+      pthread_mutex_t lock_;
+  };
+
+  //@brief スコープを抜ける時に自動的にロックを解放するクラス
+  class ScopedLock
+  {
+    public:
+      explicit ScopedLock(Mutex& arg_mutex):mutex(arg_mutex)
+      {
+        mutex.lock();
+      }
+      ~ScopedLock()
+      {
+        mutex.unlock();
+      }
+    private:
+      ScopedLock(const ScopedLock&);
+      ScopedLock& operator=(const ScopedLock&);
+      Mutex& mutex;
+  };
+}//end of namespace JHPCNDF
+#endif
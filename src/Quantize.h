@@ -0,0 +1,388 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file Quantize.h
+
+#ifndef JHPCNDF_QUANTIZE_H
+#define JHPCNDF_QUANTIZE_H
+#include <string.h>
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+#include "Stream.h"
+
+//
+//quantizeエンコーダを指定してJHPCNDF::fwriteが出力するレコードの形式
+//
+//上位bit側ファイル
+//  QuantizedRecordHeader  (40 byte, 無圧縮)
+//  頻度表                 (header.num_symbols * 3 byte, シンボル(1byte)と頻度(2byte)の組)
+//  エスケープ領域         (header.escape_size byte)
+//  rANS符号列             (header.stream_size byte)
+//下位bit側ファイル
+//  圧縮済下位bitデータ    (元データと量子化後の値のXOR)
+//
+//上位bitの各要素は、ビン幅(header.step)の整数倍に量子化した値の整数部分を直前の要素との差分にし
+//zigzag変換した値をシンボルとしてrANSで符号化する
+//差分が大きい場合と量子化できなかった値(NaNやInfなど)は、エスケープシンボルを出力し
+//実際の値をエスケープ領域に要素順に格納する
+//数値は全て出力した環境のバイトオーダーで格納する
+//
+namespace JHPCNDF
+{
+  struct QuantizedRecordHeader
+  {
+    char     magic[4];        // "JQNT"
+    uint8_t  version;
+    uint8_t  element_size;    // 1要素のサイズ(float=4, double=8)
+    uint16_t num_symbols;     // 頻度表のエントリ数
+    uint64_t num_elements;
+    double   step;            // ビン幅 (0の時は全要素がエスケープ)
+    uint64_t escape_size;
+    uint64_t stream_size;
+  };
+
+  namespace Quantize
+  {
+    const uint8_t VERSION=1;
+
+    //@brief rANSの確率の精度(bit数)
+    const uint32_t SCALE_BITS=12;
+    const uint32_t PROB_SCALE=1u<<SCALE_BITS;
+    const uint32_t RANS_L=1u<<23;
+
+    //@brief 差分が大きいため、zigzag変換後の値(8byte)をエスケープ領域に格納したことを表すシンボル
+    const unsigned int LARGE=254;
+    //@brief 量子化できなかったため、元の値をエスケープ領域に格納したことを表すシンボル
+    const unsigned int RAW=255;
+    const unsigned int NUM_SYMBOLS=256;
+
+    inline const char* magic(void)
+    {
+      return "JQNT";
+    }
+
+    //@brief 許容誤差からビン幅を決める
+    //
+    //相対誤差の場合は、0でない有限値のうち絶対値が最小の値に対する許容誤差を使う
+    //ビン幅が決まらない場合(許容誤差が0の場合など)は0を返す
+    //@param stride srcの要素間隔
+    template <typename T>
+    inline double step(const size_t& length, const T* const src, const float& tolerance, const bool& is_relative, const size_t& stride=1)
+    {
+      double width=2.0*std::fabs((double)tolerance);
+      if(is_relative)
+      {
+        double min_value=0.0;
+        for(size_t i=0; i<length; i++)
+        {
+          const double value=std::fabs((double)src[i*stride]);
+          if(value > 0.0 && value-value == 0.0 && (min_value == 0.0 || value < min_value))
+          {
+            min_value=value;
+          }
+        }
+        width*=min_value;
+      }
+      return width > 0.0 && width-width == 0.0 ? width : 0.0;
+    }
+
+    //@brief 値をビン番号に変換する
+    //@ret   ビン番号が仮数部の精度で表せない場合はfalse
+    template <typename T>
+    inline bool quantize(const T& value, const double& step, int64_t* bin)
+    {
+      if(!(step > 0.0))
+      {
+        return false;
+      }
+      const double q=std::floor((double)value/step+0.5);
+      if(!(std::fabs(q) < 4503599627370496.0)) // 2^52 (NaN, Infもここで弾く)
+      {
+        return false;
+      }
+      *bin=(int64_t)q;
+      return true;
+    }
+
+    template <typename T>
+    inline T dequantize(const int64_t& bin, const double& step)
+    {
+      return (T)((double)bin*step);
+    }
+
+    inline uint64_t zigzag(const int64_t& value)
+    {
+      return ((uint64_t)value<<1)^(uint64_t)(value>>63);
+    }
+
+    inline int64_t unzigzag(const uint64_t& value)
+    {
+      return (int64_t)(value>>1)^-(int64_t)(value&1);
+    }
+
+    //@brief 出現回数を合計がPROB_SCALEになる頻度に正規化する
+    //
+    //出現したシンボルには必ず1以上の頻度を割り当てる
+    inline void normalize_frequencies(const std::vector<uint64_t>& counts, const uint64_t& total, std::vector<uint32_t>* freqs)
+    {
+      freqs->assign(NUM_SYMBOLS, 0);
+      if(total == 0)
+      {
+        return;
+      }
+      uint32_t sum=0;
+      for(unsigned int s=0; s<NUM_SYMBOLS; s++)
+      {
+        if(counts[s] > 0)
+        {
+          uint64_t f=counts[s]*PROB_SCALE/total;
+          (*freqs)[s] = f > 0 ? (uint32_t)f : 1;
+          sum+=(*freqs)[s];
+        }
+      }
+      //切り捨てで不足した分、または1に切り上げて超過した分を頻度の大きいシンボルで調整する
+      while(sum != PROB_SCALE)
+      {
+        unsigned int largest=0;
+        for(unsigned int s=1; s<NUM_SYMBOLS; s++)
+        {
+          if((*freqs)[s] > (*freqs)[largest])
+          {
+            largest=s;
+          }
+        }
+        if(sum < PROB_SCALE)
+        {
+          (*freqs)[largest]+=PROB_SCALE-sum;
+          sum=PROB_SCALE;
+        }else{
+          const uint32_t diff = sum-PROB_SCALE < (*freqs)[largest]-1 ? sum-PROB_SCALE : (*freqs)[largest]-1;
+          (*freqs)[largest]-=diff;
+          sum-=diff;
+        }
+      }
+    }
+
+    //@brief 上位bit側のデータを量子化レコードとして出力する
+    //@param upper QuantizeEncoderで生成した上位bit側のデータ
+    //@param step  エンコード時に使ったビン幅
+    //@ret   出力したサイズ(byte) エラー時は0
+    //
+    //upperの各要素はビン番号に戻せればそのまま、戻せなければ元の値としてエスケープ領域に格納するので
+    //read_recordで読み込んだ値はupperとbit単位で一致する
+    template <typename T>
+    size_t write_record(Stream* stream, const T* const upper, const size_t& length, const double& step)
+    {
+      std::vector<unsigned char> symbols(length);
+      std::vector<unsigned char> escapes;
+      std::vector<uint64_t> counts(NUM_SYMBOLS, 0);
+      int64_t prev=0;
+      for(size_t i=0; i<length; i++)
+      {
+        int64_t bin;
+        T value;
+        if(quantize(upper[i], step, &bin) && (value=dequantize<T>(bin, step), memcmp(&value, &(upper[i]), sizeof(T)) == 0))
+        {
+          const uint64_t diff=zigzag(bin-prev);
+          if(diff < LARGE)
+          {
+            symbols[i]=(unsigned char)diff;
+          }else{
+            symbols[i]=LARGE;
+            const unsigned char* p=reinterpret_cast<const unsigned char*>(&diff);
+            escapes.insert(escapes.end(), p, p+sizeof(diff));
+          }
+          prev=bin;
+        }else{
+          symbols[i]=RAW;
+          const unsigned char* p=reinterpret_cast<const unsigned char*>(&(upper[i]));
+          escapes.insert(escapes.end(), p, p+sizeof(T));
+        }
+        counts[symbols[i]]++;
+      }
+
+      std::vector<uint32_t> freqs;
+      normalize_frequencies(counts, length, &freqs);
+      std::vector<uint32_t> cumulative(NUM_SYMBOLS, 0);
+      std::vector<unsigned char> table;
+      for(unsigned int s=0; s<NUM_SYMBOLS; s++)
+      {
+        cumulative[s] = s > 0 ? cumulative[s-1]+freqs[s-1] : 0;
+        if(freqs[s] > 0)
+        {
+          const uint16_t f=(uint16_t)freqs[s];
+          table.push_back((unsigned char)s);
+          table.insert(table.end(), reinterpret_cast<const unsigned char*>(&f), reinterpret_cast<const unsigned char*>(&f)+sizeof(f));
+        }
+      }
+
+      //rANSは後ろの要素から符号化し、出力も後ろから詰める
+      //1シンボルあたり高々SCALE_BITS bitなので、2byte/要素あれば足りる
+      std::vector<unsigned char> buffer(2*length+sizeof(uint32_t));
+      unsigned char* const end = buffer.empty() ? NULL : &(buffer[0])+buffer.size();
+      unsigned char* ptr=end;
+      if(length > 0)
+      {
+        uint32_t x=RANS_L;
+        for(size_t i=length; i>0; i--)
+        {
+          const unsigned int s=symbols[i-1];
+          const uint32_t x_max=((RANS_L>>SCALE_BITS)<<8)*freqs[s];
+          while(x >= x_max)
+          {
+            *--ptr=(unsigned char)(x&0xff);
+            x>>=8;
+          }
+          x=((x/freqs[s])<<SCALE_BITS)+(x%freqs[s])+cumulative[s];
+        }
+        //復号時に上位byteから読めるように、最上位byteが先頭に来るように詰める
+        for(int b=0; b<4; b++)
+        {
+          *--ptr=(unsigned char)(x>>(8*b));
+        }
+      }
+
+      QuantizedRecordHeader header;
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, magic(), 4);
+      header.version=VERSION;
+      header.element_size=sizeof(T);
+      header.num_symbols=(uint16_t)(table.size()/3);
+      header.num_elements=length;
+      header.step=step;
+      header.escape_size=escapes.size();
+      header.stream_size=end-ptr;
+      if(stream->write(&header, sizeof(header)) != sizeof(header) ||
+         (!table.empty()   && stream->write(&(table[0]),   table.size())   != table.size()) ||
+         (!escapes.empty() && stream->write(&(escapes[0]), escapes.size()) != escapes.size()) ||
+         (header.stream_size > 0 && stream->write(ptr, header.stream_size) != header.stream_size))
+      {
+        return 0;
+      }
+      return sizeof(header)+table.size()+escapes.size()+header.stream_size;
+    }
+
+    //@brief 入力元の先頭がlength要素のT型の量子化レコードかどうかを判定する
+    //
+    //判定のために読み込んだ分は読んでいないことにする
+    template <typename T>
+    bool is_record(Stream* stream, const size_t& length)
+    {
+      QuantizedRecordHeader header;
+      const size_t header_size=stream->read(&header, sizeof(header));
+      stream->unread(header_size);
+      return header_size == sizeof(header) && memcmp(header.magic, magic(), 4) == 0 &&
+        header.version == VERSION && header.element_size == sizeof(T) && header.num_elements == length;
+    }
+
+    //@brief 量子化レコードを読み込んで上位bit側のデータに戻す
+    //@ret   読み込みに成功したかどうか
+    template <typename T>
+    bool read_record(Stream* stream, T* const dst, const size_t& length)
+    {
+      QuantizedRecordHeader header;
+      if(stream->read(&header, sizeof(header)) != sizeof(header) || memcmp(header.magic, magic(), 4) != 0 ||
+         header.element_size != sizeof(T) || header.num_elements != length || header.num_symbols > NUM_SYMBOLS)
+      {
+        return false;
+      }
+      std::vector<unsigned char> table(3*header.num_symbols);
+      std::vector<unsigned char> escapes(header.escape_size);
+      std::vector<unsigned char> buffer(header.stream_size);
+      if((!table.empty()   && stream->read(&(table[0]),   table.size())   != table.size()) ||
+         (!escapes.empty() && stream->read(&(escapes[0]), escapes.size()) != escapes.size()) ||
+         (!buffer.empty()  && stream->read(&(buffer[0]),  buffer.size())  != buffer.size()))
+      {
+        return false;
+      }
+      if(length == 0)
+      {
+        return true;
+      }
+
+      std::vector<uint32_t> freqs(NUM_SYMBOLS, 0);
+      std::vector<uint32_t> cumulative(NUM_SYMBOLS, 0);
+      std::vector<unsigned char> slot_to_symbol(PROB_SCALE);
+      uint32_t total=0;
+      for(size_t e=0; e<header.num_symbols; e++)
+      {
+        uint16_t f;
+        memcpy(&f, &(table[3*e+1]), sizeof(f));
+        freqs[table[3*e]]=f;
+      }
+      for(unsigned int s=0; s<NUM_SYMBOLS; s++)
+      {
+        cumulative[s]=total;
+        if(total+freqs[s] > PROB_SCALE)
+        {
+          return false;
+        }
+        if(freqs[s] > 0)
+        {
+          memset(&(slot_to_symbol[total]), s, freqs[s]);
+          total+=freqs[s];
+        }
+      }
+      if(total != PROB_SCALE || buffer.size() < sizeof(uint32_t))
+      {
+        return false;
+      }
+
+      const unsigned char* ptr=&(buffer[0]);
+      const unsigned char* const end=ptr+buffer.size();
+      uint32_t x=0;
+      for(int b=0; b<4; b++)
+      {
+        x=(x<<8)|*ptr++;
+      }
+      size_t escape_pos=0;
+      int64_t prev=0;
+      for(size_t i=0; i<length; i++)
+      {
+        const uint32_t slot=x&(PROB_SCALE-1);
+        const unsigned int s=slot_to_symbol[slot];
+        x=freqs[s]*(x>>SCALE_BITS)+slot-cumulative[s];
+        while(x < RANS_L)
+        {
+          if(ptr == end)
+          {
+            return false;
+          }
+          x=(x<<8)|*ptr++;
+        }
+
+        if(s == RAW)
+        {
+          if(escape_pos+sizeof(T) > escapes.size())
+          {
+            return false;
+          }
+          memcpy(&(dst[i]), &(escapes[escape_pos]), sizeof(T));
+          escape_pos+=sizeof(T);
+          continue;
+        }
+        uint64_t diff=s;
+        if(s == LARGE)
+        {
+          if(escape_pos+sizeof(diff) > escapes.size())
+          {
+            return false;
+          }
+          memcpy(&diff, &(escapes[escape_pos]), sizeof(diff));
+          escape_pos+=sizeof(diff);
+        }
+        prev+=unzigzag(diff);
+        dst[i]=dequantize<T>(prev, header.step);
+      }
+      return true;
+    }
+  }//end of namespace Quantize
+}//end of namespace JHPCNDF
+#endif
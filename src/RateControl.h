@@ -0,0 +1,204 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file RateControl.h
+
+#ifndef JHPCNDF_RATE_CONTROL_H
+#define JHPCNDF_RATE_CONTROL_H
+#include <cmath>
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "Encoder.h"
+#include "IO.h"
+#include "Stream.h"
+#include "Quantize.h"
+
+namespace JHPCNDF
+{
+  //@brief 配列から抜き出したサンプルをエンコード、圧縮して、配列全体を出力した時のサイズを推定するクラス
+  //
+  //配列を等分した区間毎に1つずつ、区間内の位置を擬似乱数で決めたチャンクをサンプルとする
+  //zlibIOは区間毎に圧縮パラメータを切り替えるので、離れた位置のチャンクを連結せずにチャンク毎に圧縮する
+  //配列がサンプルの合計より小さい時は配列全体をサンプルとするので、推定値は実際の出力サイズと一致する
+  template <typename T>
+  class SizeEstimator
+  {
+    public:
+      //@param data           推定対象の配列
+      //@param nmemb          配列の要素数
+      //@param chunk_elements 1チャンクの要素数
+      //@param num_chunks     サンプルとして使うチャンク数
+      SizeEstimator(const T* data, const size_t& nmemb, const size_t& chunk_elements=8192, const size_t& num_chunks=32)
+        :total(nmemb), chunk_length(nmemb), min_magnitude(0.0)
+      {
+        const size_t length = chunk_elements > 0 ? chunk_elements : 1;
+        if(nmemb <= length*num_chunks || num_chunks == 0)
+        {
+          sample.assign(data, data+nmemb);
+        }else{
+          chunk_length=length;
+          const size_t stratum=nmemb/num_chunks;
+          const size_t range = stratum >= length ? stratum-length+1 : 1;
+          uint32_t seed=(uint32_t)nmemb;
+          sample.resize(length*num_chunks);
+          for(size_t c=0; c<num_chunks; c++)
+          {
+            seed=seed*1664525u+1013904223u;
+            const size_t start=c*stratum+(size_t)(((uint64_t)seed*range)>>32);
+            std::copy(data+start, data+start+length, sample.begin()+c*length);
+          }
+        }
+        // quantizeエンコーダのビン幅は配列全体の最小値で決まるので、ここで1度だけ求めておく
+        min_magnitude=Quantize::step(nmemb, data, 0.5f, true);
+      }
+
+      //@brief 配列全体をエンコード、圧縮した時の出力サイズを推定する
+      //@param enc         エンコーダの種類
+      //@param tolerance   許容誤差
+      //@param is_relative 許容誤差を相対値で指定するかどうかのフラグ
+      //@param io          圧縮に使うIOクラス
+      //@param upper_size  上位bit側の推定サイズ
+      //@param lower_size  下位bit側の推定サイズ (NULLの場合は推定しない)
+      void estimate(const std::string& enc, const float& tolerance, const bool& is_relative, IO* io, size_t* upper_size, size_t* lower_size=NULL) const
+      {
+        *upper_size=0;
+        if(lower_size != NULL)
+        {
+          *lower_size=0;
+        }
+        if(sample.empty())
+        {
+          return;
+        }
+        const size_t length=sample.size();
+        std::vector<T> upper(length);
+        std::vector<T> lower(lower_size != NULL ? length : 0);
+        T* const dst_lower = lower_size != NULL ? &(lower[0]) : NULL;
+        MemoryOutputStream upper_stream;
+        if(enc == "quantize")
+        {
+          double step=2.0*std::fabs((double)tolerance)*(is_relative ? min_magnitude : 1.0);
+          step = step-step == 0.0 ? step : 0.0;
+          QuantizeEncoder<T> encoder(tolerance, is_relative, step);
+          encoder(length, &(sample[0]), &(upper[0]), dst_lower);
+          Quantize::write_record(&upper_stream, &(upper[0]), length, step);
+        }else{
+          Encoder<T>* encoder=EncoderFactory<T>(enc, tolerance, is_relative);
+          (*encoder)(length, &(sample[0]), &(upper[0]), dst_lower);
+          delete encoder;
+          compress(io, &(upper[0]), &upper_stream);
+        }
+        *upper_size=scale(upper_stream.tell());
+        if(lower_size != NULL)
+        {
+          MemoryOutputStream lower_stream;
+          compress(io, dst_lower, &lower_stream);
+          *lower_size=scale(lower_stream.tell());
+        }
+      }
+
+      //@brief 上位bit側の推定サイズがtarget_size以下になる最小の許容誤差を探す
+      //
+      //許容誤差を対数軸上で二分探索する
+      //最も緩い許容誤差でも目標に届かない場合はその許容誤差を返す
+      float search_tolerance(const std::string& enc, const bool& is_relative, IO* io, const size_t& target_size) const
+      {
+        double lower_bound=0.0;
+        double upper_bound=0.0;
+        tolerance_range(is_relative, &lower_bound, &upper_bound);
+        if(fits(enc, (float)lower_bound, is_relative, io, target_size))
+        {
+          return (float)lower_bound;
+        }
+        if(!fits(enc, (float)upper_bound, is_relative, io, target_size))
+        {
+          return (float)upper_bound;
+        }
+        double lo=std::log(lower_bound);
+        double hi=std::log(upper_bound);
+        for(int i=0; i<SEARCH_ITERATIONS; i++)
+        {
+          const double mid=0.5*(lo+hi);
+          if(fits(enc, (float)std::exp(mid), is_relative, io, target_size))
+          {
+            hi=mid;
+          }else{
+            lo=mid;
+          }
+        }
+        return (float)std::exp(hi);
+      }
+
+      //@brief サンプルの要素数
+      size_t sample_size(void) const
+      {
+        return sample.size();
+      }
+
+    private:
+      static const int SEARCH_ITERATIONS=16;
+
+      bool fits(const std::string& enc, const float& tolerance, const bool& is_relative, IO* io, const size_t& target_size) const
+      {
+        size_t upper_size=0;
+        estimate(enc, tolerance, is_relative, io, &upper_size);
+        return upper_size <= target_size;
+      }
+
+      //@brief 探索する許容誤差の範囲
+      //
+      //相対誤差の場合は仮数部の最下位bit相当から1まで、絶対誤差の場合はサンプルの最大絶対値を基準にする
+      void tolerance_range(const bool& is_relative, double* lower_bound, double* upper_bound) const
+      {
+        const double epsilon = sizeof(T) == 4 ? 1.0/(1<<23) : 1.0/(1<<26)/(1<<26);
+        double max_magnitude=1.0;
+        if(!is_relative)
+        {
+          max_magnitude=0.0;
+          for(size_t i=0; i<sample.size(); i++)
+          {
+            const double value=std::fabs((double)sample[i]);
+            if(value-value == 0.0 && value > max_magnitude)
+            {
+              max_magnitude=value;
+            }
+          }
+          if(!(max_magnitude > 0.0) || max_magnitude > 1.0e38)
+          {
+            max_magnitude=1.0;
+          }
+        }
+        *lower_bound=max_magnitude*epsilon;
+        *upper_bound=max_magnitude;
+      }
+
+      //@brief サンプルをチャンク毎に圧縮してstreamへ出力する
+      void compress(IO* io, const T* const src, Stream* stream) const
+      {
+        for(size_t offset=0; offset<sample.size(); offset+=chunk_length)
+        {
+          io->fwrite(src+offset, sizeof(T), chunk_length, stream);
+        }
+      }
+
+      //@brief サンプルの出力サイズを配列全体のサイズに換算する
+      size_t scale(const size_t& size) const
+      {
+        return sample.size() == total ? size : (size_t)((double)size*total/sample.size()+0.5);
+      }
+
+      std::vector<T> sample;
+      const size_t total;
+      size_t chunk_length;
+      double min_magnitude;
+  };
+}//end of namespace JHPCNDF
+#endif
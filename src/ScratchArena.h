@@ -0,0 +1,192 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file ScratchArena.h
+
+#ifndef JHPCNDF_SCRATCH_ARENA_H
+#define JHPCNDF_SCRATCH_ARENA_H
+#include <stdlib.h>
+#include <stdint.h>
+#include <iostream>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace JHPCNDF
+{
+  //@brief エンコード/デコード時の作業領域を呼び出しをまたいで再利用するためのクラス
+  //
+  //作業領域はスロット単位で管理し、要求されたサイズが確保済の領域より大きい時だけ再確保する
+  //Linuxでは大きな領域を2MB境界に揃えてmmapで確保し、madviseでhuge pageの使用を要求する
+  //(ページフォルトの回数を減らすため)
+  class ScratchArena
+  {
+    public:
+      enum Slot
+      {
+        UPPER=0,
+        LOWER,
+        WORK,
+        NUM_SLOTS
+      };
+
+      ScratchArena():capacity((size_t)-1)
+      {
+        for(int i=0; i<NUM_SLOTS; i++)
+        {
+          buffers[i].ptr=NULL;
+          buffers[i].base=NULL;
+          buffers[i].size=0;
+          buffers[i].mapped_size=0;
+        }
+      }
+      ~ScratchArena()
+      {
+        release();
+      }
+
+      //@brief 指定されたスロットの作業領域へのポインタを返す
+      //@param slot 使用するスロット
+      //@param size 必要な領域のサイズ(Byte)
+      //@ret   確保に失敗した場合はNULL
+      void* get(const Slot& slot, const size_t& size)
+      {
+        Buffer& buff=buffers[slot];
+        if(buff.ptr != NULL && buff.size >= size)
+        {
+          return buff.ptr;
+        }
+        free_buffer(&buff);
+        allocate(&buff, size);
+        return buff.ptr;
+      }
+
+      //@brief 確保済の全ての作業領域を解放する
+      void release(void)
+      {
+        for(int i=0; i<NUM_SLOTS; i++)
+        {
+          free_buffer(&(buffers[i]));
+        }
+      }
+
+      //@brief 呼び出しをまたいで保持する作業領域の合計サイズの上限を設定する
+      //@param size 上限サイズ(Byte) 0を指定した場合は呼び出し毎に解放する
+      void set_capacity(const size_t& size)
+      {
+        capacity=size;
+        trim();
+      }
+      size_t get_capacity(void) const
+      {
+        return capacity;
+      }
+
+      //@brief 現在保持している作業領域の合計サイズを返す
+      size_t allocated_size(void) const
+      {
+        size_t total=0;
+        for(int i=0; i<NUM_SLOTS; i++)
+        {
+          total+=buffers[i].size;
+        }
+        return total;
+      }
+
+      //@brief 保持している領域が上限を越えていたら全て解放する
+      //
+      //fwrite/fread等の1回の呼び出しが終わる毎に呼ぶこと
+      void trim(void)
+      {
+        if(allocated_size() > capacity)
+        {
+          release();
+        }
+      }
+
+    private:
+      ScratchArena(const ScratchArena&);
+      ScratchArena& operator=(const ScratchArena&);
+
+      struct Buffer
+      {
+        void*  ptr;         // 利用者に返すアドレス
+        void*  base;        // mmapで確保した領域の先頭 (mallocで確保した時はNULL)
+        size_t size;        // 利用可能なサイズ
+        size_t mapped_size; // mmapで確保したサイズ
+      };
+
+      static size_t huge_page_size(void)
+      {
+        return 2*1024*1024;
+      }
+
+      void allocate(Buffer* buff, const size_t& size)
+      {
+        if(size == 0)
+        {
+          return;
+        }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if(size >= huge_page_size())
+        {
+          const size_t align=huge_page_size();
+          const size_t rounded_size=(size+align-1)/align*align;
+
+          // 2MB境界に揃えるため1page分余分に確保して前後を切り落とす
+          const size_t mapped_size=rounded_size+align;
+          void* base=mmap(NULL, mapped_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+          if(base != MAP_FAILED)
+          {
+            uintptr_t head=(uintptr_t)base;
+            uintptr_t aligned=(head+align-1)/align*align;
+            size_t head_size=aligned-head;
+            size_t tail_size=mapped_size-head_size-rounded_size;
+            if(head_size > 0) munmap(base, head_size);
+            if(tail_size > 0) munmap((void*)(aligned+rounded_size), tail_size);
+            madvise((void*)aligned, rounded_size, MADV_HUGEPAGE);
+            buff->base=(void*)aligned;
+            buff->ptr=(void*)aligned;
+            buff->size=rounded_size;
+            buff->mapped_size=rounded_size;
+            return;
+          }
+        }
+#endif
+        buff->ptr=malloc(size);
+        if(buff->ptr == NULL)
+        {
+          std::cerr<<"can't allocate scratch memory ("<<size<<" byte)"<<std::endl;
+          return;
+        }
+        buff->size=size;
+      }
+
+      void free_buffer(Buffer* buff)
+      {
+#ifdef __linux__
+        if(buff->base != NULL)
+        {
+          munmap(buff->base, buff->mapped_size);
+        }else
+#endif
+        {
+          free(buff->ptr);
+        }
+        buff->ptr=NULL;
+        buff->base=NULL;
+        buff->size=0;
+        buff->mapped_size=0;
+      }
+
+      Buffer buffers[NUM_SLOTS];
+      size_t capacity;
+  };
+}//end of namespace JHPCNDF
+#endif
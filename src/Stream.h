@@ -0,0 +1,250 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file Stream.h
+#ifndef JHPCNDF_STREAM_H
+#define JHPCNDF_STREAM_H
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace JHPCNDF
+{
+  //@brief IOクラスが圧縮済データを読み書きする入出力先
+  class Stream
+  {
+    public:
+      //@brief sizeバイトのデータを読み込む
+      //@ret   読み込んだサイズ
+      virtual size_t read(void* ptr, size_t size)=0;
+
+      //@brief sizeバイトのデータを書き込む
+      //@ret   書き込んだサイズ
+      virtual size_t write(const void* ptr, size_t size)=0;
+
+      //@brief 読み込み時にエラーが発生していたらtrueを返す
+      virtual bool error(void) const=0;
+
+      //@brief 入力元の終端に達していたらtrueを返す
+      virtual bool eof(void) const=0;
+
+      //@brief 最後に読み込んだデータのうち、後ろからsizeバイトを読んでいないことにする
+      //
+      //圧縮形式の終端より後ろまで先読みしたデータを、次の読み込みで使えるようにするために使う
+      virtual void unread(size_t size)=0;
+
+      virtual ~Stream(){};
+  };
+
+  //@brief stdioのファイルポインタに対して入出力を行うクラス
+  class FileStream :public Stream
+  {
+    public:
+      explicit FileStream(FILE* arg_fp):fp(arg_fp){}
+      size_t read(void* ptr, size_t size)
+      {
+        return ::fread(ptr, 1, size, fp);
+      }
+      size_t write(const void* ptr, size_t size)
+      {
+        return ::fwrite(ptr, 1, size, fp);
+      }
+      bool error(void) const
+      {
+        return ferror(fp) != 0;
+      }
+      bool eof(void) const
+      {
+        return feof(fp) != 0;
+      }
+      void unread(size_t size)
+      {
+        fseek(fp, -(long)size, SEEK_CUR);
+      }
+    private:
+      FILE* fp;
+  };
+
+  //@brief メモリ上の領域から読み込むクラス
+  class MemoryInputStream :public Stream
+  {
+    public:
+      MemoryInputStream(const void* arg_buffer, const size_t& arg_size):buffer(static_cast<const char*>(arg_buffer)), size(arg_size), position(0){}
+      size_t read(void* ptr, size_t read_size)
+      {
+        const size_t length = read_size < size-position ? read_size : size-position;
+        memcpy(ptr, buffer+position, length);
+        position+=length;
+        return length;
+      }
+      size_t write(const void* /*ptr*/, size_t /*size*/)
+      {
+        return 0;
+      }
+      bool error(void) const
+      {
+        return false;
+      }
+      bool eof(void) const
+      {
+        return position >= size;
+      }
+      void unread(size_t unread_size)
+      {
+        position = unread_size < position ? position-unread_size : 0;
+      }
+
+      //@brief これまでに読み込んだサイズ
+      size_t tell(void) const
+      {
+        return position;
+      }
+    private:
+      const char* buffer;
+      const size_t size;
+      size_t position;
+  };
+
+  //@brief メモリ上の領域へ書き込むクラス
+  //
+  //領域を指定した場合は容量を越えた分は書き込まない
+  //領域を指定しなかった場合は内部で確保した領域を必要に応じて拡張する
+  class MemoryOutputStream :public Stream
+  {
+    public:
+      MemoryOutputStream():buffer(NULL), capacity(0), position(0){}
+      MemoryOutputStream(void* arg_buffer, const size_t& arg_capacity):buffer(static_cast<char*>(arg_buffer)), capacity(arg_capacity), position(0){}
+      size_t read(void* /*ptr*/, size_t /*size*/)
+      {
+        return 0;
+      }
+      size_t write(const void* ptr, size_t size)
+      {
+        if(buffer == NULL)
+        {
+          const char* src=static_cast<const char*>(ptr);
+          storage.insert(storage.end(), src, src+size);
+          position+=size;
+          return size;
+        }
+        const size_t length = size < capacity-position ? size : capacity-position;
+        memcpy(buffer+position, ptr, length);
+        position+=length;
+        return length;
+      }
+      bool error(void) const
+      {
+        return false;
+      }
+      bool eof(void) const
+      {
+        return false;
+      }
+      void unread(size_t /*size*/){}
+
+      //@brief これまでに書き込んだサイズ
+      size_t tell(void) const
+      {
+        return position;
+      }
+
+      //@brief 内部で確保した領域 (領域を指定しなかった時のみ有効)
+      std::vector<char>& get_storage(void)
+      {
+        return storage;
+      }
+    private:
+      MemoryOutputStream(const MemoryOutputStream&);
+      MemoryOutputStream& operator=(const MemoryOutputStream&);
+
+      char*  buffer;
+      const size_t capacity;
+      size_t position;
+      std::vector<char> storage;
+  };
+  //@brief 利用者が指定したコールバック関数を使って入出力を行うクラス
+  //
+  //コールバック関数の仕様はjhpcndf.hのJHPCNDF_Callbacksを参照のこと
+  //unreadに対応するため、直前に読み込んだデータのコピーを保持する
+  class CallbackStream :public Stream
+  {
+    public:
+      typedef size_t (*WriteFunction)(const void* ptr, size_t size, void* context);
+      typedef size_t (*ReadFunction)(void* ptr, size_t size, void* context);
+
+      CallbackStream(WriteFunction arg_write, ReadFunction arg_read, void* arg_context)
+        :write_function(arg_write), read_function(arg_read), context(arg_context), pending(0), at_end(false), has_error(false){}
+
+      size_t read(void* ptr, size_t size)
+      {
+        char* dst=static_cast<char*>(ptr);
+        size_t read_size=0;
+
+        //unreadされたデータを先に返す
+        if(pending > 0)
+        {
+          read_size = size < pending ? size : pending;
+          memcpy(dst, &(last_read[last_read.size()-pending]), read_size);
+          pending-=read_size;
+          if(pending > 0)
+          {
+            return read_size;
+          }
+        }
+        if(read_size < size)
+        {
+          if(read_function == NULL)
+          {
+            has_error=true;
+          }else{
+            const size_t request=size-read_size;
+            const size_t rt=read_function(dst+read_size, request, context);
+            if(rt > request)
+            {
+              has_error=true;
+            }else{
+              at_end = rt < request;
+              read_size+=rt;
+            }
+          }
+        }
+        last_read.assign(dst, dst+read_size);
+        return read_size;
+      }
+      size_t write(const void* ptr, size_t size)
+      {
+        if(write_function == NULL)
+        {
+          return 0;
+        }
+        return write_function(ptr, size, context);
+      }
+      bool error(void) const
+      {
+        return has_error;
+      }
+      bool eof(void) const
+      {
+        return at_end && pending == 0;
+      }
+      void unread(size_t size)
+      {
+        pending = pending+size < last_read.size() ? pending+size : last_read.size();
+      }
+    private:
+      WriteFunction write_function;
+      ReadFunction  read_function;
+      void*         context;
+      std::vector<char> last_read; // 直前のreadで返したデータ
+      size_t pending;              // last_readの末尾のうち、まだ返していないサイズ
+      bool at_end;
+      bool has_error;
+  };
+}//end of namespace JHPCNDF
+#endif
@@ -0,0 +1,158 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file Subarray.h
+
+#ifndef JHPCNDF_SUBARRAY_H
+#define JHPCNDF_SUBARRAY_H
+#include <vector>
+
+namespace JHPCNDF
+{
+  //@brief 多次元配列から取り出す部分領域の配置
+  //
+  //配列は次元0が最も速く変化する順(index = i0 + n0*(i1 + n1*i2) ...)に並んでいるものとする
+  //部分領域を次元0方向の「行」の並びとして扱い、行の先頭位置を計算する
+  //全要素を取り出す次元は上位の次元とまとめるので、内部領域が連続している場合は1行になる
+  class SubarrayLayout
+  {
+    public:
+      //@param ndims   次元数
+      //@param extents 配列全体の各次元の要素数
+      //@param offsets 部分領域の先頭位置
+      //@param counts  部分領域の各次元の要素数
+      //@param strides 部分領域内で何要素おきに取り出すか (NULLの場合は全て1)
+      SubarrayLayout(const size_t& ndims, const size_t* extents, const size_t* offsets, const size_t* counts, const size_t* strides=NULL)
+        :valid(ndims > 0 && extents != NULL && offsets != NULL && counts != NULL)
+      {
+        if(!valid)
+        {
+          return;
+        }
+        size_t pitch=1;
+        for(size_t d=0; d<ndims; d++)
+        {
+          const size_t stride = strides != NULL ? strides[d] : 1;
+          if(stride == 0 || (counts[d] > 0 && offsets[d]+(counts[d]-1)*stride >= extents[d]))
+          {
+            valid=false;
+            return;
+          }
+          // 直前の次元を全て取り出す場合は、その次元とまとめる
+          if(!pitches.empty() && this->strides.back() == pitches.back() && stride == 1 && this->counts.back()*pitches.back() == pitch && this->offsets.back() == 0)
+          {
+            this->offsets.back()+=offsets[d]*pitch;
+            this->counts.back()*=counts[d];
+          }else{
+            pitches.push_back(pitch);
+            this->offsets.push_back(offsets[d]*pitch);
+            this->counts.push_back(counts[d]);
+            this->strides.push_back(stride*pitch);
+          }
+          pitch*=extents[d];
+        }
+      }
+
+      bool is_valid(void) const
+      {
+        return valid;
+      }
+
+      //@brief 部分領域の要素数
+      size_t size(void) const
+      {
+        return row_length()*num_rows();
+      }
+
+      //@brief 1行の要素数
+      size_t row_length(void) const
+      {
+        return valid ? counts[0] : 0;
+      }
+
+      //@brief 行内の要素の間隔 (1の時は行内の要素が連続している)
+      size_t row_stride(void) const
+      {
+        return valid ? strides[0] : 1;
+      }
+
+      size_t num_rows(void) const
+      {
+        if(!valid)
+        {
+          return 0;
+        }
+        size_t rows=1;
+        for(size_t d=1; d<counts.size(); d++)
+        {
+          rows*=counts[d];
+        }
+        return rows;
+      }
+
+      //@brief row番目の行の先頭要素の、配列全体の先頭からの位置
+      size_t row_offset(size_t row) const
+      {
+        size_t offset=offsets[0];
+        for(size_t d=1; d<counts.size(); d++)
+        {
+          offset+=offsets[d]+(row%counts[d])*strides[d];
+          row/=counts[d];
+        }
+        return offset;
+      }
+
+      //@brief row番目の行のfirst番目からcount要素をbaseから連続領域dstへ集める
+      template <typename T>
+      void gather_row(const size_t& row, const size_t& first, const size_t& count, const T* const base, T* const dst) const
+      {
+        const size_t stride=strides[0];
+        const T* src=base+row_offset(row)+first*stride;
+        for(size_t i=0; i<count; i++)
+        {
+          dst[i]=src[i*stride];
+        }
+      }
+
+      //@brief 連続領域srcのcount要素を、row番目の行のfirst番目以降としてbaseへ書き戻す
+      template <typename T>
+      void scatter_row(const size_t& row, const size_t& first, const size_t& count, const T* const src, T* const base) const
+      {
+        const size_t stride=strides[0];
+        T* dst=base+row_offset(row)+first*stride;
+        for(size_t i=0; i<count; i++)
+        {
+          dst[i*stride]=src[i];
+        }
+      }
+
+      //@brief 部分領域全体を連続領域srcからbaseへ書き戻す
+      template <typename T>
+      void scatter(const T* const src, T* const base) const
+      {
+        const long rows=(long)num_rows();
+        const size_t length=row_length();
+#ifdef USE_OPENMP
+#pragma omp parallel for if(rows > 1)
+#endif
+        for(long r=0; r<rows; r++)
+        {
+          scatter_row(r, 0, length, src+r*length, base);
+        }
+      }
+
+    private:
+      bool valid;
+      std::vector<size_t> pitches;
+      std::vector<size_t> offsets;  // 各次元の先頭位置 (配列全体での要素数単位)
+      std::vector<size_t> counts;
+      std::vector<size_t> strides;  // 各次元の要素間隔 (配列全体での要素数単位)
+  };
+}//end of namespace JHPCNDF
+#endif
@@ -0,0 +1,148 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file Temporal.h
+
+#ifndef JHPCNDF_TEMPORAL_H
+#define JHPCNDF_TEMPORAL_H
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include "Utility.h"
+
+//
+//JHPCNDF::fwrite_temporalが出力するレコードの形式
+//
+//上位bit側ファイル
+//  TemporalRecordHeader         (16 byte, 無圧縮)
+//  圧縮済上位bitデータ          (キーフレームの場合はエンコード後の値、それ以外は直前のステップとのXOR)
+//下位bit側ファイル
+//  圧縮済下位bitデータ          (JHPCNDF::fwriteと同じ)
+//
+//数値は全て出力した環境のバイトオーダーで格納する
+//
+namespace JHPCNDF
+{
+  struct TemporalRecordHeader
+  {
+    char     magic[4];        // "JHTR"
+    uint8_t  version;
+    uint8_t  element_size;    // 1要素のサイズ(float=4, double=8)
+    uint8_t  flags;           // Temporal::KEYFRAME
+    uint8_t  reserved;
+    uint64_t num_elements;
+  };
+
+  namespace Temporal
+  {
+    const uint8_t VERSION=1;
+    const uint8_t KEYFRAME=1;
+
+    inline const char* magic(void)
+    {
+      return "JHTR";
+    }
+
+    inline void init_header(TemporalRecordHeader* header, const uint8_t& element_size, const uint64_t& num_elements, const bool& is_keyframe)
+    {
+      memset(header, 0, sizeof(TemporalRecordHeader));
+      memcpy(header->magic, magic(), 4);
+      header->version=VERSION;
+      header->element_size=element_size;
+      header->flags= is_keyframe ? KEYFRAME : 0;
+      header->num_elements=num_elements;
+    }
+
+    inline bool is_valid_header(const TemporalRecordHeader& header)
+    {
+      return memcmp(header.magic, magic(), 4) == 0 && header.version == VERSION;
+    }
+  }//end of namespace Temporal
+
+  //@brief 変数毎に保持する直前のステップの上位bit
+  //
+  //書き込み側はエンコード後の上位bit、読み込み側は伸長後の上位bitを保持するので
+  //両者は常に一致する
+  class TemporalReference
+  {
+    public:
+      TemporalReference():element_size(0), num_elements(0), records_since_keyframe(0){}
+
+      //@brief 次のレコードをキーフレームにする必要があるかどうかを返す
+      //@param interval キーフレームを出力する間隔(レコード数)
+      //
+      //参照データが無い場合や要素数、型が変わった場合もキーフレームにする
+      bool needs_keyframe(const size_t& size, const size_t& nmemb, const int& interval) const
+      {
+        return element_size != size || num_elements != nmemb || interval <= 1 || records_since_keyframe+1 >= interval;
+      }
+
+      //@brief キーフレームの上位bitを参照データとして保存する
+      template <typename T>
+      void set_keyframe(const T* upper, const size_t& nmemb)
+      {
+        data.resize(sizeof(T)*nmemb);
+        if(nmemb > 0)
+        {
+          memcpy(&(data[0]), upper, sizeof(T)*nmemb);
+        }
+        element_size=sizeof(T);
+        num_elements=nmemb;
+        records_since_keyframe=0;
+      }
+
+      //@brief 上位bitを参照データとのXORに置き換え、参照データを元の上位bitで更新する (書き込み用)
+      template <typename T>
+      void to_residual(T* upper, const size_t& nmemb)
+      {
+        T* reference=get<T>();
+#pragma omp parallel for
+        for(long i=0; i<(long)nmemb; i++)
+        {
+          const T current=upper[i];
+          upper[i]=real_xor(current, reference[i]);
+          reference[i]=current;
+        }
+        records_since_keyframe++;
+      }
+
+      //@brief 参照データとのXORから上位bitを復元し、参照データを更新する (読み込み用)
+      template <typename T>
+      void from_residual(T* upper, const size_t& nmemb)
+      {
+        T* reference=get<T>();
+#pragma omp parallel for
+        for(long i=0; i<(long)nmemb; i++)
+        {
+          upper[i]=real_xor(upper[i], reference[i]);
+          reference[i]=upper[i];
+        }
+        records_since_keyframe++;
+      }
+
+      //@brief 参照データを持っているかどうか
+      bool has_reference(const size_t& size, const size_t& nmemb) const
+      {
+        return element_size == size && num_elements == nmemb;
+      }
+
+    private:
+      template <typename T>
+      T* get(void)
+      {
+        return reinterpret_cast<T*>(&(data[0]));
+      }
+
+      std::vector<char> data;
+      size_t element_size;
+      size_t num_elements;
+      int records_since_keyframe;
+  };
+}//end of namespace JHPCNDF
+#endif
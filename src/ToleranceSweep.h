@@ -0,0 +1,110 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file ToleranceSweep.h
+
+#ifndef JHPCNDF_TOLERANCE_SWEEP_H
+#define JHPCNDF_TOLERANCE_SWEEP_H
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include "Utility.h"
+
+//複数の許容誤差に対する分割位置(0埋めする下位bit数)を1回の走査でまとめて求める
+//
+//下位bitを0埋めした時の誤差は0埋めするbit数に対して単調に増加するので、
+//許容誤差を小さい順に処理し、直前の許容誤差で求めた分割位置から探索を始める
+namespace JHPCNDF
+{
+  namespace ToleranceSweep
+  {
+    //@brief 仮数部のbit数 (分割位置の最大値)
+    template <typename T>
+    unsigned int fraction_length(void)
+    {
+      return sizeof(T) == 4 ? 23 : 52;
+    }
+
+    //@brief 誤差がtolerance以下となる最大の分割位置をlower_limit以上の範囲から二分探索する
+    //@param value       元の値
+    //@param tolerance   許容誤差 (絶対値)
+    //@param lower_limit 探索範囲の下限 (この分割位置では誤差がtolerance以下であること)
+    template <typename T>
+    unsigned int required_split_position(const T& value, const double& tolerance, const unsigned int& lower_limit)
+    {
+      unsigned int lo=lower_limit;
+      unsigned int hi=fraction_length<T>();
+      while(lo < hi)
+      {
+        const unsigned int mid=(lo+hi+1)/2;
+        const T truncated=n_bit_zero_padding(value, mid);
+        if(is_converged<T, 1>(&value, &truncated, tolerance))
+        {
+          lo=mid;
+        }else{
+          hi=mid-1;
+        }
+      }
+      return lo;
+    }
+
+    //@brief 許容誤差毎に、分割位置のヒストグラムを求める
+    //@param length      配列の要素数
+    //@param src         元データ
+    //@param tolerances  許容誤差のリスト (順不同)
+    //@param is_relative 許容誤差を相対値で指定するかどうかのフラグ
+    //@param histograms  tolerances[k]に対するヒストグラムをhistograms[k][分割位置]に加算する
+    //                   (fraction_length<T>()+1要素で初期化しておくこと)
+    template <typename T>
+    void count_split_positions(const size_t& length, const T* const src, const std::vector<float>& tolerances, const bool& is_relative, std::vector<std::vector<size_t> >* histograms)
+    {
+      const size_t num_tolerances=tolerances.size();
+      std::vector<std::pair<float, size_t> > order(num_tolerances);
+      for(size_t k=0; k<num_tolerances; k++)
+      {
+        order[k]=std::make_pair(std::fabs(tolerances[k]), k);
+      }
+      std::sort(order.begin(), order.end());
+      const size_t num_bins=fraction_length<T>()+1;
+
+#ifdef USE_OPENMP
+#pragma omp parallel
+#endif
+      {
+        std::vector<size_t> local(num_tolerances*num_bins, 0);
+#ifdef USE_OPENMP
+#pragma omp for
+#endif
+        for(size_t i=0; i<length; i++)
+        {
+          const double scale = is_relative ? std::fabs((double)src[i]) : 1.0;
+          unsigned int split_position=0;
+          for(size_t k=0; k<num_tolerances; k++)
+          {
+            split_position=required_split_position(src[i], order[k].first*scale, split_position);
+            local[order[k].second*num_bins+split_position]++;
+          }
+        }
+#ifdef USE_OPENMP
+#pragma omp critical
+#endif
+        {
+          for(size_t k=0; k<num_tolerances; k++)
+          {
+            for(size_t n=0; n<num_bins; n++)
+            {
+              (*histograms)[k][n]+=local[k*num_bins+n];
+            }
+          }
+        }
+      }
+    }
+  }//end of namespace ToleranceSweep
+}//end of namespace JHPCNDF
+#endif
@@ -9,6 +9,15 @@ interface
     subroutine jhpcndf_close(unit)
     integer(4)       :: unit
     end subroutine jhpcndf_close
+
+    subroutine jhpcndf_set_scratch_capacity(unit, size)
+    integer(4)       :: unit
+    integer(8)       :: size
+    end subroutine jhpcndf_set_scratch_capacity
+
+    subroutine jhpcndf_release_scratch(unit)
+    integer(4)       :: unit
+    end subroutine jhpcndf_release_scratch
 end interface
 
 interface  jhpcndf_write
@@ -90,6 +99,270 @@ interface  jhpcndf_read
     end subroutine jhpcndf_read_character
 end interface
 
+interface jhpcndf_write_temporal
+    subroutine jhpcndf_write_temporal_real4(unit, recl, data, var, tol, is_rel, enc, interval)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(4)           :: data(:)
+        character(len=*)  :: var
+        real(4)           :: tol
+        logical           :: is_rel
+        character(len=*)  :: enc
+        integer(4)        :: interval
+    end subroutine jhpcndf_write_temporal_real4
+
+    subroutine jhpcndf_write_temporal_real8(unit, recl, data, var, tol, is_rel, enc, interval)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(8)           :: data(:)
+        character(len=*)  :: var
+        real(4)           :: tol
+        logical           :: is_rel
+        character(len=*)  :: enc
+        integer(4)        :: interval
+    end subroutine jhpcndf_write_temporal_real8
+end interface
+
+interface jhpcndf_read_temporal
+    subroutine jhpcndf_read_temporal_real4(unit, recl, data, var)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(4)           :: data(:)
+        character(len=*)  :: var
+    end subroutine jhpcndf_read_temporal_real4
+
+    subroutine jhpcndf_read_temporal_real8(unit, recl, data, var)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(8)           :: data(:)
+        character(len=*)  :: var
+    end subroutine jhpcndf_read_temporal_real8
+end interface
+
+interface jhpcndf_set_dictionary
+    subroutine jhpcndf_set_dictionary_real4(unit, recl, data, tol, is_rel, enc, ierr)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(4)           :: data(:)
+        real(4)           :: tol
+        logical           :: is_rel
+        character(len=*)  :: enc
+        integer(4)        :: ierr
+    end subroutine jhpcndf_set_dictionary_real4
+
+    subroutine jhpcndf_set_dictionary_real8(unit, recl, data, tol, is_rel, enc, ierr)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(8)           :: data(:)
+        real(4)           :: tol
+        logical           :: is_rel
+        character(len=*)  :: enc
+        integer(4)        :: ierr
+    end subroutine jhpcndf_set_dictionary_real8
+end interface
+
+interface jhpcndf_write_lorenzo
+    subroutine jhpcndf_write_lorenzo_real4(unit, nx, ny, nz, data, tol, is_rel)
+        integer(4)        :: unit
+        integer(8)        :: nx, ny, nz
+        real(4)           :: data(:)
+        real(4)           :: tol
+        logical           :: is_rel
+    end subroutine jhpcndf_write_lorenzo_real4
+
+    subroutine jhpcndf_write_lorenzo_real8(unit, nx, ny, nz, data, tol, is_rel)
+        integer(4)        :: unit
+        integer(8)        :: nx, ny, nz
+        real(8)           :: data(:)
+        real(4)           :: tol
+        logical           :: is_rel
+    end subroutine jhpcndf_write_lorenzo_real8
+end interface
+
+interface jhpcndf_read_lorenzo
+    subroutine jhpcndf_read_lorenzo_real4(unit, nx, ny, nz, data)
+        integer(4)        :: unit
+        integer(8)        :: nx, ny, nz
+        real(4)           :: data(:)
+    end subroutine jhpcndf_read_lorenzo_real4
+
+    subroutine jhpcndf_read_lorenzo_real8(unit, nx, ny, nz, data)
+        integer(4)        :: unit
+        integer(8)        :: nx, ny, nz
+        real(8)           :: data(:)
+    end subroutine jhpcndf_read_lorenzo_real8
+end interface
+
+interface jhpcndf_write_fixed_rate
+    subroutine jhpcndf_write_fixed_rate_real4(unit, recl, data, rate)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(4)           :: data(:)
+        integer(4)        :: rate
+    end subroutine jhpcndf_write_fixed_rate_real4
+
+    subroutine jhpcndf_write_fixed_rate_real8(unit, recl, data, rate)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(8)           :: data(:)
+        integer(4)        :: rate
+    end subroutine jhpcndf_write_fixed_rate_real8
+end interface
+
+interface jhpcndf_read_fixed_rate
+    subroutine jhpcndf_read_fixed_rate_real4(unit, recl, data)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(4)           :: data(:)
+    end subroutine jhpcndf_read_fixed_rate_real4
+
+    subroutine jhpcndf_read_fixed_rate_real8(unit, recl, data)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(8)           :: data(:)
+    end subroutine jhpcndf_read_fixed_rate_real8
+end interface
+
+interface jhpcndf_write_tolerance_field
+    subroutine jhpcndf_write_tolerance_field_real4(unit, recl, data, tol, is_rel, enc)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(4)           :: data(:)
+        real(4)           :: tol(:)
+        logical           :: is_rel
+        character(len=*)  :: enc
+    end subroutine jhpcndf_write_tolerance_field_real4
+
+    subroutine jhpcndf_write_tolerance_field_real8(unit, recl, data, tol, is_rel, enc)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(8)           :: data(:)
+        real(4)           :: tol(:)
+        logical           :: is_rel
+        character(len=*)  :: enc
+    end subroutine jhpcndf_write_tolerance_field_real8
+end interface
+
+interface jhpcndf_write_subarray
+    subroutine jhpcndf_write_subarray_real4(unit, ndims, extents, offsets, counts, strides, data, tol, is_rel, enc)
+        integer(4)        :: unit
+        integer(4)        :: ndims
+        integer(8)        :: extents(:), offsets(:), counts(:), strides(:)
+        real(4)           :: data(:)
+        real(4)           :: tol
+        logical           :: is_rel
+        character(len=*)  :: enc
+    end subroutine jhpcndf_write_subarray_real4
+
+    subroutine jhpcndf_write_subarray_real8(unit, ndims, extents, offsets, counts, strides, data, tol, is_rel, enc)
+        integer(4)        :: unit
+        integer(4)        :: ndims
+        integer(8)        :: extents(:), offsets(:), counts(:), strides(:)
+        real(8)           :: data(:)
+        real(4)           :: tol
+        logical           :: is_rel
+        character(len=*)  :: enc
+    end subroutine jhpcndf_write_subarray_real8
+end interface
+
+interface jhpcndf_read_subarray
+    subroutine jhpcndf_read_subarray_real4(unit, ndims, extents, offsets, counts, strides, data)
+        integer(4)        :: unit
+        integer(4)        :: ndims
+        integer(8)        :: extents(:), offsets(:), counts(:), strides(:)
+        real(4)           :: data(:)
+    end subroutine jhpcndf_read_subarray_real4
+
+    subroutine jhpcndf_read_subarray_real8(unit, ndims, extents, offsets, counts, strides, data)
+        integer(4)        :: unit
+        integer(4)        :: ndims
+        integer(8)        :: extents(:), offsets(:), counts(:), strides(:)
+        real(8)           :: data(:)
+    end subroutine jhpcndf_read_subarray_real8
+end interface
+
+interface jhpcndf_write_target_size
+    subroutine jhpcndf_write_target_size_real4(unit, recl, data, target, tol_used, is_rel, enc)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(4)           :: data(:)
+        integer(8)        :: target
+        real(4)           :: tol_used
+        logical           :: is_rel
+        character(len=*)  :: enc
+    end subroutine jhpcndf_write_target_size_real4
+
+    subroutine jhpcndf_write_target_size_real8(unit, recl, data, target, tol_used, is_rel, enc)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(8)           :: data(:)
+        integer(8)        :: target
+        real(4)           :: tol_used
+        logical           :: is_rel
+        character(len=*)  :: enc
+    end subroutine jhpcndf_write_target_size_real8
+end interface
+
+interface jhpcndf_write_target_ratio
+    subroutine jhpcndf_write_target_ratio_real4(unit, recl, data, target, tol_used, is_rel, enc)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(4)           :: data(:)
+        real(8)           :: target
+        real(4)           :: tol_used
+        logical           :: is_rel
+        character(len=*)  :: enc
+    end subroutine jhpcndf_write_target_ratio_real4
+
+    subroutine jhpcndf_write_target_ratio_real8(unit, recl, data, target, tol_used, is_rel, enc)
+        integer(4)        :: unit
+        integer(8)        :: recl
+        real(8)           :: data(:)
+        real(8)           :: target
+        real(4)           :: tol_used
+        logical           :: is_rel
+        character(len=*)  :: enc
+    end subroutine jhpcndf_write_target_ratio_real8
+end interface
+
+interface jhpcndf_write_components
+    subroutine jhpcndf_write_components_real4(unit, ncomp, recl, data, tol, is_rel, enc)
+        integer(4)        :: unit
+        integer(4)        :: ncomp
+        integer(8)        :: recl
+        real(4)           :: data(:)
+        real(4)           :: tol(:)
+        logical           :: is_rel
+        character(len=*)  :: enc
+    end subroutine jhpcndf_write_components_real4
+
+    subroutine jhpcndf_write_components_real8(unit, ncomp, recl, data, tol, is_rel, enc)
+        integer(4)        :: unit
+        integer(4)        :: ncomp
+        integer(8)        :: recl
+        real(8)           :: data(:)
+        real(4)           :: tol(:)
+        logical           :: is_rel
+        character(len=*)  :: enc
+    end subroutine jhpcndf_write_components_real8
+end interface
+
+interface jhpcndf_read_components
+    subroutine jhpcndf_read_components_real4(unit, ncomp, recl, data)
+        integer(4)        :: unit
+        integer(4)        :: ncomp
+        integer(8)        :: recl
+        real(4)           :: data(:)
+    end subroutine jhpcndf_read_components_real4
+
+    subroutine jhpcndf_read_components_real8(unit, ncomp, recl, data)
+        integer(4)        :: unit
+        integer(4)        :: ncomp
+        integer(8)        :: recl
+        real(8)           :: data(:)
+    end subroutine jhpcndf_read_components_real8
+end interface
+
 interface jhpcndf_encode
 subroutine jhpcndf_encode_real4(length, src, dst, dst_lower, tol, is_rel, enc)
 implicit none
@@ -131,4 +404,168 @@ real(8)           :: src_lower(:)
 real(8)           :: dst(:)
 end subroutine jhpcndf_decode_real8
 end interface
+
+interface
+subroutine jhpcndf_compress_bound(nmemb, size, comp, with_lower, bound)
+implicit none
+integer(8)        :: nmemb
+integer(8)        :: size
+character(len=*)  :: comp
+logical           :: with_lower
+integer(8)        :: bound
+end subroutine jhpcndf_compress_bound
+end interface
+
+interface jhpcndf_estimate_size
+subroutine jhpcndf_estimate_size_real4(nmemb, src, tol, is_rel, enc, comp, upper_size, lower_size)
+implicit none
+integer(8)        :: nmemb
+real(4)           :: src(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+integer(8)        :: upper_size
+integer(8)        :: lower_size
+end subroutine jhpcndf_estimate_size_real4
+subroutine jhpcndf_estimate_size_real8(nmemb, src, tol, is_rel, enc, comp, upper_size, lower_size)
+implicit none
+integer(8)        :: nmemb
+real(8)           :: src(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+integer(8)        :: upper_size
+integer(8)        :: lower_size
+end subroutine jhpcndf_estimate_size_real8
+end interface
+
+interface jhpcndf_sweep_tolerances
+subroutine jhpcndf_sweep_tolerances_real4(nmemb, src, ntol, tols, is_rel, enc, comp, hist, upper_sizes, lower_sizes)
+implicit none
+integer(8)        :: nmemb
+real(4)           :: src(:)
+integer(8)        :: ntol
+real(4)           :: tols(:)
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+integer(8)        :: hist(:,:)
+integer(8)        :: upper_sizes(:)
+integer(8)        :: lower_sizes(:)
+end subroutine jhpcndf_sweep_tolerances_real4
+subroutine jhpcndf_sweep_tolerances_real8(nmemb, src, ntol, tols, is_rel, enc, comp, hist, upper_sizes, lower_sizes)
+implicit none
+integer(8)        :: nmemb
+real(8)           :: src(:)
+integer(8)        :: ntol
+real(4)           :: tols(:)
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+integer(8)        :: hist(:,:)
+integer(8)        :: upper_sizes(:)
+integer(8)        :: lower_sizes(:)
+end subroutine jhpcndf_sweep_tolerances_real8
+end interface
+
+interface jhpcndf_compress
+subroutine jhpcndf_compress_real4(nmemb, src, capacity, dst, tol, is_rel, enc, comp, with_lower, dst_size)
+implicit none
+integer(8)        :: nmemb
+real(4)           :: src(:)
+integer(8)        :: capacity
+integer(1)        :: dst(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+logical           :: with_lower
+integer(8)        :: dst_size
+end subroutine jhpcndf_compress_real4
+
+subroutine jhpcndf_compress_real8(nmemb, src, capacity, dst, tol, is_rel, enc, comp, with_lower, dst_size)
+implicit none
+integer(8)        :: nmemb
+real(8)           :: src(:)
+integer(8)        :: capacity
+integer(1)        :: dst(:)
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+character(len=*)  :: comp
+logical           :: with_lower
+integer(8)        :: dst_size
+end subroutine jhpcndf_compress_real8
+end interface
+
+interface jhpcndf_decompress
+subroutine jhpcndf_decompress_real4(src_size, src, nmemb, dst, num_elements)
+implicit none
+integer(8)        :: src_size
+integer(1)        :: src(:)
+integer(8)        :: nmemb
+real(4)           :: dst(:)
+integer(8)        :: num_elements
+end subroutine jhpcndf_decompress_real4
+
+subroutine jhpcndf_decompress_real8(src_size, src, nmemb, dst, num_elements)
+implicit none
+integer(8)        :: src_size
+integer(1)        :: src(:)
+integer(8)        :: nmemb
+real(8)           :: dst(:)
+integer(8)        :: num_elements
+end subroutine jhpcndf_decompress_real8
+end interface
+
+interface
+subroutine jhpcndf_create_context(context, unit, tol, is_rel, enc, num_threads)
+implicit none
+integer(8)        :: context
+integer(4)        :: unit
+real(4)           :: tol
+logical           :: is_rel
+character(len=*)  :: enc
+integer(4)        :: num_threads
+end subroutine jhpcndf_create_context
+
+subroutine jhpcndf_destroy_context(context)
+implicit none
+integer(8)        :: context
+end subroutine jhpcndf_destroy_context
+end interface
+
+interface jhpcndf_context_write
+subroutine jhpcndf_context_write_real4(context, recl, data)
+implicit none
+integer(8)        :: context
+integer(8)        :: recl
+real(4)           :: data(:)
+end subroutine jhpcndf_context_write_real4
+
+subroutine jhpcndf_context_write_real8(context, recl, data)
+implicit none
+integer(8)        :: context
+integer(8)        :: recl
+real(8)           :: data(:)
+end subroutine jhpcndf_context_write_real8
+end interface
+
+interface jhpcndf_context_read
+subroutine jhpcndf_context_read_real4(context, recl, data)
+implicit none
+integer(8)        :: context
+integer(8)        :: recl
+real(4)           :: data(:)
+end subroutine jhpcndf_context_read_real4
+
+subroutine jhpcndf_context_read_real8(context, recl, data)
+implicit none
+integer(8)        :: context
+integer(8)        :: recl
+real(8)           :: data(:)
+end subroutine jhpcndf_context_read_real8
+end interface
 end module
@@ -19,7 +19,7 @@ namespace JHPCNDF
   class lz4IO :public IO
   {
     public:
-      lz4IO(const size_t& arg_buffer_size, const int& arg_compression_level): buffer_size(arg_buffer_size)
+      lz4IO(const size_t& arg_buffer_size, const int& arg_compression_level): buffer_size(arg_buffer_size), input_buffer(NULL), output_buffer(NULL)
       {
         LZ4F_errorCode_t err=LZ4F_createCompressionContext(&ctx, LZ4_versionNumber());
         if(err != 0)
@@ -44,6 +44,8 @@ namespace JHPCNDF
       }
       ~lz4IO()
       {
+        delete [] input_buffer;
+        delete [] output_buffer;
         LZ4F_errorCode_t err=LZ4F_freeCompressionContext(ctx);
         if(LZ4F_isError(err))
         {
@@ -60,12 +62,15 @@ namespace JHPCNDF
       //@param ptr     読み込んだデータを格納する領域へのポインタ
       //@param size    データの1要素あたりのサイズ
       //@param nmemb   確保済の領域サイズ
-      //@param stream  ファイル入力元のポインタ
+      //@param stream  入力元
       //@param ret 伸長後のデータサイズ(Byte)
       //
       //エラー発生時はstderrにメッセージを出力した上で0を返す
       //伸長後のファイルサイズが0だった場合も0が返るので注意
-      size_t fread(void *ptr, size_t size, size_t nmemb, FILE *stream)
+      using IO::fread;
+      using IO::fwrite;
+
+      size_t fread(void *ptr, size_t size, size_t nmemb, Stream *stream)
       {
         const int HEADER_SIZE=4;
         LZ4F_decompressOptions_t dOpt={0};
@@ -73,21 +78,24 @@ namespace JHPCNDF
         size_t decompressed_size=0;
         const size_t size_in_byte=size*nmemb;
         const size_t input_buffer_size=buffer_size > 11? buffer_size:11; //TODO check!!
-        char* buffer = new char[input_buffer_size];
+        if(input_buffer == NULL)
+        {
+          input_buffer = new char[input_buffer_size];
+        }
+        char* buffer = input_buffer;
         size_t offset=0;
         char* dst=(char* )ptr;
         char* src=buffer;
 
-        size_t read_size = ::fread(buffer, 1, (size_t)input_buffer_size, stream);
-        if (ferror(stream))
+        size_t read_size = stream->read(buffer, (size_t)input_buffer_size);
+        if (stream->error())
         {
           std::cerr<<"file read error."<<std::endl;
-          delete [] buffer;
           return 0;
         }
         for(;;)
         {
-          size_t dst_size=size_in_byte;
+          size_t dst_size=size_in_byte-decompressed_size;
           size_t src_size=read_size;
           size_t rt = LZ4F_decompress(dctx, dst, &dst_size, src, &src_size, &dOpt);
           if(LZ4F_isError(rt))
@@ -100,14 +108,16 @@ namespace JHPCNDF
           if(src_size < read_size) {
             src+=src_size;
             read_size-=src_size;
-          }else{
-            read_size = ::fread(buffer, 1, (size_t)input_buffer_size, stream);
+          }else if(rt != 0){
+            read_size = stream->read(buffer, (size_t)input_buffer_size);
             src=buffer;
-            if (ferror(stream))
+            if (stream->error())
             {
               std::cerr<<"file read error."<<std::endl;
               break;
             }
+          }else{
+            read_size=0;
           }
 
           //dstの更新
@@ -115,10 +125,17 @@ namespace JHPCNDF
 
           //伸長済サイズを更新
           decompressed_size+=dst_size;
-          if(decompressed_size >= size_in_byte) break;
+
+          //フレームの終端(end mark)まで処理したら終了
+          if(rt == 0) break;
+          if(read_size == 0 && dst_size == 0) break;
         }
 
-        delete [] buffer;
+        //フレームの終端より後ろまで読み込んでいた分だけファイルの読み込み位置を戻す
+        if(read_size > 0)
+        {
+          stream->unread(read_size);
+        }
         return decompressed_size;
       }
 
@@ -127,18 +144,22 @@ namespace JHPCNDF
       //@param ptr     圧縮するデータを格納した領域へのポインタ
       //@param size    圧縮するデータの1要素の長さ
       //@param nmemb   圧縮するデータの要素数
-      //@param stream  ファイル出力先のポインタ
+      //@param stream  出力先
       //@ret   出力したファイルサイズ(Byte)
       //
       //
       //lz4の初期化に失敗した場合は、メッセージを出力した上で無圧縮のファイルを出力する
       //圧縮中にエラーが発生した場合は、メッセージを出力した上で0を返す
-      size_t fwrite(const void *ptr, size_t size, size_t nmemb, FILE *stream)
+      size_t fwrite(const void *ptr, size_t size, size_t nmemb, Stream *stream)
       {
         size_t output_size=0;
         LZ4F_compressOptions_t cOpt={0};
         const size_t dst_size = LZ4F_compressBound(buffer_size, &preferences)+19;
-        unsigned char* dst = new unsigned char[dst_size];
+        if(output_buffer == NULL)
+        {
+          output_buffer = new unsigned char[dst_size];
+        }
+        unsigned char* dst = output_buffer;
 
         const size_t size_in_byte=size*nmemb;
         unsigned int reminder = size_in_byte%buffer_size;
@@ -150,14 +171,12 @@ namespace JHPCNDF
         if (LZ4F_isError(header_size))
         {
           std::cerr<<"Header generation failed: "<<LZ4F_getErrorName(header_size)<<std::endl;
-          delete [] dst;
           return 0;
         }
-        size_t rt=::fwrite(dst, 1, header_size, stream);
+        size_t rt=stream->write(dst, header_size);
         if(rt!=header_size)
         {
           std::cerr<<"Header write failed: "<<LZ4F_getErrorName(header_size)<<std::endl;
-          delete [] dst;
           return 0;
         }
 
@@ -168,11 +187,10 @@ namespace JHPCNDF
           {
             std::cerr<<"Compress failed: "<<LZ4F_getErrorName(compressed_size)<<std::endl;
           }
-          size_t rt=::fwrite(dst, 1, compressed_size, stream);
+          size_t rt=stream->write(dst, compressed_size);
           if(rt != compressed_size)
           {
             std::cerr<<"file output failed! "<<std::endl;
-            delete [] dst;
             return output_size;
           }
           output_size += buffer_size;
@@ -185,11 +203,10 @@ namespace JHPCNDF
           {
             std::cerr<<"Compress failed: "<<LZ4F_getErrorName(compressed_size)<<std::endl;
           }
-          size_t rt = ::fwrite(dst, 1, compressed_size, stream);
+          size_t rt = stream->write(dst, compressed_size);
           if(rt != compressed_size)
           {
             std::cerr<<"file output failed! "<<std::endl;
-            delete [] dst;
             return output_size;
           }
           output_size += reminder;
@@ -199,23 +216,25 @@ namespace JHPCNDF
         if (LZ4F_isError(footer_size))
         {
           std::cerr<<"footer generation failed: "<<LZ4F_getErrorName(header_size)<<std::endl;
-          delete [] dst;
           return 0;
         }
-        rt = ::fwrite(dst, 1, footer_size, stream);
+        rt = stream->write(dst, footer_size);
         if(rt != footer_size)
         {
           std::cerr<<"file output failed! "<<std::endl;
-          delete [] dst;
           return output_size;
         }
 
-        delete [] dst;
         return output_size;
       }
 
     private:
+      lz4IO(const lz4IO&);
+      lz4IO& operator=(const lz4IO&);
+
       const int buffer_size;
+      char* input_buffer;
+      unsigned char* output_buffer;
       LZ4F_preferences_t preferences;
       LZ4F_compressionContext_t ctx;
       LZ4F_decompressionContext_t dctx;
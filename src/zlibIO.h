@@ -26,25 +26,53 @@ namespace JHPCNDF
             level(arg_level),
             strategy(arg_st),
             windowBits(16+MAX_WBITS),
-            block_size(UINT_MAX) {}
+            block_size(UINT_MAX),
+            buffer(NULL),
+            probe_initialized(false),
+            dictionary(NULL),
+            dictionary_size(0) {}
+          ~zlibIO()
+          {
+              delete [] buffer;
+              if(probe_initialized)
+              {
+                  deflateEnd(&probe_lz);
+                  deflateEnd(&probe_huffman);
+              }
+          }
           
           //@brief zlibで圧縮されたデータを読み込んで伸長したうえでptrへ書き込む
           //
           //引数、戻り値はBaseIO.hを参照のこと
           //なお、本ルーチンはエラー発生時にstderrへメッセージを出力した上で0を返す
           //伸長後のファイルサイズが0だった場合も0が返るので注意
-          size_t fread(void *ptr, size_t size, size_t nmemb, FILE *stream)
+          using IO::fread;
+          using IO::fwrite;
+
+          void set_dictionary(const void* arg_dictionary, size_t size)
+          {
+              dictionary=static_cast<const Bytef*>(arg_dictionary);
+              dictionary_size = dictionary != NULL ? size : 0;
+          }
+          bool supports_dictionary(void) const
+          {
+              return true;
+          }
+
+          //gzip形式とzlib形式のどちらで圧縮されたデータも読み込める
+          //プリセット辞書を使ったzlib形式のデータは、set_dictionaryで同じ辞書を設定しておく必要がある
+          size_t fread(void *ptr, size_t size, size_t nmemb, Stream *stream)
           {
               size_t output_size=0;
               z_stream z_st;
               init_zstream(&z_st);
-              if(inflateInit2(&z_st, windowBits) != Z_OK)
+              if(inflateInit2(&z_st, 32+MAX_WBITS) != Z_OK)
               {
                   std::cerr<<"zlib initialization failed."<<std::endl;
                   return 0;
               }
 
-              unsigned char* buffer = new unsigned char[buffer_size];
+              unsigned char* buffer = get_buffer();
               const size_t size_in_byte=size*nmemb;
               unsigned int reminder = size_in_byte%block_size;
               const int num_block = size_in_byte/block_size;
@@ -66,12 +94,11 @@ namespace JHPCNDF
 
               //入力バッファの初期設定
               //ファイルをbuffer_size分読んで入力バッファをセット
-              z_st.avail_in = ::fread(buffer, 1, (size_t)buffer_size, stream);
+              z_st.avail_in = stream->read(buffer, (size_t)buffer_size);
               size_t read_size = z_st.avail_in;
-              if (ferror(stream)) {
+              if (stream->error()) {
                   inflateEnd(&z_st);
                   std::cerr<<"file read error."<<std::endl;
-                  delete [] buffer;
                   return 0;
               }
               z_st.next_in = (Bytef*)buffer;
@@ -82,13 +109,24 @@ namespace JHPCNDF
               {
                   // bufferにあるデータを伸張
                   int old_avail_out=z_st.avail_out;
-                  int flush = feof(stream) ? Z_FINISH : Z_NO_FLUSH;
+                  int flush = stream->eof() ? Z_FINISH : Z_NO_FLUSH;
                   rt = inflate(&z_st, flush);
                   output_size += old_avail_out-z_st.avail_out;
 
+                  //辞書IDが一致しない場合はinflateSetDictionaryがZ_DATA_ERRORを返す
+                  if(rt == Z_NEED_DICT)
+                  {
+                      if(dictionary == NULL)
+                      {
+                          std::cerr<<"preset dictionary is required to decompress this record."<<std::endl;
+                          inflateEnd(&z_st);
+                          return 0;
+                      }
+                      rt = inflateSetDictionary(&z_st, dictionary, dictionary_size);
+                  }
                   if(rt == Z_NEED_DICT || rt == Z_DATA_ERROR || rt == Z_STREAM_ERROR || rt == Z_MEM_ERROR)
                   {
-                      return fatal_error(&z_st, buffer);
+                      return fatal_error(&z_st, inflateEnd);
                   }else{
                       // 出力バッファが無くなっていたらバッファ領域を再設定
                       if(z_st.avail_out == 0)
@@ -97,11 +135,12 @@ namespace JHPCNDF
                           z_st.next_out=(Bytef*)(ptr)+offsets[offset_index++];
                       }
                       //入力バッファが無くなっていたらファイルから読み込み
-                      if(z_st.avail_in == 0)
+                      //(ストリームの終端に達していたら次のレコードを読んでしまわないように読み込まない)
+                      if(rt != Z_STREAM_END && z_st.avail_in == 0)
                       {
-                          z_st.avail_in = ::fread(buffer, 1, (size_t)buffer_size, stream);
+                          z_st.avail_in = stream->read(buffer, (size_t)buffer_size);
                           read_size += z_st.avail_in;
-                          if (ferror(stream)) {
+                          if (stream->error()) {
                               inflateEnd(&z_st);
                               std::cerr<<"file read error."<<std::endl;
                               return 0;
@@ -111,8 +150,13 @@ namespace JHPCNDF
                   }
               }while(rt != Z_STREAM_END);
 
+              //ストリームの終端より後ろまで読み込んでいた分だけファイルの読み込み位置を戻す
+              //(同じファイルに続けて書かれたレコードを次の呼び出しで読めるようにするため)
+              if(z_st.avail_in > 0)
+              {
+                  stream->unread(z_st.avail_in);
+              }
               inflateEnd(&z_st);
-              delete [] buffer;
               return output_size;
           }
 
@@ -120,103 +164,100 @@ namespace JHPCNDF
           //@brief zlibを使って圧縮したデータをファイルに出力する
           //引数、戻り値はBaseIO.hを参照のこと
           //
+          //入力はSEGMENT_SIZE毎に区切って圧縮する
+          //各区間の一部を試しに圧縮した結果から、その区間のみ無圧縮ブロックや
+          //ハフマン符号のみの圧縮に切り替える(choose_paramsを参照のこと)
+          //出力は通常のgzip形式のままなので、伸長側は区別せずに読み込める
+          //
+          //set_dictionaryで辞書が設定されている場合は、辞書を使ったzlib形式で出力する
+          //
           //zlibの初期化に失敗した場合は、メッセージを出力した上で無圧縮のファイルを出力する
           //圧縮中にエラーが発生した場合は、メッセージを出力した上で0を返す
-          size_t fwrite(const void *ptr, size_t size, size_t nmemb, FILE *stream)
+          size_t fwrite(const void *ptr, size_t size, size_t nmemb, Stream *stream)
           {
               size_t output_size=0;
               z_stream z_st;
               init_zstream(&z_st);
 
-              if(deflateInit2(&z_st, level, Z_DEFLATED, windowBits, 8, strategy) != Z_OK)
+              //gzip形式ではプリセット辞書を使えないので、辞書を使う時はzlib形式にする
+              if(deflateInit2(&z_st, level, Z_DEFLATED, dictionary != NULL ? MAX_WBITS : windowBits, 8, strategy) != Z_OK)
               {
                   std::cerr<<"zlib initialization failed uncompressed output will be generated."<<std::endl;
-                  return ::fwrite(ptr, size, nmemb, stream);
+                  return stream->write(ptr, size*nmemb)/size;
               }
-
-              unsigned char* buffer = new unsigned char[buffer_size];
-              const size_t size_in_byte=size*nmemb;
-              unsigned int reminder = size_in_byte%block_size;
-              const int num_block = size_in_byte/block_size;
-
-              std::vector<size_t> offsets;
-              if(reminder > 0)
+              if(dictionary != NULL && deflateSetDictionary(&z_st, dictionary, dictionary_size) != Z_OK)
               {
-                  offsets.push_back(reminder);
+                  return fatal_error(&z_st, deflateEnd);
               }
-              for(int i=1; i<= size_in_byte/block_size; i++)
-              {
-                  offsets.push_back(reminder+i*block_size);
-              }
-              int offset_index=0;
-                  
+
+              unsigned char* buffer = get_buffer();
+              const size_t size_in_byte=size*nmemb;
+              const Bytef* src=static_cast<const Bytef*>(ptr);
+              size_t input_offset=0;
+              int current_level=level;
+              int current_strategy=strategy;
 
               // 出力バッファの初期設定
               z_st.avail_out=buffer_size;
               z_st.next_out=(Bytef*)buffer;
 
-              //入力バッファの初期設定
-              z_st.avail_in = offsets[0];
-              z_st.next_in = (Bytef*)ptr;
+              //入力バッファの初期設定 (ループの先頭で最初の区間を設定する)
+              z_st.avail_in = 0;
+              z_st.next_in = (Bytef*)src;
 
               int rt=Z_OK;
               int flush=Z_NO_FLUSH;
               do
               {
+                  //入力バッファが無くなっていたら次の区間を設定する
+                  //最後の区間まで圧縮していたらflush parameterを切り替える
+                  if(z_st.avail_in == 0 && flush == Z_NO_FLUSH)
+                  {
+                      if(input_offset == size_in_byte)
+                      {
+                          flush=Z_FINISH;
+                      }else{
+                          const size_t length = size_in_byte-input_offset < (size_t)SEGMENT_SIZE ? size_in_byte-input_offset : (size_t)SEGMENT_SIZE;
+                          int segment_level, segment_strategy;
+                          choose_params(src+input_offset, length, &segment_level, &segment_strategy);
+                          if(segment_level != current_level || segment_strategy != current_strategy)
+                          {
+                              if(!change_params(&z_st, segment_level, segment_strategy, stream, &output_size))
+                              {
+                                  return output_error(&z_st, output_size);
+                              }
+                              current_level=segment_level;
+                              current_strategy=segment_strategy;
+                          }
+                          z_st.avail_in=length;
+                          z_st.next_in=(Bytef*)(src+input_offset);
+                          input_offset+=length;
+                      }
+                  }
+
                   //bufferサイズ分だけ圧縮
                   rt = deflate(&z_st, flush);
                   if(rt== Z_STREAM_ERROR)
                   {
-                      return fatal_error(&z_st, buffer);
-                  }else{
-                      //出力バッファが無くなっていたらファイルへ出力してバッファを再設定
-                      if(z_st.avail_out ==0)
-                      {
-                        size_t written_size = ::fwrite(buffer, 1, (size_t)(buffer_size), stream);
-                        if(written_size >= buffer_size)
-                        {
-                          output_size += buffer_size;
-                        }else{
-                          std::cerr<<"file output failed! "<<std::endl;
-                          delete [] buffer;
-                          return output_size;
-                        }
-                        z_st.avail_out=buffer_size;
-                        z_st.next_out=(Bytef*)buffer;
-                      }
-                      //入力バッファが無くなっていたらバッファ領域を再設定
-                      if(z_st.avail_in == 0)
+                      return fatal_error(&z_st, deflateEnd);
+                  }
+                  //出力バッファが無くなっていたらファイルへ出力してバッファを再設定
+                  if(z_st.avail_out ==0)
+                  {
+                      if(!flush_buffer(&z_st, stream, &output_size))
                       {
-                          //最後のブロックまで圧縮していたらflush parameterを切り替える
-                          //まだブロックが残っていれば入力バッファを進める
-                          if(offset_index == offsets.size()-1)
-                          {
-                              flush=Z_FINISH;
-                          }else{
-                              z_st.avail_in=block_size;
-                              z_st.next_in=(Bytef*)(ptr)+offsets[offset_index++];
-                          }
+                          return output_error(&z_st, output_size);
                       }
                   }
               }while(rt != Z_STREAM_END);
 
               //bufferにまだファイルに書いていないデータが残っていたら書き出す
-              size_t leftover=buffer_size-z_st.avail_out;
-              if(leftover>0)
+              if(!flush_buffer(&z_st, stream, &output_size))
               {
-                size_t written_size = ::fwrite(buffer, 1, leftover, stream);
-                if(written_size >= leftover)
-                {
-                  output_size += leftover;
-                }else{
-                  std::cerr<<"file output failed! "<<std::endl;
-                  delete [] buffer;
-                  return output_size;
-                }
+                  return output_error(&z_st, output_size);
               }
 
               deflateEnd(&z_st);
-              delete [] buffer;
               return output_size;
           }
 
@@ -228,15 +269,165 @@ namespace JHPCNDF
               stream->opaque = Z_NULL;
           }
 
-          int fatal_error(z_stream* z_st, unsigned char* buffer)
+          //@brief 出力バッファに溜まっているデータをファイルへ書き出してバッファを再設定する
+          bool flush_buffer(z_stream* z_st, Stream* stream, size_t* output_size)
+          {
+              const size_t length=buffer_size-z_st->avail_out;
+              if(length > 0)
+              {
+                  if(stream->write(buffer, length) < length)
+                  {
+                      return false;
+                  }
+                  *output_size += length;
+              }
+              z_st->avail_out=buffer_size;
+              z_st->next_out=(Bytef*)buffer;
+              return true;
+          }
+
+          //@brief 圧縮途中で圧縮レベルとstrategyを切り替える
+          //
+          //deflateParamsはそれまでの入力をブロックの区切りまで出力するので
+          //出力バッファが足りなかった場合はファイルへ書き出してから再試行する
+          bool change_params(z_stream* z_st, const int& new_level, const int& new_strategy, Stream* stream, size_t* output_size)
+          {
+              int rt=deflateParams(z_st, new_level, new_strategy);
+              while(rt == Z_BUF_ERROR && z_st->avail_out < (uInt)buffer_size)
+              {
+                  if(!flush_buffer(z_st, stream, output_size))
+                  {
+                      return false;
+                  }
+                  rt=deflateParams(z_st, new_level, new_strategy);
+              }
+              return rt == Z_OK;
+          }
+
+          //@brief 区間の中央付近のSAMPLE_SIZE分を試しに圧縮して、区間の圧縮パラメータを決める
+          //@param segment_level    区間の圧縮に使う圧縮レベル
+          //@param segment_strategy 区間の圧縮に使うstrategy
+          //
+          //圧縮レベル1とハフマン符号のみ(Z_HUFFMAN_ONLY)の2通りで試し圧縮を行い
+          //  どちらでも元のサイズのBYPASS_PERCENT%以上になる場合:   無圧縮ブロック(圧縮レベル0)
+          //  ハフマン符号のみとの差がHUFFMAN_PERCENT%以内の場合:    Z_HUFFMAN_ONLY
+          //  それ以外:                                             指定された圧縮レベルとstrategy
+          //とする。下位bit側のように一致列がほとんど無いデータでは、一致列の探索を省くことで
+          //圧縮率をほぼ変えずに圧縮時間を大きく短縮できる
+          //試し圧縮に使うz_streamは最初に使われた時に初期化し、インスタンスが破棄されるまで使い回す
+          //試し圧縮ができなかった場合は指定されたパラメータで圧縮する
+          void choose_params(const Bytef* src, const size_t& length, int* segment_level, int* segment_strategy)
+          {
+              *segment_level=level;
+              *segment_strategy=strategy;
+              if(!probe_initialized)
+              {
+                  init_zstream(&probe_lz);
+                  init_zstream(&probe_huffman);
+                  if(deflateInit2(&probe_lz, 1, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                  {
+                      return;
+                  }
+                  if(deflateInit2(&probe_huffman, 1, Z_DEFLATED, -MAX_WBITS, 8, Z_HUFFMAN_ONLY) != Z_OK)
+                  {
+                      deflateEnd(&probe_lz);
+                      return;
+                  }
+                  probe_initialized=true;
+                  probe_buffer.resize(deflateBound(&probe_lz, SAMPLE_SIZE));
+              }
+              const size_t sample_size = length < (size_t)SAMPLE_SIZE ? length : (size_t)SAMPLE_SIZE;
+              const Bytef* sample=src+(length-sample_size)/2;
+              const size_t lz_size=probe_size(&probe_lz, sample, sample_size);
+              if(lz_size == 0)
+              {
+                  return;
+              }
+              //ハフマン符号のみでは1byteあたり1bit未満にはならないので、それより縮む場合は試さない
+              if(lz_size*8 < sample_size)
+              {
+                  return;
+              }
+              const size_t huffman_size=probe_size(&probe_huffman, sample, sample_size);
+              if(huffman_size == 0)
+              {
+                  return;
+              }
+              const size_t best_size = lz_size < huffman_size ? lz_size : huffman_size;
+              if(best_size*100 >= sample_size*BYPASS_PERCENT)
+              {
+                  *segment_level=0;
+              }else if(huffman_size*100 <= lz_size*(100+HUFFMAN_PERCENT) && (strategy == Z_DEFAULT_STRATEGY || strategy == Z_FILTERED))
+              {
+                  *segment_strategy=Z_HUFFMAN_ONLY;
+              }
+          }
+
+          //@brief 試し圧縮を行って圧縮後のサイズを返す (失敗した場合は0)
+          size_t probe_size(z_stream* probe, const Bytef* sample, const size_t& sample_size)
+          {
+              deflateReset(probe);
+              probe->next_in=(Bytef*)sample;
+              probe->avail_in=sample_size;
+              probe->next_out=&(probe_buffer[0]);
+              probe->avail_out=probe_buffer.size();
+              if(deflate(probe, Z_FINISH) != Z_STREAM_END)
+              {
+                  return 0;
+              }
+              return probe->total_out;
+          }
+
+          //@brief zlibの処理中のエラーを報告し、z_stの内部状態を解放する
+          //@param end z_stの初期化に対応する終了関数 (inflateEnd or deflateEnd)
+          int fatal_error(z_stream* z_st, int (*end)(z_streamp))
           {
               std::cerr<<"fatal error occurred during the processing of zlib"<<std::endl;
-              delete [] buffer;
+              end(z_st);
               return 0;
           }
 
+          //@brief 圧縮データの出力に失敗した時に、z_stの内部状態を解放して出力済のサイズを返す
+          size_t output_error(z_stream* z_st, const size_t& output_size)
+          {
+              std::cerr<<"file output failed! "<<std::endl;
+              deflateEnd(z_st);
+              return output_size;
+          }
+
+          //@brief 入出力用のバッファを返す
+          //
+          //バッファは最初に使われた時に確保し、インスタンスが破棄されるまで使い回す
+          unsigned char* get_buffer(void)
+          {
+              if(buffer == NULL)
+              {
+                  buffer = new unsigned char[buffer_size];
+              }
+              return buffer;
+          }
+
+          zlibIO(const zlibIO&);
+          zlibIO& operator=(const zlibIO&);
+
           const int buffer_size;
           const size_t block_size;
+          unsigned char* buffer;
+
+          enum
+          {
+              SEGMENT_SIZE=131072,  // 圧縮時に入力を区切る単位
+              SAMPLE_SIZE=4096,     // 区間毎の試し圧縮に使うサイズ
+              BYPASS_PERCENT=95,    // 試し圧縮後のサイズが元のサイズのこの割合(%)以上なら無圧縮で出力する
+              HUFFMAN_PERCENT=2     // ハフマン符号のみでの試し圧縮後のサイズとの差がこの割合(%)以内ならZ_HUFFMAN_ONLYで圧縮する
+          };
+          z_stream probe_lz;
+          z_stream probe_huffman;
+          bool probe_initialized;
+          std::vector<Bytef> probe_buffer;
+
+          const Bytef* dictionary;
+          uInt dictionary_size;
 
           // instanceが生成された後で変更されるとややこしいのでsetterは作らないこと！
           int level;
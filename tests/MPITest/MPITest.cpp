@@ -0,0 +1,241 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file MPITest.cpp
+//
+// MPI-IOによる共有ファイル入出力のテスト
+//
+// usage: mpiexec -n <np> MPITest write
+//        mpiexec -n <np> MPITest read
+//
+// writeはプロセス毎に異なる要素数でfloat/doubleの2レコードを出力し
+// readは出力時とは異なるプロセス数で均等に分割して読み込んで値を検証する
+// また、範囲や3次元配列の部分領域を指定した読み込みも検証する
+//
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "jhpcndf_mpi.h"
+
+namespace
+{
+  const char* upper_filename="mpitest_upper";
+  const char* lower_filename="mpitest_lower";
+  const size_t dims[3]={53, 37, 51};
+  const size_t num_elements=dims[0]*dims[1]*dims[2];
+  const size_t chunk_elements=4096;
+
+  template<typename T>
+  T value(const size_t& index, const int& record)
+  {
+    return (T)(std::sin(0.001*index)*(record+1)*100.0);
+  }
+
+  // 書き込み時の分割 (プロセス毎に要素数を変える)
+  void write_range(const int& rank, const int& nprocs, size_t* first, size_t* count)
+  {
+    size_t weight_total=0;
+    for(int i=0; i<nprocs; i++)
+    {
+      weight_total+=i+1;
+    }
+    size_t offset=0;
+    for(int i=0; i<rank; i++)
+    {
+      offset+=num_elements*(i+1)/weight_total;
+    }
+    *first=offset;
+    *count= rank == nprocs-1 ? num_elements-offset : num_elements*(rank+1)/weight_total;
+  }
+
+  // 読み込み時の分割 (均等割り)
+  void read_range(const int& rank, const int& nprocs, size_t* first, size_t* count)
+  {
+    const size_t base=num_elements/nprocs;
+    const size_t reminder=num_elements%nprocs;
+    *first=base*rank+std::min<size_t>(rank, reminder);
+    *count=base+(rank < (int)reminder ? 1 : 0);
+  }
+
+  template<typename T>
+  int write_record(const int& key, const int& rank, const int& nprocs, const int& record)
+  {
+    size_t first, count;
+    write_range(rank, nprocs, &first, &count);
+    std::vector<T> data(count+1);
+    for(size_t i=0; i<count; i++)
+    {
+      data[i]=value<T>(first+i, record);
+    }
+    if(JHPCNDF::mpi_fwrite(&(data[0]), count, key, 0.01) == 0 && count > 0)
+    {
+      std::cerr<<"rank "<<rank<<": mpi_fwrite failed"<<std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  template<typename T>
+  int read_record(const int& key, const int& rank, const int& nprocs, const int& record, const bool& lossless)
+  {
+    size_t first, count;
+    read_range(rank, nprocs, &first, &count);
+    std::vector<T> data(count+1);
+    if(JHPCNDF::mpi_fread(&(data[0]), count, key) != count)
+    {
+      std::cerr<<"rank "<<rank<<": mpi_fread failed"<<std::endl;
+      return 1;
+    }
+    int num_errors=0;
+    for(size_t i=0; i<count; i++)
+    {
+      const T expected=value<T>(first+i, record);
+      const bool ok = lossless ? data[i] == expected : std::fabs(data[i]-expected) <= std::fabs(expected*0.01);
+      if(!ok)
+      {
+        if(num_errors < 10)
+        {
+          std::cerr<<"rank "<<rank<<": record "<<record<<" index "<<first+i<<" expected "<<expected<<" actual "<<data[i]<<std::endl;
+        }
+        num_errors++;
+      }
+    }
+    return num_errors;
+  }
+
+  // 各プロセスが重なりのある任意の範囲を読み込む
+  template<typename T>
+  int read_range_record(const int& key, const int& rank, const int& record)
+  {
+    if(JHPCNDF::mpi_get_record_elements(key) != num_elements)
+    {
+      std::cerr<<"rank "<<rank<<": mpi_get_record_elements failed"<<std::endl;
+      return 1;
+    }
+    const size_t first=(rank*7919+13)%num_elements;
+    const size_t count=std::min<size_t>(20000, num_elements-first);
+    std::vector<T> data(count+1);
+    if(JHPCNDF::mpi_fread_range(&(data[0]), first, count, key) != count)
+    {
+      std::cerr<<"rank "<<rank<<": mpi_fread_range failed"<<std::endl;
+      return 1;
+    }
+    int num_errors=0;
+    for(size_t i=0; i<count; i++)
+    {
+      if(data[i] != value<T>(first+i, record)) num_errors++;
+    }
+    return num_errors;
+  }
+
+  // 各プロセスがz方向に分割した部分領域を読み込む
+  template<typename T>
+  int read_subarray_record(const int& key, const int& rank, const int& nprocs, const int& record)
+  {
+    size_t start[3]={5, 3, 0};
+    size_t count[3]={40, 30, 0};
+    start[2]=dims[2]*rank/nprocs;
+    count[2]=dims[2]*(rank+1)/nprocs-start[2];
+    std::vector<T> data(count[0]*count[1]*count[2]+1);
+    if(JHPCNDF::mpi_fread_subarray(&(data[0]), dims, start, count, key) != count[0]*count[1]*count[2])
+    {
+      std::cerr<<"rank "<<rank<<": mpi_fread_subarray failed"<<std::endl;
+      return 1;
+    }
+    int num_errors=0;
+    for(size_t k=0; k<count[2]; k++)
+    {
+      for(size_t j=0; j<count[1]; j++)
+      {
+        for(size_t i=0; i<count[0]; i++)
+        {
+          const size_t index=((start[2]+k)*dims[1]+start[1]+j)*dims[0]+start[0]+i;
+          if(data[(k*count[1]+j)*count[0]+i] != value<T>(index, record)) num_errors++;
+        }
+      }
+    }
+    return num_errors;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+  int rank=0;
+  int nprocs=1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+  if(argc < 2)
+  {
+    if(rank == 0)
+    {
+      std::cerr<<"usage: "<<argv[0]<<" write|read"<<std::endl;
+    }
+    MPI_Finalize();
+    return 1;
+  }
+
+  int num_errors=0;
+  if(strcmp(argv[1], "write") == 0)
+  {
+    int key=JHPCNDF::mpi_fopen(MPI_COMM_WORLD, upper_filename, lower_filename, "wb", "gzip", 32768, chunk_elements);
+    if(key < 0)
+    {
+      num_errors++;
+    }else{
+      num_errors+=write_record<float>(key, rank, nprocs, 0);
+      num_errors+=write_record<double>(key, rank, nprocs, 1);
+      JHPCNDF::mpi_fclose(key);
+    }
+  }else{
+    // 上位bitと下位bitの両方を読み込んだ場合は元データに戻る
+    int key=JHPCNDF::mpi_fopen(MPI_COMM_WORLD, upper_filename, lower_filename, "rb", "gzip");
+    if(key < 0)
+    {
+      num_errors++;
+    }else{
+      num_errors+=read_record<float>(key, rank, nprocs, 0, true);
+      num_errors+=read_record<double>(key, rank, nprocs, 1, true);
+      JHPCNDF::mpi_fclose(key);
+    }
+
+    // レコード内の範囲/部分領域を指定した読み込み
+    key=JHPCNDF::mpi_fopen(MPI_COMM_WORLD, upper_filename, lower_filename, "rb", "gzip");
+    if(key < 0)
+    {
+      num_errors++;
+    }else{
+      num_errors+=read_range_record<float>(key, rank, 0);
+      num_errors+=read_subarray_record<double>(key, rank, nprocs, 1);
+      JHPCNDF::mpi_fclose(key);
+    }
+
+    // 上位bitのみ読み込んだ場合は許容誤差内に収まる
+    key=JHPCNDF::mpi_fopen(MPI_COMM_WORLD, upper_filename, "", "rb", "gzip");
+    if(key < 0)
+    {
+      num_errors++;
+    }else{
+      num_errors+=read_record<float>(key, rank, nprocs, 0, false);
+      num_errors+=read_record<double>(key, rank, nprocs, 1, false);
+      JHPCNDF::mpi_fclose(key);
+    }
+  }
+
+  int total_errors=0;
+  MPI_Allreduce(&num_errors, &total_errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  if(rank == 0)
+  {
+    std::cout<<argv[1]<<" with "<<nprocs<<" processes: "<<(total_errors == 0 ? "passed" : "failed")<<std::endl;
+  }
+  MPI_Finalize();
+  return total_errors == 0 ? 0 : 1;
+}
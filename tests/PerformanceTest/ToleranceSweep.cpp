@@ -0,0 +1,162 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file ToleranceSweep.cpp
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <unistd.h>
+#include "jhpcndf.h"
+#include "real_type.h"
+
+//複数の許容誤差について、分割位置のヒストグラムと推定出力サイズを変数(ファイル)毎に表示する
+//許容誤差毎にPerformanceTestを実行する代わりに、各ファイルを1回読むだけで許容誤差を比べられる
+namespace{
+void usage_and_exit(const char* cmd, const int& err_code)
+{
+  std::cerr<<"usage: "<<cmd<<" [-t tolerance,tolerance,...] [-a] [-e encoder] [-c compression] [-n number_of_data] [-r] [-H] file..."<< std::endl;
+  std::cerr<<"  -a  tolerances are absolute values (default: relative)"<<std::endl;
+  std::cerr<<"  -n  number of data in each file (required unless -r is specified)"<<std::endl;
+  std::cerr<<"  -r  files are raw binary arrays instead of JHPCN-DF files"<<std::endl;
+  std::cerr<<"  -H  print histogram of truncated bits"<<std::endl;
+  exit(err_code);
+}
+
+std::vector<float> parse_tolerances(const std::string& arg)
+{
+  std::vector<float> tolerances;
+  std::istringstream iss(arg);
+  std::string tmp;
+  while(getline(iss, tmp, ','))
+  {
+    tolerances.push_back((float)std::atof(tmp.c_str()));
+  }
+  return tolerances;
+}
+
+//ファイル全体を1回だけ読み込む
+bool read_data(const std::string& filename, const bool& raw, const size_t& num_data, std::vector<REAL_TYPE>* data)
+{
+  if(raw)
+  {
+    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    if(!ifs)
+    {
+      return false;
+    }
+    ifs.seekg(0, std::ios::end);
+    const size_t size=ifs.tellg();
+    ifs.seekg(0, std::ios::beg);
+    data->resize(size/sizeof(REAL_TYPE));
+    if(!data->empty())
+    {
+      ifs.read(reinterpret_cast<char*>(&((*data)[0])), data->size()*sizeof(REAL_TYPE));
+    }
+    return ifs.good();
+  }
+  data->resize(num_data);
+  int key=JHPCNDF::fopen(filename);
+  if(key < 0 || num_data == 0)
+  {
+    return false;
+  }
+  const size_t read_size=JHPCNDF::fread(&((*data)[0]), sizeof(REAL_TYPE), num_data, key);
+  JHPCNDF::fclose(key);
+  return read_size > 0;
+}
+}
+
+int main(int argc, char *argv[])
+{
+  std::vector<float> tolerances=parse_tolerances("1e-1,1e-2,1e-3,1e-4,1e-5,1e-6");
+  bool is_relative=true;
+  std::string encoder="binary_search";
+  std::string comp="gzip";
+  size_t num_data=0;
+  bool raw=false;
+  bool print_histogram=false;
+
+  int results=0;
+  while((results=getopt(argc,argv,"t:ae:c:n:rH")) != -1)
+  {
+    switch(results)
+    {
+      case 't':
+        tolerances=parse_tolerances(optarg);
+        break;
+      case 'a':
+        is_relative=false;
+        break;
+      case 'e':
+        encoder=optarg;
+        break;
+      case 'c':
+        comp=optarg;
+        break;
+      case 'n':
+        num_data=std::atol(optarg);
+        break;
+      case 'r':
+        raw=true;
+        break;
+      case 'H':
+        print_histogram=true;
+        break;
+      case '?':
+        usage_and_exit(argv[0], -1);
+        break;
+    }
+  }
+  if(optind >= argc || tolerances.empty() || (!raw && num_data == 0))
+  {
+    usage_and_exit(argv[0], -1);
+  }
+
+  std::vector<REAL_TYPE> data;
+  for(int i=optind; i<argc; i++)
+  {
+    const std::string filename(argv[i]);
+    if(!read_data(filename, raw, num_data, &data))
+    {
+      std::cerr<<"failed to read "<<filename<<std::endl;
+      continue;
+    }
+    std::vector<JHPCNDF::ToleranceSweepResult> sweep;
+    JHPCNDF::sweep_tolerances(&(data[0]), data.size(), tolerances, &sweep, is_relative, encoder, comp);
+
+    const double original_size=(double)data.size()*sizeof(REAL_TYPE);
+    std::cout<<"# "<<filename<<" ("<<data.size()<<" elements, "<<encoder<<", "<<comp<<", "<<(is_relative ? "relative" : "absolute")<<")"<<std::endl;
+    std::cout<<std::setw(12)<<"tolerance"<<std::setw(14)<<"mean_bits"<<std::setw(16)<<"upper_size"<<std::setw(12)<<"ratio"<<std::setw(16)<<"lower_size"<<std::endl;
+    for(size_t k=0; k<sweep.size(); k++)
+    {
+      const JHPCNDF::ToleranceSweepResult& result=sweep[k];
+      std::cout<<std::scientific<<std::setprecision(3)<<std::setw(12)<<result.tolerance;
+      std::cout<<std::fixed<<std::setprecision(2)<<std::setw(14)<<result.mean_truncated_bits;
+      std::cout<<std::setw(16)<<result.estimated_upper_size;
+      std::cout<<std::setw(12)<<(result.estimated_upper_size > 0 ? original_size/result.estimated_upper_size : 0.0);
+      std::cout<<std::setw(16)<<result.estimated_lower_size<<std::endl;
+      if(print_histogram)
+      {
+        std::cout<<"  histogram:";
+        for(size_t n=0; n<result.histogram.size(); n++)
+        {
+          std::cout<<" "<<result.histogram[n];
+        }
+        std::cout<<std::endl;
+      }
+    }
+    std::cout<<std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestAsyncIO.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+#include "jhpcndf.h"
+#include "AsyncFileStream.h"
+#include "TestUtility.h"
+
+struct AsyncParam
+{
+  const char* comp;
+  size_t queue_depth;
+  size_t block_size;
+  bool direct_io;
+};
+
+class AsyncIOTest : public ::testing::TestWithParam<AsyncParam>
+{
+};
+
+TEST_P(AsyncIOTest, WriteAndRead)
+{
+  const AsyncParam param=GetParam();
+  const size_t nmemb=100000;
+  std::vector<float>  record0=make_record_data<float>(nmemb, 0);
+  std::vector<double> record1=make_record_data<double>(nmemb, 1);
+
+  int key=JHPCNDF::fopen_async("async_upper", "async_lower", "wb", param.comp, 32768, param.queue_depth, param.block_size, param.direct_io);
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fwrite(&(record0[0]), sizeof(float),  nmemb, key, 0.01), 0u);
+  EXPECT_GT(JHPCNDF::fwrite(&(record1[0]), sizeof(double), nmemb, key, 0.01), 0u);
+  JHPCNDF::fclose(key);
+
+  // fopen_asyncで読み込む
+  std::vector<float>  result0(nmemb);
+  std::vector<double> result1(nmemb);
+  key=JHPCNDF::fopen_async("async_upper", "async_lower", "rb", param.comp, 32768, param.queue_depth, param.block_size, param.direct_io);
+  ASSERT_GE(key, 0);
+  JHPCNDF::fread(&(result0[0]), sizeof(float),  nmemb, key);
+  JHPCNDF::fread(&(result1[0]), sizeof(double), nmemb, key);
+  JHPCNDF::fclose(key);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(record0[i], result0[i]) << "i = " << i;
+    ASSERT_EQ(record1[i], result1[i]) << "i = " << i;
+  }
+
+  // 出力したファイルは通常のfopenでも読み込める
+  key=JHPCNDF::fopen("async_upper", "async_lower", "rb", param.comp);
+  ASSERT_GE(key, 0);
+  JHPCNDF::fread(&(result0[0]), sizeof(float),  nmemb, key);
+  JHPCNDF::fread(&(result1[0]), sizeof(double), nmemb, key);
+  JHPCNDF::fclose(key);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(record0[i], result0[i]) << "i = " << i;
+    ASSERT_EQ(record1[i], result1[i]) << "i = " << i;
+  }
+}
+
+TEST_P(AsyncIOTest, ReadFileWrittenByFopen)
+{
+  const AsyncParam param=GetParam();
+  const size_t nmemb=50000;
+  std::vector<double> record=make_record_data<double>(nmemb, 2);
+
+  int key=JHPCNDF::fopen("async_upper", "", "wb", param.comp);
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite(&(record[0]), sizeof(double), nmemb, key, 0.01);
+  JHPCNDF::fwrite(&(record[0]), sizeof(double), nmemb, key, 0.01);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen_async("async_upper", "", "rb", param.comp, 32768, param.queue_depth, param.block_size, param.direct_io);
+  ASSERT_GE(key, 0);
+  std::vector<double> result(nmemb);
+  for(int r=0; r<2; r++)
+  {
+    JHPCNDF::fread(&(result[0]), sizeof(double), nmemb, key);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_NEAR(record[i], result[i], std::fabs(record[i]*0.01)) << "record = " << r << " i = " << i;
+    }
+  }
+  JHPCNDF::fclose(key);
+}
+
+const AsyncParam async_params[]=
+{
+  {"gzip", 4, 1048576, false},
+  {"gzip", 2, 4096,    false},
+  {"gzip", 3, 8192,    true},
+  {"none", 4, 65536,   false},
+  {"none", 1, 4096,    true},
+};
+INSTANTIATE_TEST_CASE_P(AsyncParams, AsyncIOTest, ::testing::ValuesIn(async_params));
+
+TEST(AsyncOpenTest, InvalidArgument)
+{
+  EXPECT_EQ(-500, JHPCNDF::fopen_async("async_upper", "", "w+b"));
+  EXPECT_EQ(-500, JHPCNDF::fopen_async("async_upper", "", "ab"));
+  EXPECT_EQ(-300, JHPCNDF::fopen_async("", "", "rb"));
+  EXPECT_EQ(-1,   JHPCNDF::fopen_async("no_such_directory/async_upper", "", "rb"));
+  // 失敗した時は名前を登録しない
+  int key=JHPCNDF::fopen("no_such_directory/async_upper", "", "rb");
+  EXPECT_GE(key, 0);
+  JHPCNDF::fclose(key);
+}
+
+TEST(AsyncFileStreamTest, UnreadAcrossBlocks)
+{
+  {
+    JHPCNDF::AsyncFileStream stream("async_stream", true, 2, 4096, false);
+    ASSERT_TRUE(stream.is_open());
+    std::vector<char> data(10000);
+    for(size_t i=0; i<data.size(); i++)
+    {
+      data[i]=(char)(i%251);
+    }
+    ASSERT_EQ(data.size(), stream.write(&(data[0]), data.size()));
+  }
+  JHPCNDF::AsyncFileStream stream("async_stream", false, 2, 4096, false);
+  ASSERT_TRUE(stream.is_open());
+  std::vector<char> buff(5000);
+  ASSERT_EQ(5000u, stream.read(&(buff[0]), 5000));
+  stream.unread(1000);
+  ASSERT_EQ(5000u, stream.read(&(buff[0]), 5000));
+  EXPECT_EQ((char)(4000%251), buff[0]);
+  EXPECT_EQ((char)(8999%251), buff[4999]);
+  ASSERT_EQ(1000u, stream.read(&(buff[0]), 5000));
+  EXPECT_EQ((char)(9999%251), buff[999]);
+  EXPECT_TRUE(stream.eof());
+  EXPECT_FALSE(stream.error());
+}
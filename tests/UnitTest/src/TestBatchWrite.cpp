@@ -0,0 +1,157 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestBatchWrite.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "jhpcndf.h"
+#include "TestUtility.h"
+
+class BatchWriteTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+      const size_t float_sizes[]={1000, 3, 37, 20000, 5};
+      for(size_t i=0; i<sizeof(float_sizes)/sizeof(size_t); i++)
+      {
+        float_data.push_back(make_data<float>(float_sizes[i], i));
+      }
+      const size_t double_sizes[]={3000, 1, 50000};
+      for(size_t i=0; i<sizeof(double_sizes)/sizeof(size_t); i++)
+      {
+        double_data.push_back(make_data<double>(double_sizes[i], 10.0*i));
+      }
+      const char* encoders[]={"binary_search", "quantize", "byte_aligned", "nbit_filter"};
+      for(size_t i=0; i<float_data.size(); i++)
+      {
+        requests.push_back(JHPCNDF::WriteRequest(&(float_data[i][0]), sizeof(float), float_data[i].size(), i == 4 ? 10.0f : 0.01f, true, encoders[i%4]));
+        if(i < double_data.size())
+        {
+          requests.push_back(JHPCNDF::WriteRequest(&(double_data[i][0]), sizeof(double), double_data[i].size(), 0.001f, i != 1, encoders[(i+1)%4]));
+        }
+      }
+    }
+
+    //requestsを1つずつJHPCNDF::fwriteで出力する
+    void write_sequential(const char* upper, const char* lower)
+    {
+      int key=JHPCNDF::fopen(upper, lower, "wb");
+      ASSERT_GE(key, 0);
+      for(size_t i=0; i<requests.size(); i++)
+      {
+        const JHPCNDF::WriteRequest& r=requests[i];
+        if(r.size == sizeof(float))
+        {
+          JHPCNDF::fwrite(static_cast<const float*>(r.ptr), r.size, r.nmemb, key, r.tolerance, r.is_relative, r.enc);
+        }else{
+          JHPCNDF::fwrite(static_cast<const double*>(r.ptr), r.size, r.nmemb, key, r.tolerance, r.is_relative, r.enc);
+        }
+      }
+      JHPCNDF::fclose(key);
+    }
+
+    std::vector<std::vector<float> > float_data;
+    std::vector<std::vector<double> > double_data;
+    std::vector<JHPCNDF::WriteRequest> requests;
+};
+
+TEST_F(BatchWriteTest, SameAsSequentialWrites)
+{
+  requests.insert(requests.begin()+2, JHPCNDF::WriteRequest(NULL, sizeof(float), 0, 0.01f));
+  write_sequential("sequential_upper", "sequential_lower");
+  int key=JHPCNDF::fopen("batch_upper", "batch_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fwrite_batch(requests, key), 0u);
+  JHPCNDF::fclose(key);
+
+  const std::vector<char> sequential_upper=read_file("sequential_upper");
+  ASSERT_FALSE(sequential_upper.empty());
+  EXPECT_TRUE(sequential_upper == read_file("batch_upper"));
+  EXPECT_TRUE(read_file("sequential_lower") == read_file("batch_lower"));
+}
+
+TEST_F(BatchWriteTest, ReadBack)
+{
+  int key=JHPCNDF::fopen("batch_upper", "batch_lower", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_batch(requests, key);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("batch_upper", "batch_lower", "rb");
+  ASSERT_GE(key, 0);
+  for(size_t i=0; i<requests.size(); i++)
+  {
+    const JHPCNDF::WriteRequest& r=requests[i];
+    if(r.size == sizeof(float))
+    {
+      std::vector<float> result(r.nmemb);
+      JHPCNDF::fread(&(result[0]), r.size, r.nmemb, key);
+      for(size_t j=0; j<r.nmemb; j++)
+      {
+        ASSERT_EQ(static_cast<const float*>(r.ptr)[j], result[j]) << "request = " << i << " j = " << j;
+      }
+    }else{
+      std::vector<double> result(r.nmemb);
+      JHPCNDF::fread(&(result[0]), r.size, r.nmemb, key);
+      for(size_t j=0; j<r.nmemb; j++)
+      {
+        ASSERT_EQ(static_cast<const double*>(r.ptr)[j], result[j]) << "request = " << i << " j = " << j;
+      }
+    }
+  }
+  JHPCNDF::fclose(key);
+}
+
+TEST_F(BatchWriteTest, LargeArray)
+{
+  //ループ並列でエンコードする大きさの配列を含める
+  std::vector<double> large=make_data<double>(2200000, 0.0);
+  requests.insert(requests.begin()+1, JHPCNDF::WriteRequest(&(large[0]), sizeof(double), large.size(), 0.001f));
+  write_sequential("sequential_upper", "");
+  int key=JHPCNDF::fopen("batch_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fwrite_batch(requests, key), 0u);
+  JHPCNDF::fclose(key);
+  EXPECT_TRUE(read_file("sequential_upper") == read_file("batch_upper"));
+}
+
+TEST_F(BatchWriteTest, InvalidRequest)
+{
+  requests.push_back(JHPCNDF::WriteRequest(&(double_data[0][0]), 2, 10, 0.01f));
+  int key=JHPCNDF::fopen("batch_upper", "batch_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_EQ(0u, JHPCNDF::fwrite_batch(requests, key));
+  JHPCNDF::fclose(key);
+  EXPECT_TRUE(read_file("batch_upper").empty());
+  EXPECT_EQ(0u, JHPCNDF::fwrite_batch(std::vector<JHPCNDF::WriteRequest>(), -1));
+}
+
+TEST_F(BatchWriteTest, CAPI)
+{
+  write_sequential("sequential_upper", "sequential_lower");
+  std::vector<JHPCNDF_WriteRequest> c_requests(requests.size());
+  for(size_t i=0; i<requests.size(); i++)
+  {
+    c_requests[i].ptr=requests[i].ptr;
+    c_requests[i].size=requests[i].size;
+    c_requests[i].nmemb=requests[i].nmemb;
+    c_requests[i].tolerance=requests[i].tolerance;
+    c_requests[i].is_relative=requests[i].is_relative ? 1 : 0;
+    c_requests[i].enc=requests[i].enc.c_str();
+  }
+  int key=JHPCNDF::fopen("batch_upper", "batch_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF_fwrite_batch(&(c_requests[0]), c_requests.size(), key), 0u);
+  JHPCNDF::fclose(key);
+  EXPECT_TRUE(read_file("sequential_upper") == read_file("batch_upper"));
+}
@@ -0,0 +1,216 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestBlockTransform.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <zlib.h>
+#include "jhpcndf.h"
+#include "BlockTransform.h"
+
+namespace
+{
+  //構造格子上の滑らかな場
+  template<typename T>
+  std::vector<T> make_field(const size_t& nx, const size_t& ny, const size_t& nz)
+  {
+    std::vector<T> data(nx*ny*nz);
+    size_t index=0;
+    for(size_t k=0; k<nz; k++)
+    {
+      for(size_t j=0; j<ny; j++)
+      {
+        for(size_t i=0; i<nx; i++, index++)
+        {
+          data[index]=(T)(300.0+std::sin(0.11*i+0.05*k)*std::cos(0.07*j+0.03*k)*20.0);
+        }
+      }
+    }
+    return data;
+  }
+
+  template<typename T>
+  size_t deflate_size(const std::vector<T>& data)
+  {
+    uLongf size=compressBound(sizeof(T)*data.size());
+    std::vector<unsigned char> work(size);
+    compress2(&(work[0]), &size, reinterpret_cast<const Bytef*>(&(data[0])), sizeof(T)*data.size(), Z_DEFAULT_COMPRESSION);
+    return size;
+  }
+}
+
+struct BlockDims
+{
+  size_t nx;
+  size_t ny;
+  size_t nz;
+};
+
+class BlockTransformTest : public ::testing::TestWithParam<BlockDims>
+{
+};
+
+TEST_P(BlockTransformTest, LosslessRoundTrip)
+{
+  const BlockDims dims=GetParam();
+  const size_t nmemb=dims.nx*dims.ny*dims.nz;
+  std::vector<double> data=make_field<double>(dims.nx, dims.ny, dims.nz);
+  std::vector<double> upper(nmemb);
+  std::vector<double> lower(nmemb);
+  std::vector<double> result(nmemb);
+  JHPCNDF::encode_block_transform(dims.nx, dims.ny, dims.nz, &(data[0]), &(upper[0]), &(lower[0]), 0.001);
+  JHPCNDF::decode_block_transform(dims.nx, dims.ny, dims.nz, &(upper[0]), &(lower[0]), &(result[0]));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(data[i], result[i]) << "i = " << i;
+  }
+
+  std::vector<float> data_float=make_field<float>(dims.nx, dims.ny, dims.nz);
+  std::vector<float> upper_float(nmemb);
+  std::vector<float> lower_float(nmemb);
+  std::vector<float> result_float(nmemb);
+  JHPCNDF::encode_block_transform(dims.nx, dims.ny, dims.nz, &(data_float[0]), &(upper_float[0]), &(lower_float[0]), 0.01, false);
+  JHPCNDF::decode_block_transform(dims.nx, dims.ny, dims.nz, &(upper_float[0]), &(lower_float[0]), &(result_float[0]));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(data_float[i], result_float[i]) << "i = " << i;
+  }
+}
+
+TEST_P(BlockTransformTest, UpperBitsOnly)
+{
+  const BlockDims dims=GetParam();
+  const size_t nmemb=dims.nx*dims.ny*dims.nz;
+  std::vector<double> data=make_field<double>(dims.nx, dims.ny, dims.nz);
+  std::vector<double> upper(nmemb);
+  std::vector<double> result(nmemb);
+
+  const float tolerance=0.01;
+  JHPCNDF::encode_block_transform(dims.nx, dims.ny, dims.nz, &(data[0]), &(upper[0]), (double*)NULL, tolerance, false);
+  JHPCNDF::decode_block_transform(dims.nx, dims.ny, dims.nz, &(upper[0]), (const double*)NULL, &(result[0]));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_LE(std::fabs(data[i]-result[i]), tolerance) << "i = " << i;
+  }
+
+  const float relative_tolerance=1.0e-5;
+  JHPCNDF::encode_block_transform(dims.nx, dims.ny, dims.nz, &(data[0]), &(upper[0]), (double*)NULL, relative_tolerance);
+  JHPCNDF::decode_block_transform(dims.nx, dims.ny, dims.nz, &(upper[0]), (const double*)NULL, &(result[0]));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_LE(std::fabs(data[i]-result[i]), std::fabs(data[i]*relative_tolerance)) << "i = " << i;
+  }
+}
+
+const BlockDims block_dims[]=
+{
+  {40, 32, 20},
+  {17, 9, 5},
+  {13, 11, 1},
+  {1000, 1, 1},
+  {3, 1, 1},
+};
+INSTANTIATE_TEST_CASE_P(Dims, BlockTransformTest, ::testing::ValuesIn(block_dims));
+
+TEST(BlockTransformAccessTest, DecodeSingleBlock)
+{
+  const size_t nx=17, ny=9, nz=6;
+  const size_t nmemb=nx*ny*nz;
+  std::vector<float> data=make_field<float>(nx, ny, nz);
+  std::vector<float> upper(nmemb);
+  std::vector<float> lower(nmemb);
+  JHPCNDF::encode_block_transform(nx, ny, nz, &(data[0]), &(upper[0]), &(lower[0]), 0.001);
+
+  const size_t bi=4, bj=1, bk=1;
+  std::vector<float> result(nmemb, -1.0f);
+  ASSERT_TRUE(JHPCNDF::decode_transform_block(nx, ny, nz, bi, bj, bk, &(upper[0]), &(lower[0]), &(result[0])));
+  for(size_t k=0; k<nz; k++)
+  {
+    for(size_t j=0; j<ny; j++)
+    {
+      for(size_t i=0; i<nx; i++)
+      {
+        const size_t index=i+nx*(j+ny*k);
+        if(i/4 == bi && j/4 == bj && k/4 == bk)
+        {
+          ASSERT_EQ(data[index], result[index]) << i << " " << j << " " << k;
+        }else{
+          ASSERT_EQ(-1.0f, result[index]) << i << " " << j << " " << k;
+        }
+      }
+    }
+  }
+  EXPECT_FALSE(JHPCNDF::decode_transform_block(nx, ny, nz, 5, 0, 0, &(upper[0]), &(lower[0]), &(result[0])));
+}
+
+TEST(BlockTransformAccessTest, NonFiniteBlock)
+{
+  const size_t nx=8, ny=8, nz=8;
+  const size_t nmemb=nx*ny*nz;
+  std::vector<double> data=make_field<double>(nx, ny, nz);
+  data[0]=std::numeric_limits<double>::quiet_NaN();
+  data[nmemb-1]=std::numeric_limits<double>::infinity();
+  std::vector<double> upper(nmemb);
+  std::vector<double> lower(nmemb);
+  std::vector<double> result(nmemb);
+  JHPCNDF::encode_block_transform(nx, ny, nz, &(data[0]), &(upper[0]), &(lower[0]), 0.01, false);
+  JHPCNDF::decode_block_transform(nx, ny, nz, &(upper[0]), &(lower[0]), &(result[0]));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(0, memcmp(&(data[i]), &(result[i]), sizeof(double))) << "i = " << i;
+  }
+
+  JHPCNDF::decode_block_transform(nx, ny, nz, &(upper[0]), (const double*)NULL, &(result[0]));
+  EXPECT_TRUE(result[0] != result[0]);
+  EXPECT_EQ(data[nmemb-1], result[nmemb-1]);
+  for(size_t i=1; i<nmemb-1; i++)
+  {
+    ASSERT_LE(std::fabs(data[i]-result[i]), 0.01) << "i = " << i;
+  }
+}
+
+TEST(BlockTransformSizeTest, SmallerThanBinarySearch)
+{
+  const size_t nx=64, ny=64, nz=32;
+  const size_t nmemb=nx*ny*nz;
+  std::vector<double> data=make_field<double>(nx, ny, nz);
+  std::vector<double> upper_transform(nmemb);
+  std::vector<double> upper_truncate(nmemb);
+  JHPCNDF::encode_block_transform(nx, ny, nz, &(data[0]), &(upper_transform[0]), (double*)NULL, 0.001, false);
+  JHPCNDF::encode(nmemb, &(data[0]), &(upper_truncate[0]), (double*)NULL, 0.001, false);
+  EXPECT_LT(deflate_size(upper_transform), deflate_size(upper_truncate));
+}
+
+TEST(BlockTransformBasisTest, Orthonormal)
+{
+  const JHPCNDF::BlockTransform::Basis basis;
+  for(size_t n=1; n<=JHPCNDF::BlockTransform::TRANSFORM_BLOCK_SIZE; n++)
+  {
+    double data[JHPCNDF::BlockTransform::TRANSFORM_BLOCK_SIZE]={1.5, -2.0, 0.25, 8.0};
+    double org[JHPCNDF::BlockTransform::TRANSFORM_BLOCK_SIZE];
+    memcpy(org, data, sizeof(data));
+    double norm=0.0;
+    for(size_t i=0; i<n; i++) norm+=data[i]*data[i];
+
+    basis.apply(data, n, 1, false);
+    double transformed_norm=0.0;
+    for(size_t i=0; i<n; i++) transformed_norm+=data[i]*data[i];
+    EXPECT_NEAR(norm, transformed_norm, 1.0e-12) << "n = " << n;
+
+    basis.apply(data, n, 1, true);
+    for(size_t i=0; i<n; i++)
+    {
+      EXPECT_NEAR(org[i], data[i], 1.0e-12) << "n = " << n << " i = " << i;
+    }
+  }
+}
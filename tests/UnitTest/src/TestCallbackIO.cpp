@@ -0,0 +1,154 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestCallbackIO.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "jhpcndf.h"
+#include "Stream.h"
+#include "TestUtility.h"
+
+namespace
+{
+  struct MemorySink
+  {
+    MemorySink():position(0), num_calls(0){}
+    std::vector<char> data;
+    size_t position;
+    size_t num_calls;
+  };
+
+  size_t write_to_sink(const void* ptr, size_t size, void* context)
+  {
+    MemorySink* sink=static_cast<MemorySink*>(context);
+    const char* src=static_cast<const char*>(ptr);
+    sink->data.insert(sink->data.end(), src, src+size);
+    sink->num_calls++;
+    return size;
+  }
+
+  size_t read_from_sink(void* ptr, size_t size, void* context)
+  {
+    MemorySink* sink=static_cast<MemorySink*>(context);
+    const size_t length = size < sink->data.size()-sink->position ? size : sink->data.size()-sink->position;
+    if(length > 0)
+    {
+      memcpy(ptr, &(sink->data[sink->position]), length);
+    }
+    sink->position+=length;
+    sink->num_calls++;
+    return length;
+  }
+}
+
+class CallbackIOTest : public ::testing::TestWithParam<const char*>
+{
+};
+
+TEST_P(CallbackIOTest, MultipleRecords)
+{
+  const size_t nmemb=100000;
+  const size_t buff_size=4096;
+  std::vector<float>  record0=make_record_data<float>(nmemb, 0);
+  std::vector<double> record1=make_record_data<double>(nmemb, 1);
+  std::vector<float>  record2=make_record_data<float>(nmemb, 2);
+
+  MemorySink upper_sink;
+  MemorySink lower_sink;
+  JHPCNDF_Callbacks upper={write_to_sink, NULL, &upper_sink};
+  JHPCNDF_Callbacks lower={write_to_sink, NULL, &lower_sink};
+  int key=JHPCNDF::fopen_callbacks(&upper, &lower, GetParam(), buff_size);
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fwrite(&(record0[0]), sizeof(float),  nmemb, key, 0.01), 0u);
+  EXPECT_GT(JHPCNDF::fwrite(&(record1[0]), sizeof(double), nmemb, key, 0.01), 0u);
+  EXPECT_GT(JHPCNDF::fwrite(&(record2[0]), sizeof(float),  nmemb, key, 0.01), 0u);
+  JHPCNDF::fclose(key);
+
+  // 圧縮する場合はバッファサイズ程度の断片に分けて渡される
+  if(std::string(GetParam()) != "none")
+  {
+    EXPECT_GT(upper_sink.num_calls, 3u);
+    EXPECT_GT(lower_sink.num_calls, 3u);
+  }
+
+  JHPCNDF_Callbacks upper_in={NULL, read_from_sink, &upper_sink};
+  JHPCNDF_Callbacks lower_in={NULL, read_from_sink, &lower_sink};
+  key=JHPCNDF::fopen_callbacks(&upper_in, &lower_in, GetParam(), buff_size);
+  ASSERT_GE(key, 0);
+  std::vector<float>  result0(nmemb);
+  std::vector<double> result1(nmemb);
+  std::vector<float>  result2(nmemb);
+  JHPCNDF::fread(&(result0[0]), sizeof(float),  nmemb, key);
+  JHPCNDF::fread(&(result1[0]), sizeof(double), nmemb, key);
+  JHPCNDF::fread(&(result2[0]), sizeof(float),  nmemb, key);
+  JHPCNDF::fclose(key);
+
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(record0[i], result0[i]) << "i = " << i;
+    ASSERT_EQ(record1[i], result1[i]) << "i = " << i;
+    ASSERT_EQ(record2[i], result2[i]) << "i = " << i;
+  }
+}
+
+TEST_P(CallbackIOTest, UpperBitsOnly)
+{
+  const size_t nmemb=20000;
+  std::vector<double> record=make_record_data<double>(nmemb, 0);
+
+  MemorySink sink;
+  JHPCNDF_Callbacks callbacks={write_to_sink, read_from_sink, &sink};
+  int key=JHPCNDF::fopen_callbacks(&callbacks, NULL, GetParam());
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite(&(record[0]), sizeof(double), nmemb, key, 0.01);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen_callbacks(&callbacks, NULL, GetParam());
+  ASSERT_GE(key, 0);
+  std::vector<double> result(nmemb);
+  JHPCNDF::fread(&(result[0]), sizeof(double), nmemb, key);
+  JHPCNDF::fclose(key);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_NEAR(record[i], result[i], std::fabs(record[i]*0.01)) << "i = " << i;
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(Compression, CallbackIOTest, ::testing::Values("gzip", "none"));
+
+TEST(CallbackOpenTest, NullCallbacks)
+{
+  EXPECT_LT(JHPCNDF::fopen_callbacks(NULL), 0);
+}
+
+TEST(CallbackStreamTest, Unread)
+{
+  MemorySink sink;
+  for(int i=0; i<10; i++)
+  {
+    sink.data.push_back((char)i);
+  }
+  JHPCNDF::CallbackStream stream(NULL, read_from_sink, &sink);
+  char buff[10];
+  ASSERT_EQ(4u, stream.read(buff, 4));
+  stream.unread(3);
+  ASSERT_EQ(2u, stream.read(buff, 2));
+  EXPECT_EQ(1, buff[0]);
+  EXPECT_EQ(2, buff[1]);
+  stream.unread(1);
+  ASSERT_EQ(8u, stream.read(buff, 10));
+  EXPECT_EQ(2, buff[0]);
+  EXPECT_EQ(9, buff[7]);
+  EXPECT_TRUE(stream.eof());
+  EXPECT_FALSE(stream.error());
+}
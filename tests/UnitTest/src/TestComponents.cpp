@@ -0,0 +1,157 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestComponents.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "jhpcndf.h"
+#include "TestUtility.h"
+
+namespace
+{
+  //値の大きさが異なる3成分を交互に並べたデータ
+  template<typename T>
+  std::vector<T> make_components_data(const size_t& nmemb)
+  {
+    std::vector<T> data(3*nmemb);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      data[3*i  ]=(T)(300.0+std::sin(0.001*i)*20.0+std::cos(0.037*i)*0.5);
+      data[3*i+1]=(T)(1.0e-3*std::cos(0.002*i));
+      data[3*i+2]=(T)(1.0e5+std::sin(0.0005*i)*3.0e3);
+    }
+    return data;
+  }
+
+  template<typename T>
+  std::vector<T> component(const std::vector<T>& data, const size_t& c)
+  {
+    std::vector<T> result(data.size()/3);
+    for(size_t i=0; i<result.size(); i++)
+    {
+      result[i]=data[3*i+c];
+    }
+    return result;
+  }
+}
+
+REAL_TYPED_TEST_CASE(ComponentsTest);
+
+TYPED_TEST(ComponentsTest, SameAsSeparateWrites)
+{
+  const size_t nmemb=30000;
+  std::vector<TypeParam> data=make_components_data<TypeParam>(nmemb);
+  std::vector<float> tolerances;
+  tolerances.push_back(0.01f);
+  tolerances.push_back(1.0e-6f);
+  tolerances.push_back(1.0f);
+
+  const char* encoders[]={"binary_search", "quantize"};
+  for(size_t e=0; e<sizeof(encoders)/sizeof(char*); e++)
+  {
+    int key=JHPCNDF::fopen("separate_upper", "separate_lower", "wb");
+    ASSERT_GE(key, 0);
+    for(size_t c=0; c<3; c++)
+    {
+      std::vector<TypeParam> u=component(data, c);
+      JHPCNDF::fwrite(&(u[0]), sizeof(TypeParam), nmemb, key, tolerances[c], false, encoders[e]);
+    }
+    JHPCNDF::fclose(key);
+
+    key=JHPCNDF::fopen("components_upper", "components_lower", "wb");
+    ASSERT_GE(key, 0);
+    EXPECT_GT(JHPCNDF::fwrite_components(&(data[0]), 3, nmemb, key, tolerances, false, encoders[e]), 0u);
+    JHPCNDF::fclose(key);
+
+    EXPECT_TRUE(read_file("separate_upper") == read_file("components_upper")) << encoders[e];
+    EXPECT_TRUE(read_file("separate_lower") == read_file("components_lower")) << encoders[e];
+  }
+}
+
+TYPED_TEST(ComponentsTest, ReadBack)
+{
+  const size_t nmemb=10000;
+  std::vector<TypeParam> data=make_components_data<TypeParam>(nmemb);
+  int key=JHPCNDF::fopen("components_upper", "components_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fwrite_components(&(data[0]), 3, nmemb, key, 0.01f), 0u);
+  JHPCNDF::fclose(key);
+
+  std::vector<TypeParam> result(data.size());
+  key=JHPCNDF::fopen("components_upper", "components_lower", "rb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fread_components(&(result[0]), 3, nmemb, key), 0u);
+  JHPCNDF::fclose(key);
+  for(size_t i=0; i<data.size(); i++)
+  {
+    ASSERT_EQ(data[i], result[i]) << "i = " << i;
+  }
+}
+
+TEST(ComponentsFileTest, PerComponentTolerance)
+{
+  const size_t nmemb=20000;
+  std::vector<double> data=make_components_data<double>(nmemb);
+  std::vector<float> tolerances;
+  tolerances.push_back(0.01f);
+  tolerances.push_back(1.0e-6f);
+  tolerances.push_back(1.0f);
+  int key=JHPCNDF::fopen("components_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  const size_t components_size=JHPCNDF::fwrite_components(&(data[0]), 3, nmemb, key, tolerances, false);
+  JHPCNDF::fclose(key);
+
+  std::vector<double> result(data.size());
+  key=JHPCNDF::fopen("components_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fread_components(&(result[0]), 3, nmemb, key);
+  JHPCNDF::fclose(key);
+  for(size_t i=0; i<data.size(); i++)
+  {
+    ASSERT_LE(std::fabs(data[i]-result[i]), tolerances[i%3]) << "i = " << i;
+  }
+
+  //1つの配列として最も厳しい許容誤差で出力するより小さくなる
+  key=JHPCNDF::fopen("flat_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  const size_t flat_size=JHPCNDF::fwrite(&(data[0]), sizeof(double), data.size(), key, 1.0e-6f, false);
+  JHPCNDF::fclose(key);
+  EXPECT_LT(components_size, flat_size);
+}
+
+TEST(ComponentsFileTest, InvalidTolerances)
+{
+  std::vector<float> data=make_components_data<float>(100);
+  int key=JHPCNDF::fopen("components_upper", "components_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_EQ(0u, JHPCNDF::fwrite_components(&(data[0]), 3, 100, key, std::vector<float>(2, 0.01f)));
+  EXPECT_EQ(0u, JHPCNDF::fwrite_components(&(data[0]), 0, 100, key, 0.01f));
+  JHPCNDF::fclose(key);
+  EXPECT_TRUE(read_file("components_upper").empty());
+}
+
+TEST(ComponentsFileTest, CAPI)
+{
+  const size_t nmemb=2000;
+  std::vector<float> data=make_components_data<float>(nmemb);
+  const float tolerances[]={0.01f, 0.01f, 0.01f};
+  int key=JHPCNDF::fopen("components_upper", "components_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF_fwrite_components_float(&(data[0]), 3, nmemb, key, tolerances, 1, "byte_aligned"), 0u);
+  JHPCNDF::fclose(key);
+
+  std::vector<float> result(data.size());
+  key=JHPCNDF::fopen("components_upper", "components_lower", "rb");
+  EXPECT_GT(JHPCNDF_fread_components_float(&(result[0]), 3, nmemb, key), 0u);
+  JHPCNDF::fclose(key);
+  EXPECT_TRUE(data == result);
+}
@@ -0,0 +1,125 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestCompressBuffer.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+#include "jhpcndf.h"
+#include "IO.h"
+#include "TestUtility.h"
+
+template <typename T>
+class CompressBufferTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+      data.resize(nmemb);
+      for(size_t i=0; i<nmemb; i++)
+      {
+        data[i]=(T)(std::sin(0.003*i)*1000.0);
+      }
+    }
+    static const size_t nmemb=50000;
+    std::vector<T> data;
+};
+
+TYPED_TEST_CASE(CompressBufferTest, RealTypes);
+
+TYPED_TEST(CompressBufferTest, RoundTrip)
+{
+  const size_t nmemb=this->nmemb;
+  const char* comps[]={"gzip", "none", "gzip_1"};
+  for(int c=0; c<3; c++)
+  {
+    std::vector<char> buffer(JHPCNDF::compress_bound(nmemb, sizeof(TypeParam), comps[c]));
+    const size_t size=JHPCNDF::compress(&(this->data[0]), nmemb, &(buffer[0]), buffer.size(), 0.01, true, "binary_search", comps[c]);
+    ASSERT_GT(size, 0u) << comps[c];
+    ASSERT_LE(size, buffer.size());
+    EXPECT_EQ(nmemb, JHPCNDF::get_decompressed_elements(&(buffer[0]), size));
+
+    std::vector<TypeParam> result(nmemb);
+    ASSERT_EQ(nmemb, JHPCNDF::decompress(&(buffer[0]), size, &(result[0]), nmemb));
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_EQ(this->data[i], result[i]) << comps[c] << " i = " << i;
+    }
+  }
+}
+
+TYPED_TEST(CompressBufferTest, UpperBitsOnly)
+{
+  const size_t nmemb=this->nmemb;
+  std::vector<char> buffer(JHPCNDF::compress_bound(nmemb, sizeof(TypeParam), "gzip", false));
+  const size_t size=JHPCNDF::compress(&(this->data[0]), nmemb, &(buffer[0]), buffer.size(), 0.01, true, "binary_search", "gzip", false);
+  ASSERT_GT(size, 0u);
+
+  std::vector<TypeParam> result(nmemb);
+  ASSERT_EQ(nmemb, JHPCNDF::decompress(&(buffer[0]), size, &(result[0]), nmemb));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_LE(std::fabs(this->data[i]-result[i]), std::fabs(this->data[i]*0.01)) << "i = " << i;
+  }
+}
+
+TYPED_TEST(CompressBufferTest, SmallCapacity)
+{
+  const size_t nmemb=this->nmemb;
+  const size_t bound=JHPCNDF::compress_bound(nmemb, sizeof(TypeParam));
+  std::vector<char> buffer(bound);
+  const size_t size=JHPCNDF::compress(&(this->data[0]), nmemb, &(buffer[0]), bound, 0.01);
+  ASSERT_GT(size, 0u);
+
+  // 圧縮後のサイズちょうどの領域なら成功し、1byteでも足りなければ0が返る
+  std::vector<char> exact(size);
+  EXPECT_EQ(size, JHPCNDF::compress(&(this->data[0]), nmemb, &(exact[0]), size, 0.01));
+  EXPECT_EQ(0u, JHPCNDF::compress(&(this->data[0]), nmemb, &(exact[0]), size-1, 0.01));
+}
+
+TYPED_TEST(CompressBufferTest, InvalidBuffer)
+{
+  const size_t nmemb=this->nmemb;
+  std::vector<char> buffer(JHPCNDF::compress_bound(nmemb, sizeof(TypeParam)));
+  const size_t size=JHPCNDF::compress(&(this->data[0]), nmemb, &(buffer[0]), buffer.size(), 0.01);
+  std::vector<TypeParam> result(nmemb);
+
+  // 途中で切れている
+  EXPECT_EQ(0u, JHPCNDF::decompress(&(buffer[0]), size-1, &(result[0]), nmemb));
+  // 出力先の要素数が足りない
+  EXPECT_EQ(0u, JHPCNDF::decompress(&(buffer[0]), size, &(result[0]), nmemb-1));
+  // ヘッダが壊れている
+  buffer[0]='X';
+  EXPECT_EQ(0u, JHPCNDF::get_decompressed_elements(&(buffer[0]), size));
+  EXPECT_EQ(0u, JHPCNDF::decompress(&(buffer[0]), size, &(result[0]), nmemb));
+}
+
+TEST(MemoryStreamTest, MultipleRecords)
+{
+  const size_t nmemb=1000;
+  std::vector<int> data0(nmemb), data1(nmemb), result(nmemb);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    data0[i]=i;
+    data1[i]=i*3;
+  }
+  JHPCNDF::IO* io=JHPCNDF::IOFactory("gzip", 128);
+  JHPCNDF::MemoryOutputStream output;
+  io->fwrite(&(data0[0]), sizeof(int), nmemb, &output);
+  io->fwrite(&(data1[0]), sizeof(int), nmemb, &output);
+
+  JHPCNDF::MemoryInputStream input(&(output.get_storage()[0]), output.tell());
+  io->fread(&(result[0]), sizeof(int), nmemb, &input);
+  EXPECT_EQ(data0, result);
+  io->fread(&(result[0]), sizeof(int), nmemb, &input);
+  EXPECT_EQ(data1, result);
+  EXPECT_TRUE(input.eof());
+  delete io;
+}
@@ -0,0 +1,212 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestCompressedArray.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <map>
+#include <vector>
+#include "jhpcndf.h"
+#include "BlockCache.h"
+#include "TestUtility.h"
+
+namespace
+{
+  //書き戻しの成否を切り替えられるBlockCacheのwriter
+  struct RecordingWriter
+  {
+    RecordingWriter():succeed(true){}
+    bool operator()(const size_t& index, const float* data)
+    {
+      if(!succeed)
+      {
+        return false;
+      }
+      written[index]=data[0];
+      return true;
+    }
+    bool succeed;
+    std::map<size_t, float> written;
+  };
+}
+
+REAL_TYPED_TEST_CASE(CompressedArrayTest);
+
+TYPED_TEST(CompressedArrayTest, AssignAndCopy)
+{
+  const size_t nmemb=100003;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  JHPCNDF::CompressedArray<TypeParam> array(nmemb, 0.01, true, "binary_search", "gzip", true, 4096, 3);
+  EXPECT_EQ(nmemb, array.size());
+  EXPECT_EQ(25u, array.num_blocks());
+  EXPECT_EQ(nmemb-24*4096, array.block_length(24));
+  EXPECT_EQ(0u, array.block_length(25));
+
+  ASSERT_TRUE(array.assign(&(data[0])));
+  EXPECT_LT(array.compressed_size(), sizeof(TypeParam)*nmemb);
+
+  std::vector<TypeParam> result(nmemb);
+  ASSERT_TRUE(array.copy_to(&(result[0])));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(data[i], result[i]) << "i = " << i;
+  }
+}
+
+TYPED_TEST(CompressedArrayTest, ElementAccess)
+{
+  const size_t nmemb=10000;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  JHPCNDF::CompressedArray<TypeParam> array(nmemb, 0.01, true, "binary_search", "gzip", true, 1000, 2);
+  EXPECT_EQ((TypeParam)0, array.get(123));
+  ASSERT_TRUE(array.assign(&(data[0])));
+
+  //キャッシュ容量を超えるブロックを交互に書き換えて、追い出し時の書き戻しを確認する
+  for(size_t i=0; i<nmemb; i+=7)
+  {
+    data[i]=(TypeParam)i;
+    array.set(i, (TypeParam)i);
+    const size_t j=nmemb-1-i;
+    data[j]=(TypeParam)-1.0*j;
+    array.set(j, (TypeParam)-1.0*j);
+  }
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(data[i], array.get(i)) << "i = " << i;
+  }
+  EXPECT_EQ((TypeParam)0, array.get(nmemb));
+
+  ASSERT_TRUE(array.flush());
+  std::vector<TypeParam> block(1000);
+  for(size_t b=0; b<array.num_blocks(); b++)
+  {
+    ASSERT_TRUE(array.get_block(b, &(block[0])));
+    for(size_t i=0; i<1000; i++)
+    {
+      ASSERT_EQ(data[b*1000+i], block[i]) << "block = " << b << " i = " << i;
+    }
+  }
+  EXPECT_FALSE(array.get_block(10, &(block[0])));
+}
+
+TYPED_TEST(CompressedArrayTest, SetBlockDiscardsCachedBlock)
+{
+  const size_t nmemb=300;
+  JHPCNDF::CompressedArray<TypeParam> array(nmemb, 0.01, true, "binary_search", "gzip", true, 128, 4);
+  EXPECT_TRUE(array.set(130, (TypeParam)5.0));
+  EXPECT_FALSE(array.set(nmemb, (TypeParam)5.0));
+  std::vector<TypeParam> block(array.block_length(1), (TypeParam)2.0);
+  ASSERT_TRUE(array.set_block(1, &(block[0])));
+  EXPECT_EQ((TypeParam)2.0, array.get(130));
+  ASSERT_TRUE(array.flush());
+  EXPECT_EQ((TypeParam)2.0, array.get(130));
+  EXPECT_FALSE(array.set_block(3, &(block[0])));
+}
+
+TYPED_TEST(CompressedArrayTest, Iterator)
+{
+  const size_t nmemb=5000;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  JHPCNDF::CompressedArray<TypeParam> array(nmemb, 0.01, true, "binary_search", "gzip", true, 512, 1);
+  array.assign(&(data[0]));
+  size_t i=0;
+  for(typename JHPCNDF::CompressedArray<TypeParam>::const_iterator it=array.begin(); it != array.end(); ++it, ++i)
+  {
+    ASSERT_EQ(data[i], *it) << "i = " << i;
+  }
+  EXPECT_EQ(nmemb, i);
+  EXPECT_EQ(nmemb, (size_t)std::distance(array.begin(), array.end()));
+}
+
+TEST(CompressedArrayLossyTest, UpperBitsOnly)
+{
+  const size_t nmemb=50000;
+  const float tolerance=0.01;
+  std::vector<double> data=make_data<double>(nmemb);
+  JHPCNDF::CompressedArray<double> lossless(nmemb, tolerance, false);
+  JHPCNDF::CompressedArray<double> lossy(nmemb, tolerance, false, "binary_search", "gzip", false);
+  lossless.assign(&(data[0]));
+  lossy.assign(&(data[0]));
+  EXPECT_LT(lossy.compressed_size(), lossless.compressed_size());
+  EXPECT_LT(5*lossy.compressed_size(), sizeof(double)*nmemb);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_LE(std::fabs(data[i]-lossy.get(i)), tolerance) << "i = " << i;
+  }
+}
+
+TEST(CompressedArrayCAPITest, CreateAndAccess)
+{
+  const size_t nmemb=1000;
+  std::vector<float> data=make_data<float>(nmemb);
+  JHPCNDF_CompressedArray_float* array=JHPCNDF_create_compressed_array_float(nmemb, 0.01, 1, "binary_search", "gzip", 1, 256, 2);
+  ASSERT_TRUE(array != NULL);
+  for(size_t b=0; b<4; b++)
+  {
+    ASSERT_EQ(1, JHPCNDF_compressed_array_set_block_float(array, b, &(data[b*256])));
+  }
+  EXPECT_EQ(1, JHPCNDF_compressed_array_set_float(array, 999, 1.5f));
+  EXPECT_EQ(1.5f, JHPCNDF_compressed_array_get_float(array, 999));
+  EXPECT_EQ(data[300], JHPCNDF_compressed_array_get_float(array, 300));
+  EXPECT_EQ(1, JHPCNDF_compressed_array_flush_float(array));
+  EXPECT_GT(JHPCNDF_compressed_array_compressed_size_float(array), 0u);
+  JHPCNDF_destroy_compressed_array_float(array);
+}
+
+TEST(BlockCacheTest, LeastRecentlyUsedOrder)
+{
+  JHPCNDF::BlockCache<float> cache(2);
+  cache.push(0);
+  cache.push(1);
+  EXPECT_TRUE(cache.full());
+  ASSERT_TRUE(cache.find(0) != NULL);
+  EXPECT_EQ(1u, cache.oldest().index);
+  cache.pop_oldest();
+  EXPECT_TRUE(cache.find(1) == NULL);
+  cache.push(2);
+  EXPECT_EQ(0u, cache.oldest().index);
+  cache.erase(0);
+  EXPECT_FALSE(cache.full());
+  EXPECT_EQ(2u, cache.oldest().index);
+}
+
+TEST(BlockCacheTest, KeepDirtyEntryOnWriteFailure)
+{
+  JHPCNDF::BlockCache<float> cache(2);
+  JHPCNDF::BlockCache<float>::Entry* entry=cache.push(0);
+  entry->data.assign(4, 1.5f);
+  entry->dirty=true;
+  cache.push(1)->data.assign(4, 2.0f);
+  RecordingWriter writer;
+
+  //書き戻しに失敗したエントリはdirtyのまま残り、追い出されない
+  writer.succeed=false;
+  EXPECT_FALSE(cache.write_back(writer));
+  ASSERT_TRUE(cache.peek(0) != NULL);
+  EXPECT_TRUE(cache.peek(0)->dirty);
+  EXPECT_EQ(0u, cache.oldest().index);
+  EXPECT_FALSE(cache.evict_oldest(writer));
+  ASSERT_TRUE(cache.peek(0) != NULL);
+  EXPECT_EQ(1.5f, cache.peek(0)->data[0]);
+  EXPECT_TRUE(writer.written.empty());
+
+  //書き戻せるようになれば、書き換えた内容を書き戻してから追い出す
+  writer.succeed=true;
+  EXPECT_TRUE(cache.evict_oldest(writer));
+  EXPECT_TRUE(cache.peek(0) == NULL);
+  ASSERT_EQ(1u, writer.written.count(0));
+  EXPECT_EQ(1.5f, writer.written[0]);
+  EXPECT_EQ(0u, writer.written.count(1));
+
+  //dirtyでないエントリは書き戻さずに追い出す
+  EXPECT_TRUE(cache.write_back(writer));
+  EXPECT_TRUE(cache.evict_oldest(writer));
+  EXPECT_EQ(0u, writer.written.count(1));
+}
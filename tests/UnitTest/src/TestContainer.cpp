@@ -0,0 +1,110 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestContainer.cpp
+
+#include "gtest/gtest.h"
+#include <vector>
+#include "Container.h"
+
+class ContainerTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+      // 10要素ずつのチャンク(最後だけ5要素)
+      for(uint64_t i=0; i<10; i++)
+      {
+        JHPCNDF::ContainerChunk chunk={};
+        chunk.element_offset=i*10;
+        chunk.num_elements= i == 9 ? 5 : 10;
+        chunks.push_back(chunk);
+      }
+    }
+    std::vector<JHPCNDF::ContainerChunk> chunks;
+};
+
+TEST_F(ContainerTest, FindChunksByRange)
+{
+  size_t begin=0;
+  size_t end=0;
+  JHPCNDF::Container::find_chunks(chunks, 0, 10, &begin, &end);
+  EXPECT_EQ(0u, begin);
+  EXPECT_EQ(1u, end);
+  JHPCNDF::Container::find_chunks(chunks, 15, 20, &begin, &end);
+  EXPECT_EQ(1u, begin);
+  EXPECT_EQ(4u, end);
+  JHPCNDF::Container::find_chunks(chunks, 94, 1, &begin, &end);
+  EXPECT_EQ(9u, begin);
+  EXPECT_EQ(10u, end);
+  JHPCNDF::Container::find_chunks(chunks, 95, 10, &begin, &end);
+  EXPECT_EQ(begin, end);
+}
+
+TEST_F(ContainerTest, FindChunksByRanges)
+{
+  std::vector<JHPCNDF::ContainerRange> ranges;
+  JHPCNDF::ContainerRange range={};
+  range.first=5;  range.count=3;  ranges.push_back(range);
+  range.first=9;  range.count=2;  ranges.push_back(range);
+  range.first=42; range.count=20; ranges.push_back(range);
+  std::vector<size_t> ids;
+  JHPCNDF::Container::find_chunks(chunks, ranges, &ids);
+  ASSERT_EQ(5u, ids.size());
+  EXPECT_EQ(0u, ids[0]);
+  EXPECT_EQ(1u, ids[1]);
+  EXPECT_EQ(4u, ids[2]);
+  EXPECT_EQ(5u, ids[3]);
+  EXPECT_EQ(6u, ids[4]);
+  EXPECT_EQ(1u, JHPCNDF::Container::find_range(ranges, 8));
+  EXPECT_EQ(2u, JHPCNDF::Container::find_range(ranges, 11));
+}
+
+TEST(ContainerSubarrayTest, Rows)
+{
+  const size_t dims[3]={4, 3, 2};
+  const size_t start[3]={1, 1, 0};
+  const size_t count[3]={2, 2, 2};
+  std::vector<JHPCNDF::ContainerRange> ranges;
+  ASSERT_TRUE(JHPCNDF::Container::subarray_to_ranges(dims, start, count, &ranges));
+  ASSERT_EQ(4u, ranges.size());
+  EXPECT_EQ(5u,  ranges[0].first);
+  EXPECT_EQ(9u,  ranges[1].first);
+  EXPECT_EQ(17u, ranges[2].first);
+  EXPECT_EQ(21u, ranges[3].first);
+  for(size_t i=0; i<ranges.size(); i++)
+  {
+    EXPECT_EQ(2u, ranges[i].count);
+    EXPECT_EQ(2*i, ranges[i].dst_offset);
+  }
+}
+
+TEST(ContainerSubarrayTest, MergeContiguousRows)
+{
+  const size_t dims[3]={4, 3, 2};
+  const size_t start[3]={0, 1, 0};
+  const size_t count[3]={4, 2, 2};
+  std::vector<JHPCNDF::ContainerRange> ranges;
+  ASSERT_TRUE(JHPCNDF::Container::subarray_to_ranges(dims, start, count, &ranges));
+  ASSERT_EQ(2u, ranges.size());
+  EXPECT_EQ(4u,  ranges[0].first);
+  EXPECT_EQ(8u,  ranges[0].count);
+  EXPECT_EQ(16u, ranges[1].first);
+  EXPECT_EQ(8u,  ranges[1].count);
+  EXPECT_EQ(8u,  ranges[1].dst_offset);
+}
+
+TEST(ContainerSubarrayTest, OutOfRange)
+{
+  const size_t dims[3]={4, 3, 2};
+  const size_t start[3]={3, 0, 0};
+  const size_t count[3]={2, 1, 1};
+  std::vector<JHPCNDF::ContainerRange> ranges;
+  EXPECT_FALSE(JHPCNDF::Container::subarray_to_ranges(dims, start, count, &ranges));
+}
@@ -0,0 +1,139 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestContext.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <sstream>
+#include <vector>
+#include "jhpcndf.h"
+
+class ContextTest : public ::testing::TestWithParam<const char*>
+{
+  protected:
+    virtual void SetUp()
+    {
+      for(size_t i=0; i<nmemb; i++)
+      {
+        data0[i]=std::sin(0.01*i);
+        data1[i]=std::cos(0.02*i)*100.0;
+      }
+    }
+    static const size_t nmemb=10000;
+    double data0[nmemb];
+    double data1[nmemb];
+    double read_data[nmemb];
+};
+
+TEST_P(ContextTest, MultipleRecords)
+{
+  int key=JHPCNDF::fopen("context_upper", "context_lower", "w+b", GetParam());
+  {
+    JHPCNDF::Context context(key, 0.01);
+    ASSERT_TRUE(context.is_valid());
+    EXPECT_GT(context.fwrite(data0, nmemb), 0u);
+    EXPECT_GT(context.fwrite(data1, nmemb), 0u);
+  }
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("context_upper", "context_lower", "rb", GetParam());
+  {
+    JHPCNDF::Context context(key, 0.01);
+    context.fread(read_data, nmemb);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_EQ(data0[i], read_data[i]) << "i = "<< i;
+    }
+    context.fread(read_data, nmemb);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_EQ(data1[i], read_data[i]) << "i = "<< i;
+    }
+  }
+  JHPCNDF::fclose(key);
+}
+
+TEST_P(ContextTest, UpperBitsOnly)
+{
+  int key=JHPCNDF::fopen("context_upper", "context_lower", "w+b", GetParam());
+  {
+    JHPCNDF::Context context(key, 0.01, true, "binary_search", 2);
+    context.fwrite(data0, nmemb);
+    context.fwrite(data1, nmemb);
+  }
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("context_upper", "", "rb", GetParam());
+  {
+    JHPCNDF::Context context(key, 0.01);
+    context.fread(read_data, nmemb);
+    context.fread(read_data, nmemb);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_LE(std::fabs(data1[i]-read_data[i]), std::fabs(data1[i]*0.01)) << "i = "<< i;
+    }
+  }
+  JHPCNDF::fclose(key);
+}
+
+TEST(ContextTestWithoutFile, Encode)
+{
+  const size_t nmemb=1000;
+  float src[nmemb];
+  float upper[nmemb];
+  float lower[nmemb];
+  float decoded[nmemb];
+  for(size_t i=0; i<nmemb; i++)
+  {
+    src[i]=std::sin(0.01f*i);
+  }
+  JHPCNDF::Context context(-1, 0.01);
+  EXPECT_FALSE(context.is_valid());
+  context.encode(nmemb, src, upper, lower);
+  JHPCNDF::decode(nmemb, upper, lower, decoded);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(src[i], decoded[i]) << "i = "<< i;
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(ContextTest, ContextTest, ::testing::Values("gzip", "none"));
+
+// 異なるスレッドから別々のファイルへ同時に入出力するテスト
+TEST(ConcurrentFileTest, WriteAndRead)
+{
+  const int num_files=8;
+  const size_t nmemb=4096;
+  int num_errors=0;
+#pragma omp parallel for reduction(+:num_errors)
+  for(int i=0; i<num_files; i++)
+  {
+    std::ostringstream upper, lower;
+    upper<<"concurrent_upper_"<<i;
+    lower<<"concurrent_lower_"<<i;
+    std::vector<float> data(nmemb), read_data(nmemb);
+    for(size_t j=0; j<nmemb; j++)
+    {
+      data[j]=std::sin(0.001f*j*(i+1));
+    }
+    int key=JHPCNDF::fopen(upper.str(), lower.str(), "w+b", "gzip");
+    JHPCNDF::fwrite(&(data[0]), sizeof(float), nmemb, key, 0.01);
+    JHPCNDF::fclose(key);
+
+    key=JHPCNDF::fopen(upper.str(), lower.str(), "rb", "gzip");
+    JHPCNDF::fread(&(read_data[0]), sizeof(float), nmemb, key);
+    JHPCNDF::fclose(key);
+    for(size_t j=0; j<nmemb; j++)
+    {
+      if(data[j] != read_data[j]) num_errors++;
+    }
+  }
+  EXPECT_EQ(0, num_errors);
+}
@@ -0,0 +1,149 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestDictionary.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "jhpcndf.h"
+#include "Dictionary.h"
+#include "TestUtility.h"
+
+namespace
+{
+  //境界面のデータのような小さいレコード
+  template<typename T>
+  std::vector<T> make_patch(const size_t& nmemb, const int& record)
+  {
+    std::vector<T> data(nmemb);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      data[i]=(T)(100.0+std::sin(0.05*(i%200)+0.3*record)*20.0+(i/200)*0.5);
+    }
+    return data;
+  }
+
+  template<typename T>
+  void write_patches(const char* upper, const char* lower, const bool& with_dictionary, const size_t& nmemb, const int& num_records)
+  {
+    int key=JHPCNDF::fopen(upper, lower, "wb");
+    ASSERT_GE(key, 0);
+    if(with_dictionary)
+    {
+      std::vector<T> sample=make_patch<T>(nmemb, -1);
+      ASSERT_EQ(0, JHPCNDF::set_dictionary(&(sample[0]), nmemb, key, 0.01));
+    }
+    for(int r=0; r<num_records; r++)
+    {
+      std::vector<T> data=make_patch<T>(nmemb, r);
+      JHPCNDF::fwrite(&(data[0]), sizeof(T), nmemb, key, 0.01);
+    }
+    JHPCNDF::fclose(key);
+  }
+}
+
+REAL_TYPED_TEST_CASE(DictionaryTest);
+
+TYPED_TEST(DictionaryTest, LosslessRoundTrip)
+{
+  const size_t nmemb=3000;
+  const int num_records=8;
+  write_patches<TypeParam>("dictionary_upper", "dictionary_lower", true, nmemb, num_records);
+
+  int key=JHPCNDF::fopen("dictionary_upper", "dictionary_lower", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<TypeParam> result(nmemb);
+  for(int r=0; r<num_records; r++)
+  {
+    std::vector<TypeParam> data=make_patch<TypeParam>(nmemb, r);
+    JHPCNDF::fread(&(result[0]), sizeof(TypeParam), nmemb, key);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_EQ(data[i], result[i]) << "record = " << r << " i = " << i;
+    }
+  }
+  JHPCNDF::fclose(key);
+}
+
+TYPED_TEST(DictionaryTest, UpperBitsOnly)
+{
+  const size_t nmemb=3000;
+  const int num_records=4;
+  write_patches<TypeParam>("dictionary_upper", "", true, nmemb, num_records);
+
+  int key=JHPCNDF::fopen("dictionary_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<TypeParam> result(nmemb);
+  for(int r=0; r<num_records; r++)
+  {
+    std::vector<TypeParam> data=make_patch<TypeParam>(nmemb, r);
+    JHPCNDF::fread(&(result[0]), sizeof(TypeParam), nmemb, key);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_NEAR(data[i], result[i], std::fabs(data[i]*0.01)) << "record = " << r << " i = " << i;
+    }
+  }
+  JHPCNDF::fclose(key);
+}
+
+TEST(DictionarySizeTest, SmallRecords)
+{
+  const size_t nmemb=2000;
+  const int num_records=20;
+  write_patches<double>("dictionary_upper", "", true, nmemb, num_records);
+  write_patches<double>("plain_upper", "", false, nmemb, num_records);
+
+  const long dictionary_size=file_size("dictionary_upper");
+  const long plain_size=file_size("plain_upper");
+  ASSERT_GT(dictionary_size, 0);
+  ASSERT_GT(plain_size, 0);
+  // 辞書レコードの分を含めても小さくなる
+  EXPECT_LT(dictionary_size, plain_size);
+}
+
+TEST(DictionaryErrorTest, ReturnCodes)
+{
+  std::vector<double> sample=make_patch<double>(100, 0);
+  EXPECT_EQ(-1, JHPCNDF::set_dictionary(&(sample[0]), 100, 12345, 0.01));
+
+  int key=JHPCNDF::fopen("dictionary_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_EQ(-1, JHPCNDF::set_dictionary(&(sample[0]), 0, key, 0.01));
+  EXPECT_EQ(0,  JHPCNDF::set_dictionary(&(sample[0]), 100, key, 0.01));
+  // 辞書は1ファイルに1回だけ設定できる
+  EXPECT_EQ(-2, JHPCNDF::set_dictionary(&(sample[0]), 100, key, 0.01));
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("dictionary_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite(&(sample[0]), sizeof(double), 100, key, 0.01);
+  EXPECT_EQ(-2, JHPCNDF::set_dictionary(&(sample[0]), 100, key, 0.01));
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("dictionary_upper", "", "wb", "none");
+  ASSERT_GE(key, 0);
+  EXPECT_EQ(-3, JHPCNDF::set_dictionary(&(sample[0]), 100, key, 0.01));
+  JHPCNDF::fclose(key);
+}
+
+TEST(DictionaryRecordTest, BuildKeepsTail)
+{
+  std::vector<unsigned char> sample(JHPCNDF::Dictionary::MAX_SIZE+100);
+  for(size_t i=0; i<sample.size(); i++)
+  {
+    sample[i]=(unsigned char)(i%253);
+  }
+  std::vector<unsigned char> dictionary;
+  JHPCNDF::Dictionary::build(&(sample[0]), sample.size(), &dictionary);
+  ASSERT_EQ(JHPCNDF::Dictionary::MAX_SIZE, dictionary.size());
+  EXPECT_EQ(sample[100], dictionary[0]);
+  EXPECT_EQ(sample.back(), dictionary.back());
+}
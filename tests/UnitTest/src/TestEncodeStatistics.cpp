@@ -0,0 +1,150 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestEncodeStatistics.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "jhpcndf.h"
+#include "ToleranceSweep.h"
+#include "TestUtility.h"
+
+REAL_TYPED_TEST_CASE(EncodeStatisticsTest);
+
+TYPED_TEST(EncodeStatisticsTest, Fwrite)
+{
+  const size_t nmemb=100000;
+  const float tolerance=1e-3f;
+  std::vector<TypeParam> data=make_noisy_data<TypeParam>(nmemb);
+  JHPCNDF::EncodeStatistics statistics;
+  int key=JHPCNDF::fopen("statistics_upper", "statistics_lower", "wb");
+  ASSERT_GE(key, 0);
+  const size_t output_size=JHPCNDF::fwrite(&(data[0]), sizeof(TypeParam), nmemb, key, tolerance, true, "binary_search", &statistics);
+  JHPCNDF::fclose(key);
+
+  EXPECT_EQ(nmemb, statistics.num_elements);
+  EXPECT_EQ(output_size, statistics.upper_bytes_out);
+  EXPECT_EQ((long)statistics.upper_bytes_out, file_size("statistics_upper"));
+  EXPECT_EQ((long)statistics.lower_bytes_out, file_size("statistics_lower"));
+  EXPECT_EQ(sizeof(TypeParam)*nmemb, statistics.upper_bytes_in);
+  EXPECT_EQ(sizeof(TypeParam)*nmemb, statistics.lower_bytes_in);
+  EXPECT_GE(statistics.encode_time, 0.0);
+  EXPECT_GE(statistics.upper_output_time, 0.0);
+  EXPECT_GE(statistics.lower_output_time, 0.0);
+
+  //ヒストグラムはbinary_searchが選んだ分割位置と一致する
+  const unsigned int num_bins=JHPCNDF::ToleranceSweep::fraction_length<TypeParam>()+1;
+  std::vector<size_t> expected(num_bins, 0);
+  double max_error=0.0;
+  for(size_t i=0; i<nmemb; i++)
+  {
+    const unsigned int split_position=JHPCNDF::ToleranceSweep::required_split_position(data[i], (double)tolerance*data[i], 0);
+    expected[split_position]++;
+    const double error=std::fabs((double)data[i]-(double)n_bit_zero_padding(data[i], split_position));
+    max_error = error > max_error ? error : max_error;
+  }
+  EXPECT_TRUE(expected == statistics.histogram);
+  EXPECT_EQ(expected[0], statistics.num_full_mantissa);
+  EXPECT_DOUBLE_EQ(max_error, statistics.max_error);
+  EXPECT_LE(statistics.rms_error, statistics.max_error);
+  EXPECT_GT(statistics.rms_error, 0.0);
+
+  //統計情報を集計しない場合と同じ内容を出力する
+  key=JHPCNDF::fopen("statistics_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_EQ(output_size, JHPCNDF::fwrite(&(data[0]), sizeof(TypeParam), nmemb, key, tolerance, true, "binary_search"));
+  JHPCNDF::fclose(key);
+}
+
+TYPED_TEST(EncodeStatisticsTest, Encode)
+{
+  const size_t nmemb=20000;
+  std::vector<TypeParam> data=make_noisy_data<TypeParam>(nmemb);
+  std::vector<TypeParam> upper(nmemb);
+  std::vector<TypeParam> lower(nmemb);
+  JHPCNDF::EncodeStatistics statistics;
+  const char* encoders[]={"original", "linear_search", "byte_aligned", "binary_search"};
+  for(size_t e=0; e<sizeof(encoders)/sizeof(char*); e++)
+  {
+    const float tolerance=0.01f;
+    JHPCNDF::encode(nmemb, &(data[0]), &(upper[0]), &(lower[0]), tolerance, false, encoders[e], &statistics);
+    size_t sum=0;
+    for(size_t n=0; n<statistics.histogram.size(); n++)
+    {
+      sum+=statistics.histogram[n];
+    }
+    EXPECT_EQ(nmemb, sum) << encoders[e];
+    EXPECT_LE(statistics.max_error, tolerance) << encoders[e];
+    EXPECT_EQ(statistics.upper_bytes_in, statistics.upper_bytes_out) << encoders[e];
+    EXPECT_EQ(0.0, statistics.upper_output_time) << encoders[e];
+  }
+
+  //許容誤差が十分小さい時は、最下位bitが1の要素は仮数部を全て残す
+  JHPCNDF::encode(nmemb, &(data[0]), &(upper[0]), (TypeParam*)NULL, 1e-30f, false, "binary_search", &statistics);
+  size_t num_full_mantissa=0;
+  for(size_t i=0; i<nmemb; i++)
+  {
+    if(n_bit_zero_padding(data[i], 1) != data[i])
+    {
+      num_full_mantissa++;
+    }
+  }
+  EXPECT_GT(num_full_mantissa, 0u);
+  EXPECT_EQ(num_full_mantissa, statistics.num_full_mantissa);
+  EXPECT_EQ(0.0, statistics.max_error);
+  EXPECT_EQ(0u, statistics.lower_bytes_in);
+}
+
+TEST(EncodeStatisticsFileTest, EncoderWithoutSplitPosition)
+{
+  const size_t nmemb=50000;
+  const float tolerance=0.05f;
+  std::vector<float> data=make_noisy_data<float>(nmemb);
+  JHPCNDF::EncodeStatistics statistics;
+  int key=JHPCNDF::fopen("statistics_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  const size_t output_size=JHPCNDF::fwrite(&(data[0]), sizeof(float), nmemb, key, tolerance, false, "quantize", &statistics);
+  JHPCNDF::fclose(key);
+  EXPECT_TRUE(statistics.histogram.empty());
+  EXPECT_EQ(0u, statistics.num_full_mantissa);
+  EXPECT_EQ(nmemb, statistics.num_elements);
+  EXPECT_GT(statistics.max_error, 0.0);
+  EXPECT_LE(statistics.max_error, tolerance);
+  EXPECT_EQ(output_size, statistics.upper_bytes_out);
+  EXPECT_EQ(0u, statistics.lower_bytes_out);
+
+  std::vector<float> upper(nmemb);
+  JHPCNDF::encode(nmemb, &(data[0]), &(upper[0]), (float*)NULL, tolerance, false, "dummy", &statistics);
+  EXPECT_TRUE(statistics.histogram.empty());
+  EXPECT_EQ(0.0, statistics.max_error);
+  EXPECT_EQ(0.0, statistics.rms_error);
+}
+
+TEST(EncodeStatisticsFileTest, CAPI)
+{
+  const size_t nmemb=30000;
+  std::vector<double> data=make_noisy_data<double>(nmemb);
+  JHPCNDF_EncodeStatistics statistics;
+  int key=JHPCNDF::fopen("statistics_upper", "statistics_lower", "wb");
+  ASSERT_GE(key, 0);
+  const size_t output_size=JHPCNDF_fwrite_statistics_double(&(data[0]), sizeof(double), nmemb, key, 1e-4f, 1, NULL, &statistics);
+  JHPCNDF::fclose(key);
+  EXPECT_EQ(53u, statistics.num_bins);
+  EXPECT_EQ(nmemb, statistics.num_elements);
+  EXPECT_EQ(output_size, statistics.upper_bytes_out);
+  EXPECT_GT(statistics.lower_bytes_out, 0u);
+  size_t sum=0;
+  for(size_t n=0; n<statistics.num_bins; n++)
+  {
+    sum+=statistics.histogram[n];
+  }
+  EXPECT_EQ(nmemb, sum);
+}
@@ -0,0 +1,81 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestEstimate.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "jhpcndf.h"
+#include "TestUtility.h"
+
+REAL_TYPED_TEST_CASE(EstimateTest);
+
+TYPED_TEST(EstimateTest, SmallArrayMatchesFwrite)
+{
+  //サンプルの合計より小さい配列は全体から推定するので、fwriteの出力サイズと一致する
+  const size_t nmemb=100000;
+  std::vector<TypeParam> data=make_noisy_data<TypeParam>(nmemb);
+  const char* encoders[]={"binary_search", "byte_aligned", "quantize"};
+  for(size_t e=0; e<sizeof(encoders)/sizeof(char*); e++)
+  {
+    int key=JHPCNDF::fopen("estimate_upper", "estimate_lower", "wb");
+    ASSERT_GE(key, 0);
+    JHPCNDF::fwrite(&(data[0]), sizeof(TypeParam), nmemb, key, 1.0e-4f, true, encoders[e]);
+    JHPCNDF::fclose(key);
+
+    size_t lower_size=0;
+    EXPECT_EQ(file_size("estimate_upper"), (long)JHPCNDF::estimate_compressed_size(&(data[0]), nmemb, 1.0e-4f, true, encoders[e], "gzip", &lower_size)) << encoders[e];
+    EXPECT_EQ(file_size("estimate_lower"), (long)lower_size) << encoders[e];
+  }
+}
+
+TYPED_TEST(EstimateTest, LargeArrayWithinFewPercent)
+{
+  const size_t nmemb=1000000;
+  std::vector<TypeParam> data=make_noisy_data<TypeParam>(nmemb);
+  const float tolerances[]={1.0e-3f, 1.0e-5f};
+  for(size_t t=0; t<sizeof(tolerances)/sizeof(float); t++)
+  {
+    int key=JHPCNDF::fopen("estimate_upper", "estimate_lower", "wb");
+    ASSERT_GE(key, 0);
+    JHPCNDF::fwrite(&(data[0]), sizeof(TypeParam), nmemb, key, tolerances[t]);
+    JHPCNDF::fclose(key);
+
+    size_t lower_size=0;
+    const double upper_size=JHPCNDF::estimate_compressed_size(&(data[0]), nmemb, tolerances[t], true, "binary_search", "gzip", &lower_size);
+    const double actual_upper=file_size("estimate_upper");
+    const double actual_lower=file_size("estimate_lower");
+    EXPECT_NEAR(1.0, upper_size/actual_upper, 0.05) << "tolerance = " << tolerances[t];
+    EXPECT_NEAR(1.0, lower_size/actual_lower, 0.05) << "tolerance = " << tolerances[t];
+  }
+}
+
+TEST(EstimateFileTest, EmptyInput)
+{
+  size_t lower_size=1;
+  EXPECT_EQ(0u, JHPCNDF::estimate_compressed_size((float*)NULL, 100, 0.01f, true, "binary_search", "gzip", &lower_size));
+  EXPECT_EQ(0u, lower_size);
+}
+
+TEST(EstimateFileTest, CAPI)
+{
+  const size_t nmemb=20000;
+  std::vector<double> data=make_noisy_data<double>(nmemb);
+  size_t lower_size=0;
+  const size_t upper_size=JHPCNDF_estimate_compressed_size_double(&(data[0]), nmemb, 0.01f, 1, NULL, NULL, &lower_size);
+  EXPECT_GT(upper_size, 0u);
+  EXPECT_GT(lower_size, 0u);
+  EXPECT_EQ(upper_size, JHPCNDF::estimate_compressed_size(&(data[0]), nmemb, 0.01f));
+
+  //圧縮しない場合は元データのサイズになる
+  std::vector<float> single=make_noisy_data<float>(nmemb);
+  EXPECT_EQ(sizeof(float)*nmemb, JHPCNDF_estimate_compressed_size_float(&(single[0]), nmemb, 0.01f, 1, "binary_search", "none", NULL));
+}
@@ -11,6 +11,7 @@
 
 #include "gtest/gtest.h"
 #include <fstream>
+#include <sstream>
 #include <string>
 #include "FileInfoManager.h"
 
@@ -96,7 +97,7 @@ TEST_F(FileManagerTest2, get_upper)
     fwrite("upper\n", 6, 1, tmp);
     FM.destroy_entry(10);
     std::ifstream ifs("upper");
-    char test[10];
+    char test[10]={0};
     ifs.read(test, 6);
     EXPECT_STREQ("upper\n", test);
 }
@@ -106,7 +107,53 @@ TEST_F(FileManagerTest2, get_lower)
     fwrite("lower\n", 6, 1, tmp);
     FM.destroy_entry(10);
     std::ifstream ifs("lower");
-    char test[10];
+    char test[10]={0};
     ifs.read(test, 6);
     EXPECT_STREQ("lower\n", test);
 }
+
+// 複数スレッドから同時にopen/closeするテスト
+TEST_F(FileManagerTest, ConcurrentOpenAndClose)
+{
+    const int num_files=64;
+    int keys[num_files];
+    int num_failed=0;
+#pragma omp parallel for reduction(+:num_failed)
+    for(int i=0; i<num_files; i++)
+    {
+        std::ostringstream oss;
+        oss<<"concurrent_"<<i;
+        keys[i]=FM.create_new_entry(oss.str());
+        if(keys[i] < 0 || FM.get_upper_file_pointer(keys[i]) == NULL)
+        {
+            num_failed++;
+        }
+    }
+    EXPECT_EQ(0, num_failed);
+    for(int i=0; i<num_files; i++)
+    {
+        for(int j=i+1; j<num_files; j++)
+        {
+            ASSERT_NE(keys[i], keys[j]);
+        }
+    }
+#pragma omp parallel for reduction(+:num_failed)
+    for(int i=0; i<num_files; i++)
+    {
+        if(! FM.destroy_entry(keys[i]))
+        {
+            num_failed++;
+        }
+    }
+    EXPECT_EQ(0, num_failed);
+    EXPECT_EQ(100, FM.create_new_entry("hoge"));
+}
+
+TEST_F(FileManagerTest, ReuseReleasedKey)
+{
+    EXPECT_EQ(100, FM.create_new_entry("hoge"));
+    EXPECT_EQ(101, FM.create_new_entry("huga"));
+    FM.destroy_entry(100);
+    EXPECT_EQ(100, FM.create_new_entry("hoge"));
+    EXPECT_EQ(102, FM.create_new_entry("piyo"));
+}
@@ -0,0 +1,207 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestFixedRate.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "jhpcndf.h"
+#include "FixedRate.h"
+#include "TestUtility.h"
+
+namespace
+{
+  template<typename T>
+  double max_error(const std::vector<T>& lhs, const std::vector<T>& rhs)
+  {
+    double error=0.0;
+    for(size_t i=0; i<lhs.size(); i++)
+    {
+      const double diff=std::fabs((double)lhs[i]-(double)rhs[i]);
+      error = diff > error ? diff : error;
+    }
+    return error;
+  }
+}
+
+REAL_TYPED_TEST_CASE(FixedRateTest);
+
+TYPED_TEST(FixedRateTest, LosslessRoundTrip)
+{
+  const size_t nmemb=10001;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  data[10]=(TypeParam)-1.0e30;
+  data[20]=(TypeParam)-0.0;
+  const unsigned int rate=12;
+  std::vector<unsigned char> upper(JHPCNDF::fixed_rate_size(nmemb, rate));
+  std::vector<TypeParam> lower(nmemb);
+  std::vector<TypeParam> result(nmemb);
+  ASSERT_EQ(upper.size(), JHPCNDF::encode_fixed_rate(&(data[0]), nmemb, rate, &(upper[0]), &(lower[0])));
+  ASSERT_EQ(nmemb, JHPCNDF::decode_fixed_rate(&(upper[0]), nmemb, rate, &(lower[0]), &(result[0])));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(0, memcmp(&(data[i]), &(result[i]), sizeof(TypeParam))) << "i = " << i;
+  }
+}
+
+TYPED_TEST(FixedRateTest, ErrorDecreasesWithRate)
+{
+  const size_t nmemb=4096;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  std::vector<TypeParam> result(nmemb);
+  double previous=std::numeric_limits<double>::max();
+  for(unsigned int rate=4; rate<=8*sizeof(TypeParam); rate+=4)
+  {
+    std::vector<unsigned char> upper(JHPCNDF::fixed_rate_size(nmemb, rate));
+    JHPCNDF::encode_fixed_rate(&(data[0]), nmemb, rate, &(upper[0]));
+    JHPCNDF::decode_fixed_rate(&(upper[0]), nmemb, rate, (const TypeParam*)NULL, &(result[0]));
+    const double error=max_error(data, result);
+    EXPECT_LE(error, previous) << "rate = " << rate;
+    //共通指数に対して仮数(rate-1)bit分の精度がある
+    EXPECT_LE(error, std::ldexp(512.0, 1-(int)JHPCNDF::FixedRate::mantissa_bits(rate, JHPCNDF::FixedRate::BLOCK_VALUES-1))) << "rate = " << rate;
+    previous=error;
+  }
+}
+
+TYPED_TEST(FixedRateTest, WriteAndRead)
+{
+  const size_t nmemb=5000;
+  const unsigned int rate=16;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  int key=JHPCNDF::fopen("fixed_rate_upper", "fixed_rate_lower", "wb");
+  ASSERT_GE(key, 0);
+  const size_t expected=sizeof(JHPCNDF::FixedRateRecordHeader)+JHPCNDF::fixed_rate_size(nmemb, rate);
+  EXPECT_EQ(expected, JHPCNDF::fwrite_fixed_rate(&(data[0]), nmemb, key, rate));
+  EXPECT_EQ(expected, JHPCNDF::fwrite_fixed_rate(&(data[0]), nmemb, key, rate));
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("fixed_rate_upper", "fixed_rate_lower", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<TypeParam> result(nmemb);
+  for(int r=0; r<2; r++)
+  {
+    ASSERT_EQ(nmemb, JHPCNDF::fread_fixed_rate(&(result[0]), nmemb, key));
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_EQ(data[i], result[i]) << "record = " << r << " i = " << i;
+    }
+  }
+  JHPCNDF::fclose(key);
+}
+
+TEST(FixedRateFileTest, UpperSizeIndependentOfData)
+{
+  const size_t nmemb=3000;
+  const unsigned int rate=8;
+  std::vector<double> smooth=make_data<double>(nmemb);
+  std::vector<double> noisy(nmemb);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    noisy[i]=std::sin(i*i*0.7)*std::pow(10.0, (double)(i%40)-20.0);
+  }
+
+  int key=JHPCNDF::fopen("fixed_rate_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_fixed_rate(&(smooth[0]), nmemb, key, rate);
+  JHPCNDF::fclose(key);
+  const long smooth_size=file_size("fixed_rate_upper");
+
+  key=JHPCNDF::fopen("fixed_rate_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_fixed_rate(&(noisy[0]), nmemb, key, rate);
+  JHPCNDF::fclose(key);
+  EXPECT_EQ(smooth_size, file_size("fixed_rate_upper"));
+  EXPECT_EQ((long)(sizeof(JHPCNDF::FixedRateRecordHeader)+JHPCNDF::fixed_rate_size(nmemb, rate)), smooth_size);
+
+  key=JHPCNDF::fopen("fixed_rate_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<double> result(nmemb);
+  EXPECT_EQ(0u, JHPCNDF::fread_fixed_rate(&(result[0]), nmemb+1, key));
+  JHPCNDF::fclose(key);
+}
+
+TEST(FixedRateAccessTest, DecodeRange)
+{
+  const size_t nmemb=1000;
+  const unsigned int rate=10;
+  std::vector<float> data=make_data<float>(nmemb);
+  std::vector<unsigned char> upper(JHPCNDF::fixed_rate_size(nmemb, rate));
+  std::vector<float> lower(nmemb);
+  JHPCNDF::encode_fixed_rate(&(data[0]), nmemb, rate, &(upper[0]), &(lower[0]));
+
+  std::vector<float> full(nmemb);
+  JHPCNDF::decode_fixed_rate(&(upper[0]), nmemb, rate, (const float*)NULL, &(full[0]));
+
+  const size_t ranges[][2]={{0, 1}, {63, 2}, {100, 300}, {960, 40}, {999, 1}};
+  for(size_t r=0; r<sizeof(ranges)/sizeof(ranges[0]); r++)
+  {
+    const size_t first=ranges[r][0];
+    const size_t count=ranges[r][1];
+    std::vector<float> partial(count);
+    ASSERT_EQ(count, JHPCNDF::decode_fixed_rate_range(&(upper[0]), nmemb, rate, first, count, (const float*)NULL, &(partial[0])));
+    for(size_t i=0; i<count; i++)
+    {
+      ASSERT_EQ(full[first+i], partial[i]) << "first = " << first << " i = " << i;
+    }
+    ASSERT_EQ(count, JHPCNDF::decode_fixed_rate_range(&(upper[0]), nmemb, rate, first, count, &(lower[0]), &(partial[0])));
+    for(size_t i=0; i<count; i++)
+    {
+      ASSERT_EQ(data[first+i], partial[i]) << "first = " << first << " i = " << i;
+    }
+  }
+  std::vector<float> dummy(2);
+  EXPECT_EQ(0u, JHPCNDF::decode_fixed_rate_range(&(upper[0]), nmemb, rate, nmemb-1, 2, (const float*)NULL, &(dummy[0])));
+}
+
+TEST(FixedRateAccessTest, InvalidRate)
+{
+  const size_t nmemb=100;
+  std::vector<float> data=make_data<float>(nmemb);
+  std::vector<unsigned char> upper(JHPCNDF::fixed_rate_size(nmemb, 32));
+  EXPECT_EQ(0u, JHPCNDF::fixed_rate_size(nmemb, 1));
+  EXPECT_EQ(0u, JHPCNDF::fixed_rate_size(nmemb, 65));
+  EXPECT_EQ(0u, JHPCNDF::encode_fixed_rate(&(data[0]), nmemb, 1, &(upper[0])));
+  EXPECT_EQ(0u, JHPCNDF::encode_fixed_rate(&(data[0]), nmemb, 33, &(upper[0])));
+  EXPECT_EQ(2*64*32/8u, JHPCNDF::fixed_rate_size(nmemb, 32));
+}
+
+TEST(FixedRateAccessTest, NonFiniteValues)
+{
+  const size_t nmemb=200;
+  std::vector<double> data=make_data<double>(nmemb);
+  data[0]=std::numeric_limits<double>::quiet_NaN();
+  data[70]=std::numeric_limits<double>::infinity();
+  for(size_t i=128; i<nmemb; i++)
+  {
+    data[i]=0.0;
+  }
+  const unsigned int rate=20;
+  std::vector<unsigned char> upper(JHPCNDF::fixed_rate_size(nmemb, rate));
+  std::vector<double> lower(nmemb);
+  std::vector<double> result(nmemb);
+  JHPCNDF::encode_fixed_rate(&(data[0]), nmemb, rate, &(upper[0]), &(lower[0]));
+  JHPCNDF::decode_fixed_rate(&(upper[0]), nmemb, rate, &(lower[0]), &(result[0]));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(0, memcmp(&(data[i]), &(result[i]), sizeof(double))) << "i = " << i;
+  }
+
+  JHPCNDF::decode_fixed_rate(&(upper[0]), nmemb, rate, (const double*)NULL, &(result[0]));
+  EXPECT_EQ(0.0, result[0]);
+  EXPECT_EQ(0.0, result[70]);
+  for(size_t i=1; i<nmemb; i++)
+  {
+    if(i == 70) continue;
+    ASSERT_NEAR(data[i], result[i], 1.0e-3) << "i = " << i;
+  }
+}
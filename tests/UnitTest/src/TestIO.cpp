@@ -10,6 +10,7 @@
 // @file TestIO.cpp
 
 #include "gtest/gtest.h"
+#include <vector>
 #include "IO.h"
 
 class IOTest : public ::testing::TestWithParam<std::tr1::tuple <const char*, size_t> >
@@ -102,3 +103,84 @@ INSTANTIATE_TEST_CASE_P(LZ4Test, IOTest, ::testing::Combine(
                         4294967297)
       ));
 #endif
+
+//
+// 縮まない区間を無圧縮ブロックで出力する処理のテスト
+//
+class ZlibBypassTest : public ::testing::Test
+{
+  protected:
+    // 線形合同法による乱数 (圧縮できないデータ)
+    void fill_noise(char* dst, const size_t& n)
+    {
+      unsigned int x=12345;
+      for(size_t i=0; i<n; i++)
+      {
+        x=x*1103515245u+12345u;
+        dst[i]=(char)(x>>24);
+      }
+    }
+    size_t round_trip(const std::vector<char>& data, const char* comp)
+    {
+      JHPCNDF::IO* io = JHPCNDF::IOFactory(comp, 32768);
+      JHPCNDF::MemoryOutputStream output;
+      const size_t write_size=io->fwrite(&(data[0]), 1, data.size(), &output);
+      EXPECT_EQ(write_size, output.get_storage().size());
+
+      std::vector<char> result(data.size());
+      JHPCNDF::MemoryInputStream input(&(output.get_storage()[0]), output.get_storage().size());
+      EXPECT_EQ(data.size(), io->fread(&(result[0]), 1, result.size(), &input));
+      EXPECT_TRUE(data == result);
+      delete io;
+      return write_size;
+    }
+};
+
+TEST_F(ZlibBypassTest, Incompressible)
+{
+  std::vector<char> data(1000000);
+  fill_noise(&(data[0]), data.size());
+  const size_t write_size=round_trip(data, "gzip");
+  // 無圧縮ブロックのオーバーヘッドは64KiB毎に5byte程度
+  EXPECT_LT(write_size, data.size()+data.size()/1000);
+}
+
+TEST_F(ZlibBypassTest, Mixed)
+{
+  // 縮む区間と縮まない区間が交互に並ぶデータ
+  std::vector<char> data(1000000);
+  for(size_t offset=0; offset<data.size(); offset+=200000)
+  {
+    fill_noise(&(data[offset]), 100000);
+    for(size_t i=offset+100000; i<offset+200000; i++)
+    {
+      data[i]='A'+i%26;
+    }
+  }
+  const size_t write_size=round_trip(data, "gzip");
+  EXPECT_LT(write_size, data.size()*6/10);
+}
+
+TEST_F(ZlibBypassTest, Compressible)
+{
+  std::vector<char> data(1000000);
+  for(size_t i=0; i<data.size(); i++)
+  {
+    data[i]='A'+i%26;
+  }
+  EXPECT_LT(round_trip(data, "gzip_1"), data.size()/100);
+}
+
+TEST_F(ZlibBypassTest, NoiseInLowBytes)
+{
+  // 各要素の上位byteは揃っていて下位byteが乱数のデータ(JHPCN-DFの下位bit側に近いもの)
+  std::vector<char> data(1000000);
+  fill_noise(&(data[0]), data.size());
+  for(size_t i=0; i<data.size(); i+=4)
+  {
+    data[i+3]=0;
+    data[i+2]&=0x0f;
+  }
+  const size_t write_size=round_trip(data, "gzip");
+  EXPECT_LT(write_size, data.size()*8/10);
+}
@@ -0,0 +1,215 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestLorenzo.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "jhpcndf.h"
+#include "Lorenzo.h"
+#include "TestUtility.h"
+
+namespace
+{
+  //構造格子上の滑らかな場
+  template<typename T>
+  std::vector<T> make_field(const size_t& nx, const size_t& ny, const size_t& nz)
+  {
+    std::vector<T> data(nx*ny*nz);
+    size_t index=0;
+    for(size_t k=0; k<nz; k++)
+    {
+      for(size_t j=0; j<ny; j++)
+      {
+        for(size_t i=0; i<nx; i++, index++)
+        {
+          data[index]=(T)(300.0+std::sin(0.11*i+0.05*k)*std::cos(0.07*j+0.03*k)*20.0);
+        }
+      }
+    }
+    return data;
+  }
+}
+
+struct LorenzoDims
+{
+  size_t nx;
+  size_t ny;
+  size_t nz;
+};
+
+class LorenzoTest : public ::testing::TestWithParam<LorenzoDims>
+{
+};
+
+TEST_P(LorenzoTest, LosslessRoundTrip)
+{
+  const LorenzoDims dims=GetParam();
+  const size_t nmemb=dims.nx*dims.ny*dims.nz;
+  std::vector<double> data=make_field<double>(dims.nx, dims.ny, dims.nz);
+  std::vector<float>  data_float=make_field<float>(dims.nx, dims.ny, dims.nz);
+
+  int key=JHPCNDF::fopen("lorenzo_upper", "lorenzo_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fwrite_lorenzo(&(data[0]), dims.nx, dims.ny, dims.nz, key, 0.001), 0u);
+  EXPECT_GT(JHPCNDF::fwrite_lorenzo(&(data_float[0]), dims.nx, dims.ny, dims.nz, key, 0.001), 0u);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("lorenzo_upper", "lorenzo_lower", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<double> result(nmemb);
+  std::vector<float>  result_float(nmemb);
+  ASSERT_EQ(nmemb, JHPCNDF::fread_lorenzo(&(result[0]), dims.nx, dims.ny, dims.nz, key));
+  ASSERT_EQ(nmemb, JHPCNDF::fread_lorenzo(&(result_float[0]), dims.nx, dims.ny, dims.nz, key));
+  JHPCNDF::fclose(key);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(data[i], result[i]) << "i = " << i;
+    ASSERT_EQ(data_float[i], result_float[i]) << "i = " << i;
+  }
+}
+
+TEST_P(LorenzoTest, UpperBitsOnly)
+{
+  const LorenzoDims dims=GetParam();
+  const size_t nmemb=dims.nx*dims.ny*dims.nz;
+  const float tolerance=0.01;
+  std::vector<double> data=make_field<double>(dims.nx, dims.ny, dims.nz);
+
+  int key=JHPCNDF::fopen("lorenzo_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_lorenzo(&(data[0]), dims.nx, dims.ny, dims.nz, key, tolerance, false);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("lorenzo_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<double> result(nmemb);
+  ASSERT_EQ(nmemb, JHPCNDF::fread_lorenzo(&(result[0]), dims.nx, dims.ny, dims.nz, key));
+  JHPCNDF::fclose(key);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_LE(std::fabs(data[i]-result[i]), tolerance) << "i = " << i;
+  }
+}
+
+const LorenzoDims lorenzo_dims[]=
+{
+  {40, 30, 20},
+  {200, 150, 1},
+  {5000, 1, 1},
+  {1, 1, 1},
+};
+INSTANTIATE_TEST_CASE_P(Dims, LorenzoTest, ::testing::ValuesIn(lorenzo_dims));
+
+TEST(LorenzoSizeTest, SmallerThanFwrite)
+{
+  const size_t nx=64, ny=64, nz=32;
+  std::vector<double> data=make_field<double>(nx, ny, nz);
+
+  int key=JHPCNDF::fopen("lorenzo_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_lorenzo(&(data[0]), nx, ny, nz, key, 1.0e-6);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("plain_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite(&(data[0]), sizeof(double), nx*ny*nz, key, 1.0e-6);
+  JHPCNDF::fclose(key);
+
+  const long lorenzo_size=file_size("lorenzo_upper");
+  const long plain_size=file_size("plain_upper");
+  ASSERT_GT(lorenzo_size, 0);
+  ASSERT_GT(plain_size, 0);
+  EXPECT_LT(lorenzo_size, plain_size);
+}
+
+TEST(LorenzoReadTest, MismatchedDims)
+{
+  std::vector<float> data=make_field<float>(10, 10, 10);
+  int key=JHPCNDF::fopen("lorenzo_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_lorenzo(&(data[0]), 10, 10, 10, key, 0.01);
+  JHPCNDF::fclose(key);
+
+  std::vector<float> result(1000);
+  key=JHPCNDF::fopen("lorenzo_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  EXPECT_EQ(0u, JHPCNDF::fread_lorenzo(&(result[0]), 100, 10, 1, key));
+  JHPCNDF::fclose(key);
+
+  std::vector<double> result_double(1000);
+  key=JHPCNDF::fopen("lorenzo_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  EXPECT_EQ(0u, JHPCNDF::fread_lorenzo(&(result_double[0]), 10, 10, 10, key));
+  JHPCNDF::fclose(key);
+}
+
+TEST(LorenzoMemoryTest, RelativeToleranceAndNonFinite)
+{
+  const size_t nx=30, ny=20, nz=10;
+  const size_t nmemb=nx*ny*nz;
+  std::vector<float> data=make_field<float>(nx, ny, nz);
+  data[5]=std::numeric_limits<float>::quiet_NaN();
+  data[nx*ny+3]=std::numeric_limits<float>::infinity();
+  data[nmemb-1]=-1.0e30f;
+
+  std::vector<float> upper(nmemb);
+  std::vector<float> lower(nmemb);
+  JHPCNDF::encode_lorenzo(nx, ny, nz, &(data[0]), &(upper[0]), &(lower[0]), 0.001);
+
+  std::vector<float> result(nmemb);
+  JHPCNDF::decode_lorenzo(nx, ny, nz, &(upper[0]), &(lower[0]), &(result[0]));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    if(data[i] != data[i])
+    {
+      ASSERT_TRUE(result[i] != result[i]) << "i = " << i;
+    }else{
+      ASSERT_EQ(data[i], result[i]) << "i = " << i;
+    }
+  }
+
+  //上位bit側のみでも、NaNやInfの後ろの要素は許容誤差以内で復元できる
+  JHPCNDF::decode_lorenzo(nx, ny, nz, &(upper[0]), (const float*)NULL, &(result[0]));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    if(data[i] != data[i] || std::fabs(data[i]) == std::numeric_limits<float>::infinity())
+    {
+      continue;
+    }
+    ASSERT_LE(std::fabs(data[i]-result[i]), std::fabs(data[i]*0.001)) << "i = " << i;
+  }
+
+  //上位bitのみを出力した場合と同じ値になる
+  std::vector<float> upper_only(nmemb);
+  JHPCNDF::encode_lorenzo(nx, ny, nz, &(data[0]), &(upper_only[0]), (float*)NULL, 0.001);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(0, memcmp(&(upper[i]), &(upper_only[i]), sizeof(float))) << "i = " << i;
+  }
+}
+
+TEST(LorenzoTruncateTest, ErrorBound)
+{
+  const double tolerances[]={1.0, 0.3, 1.0e-3, 1.0e-7};
+  const double residuals[]={0.0, 0.2, -0.75, 3.14159, -1234.5678, 1.0e-9};
+  for(size_t t=0; t<sizeof(tolerances)/sizeof(double); t++)
+  {
+    for(size_t r=0; r<sizeof(residuals)/sizeof(double); r++)
+    {
+      const double truncated=JHPCNDF::Lorenzo::truncate(residuals[r], tolerances[t]);
+      EXPECT_LE(std::fabs(residuals[r]-truncated), tolerances[t]) << residuals[r] << " " << tolerances[t];
+      EXPECT_LE(std::fabs(truncated), std::fabs(residuals[r]));
+    }
+  }
+}
@@ -0,0 +1,197 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestQuantize.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "jhpcndf.h"
+#include "Stream.h"
+#include "Quantize.h"
+#include "TestUtility.h"
+
+REAL_TYPED_TEST_CASE(QuantizeTest);
+
+TYPED_TEST(QuantizeTest, LosslessRoundTrip)
+{
+  const size_t nmemb=20000;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  data[10]=std::numeric_limits<TypeParam>::quiet_NaN();
+  data[20]=std::numeric_limits<TypeParam>::infinity();
+  data[30]=(TypeParam)-1.0e30;
+  data[40]=(TypeParam)-0.0;
+
+  int key=JHPCNDF::fopen("quantize_upper", "quantize_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fwrite(&(data[0]), sizeof(TypeParam), nmemb, key, 0.01, false, "quantize"), 0u);
+  EXPECT_GT(JHPCNDF::fwrite(&(data[0]), sizeof(TypeParam), nmemb, key, 0.001, true, "quantize"), 0u);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("quantize_upper", "quantize_lower", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<TypeParam> result(nmemb);
+  for(int r=0; r<2; r++)
+  {
+    JHPCNDF::fread(&(result[0]), sizeof(TypeParam), nmemb, key);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_EQ(0, memcmp(&(data[i]), &(result[i]), sizeof(TypeParam))) << "record = " << r << " i = " << i;
+    }
+  }
+  JHPCNDF::fclose(key);
+}
+
+TYPED_TEST(QuantizeTest, UpperBitsOnly)
+{
+  const size_t nmemb=20000;
+  const float tolerance=0.01;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  data[10]=std::numeric_limits<TypeParam>::quiet_NaN();
+
+  int key=JHPCNDF::fopen("quantize_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite(&(data[0]), sizeof(TypeParam), nmemb, key, tolerance, false, "quantize");
+  JHPCNDF::fwrite(&(data[0]), sizeof(TypeParam), nmemb, key, tolerance, true, "quantize");
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("quantize_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<TypeParam> result(nmemb);
+  JHPCNDF::fread(&(result[0]), sizeof(TypeParam), nmemb, key);
+  EXPECT_TRUE(result[10] != result[10]);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    if(i == 10) continue;
+    ASSERT_LE(std::fabs(data[i]-result[i]), tolerance) << "i = " << i;
+  }
+  JHPCNDF::fread(&(result[0]), sizeof(TypeParam), nmemb, key);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    if(i == 10) continue;
+    ASSERT_LE(std::fabs(data[i]-result[i]), std::fabs(data[i]*tolerance)) << "i = " << i;
+  }
+  JHPCNDF::fclose(key);
+}
+
+TEST(QuantizeFileTest, MixedWithOtherEncoders)
+{
+  const size_t nmemb=5000;
+  std::vector<double> data=make_data<double>(nmemb);
+  int key=JHPCNDF::fopen("quantize_upper", "quantize_lower", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite(&(data[0]), sizeof(double), nmemb, key, 0.01, true, "binary_search");
+  JHPCNDF::fwrite(&(data[0]), sizeof(double), nmemb, key, 0.01, true, "quantize");
+  JHPCNDF::fwrite(&(data[0]), sizeof(double), nmemb, key, 0.01, true, "binary_search");
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("quantize_upper", "quantize_lower", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<double> result(nmemb);
+  for(int r=0; r<3; r++)
+  {
+    ASSERT_EQ(sizeof(double)*nmemb, JHPCNDF::fread(&(result[0]), sizeof(double), nmemb, key));
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_EQ(data[i], result[i]) << "record = " << r << " i = " << i;
+    }
+  }
+  JHPCNDF::fclose(key);
+}
+
+TEST(QuantizeFileTest, SmallerThanBinarySearch)
+{
+  const size_t nmemb=100000;
+  std::vector<double> data=make_data<double>(nmemb);
+
+  int key=JHPCNDF::fopen("quantize_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite(&(data[0]), sizeof(double), nmemb, key, 0.001, false, "quantize");
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("plain_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite(&(data[0]), sizeof(double), nmemb, key, 0.001, false, "binary_search");
+  JHPCNDF::fclose(key);
+
+  const long quantize_size=file_size("quantize_upper");
+  const long plain_size=file_size("plain_upper");
+  ASSERT_GT(quantize_size, 0);
+  ASSERT_GT(plain_size, 0);
+  EXPECT_LT(quantize_size, plain_size);
+}
+
+TEST(QuantizeFileTest, InMemoryEncodeDecode)
+{
+  const size_t nmemb=1000;
+  std::vector<float> data=make_data<float>(nmemb);
+  std::vector<float> upper(nmemb);
+  std::vector<float> lower(nmemb);
+  std::vector<float> result(nmemb);
+  JHPCNDF::encode(nmemb, &(data[0]), &(upper[0]), &(lower[0]), 0.05, false, "quantize");
+  JHPCNDF::decode(nmemb, &(upper[0]), &(lower[0]), &(result[0]));
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_LE(std::fabs(data[i]-upper[i]), 0.05) << "i = " << i;
+    ASSERT_EQ(data[i], result[i]) << "i = " << i;
+  }
+}
+
+TEST(QuantizeRecordTest, ConstantEmptyAndLargeJumps)
+{
+  const double step=0.5;
+  std::vector<double> values;
+  values.push_back(0.0);
+  values.push_back(1.0e12);
+  values.push_back(-1.0e12);
+  values.push_back(std::numeric_limits<double>::quiet_NaN());
+  values.push_back(0.3);
+  for(int i=0; i<1000; i++)
+  {
+    values.push_back(2.5);
+  }
+
+  const size_t lengths[]={0, 1, values.size()};
+  for(size_t l=0; l<sizeof(lengths)/sizeof(size_t); l++)
+  {
+    const size_t length=lengths[l];
+    JHPCNDF::MemoryOutputStream output;
+    const size_t record_size=JHPCNDF::Quantize::write_record(&output, length > 0 ? &(values[0]) : (double*)NULL, length, step);
+    ASSERT_EQ(output.tell(), record_size);
+
+    std::vector<double> result(length+1);
+    JHPCNDF::MemoryInputStream input(&(output.get_storage()[0]), output.tell());
+    ASSERT_TRUE(JHPCNDF::Quantize::is_record<double>(&input, length));
+    EXPECT_FALSE(JHPCNDF::Quantize::is_record<float>(&input, length));
+    EXPECT_FALSE(JHPCNDF::Quantize::is_record<double>(&input, length+1));
+    ASSERT_TRUE(JHPCNDF::Quantize::read_record(&input, &(result[0]), length));
+    for(size_t i=0; i<length; i++)
+    {
+      ASSERT_EQ(0, memcmp(&(values[i]), &(result[i]), sizeof(double))) << "length = " << length << " i = " << i;
+    }
+  }
+}
+
+TEST(QuantizeRecordTest, NormalizeFrequencies)
+{
+  std::vector<uint64_t> counts(JHPCNDF::Quantize::NUM_SYMBOLS, 1);
+  counts[0]=1000000;
+  std::vector<uint32_t> freqs;
+  JHPCNDF::Quantize::normalize_frequencies(counts, 1000000+JHPCNDF::Quantize::NUM_SYMBOLS-1, &freqs);
+  uint32_t sum=0;
+  for(size_t s=0; s<freqs.size(); s++)
+  {
+    EXPECT_GE(freqs[s], 1u);
+    sum+=freqs[s];
+  }
+  EXPECT_EQ(JHPCNDF::Quantize::PROB_SCALE, sum);
+}
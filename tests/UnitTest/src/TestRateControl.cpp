@@ -0,0 +1,126 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestRateControl.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "jhpcndf.h"
+#include "TestUtility.h"
+
+REAL_TYPED_TEST_CASE(RateControlTest);
+
+TYPED_TEST(RateControlTest, TargetSize)
+{
+  const size_t nmemb=600000;
+  std::vector<TypeParam> data=make_noisy_data<TypeParam>(nmemb);
+  const size_t raw_size=sizeof(TypeParam)*nmemb;
+  const char* encoders[]={"binary_search", "quantize"};
+  for(size_t e=0; e<sizeof(encoders)/sizeof(char*); e++)
+  {
+    float previous_tolerance=0.0f;
+    for(size_t divisor=3; divisor<=12; divisor*=4)
+    {
+      const size_t target_size=raw_size/divisor;
+      float tolerance=-1.0f;
+      int key=JHPCNDF::fopen("rate_upper", "rate_lower", "wb");
+      ASSERT_GE(key, 0);
+      const size_t output_size=JHPCNDF::fwrite_target_size(&(data[0]), nmemb, key, target_size, &tolerance, true, encoders[e]);
+      JHPCNDF::fclose(key);
+      EXPECT_GT(tolerance, 0.0f);
+      EXPECT_EQ((long)output_size, file_size("rate_upper"));
+      //推定値を使うので数%の超過は許容する
+      //分割位置は離散的にしか変わらないので、目標を大きく下回る場合もある
+      EXPECT_LE(output_size, target_size*1.05) << encoders[e] << " divisor = " << divisor;
+      EXPECT_GE(output_size, target_size*0.5) << encoders[e] << " divisor = " << divisor;
+      //目標サイズが小さい程、許容誤差は緩くなる
+      EXPECT_GT(tolerance, previous_tolerance);
+      previous_tolerance=tolerance;
+
+      std::vector<TypeParam> result(nmemb);
+      key=JHPCNDF::fopen("rate_upper", "", "rb");
+      ASSERT_GE(key, 0);
+      JHPCNDF::fread(&(result[0]), sizeof(TypeParam), nmemb, key);
+      JHPCNDF::fclose(key);
+      for(size_t i=0; i<nmemb; i+=101)
+      {
+        ASSERT_LE(std::fabs(data[i]-result[i]), std::fabs(data[i])*tolerance) << "i = " << i;
+      }
+    }
+  }
+}
+
+TEST(RateControlFileTest, SmallArrayIsExact)
+{
+  //サンプルの合計より小さい配列は全体から推定するので、目標値を超えない
+  const size_t nmemb=50000;
+  std::vector<double> data=make_noisy_data<double>(nmemb);
+  const size_t target_size=sizeof(double)*nmemb/5;
+  float tolerance=0.0f;
+  int key=JHPCNDF::fopen("rate_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  const size_t output_size=JHPCNDF::fwrite_target_size(&(data[0]), nmemb, key, target_size, &tolerance, false);
+  JHPCNDF::fclose(key);
+  EXPECT_LE(output_size, target_size);
+  EXPECT_GT(output_size, target_size*0.9);
+
+  //同じ許容誤差でfwriteした場合と同じ
+  key=JHPCNDF::fopen("rate_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_EQ(output_size, JHPCNDF::fwrite(&(data[0]), sizeof(double), nmemb, key, tolerance, false));
+  JHPCNDF::fclose(key);
+}
+
+TEST(RateControlFileTest, TargetRatio)
+{
+  const size_t nmemb=300000;
+  std::vector<float> data=make_noisy_data<float>(nmemb);
+  float tolerance=0.0f;
+  int key=JHPCNDF::fopen("rate_upper", "rate_lower", "wb");
+  ASSERT_GE(key, 0);
+  const size_t output_size=JHPCNDF::fwrite_target_ratio(&(data[0]), nmemb, key, 4.0, &tolerance, true, "byte_aligned");
+  JHPCNDF::fclose(key);
+  EXPECT_LE(output_size, sizeof(float)*nmemb/4*1.05);
+
+  //下位bit側と合わせると元データを復元できる
+  std::vector<float> result(nmemb);
+  key=JHPCNDF::fopen("rate_upper", "rate_lower", "rb");
+  JHPCNDF::fread(&(result[0]), sizeof(float), nmemb, key);
+  JHPCNDF::fclose(key);
+  EXPECT_TRUE(data == result);
+}
+
+TEST(RateControlFileTest, UnreachableTarget)
+{
+  const size_t nmemb=10000;
+  std::vector<float> data=make_noisy_data<float>(nmemb);
+  float tolerance=0.0f;
+  int key=JHPCNDF::fopen("rate_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fwrite_target_size(&(data[0]), nmemb, key, 1, &tolerance), 0u);
+  EXPECT_EQ(1.0f, tolerance);
+  EXPECT_EQ(0u, JHPCNDF::fwrite_target_size(&(data[0]), nmemb, key, 1000, &tolerance, true, "nbit_filter"));
+  EXPECT_EQ(0u, JHPCNDF::fwrite_target_ratio(&(data[0]), nmemb, key, 0.0, &tolerance));
+  JHPCNDF::fclose(key);
+}
+
+TEST(RateControlFileTest, CAPI)
+{
+  const size_t nmemb=20000;
+  std::vector<double> data=make_noisy_data<double>(nmemb);
+  float tolerance=0.0f;
+  int key=JHPCNDF::fopen("rate_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF_fwrite_target_ratio_double(&(data[0]), nmemb, key, 8.0, &tolerance, 1, NULL), 0u);
+  EXPECT_GT(tolerance, 0.0f);
+  EXPECT_GT(JHPCNDF_fwrite_target_size_double(&(data[0]), nmemb, key, 10000, NULL, 1, "binary_search"), 0u);
+  JHPCNDF::fclose(key);
+}
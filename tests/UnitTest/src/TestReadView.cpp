@@ -0,0 +1,228 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestReadView.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+#include <pthread.h>
+#include "jhpcndf.h"
+#include "TestUtility.h"
+
+namespace
+{
+  //1つのReadViewを複数のスレッドから読む時の各スレッドの担当範囲
+  struct ConcurrentReader
+  {
+    JHPCNDF::ReadView<float>* view;
+    size_t first;
+    size_t count;
+    std::vector<float> result;
+    size_t num_failures;
+  };
+
+  void* concurrent_read(void* arg)
+  {
+    ConcurrentReader* reader=static_cast<ConcurrentReader*>(arg);
+    reader->result.resize(reader->count);
+    reader->num_failures=0;
+    //キャッシュより多いチャンクを何度も読み直して、スレッド毎に別のチャンクのデコードが重なるようにする
+    for(int repeat=0; repeat<4; repeat++)
+    {
+      for(size_t offset=0; offset<reader->count; offset+=700)
+      {
+        const size_t count=std::min<size_t>(700, reader->count-offset);
+        if(reader->view->read(reader->first+offset, count, &(reader->result[offset])) != count)
+        {
+          reader->num_failures++;
+        }
+      }
+    }
+    return NULL;
+  }
+}
+
+REAL_TYPED_TEST_CASE(ReadViewTest);
+
+TYPED_TEST(ReadViewTest, SparseAccess)
+{
+  const size_t nmemb=100000;
+  const size_t chunk_elements=1000;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  int key=JHPCNDF::fopen("view_upper", "view_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fwrite_chunked(&(data[0]), nmemb, key, 0.01, true, chunk_elements), 0u);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("view_upper", "view_lower", "rb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::ReadView<TypeParam> view(key, 4, 0);
+  JHPCNDF::fclose(key);
+  ASSERT_TRUE(view.is_valid());
+  EXPECT_EQ(nmemb, view.size());
+  EXPECT_EQ(nmemb/chunk_elements, view.num_chunks());
+  EXPECT_EQ(0u, view.decoded_chunks());
+
+  const size_t probes[]={5, 999, 1000, 54321, 99999};
+  for(size_t p=0; p<sizeof(probes)/sizeof(size_t); p++)
+  {
+    ASSERT_EQ(data[probes[p]], view.get(probes[p])) << "index = " << probes[p];
+  }
+  EXPECT_EQ(4u, view.decoded_chunks());
+
+  //キャッシュに残っているチャンクは再デコードしない
+  EXPECT_EQ(data[99998], view.get(99998));
+  EXPECT_EQ(4u, view.decoded_chunks());
+  EXPECT_EQ((TypeParam)0, view.get(nmemb));
+}
+
+TYPED_TEST(ReadViewTest, RangeReadWithPrefetch)
+{
+  const size_t nmemb=50000;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  int key=JHPCNDF::fopen("view_upper", "view_lower", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_chunked(&(data[0]), nmemb, key, 0.01, true, 4096);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("view_upper", "view_lower", "rb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::ReadView<TypeParam> view(key, 8, 2);
+  ASSERT_TRUE(view.is_valid());
+  std::vector<TypeParam> result(nmemb);
+  for(size_t first=0; first<nmemb; first+=3000)
+  {
+    const size_t count=std::min<size_t>(3000, nmemb-first);
+    ASSERT_EQ(count, view.read(first, count, &(result[first])));
+  }
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_EQ(data[i], result[i]) << "i = " << i;
+  }
+  EXPECT_EQ(0u, view.read(nmemb-1, 2, &(result[0])));
+  JHPCNDF::fclose(key);
+}
+
+TEST(ReadViewFileTest, ConsecutiveRecords)
+{
+  const size_t nmemb=20000;
+  std::vector<double> first=make_data<double>(nmemb);
+  std::vector<double> second=make_data<double>(nmemb/2, 100.0);
+  int key=JHPCNDF::fopen("view_upper", "view_lower", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_chunked(&(first[0]), nmemb, key, 0.01, true, 3000);
+  JHPCNDF::fwrite_chunked(&(second[0]), nmemb/2, key, 0.01, false, 7000, "byte_aligned");
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("view_upper", "view_lower", "rb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::ReadView<double> view1(key);
+  JHPCNDF::ReadView<double> view2(key);
+  JHPCNDF::ReadView<double> view3(key);
+  JHPCNDF::fclose(key);
+  ASSERT_TRUE(view1.is_valid());
+  ASSERT_TRUE(view2.is_valid());
+  EXPECT_FALSE(view3.is_valid());
+  EXPECT_EQ(nmemb, view1.size());
+  EXPECT_EQ(nmemb/2, view2.size());
+  for(size_t i=0; i<nmemb/2; i+=37)
+  {
+    ASSERT_EQ(first[i], view1.get(i)) << "i = " << i;
+    ASSERT_EQ(second[i], view2.get(i)) << "i = " << i;
+  }
+}
+
+TEST(ReadViewFileTest, ConcurrentReads)
+{
+  const size_t nmemb=200000;
+  const size_t num_threads=4;
+  std::vector<float> data=make_data<float>(nmemb);
+  int key=JHPCNDF::fopen("view_upper", "view_lower", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_chunked(&(data[0]), nmemb, key, 0.01, true, 2000);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("view_upper", "view_lower", "rb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::ReadView<float> view(key, 2, 1);
+  JHPCNDF::fclose(key);
+  ASSERT_TRUE(view.is_valid());
+
+  std::vector<ConcurrentReader> readers(num_threads);
+  std::vector<pthread_t> threads(num_threads);
+  for(size_t t=0; t<num_threads; t++)
+  {
+    readers[t].view=&view;
+    readers[t].first=t*(nmemb/num_threads);
+    readers[t].count=nmemb/num_threads;
+    ASSERT_EQ(0, pthread_create(&(threads[t]), NULL, concurrent_read, &(readers[t])));
+  }
+  for(size_t t=0; t<num_threads; t++)
+  {
+    pthread_join(threads[t], NULL);
+  }
+  for(size_t t=0; t<num_threads; t++)
+  {
+    EXPECT_EQ(0u, readers[t].num_failures) << "thread = " << t;
+    for(size_t i=0; i<readers[t].count; i++)
+    {
+      ASSERT_EQ(data[readers[t].first+i], readers[t].result[i]) << "thread = " << t << ", i = " << i;
+    }
+  }
+}
+
+TEST(ReadViewFileTest, UpperBitsOnly)
+{
+  const size_t nmemb=20000;
+  const float tolerance=0.01;
+  std::vector<float> data=make_data<float>(nmemb);
+  int key=JHPCNDF::fopen("view_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_chunked(&(data[0]), nmemb, key, tolerance, false, 2500);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("view_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::ReadView<float> view(key);
+  ASSERT_TRUE(view.is_valid());
+  //型が一致しない場合は生成に失敗する
+  JHPCNDF::fclose(key);
+  key=JHPCNDF::fopen("view_upper", "", "rb");
+  JHPCNDF::ReadView<double> wrong_type(key);
+  EXPECT_FALSE(wrong_type.is_valid());
+  JHPCNDF::fclose(key);
+  for(size_t i=0; i<nmemb; i+=13)
+  {
+    ASSERT_LE(std::fabs(data[i]-view.get(i)), tolerance) << "i = " << i;
+  }
+}
+
+TEST(ReadViewFileTest, CAPI)
+{
+  const size_t nmemb=5000;
+  std::vector<float> data=make_data<float>(nmemb);
+  int key=JHPCNDF::fopen("view_upper", "view_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF_fwrite_chunked_float(&(data[0]), nmemb, key, 0.01, 1, 1024, "binary_search"), 0u);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("view_upper", "view_lower", "rb");
+  JHPCNDF_ReadView_float* view=JHPCNDF_open_view_float(key, 4, 1);
+  JHPCNDF::fclose(key);
+  ASSERT_TRUE(view != NULL);
+  EXPECT_EQ(nmemb, JHPCNDF_view_size_float(view));
+  std::vector<float> result(100);
+  ASSERT_EQ(100u, JHPCNDF_view_read_float(view, 2000, 100, &(result[0])));
+  for(size_t i=0; i<100; i++)
+  {
+    ASSERT_EQ(data[2000+i], result[i]) << "i = " << i;
+  }
+  JHPCNDF_close_view_float(view);
+}
@@ -0,0 +1,71 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestScratchArena.cpp
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include "ScratchArena.h"
+
+TEST(ScratchArenaTest, ReuseSameRegion)
+{
+    JHPCNDF::ScratchArena arena;
+    void* first=arena.get(JHPCNDF::ScratchArena::UPPER, 1024);
+    ASSERT_TRUE(first != NULL);
+    EXPECT_EQ(first, arena.get(JHPCNDF::ScratchArena::UPPER, 512));
+    EXPECT_EQ(first, arena.get(JHPCNDF::ScratchArena::UPPER, 1024));
+}
+
+TEST(ScratchArenaTest, SlotsAreIndependent)
+{
+    JHPCNDF::ScratchArena arena;
+    char* upper=static_cast<char*>(arena.get(JHPCNDF::ScratchArena::UPPER, 128));
+    char* lower=static_cast<char*>(arena.get(JHPCNDF::ScratchArena::LOWER, 128));
+    ASSERT_TRUE(upper != NULL);
+    ASSERT_TRUE(lower != NULL);
+    EXPECT_NE(upper, lower);
+    std::memset(upper, 1, 128);
+    std::memset(lower, 2, 128);
+    EXPECT_EQ(1, upper[127]);
+    EXPECT_EQ(2, lower[0]);
+}
+
+TEST(ScratchArenaTest, HugeRegion)
+{
+    JHPCNDF::ScratchArena arena;
+    const size_t size=5*1024*1024+3;
+    char* ptr=static_cast<char*>(arena.get(JHPCNDF::ScratchArena::WORK, size));
+    ASSERT_TRUE(ptr != NULL);
+    std::memset(ptr, 0xff, size);
+    EXPECT_GE(arena.allocated_size(), size);
+    EXPECT_EQ(ptr, arena.get(JHPCNDF::ScratchArena::WORK, size-1));
+}
+
+TEST(ScratchArenaTest, TrimByCapacity)
+{
+    JHPCNDF::ScratchArena arena;
+    arena.get(JHPCNDF::ScratchArena::UPPER, 4096);
+    arena.trim();
+    EXPECT_EQ(4096u, arena.allocated_size());
+    arena.set_capacity(1024);
+    EXPECT_EQ(0u, arena.allocated_size());
+    arena.set_capacity(0);
+    arena.get(JHPCNDF::ScratchArena::UPPER, 16);
+    arena.trim();
+    EXPECT_EQ(0u, arena.allocated_size());
+}
+
+TEST(ScratchArenaTest, Release)
+{
+    JHPCNDF::ScratchArena arena;
+    arena.get(JHPCNDF::ScratchArena::UPPER, 100);
+    arena.get(JHPCNDF::ScratchArena::LOWER, 100);
+    arena.release();
+    EXPECT_EQ(0u, arena.allocated_size());
+}
@@ -0,0 +1,214 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestSubarray.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "jhpcndf.h"
+#include "Subarray.h"
+#include "TestUtility.h"
+
+namespace
+{
+  //部分領域を連続領域にコピーする (比較用)
+  template<typename T>
+  std::vector<T> copy_subarray(const std::vector<T>& data, const JHPCNDF::Subarray& subarray)
+  {
+    const JHPCNDF::SubarrayLayout layout(subarray.extents.size(), &(subarray.extents[0]), &(subarray.offsets[0]), &(subarray.counts[0]), &(subarray.strides[0]));
+    std::vector<T> interior(layout.size());
+    for(size_t r=0; r<layout.num_rows(); r++)
+    {
+      layout.gather_row(r, 0, layout.row_length(), &(data[0]), &(interior[r*layout.row_length()]));
+    }
+    return interior;
+  }
+}
+
+TEST(SubarrayLayoutTest, RowsAndOffsets)
+{
+  const size_t extents[]={10, 8, 6};
+  const size_t offsets[]={2, 1, 3};
+  const size_t counts[]={5, 4, 2};
+  const size_t strides[]={1, 2, 1};
+  JHPCNDF::SubarrayLayout layout(3, extents, offsets, counts, strides);
+  ASSERT_TRUE(layout.is_valid());
+  EXPECT_EQ(40u, layout.size());
+  EXPECT_EQ(5u, layout.row_length());
+  EXPECT_EQ(8u, layout.num_rows());
+  EXPECT_EQ(2+10*1+80*3u, layout.row_offset(0));
+  EXPECT_EQ(2+10*3+80*3u, layout.row_offset(1));
+  EXPECT_EQ(2+10*7+80*4u, layout.row_offset(7));
+
+  //範囲外やstride=0は不正
+  const size_t too_large[]={5, 4, 4};
+  EXPECT_FALSE(JHPCNDF::SubarrayLayout(3, extents, offsets, too_large).is_valid());
+  const size_t zero_stride[]={1, 0, 1};
+  EXPECT_FALSE(JHPCNDF::SubarrayLayout(3, extents, offsets, counts, zero_stride).is_valid());
+}
+
+TEST(SubarrayLayoutTest, MergeContiguousDimensions)
+{
+  //次元0と次元1を全て取り出す場合は、次元2の範囲が1行になる
+  const size_t extents[]={10, 8, 6};
+  const size_t offsets[]={0, 0, 2};
+  const size_t counts[]={10, 8, 3};
+  JHPCNDF::SubarrayLayout layout(3, extents, offsets, counts);
+  ASSERT_TRUE(layout.is_valid());
+  EXPECT_EQ(1u, layout.num_rows());
+  EXPECT_EQ(240u, layout.row_length());
+  EXPECT_EQ(160u, layout.row_offset(0));
+}
+
+REAL_TYPED_TEST_CASE(SubarrayTest);
+
+TYPED_TEST(SubarrayTest, SameAsCopiedInterior)
+{
+  const size_t extents[]={70, 40, 30};
+  const JHPCNDF::Subarray subarray(3, extents, 3);
+  std::vector<TypeParam> data=make_data<TypeParam>(70*40*30);
+  std::vector<TypeParam> interior=copy_subarray(data, subarray);
+  ASSERT_EQ(64u*34u*24u, interior.size());
+
+  const char* encoders[]={"binary_search", "quantize", "byte_aligned"};
+  for(size_t e=0; e<sizeof(encoders)/sizeof(char*); e++)
+  {
+    int key=JHPCNDF::fopen("copy_upper", "copy_lower", "wb");
+    ASSERT_GE(key, 0);
+    JHPCNDF::fwrite(&(interior[0]), sizeof(TypeParam), interior.size(), key, 0.01, true, encoders[e]);
+    JHPCNDF::fclose(key);
+
+    key=JHPCNDF::fopen("subarray_upper", "subarray_lower", "wb");
+    ASSERT_GE(key, 0);
+    EXPECT_GT(JHPCNDF::fwrite_subarray(&(data[0]), subarray, key, 0.01, true, encoders[e]), 0u);
+    JHPCNDF::fclose(key);
+
+    EXPECT_TRUE(read_file("copy_upper") == read_file("subarray_upper")) << encoders[e];
+    EXPECT_TRUE(read_file("copy_lower") == read_file("subarray_lower")) << encoders[e];
+  }
+}
+
+TYPED_TEST(SubarrayTest, ReadBackToStridedRegion)
+{
+  const size_t extents[]={50, 21, 9};
+  const size_t offsets[]={1, 2, 0};
+  const size_t counts[]={16, 10, 9};
+  const size_t strides[]={3, 2, 1};
+  const JHPCNDF::Subarray subarray(3, extents, offsets, counts, strides);
+  std::vector<TypeParam> data=make_data<TypeParam>(50*21*9);
+  int key=JHPCNDF::fopen("subarray_upper", "subarray_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fwrite_subarray(&(data[0]), subarray, key, 0.01), 0u);
+  JHPCNDF::fclose(key);
+
+  //部分領域以外の要素は変更されない
+  std::vector<TypeParam> result(data.size(), (TypeParam)-1.0);
+  key=JHPCNDF::fopen("subarray_upper", "subarray_lower", "rb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF::fread_subarray(&(result[0]), subarray, key), 0u);
+  JHPCNDF::fclose(key);
+  size_t num_selected=0;
+  for(size_t k=0; k<9; k++)
+  {
+    for(size_t j=0; j<21; j++)
+    {
+      for(size_t i=0; i<50; i++)
+      {
+        const size_t index=i+50*(j+21*k);
+        const bool selected = i >= 1 && (i-1)%3 == 0 && (i-1)/3 < 16 && j >= 2 && j%2 == 0 && (j-2)/2 < 10;
+        if(selected)
+        {
+          num_selected++;
+          ASSERT_EQ(data[index], result[index]) << "i, j, k = " << i << ", " << j << ", " << k;
+        }else{
+          ASSERT_EQ((TypeParam)-1.0, result[index]) << "i, j, k = " << i << ", " << j << ", " << k;
+        }
+      }
+    }
+  }
+  EXPECT_EQ(16u*10u*9u, num_selected);
+
+  //通常のfreadでも部分領域の要素数を指定して読み込める
+  std::vector<TypeParam> interior(num_selected);
+  key=JHPCNDF::fopen("subarray_upper", "subarray_lower", "rb");
+  JHPCNDF::fread(&(interior[0]), sizeof(TypeParam), interior.size(), key);
+  JHPCNDF::fclose(key);
+  EXPECT_TRUE(interior == copy_subarray(data, subarray));
+}
+
+TEST(SubarrayFileTest, UpperBitsOnly)
+{
+  const size_t extents[]={300, 200};
+  const JHPCNDF::Subarray subarray(2, extents, 2);
+  const float tolerance=0.01;
+  std::vector<double> data=make_data<double>(300*200);
+  int key=JHPCNDF::fopen("subarray_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_subarray(&(data[0]), subarray, key, tolerance, false, "quantize");
+  JHPCNDF::fclose(key);
+
+  std::vector<double> result(data.size(), 0.0);
+  key=JHPCNDF::fopen("subarray_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fread_subarray(&(result[0]), subarray, key);
+  JHPCNDF::fclose(key);
+  for(size_t j=0; j<200; j++)
+  {
+    for(size_t i=0; i<300; i++)
+    {
+      const size_t index=i+300*j;
+      if(i < 2 || i >= 298 || j < 2 || j >= 198)
+      {
+        ASSERT_EQ(0.0, result[index]) << "i, j = " << i << ", " << j;
+      }else{
+        ASSERT_LE(std::fabs(data[index]-result[index]), tolerance) << "i, j = " << i << ", " << j;
+      }
+    }
+  }
+}
+
+TEST(SubarrayFileTest, InvalidSubarray)
+{
+  const size_t extents[]={10, 10};
+  const size_t offsets[]={5, 0};
+  const size_t counts[]={6, 10};
+  std::vector<float> data=make_data<float>(100);
+  int key=JHPCNDF::fopen("subarray_upper", "subarray_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_EQ(0u, JHPCNDF::fwrite_subarray(&(data[0]), JHPCNDF::Subarray(2, extents, offsets, counts), key, 0.01));
+  JHPCNDF::fclose(key);
+  EXPECT_TRUE(read_file("subarray_upper").empty());
+}
+
+TEST(SubarrayFileTest, CAPI)
+{
+  const size_t extents[]={40, 30};
+  const size_t offsets[]={1, 1};
+  const size_t counts[]={38, 28};
+  std::vector<float> data=make_data<float>(40*30);
+  int key=JHPCNDF::fopen("subarray_upper", "subarray_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF_fwrite_subarray_float(&(data[0]), 2, extents, offsets, counts, NULL, key, 0.01, 1, "binary_search"), 0u);
+  JHPCNDF::fclose(key);
+
+  std::vector<float> result(data.size(), 0.0f);
+  key=JHPCNDF::fopen("subarray_upper", "subarray_lower", "rb");
+  EXPECT_GT(JHPCNDF_fread_subarray_float(&(result[0]), 2, extents, offsets, counts, NULL, key), 0u);
+  JHPCNDF::fclose(key);
+  for(size_t j=1; j<29; j++)
+  {
+    for(size_t i=1; i<39; i++)
+    {
+      ASSERT_EQ(data[i+40*j], result[i+40*j]) << "i, j = " << i << ", " << j;
+    }
+  }
+  EXPECT_EQ(0.0f, result[0]);
+}
@@ -0,0 +1,216 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestTemporal.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "jhpcndf.h"
+#include "Temporal.h"
+#include "TestUtility.h"
+
+namespace
+{
+  //空間的には不規則で、時間方向にはゆっくり変化する場のデータ
+  template<typename T>
+  std::vector<T> make_step(const size_t& nmemb, const int& step)
+  {
+    std::vector<T> data(nmemb);
+    unsigned int seed=12345;
+    for(size_t i=0; i<nmemb; i++)
+    {
+      seed=seed*1103515245+12345;
+      const double noise=(double)((seed>>8)&0xffff)/65536.0;
+      data[i]=(T)(100.0+noise*50.0+0.0001*step*noise);
+    }
+    return data;
+  }
+}
+
+class TemporalTest : public ::testing::TestWithParam<int>
+{
+};
+
+TEST_P(TemporalTest, LosslessRoundTrip)
+{
+  const int interval=GetParam();
+  const size_t nmemb=20000;
+  const int num_steps=12;
+
+  int key=JHPCNDF::fopen("temporal_upper", "temporal_lower", "wb");
+  ASSERT_GE(key, 0);
+  for(int step=0; step<num_steps; step++)
+  {
+    std::vector<double> data=make_step<double>(nmemb, step);
+    EXPECT_GT(JHPCNDF::fwrite_temporal(&(data[0]), nmemb, key, "u", 0.01, true, "binary_search", interval), 0u);
+  }
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("temporal_upper", "temporal_lower", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<double> result(nmemb);
+  for(int step=0; step<num_steps; step++)
+  {
+    std::vector<double> data=make_step<double>(nmemb, step);
+    ASSERT_EQ(nmemb, JHPCNDF::fread_temporal(&(result[0]), nmemb, key, "u"));
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_EQ(data[i], result[i]) << "step = " << step << " i = " << i;
+    }
+  }
+  JHPCNDF::fclose(key);
+}
+
+TEST_P(TemporalTest, UpperBitsOnly)
+{
+  const int interval=GetParam();
+  const size_t nmemb=20000;
+  const int num_steps=6;
+
+  int key=JHPCNDF::fopen("temporal_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  for(int step=0; step<num_steps; step++)
+  {
+    std::vector<float> data=make_step<float>(nmemb, step);
+    JHPCNDF::fwrite_temporal(&(data[0]), nmemb, key, "u", 0.001, true, "binary_search", interval);
+  }
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("temporal_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<float> result(nmemb);
+  for(int step=0; step<num_steps; step++)
+  {
+    std::vector<float> data=make_step<float>(nmemb, step);
+    ASSERT_EQ(nmemb, JHPCNDF::fread_temporal(&(result[0]), nmemb, key, "u"));
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_NEAR(data[i], result[i], std::fabs(data[i]*0.001)) << "step = " << step << " i = " << i;
+    }
+  }
+  JHPCNDF::fclose(key);
+}
+
+INSTANTIATE_TEST_CASE_P(KeyframeInterval, TemporalTest, ::testing::Values(1, 3, 10));
+
+TEST(TemporalSizeTest, SmallerThanFwrite)
+{
+  const size_t nmemb=50000;
+  const int num_steps=10;
+
+  int key=JHPCNDF::fopen("temporal_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  for(int step=0; step<num_steps; step++)
+  {
+    std::vector<double> data=make_step<double>(nmemb, step);
+    JHPCNDF::fwrite_temporal(&(data[0]), nmemb, key, "u", 0.01, true, "binary_search", num_steps);
+  }
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("plain_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  for(int step=0; step<num_steps; step++)
+  {
+    std::vector<double> data=make_step<double>(nmemb, step);
+    JHPCNDF::fwrite(&(data[0]), sizeof(double), nmemb, key, 0.01);
+  }
+  JHPCNDF::fclose(key);
+
+  const long temporal_size=file_size("temporal_upper");
+  const long plain_size=file_size("plain_upper");
+  ASSERT_GT(temporal_size, 0);
+  ASSERT_GT(plain_size, 0);
+  EXPECT_LT(temporal_size, plain_size);
+}
+
+TEST(TemporalVariableTest, InterleavedVariablesAndSizeChange)
+{
+  const size_t nmemb=10000;
+  int key=JHPCNDF::fopen("temporal_upper", "temporal_lower", "wb");
+  ASSERT_GE(key, 0);
+  for(int step=0; step<4; step++)
+  {
+    std::vector<double> u=make_step<double>(nmemb, step);
+    std::vector<float>  v=make_step<float>(nmemb/2, step+100);
+    JHPCNDF::fwrite_temporal(&(u[0]), nmemb, key, "u", 0.01);
+    JHPCNDF::fwrite_temporal(&(v[0]), nmemb/2, key, "v", 0.01);
+  }
+  // 要素数が変わった場合はキーフレームとして出力される
+  std::vector<double> u=make_step<double>(nmemb/4, 4);
+  JHPCNDF::fwrite_temporal(&(u[0]), nmemb/4, key, "u", 0.01);
+  JHPCNDF::fclose(key);
+
+  key=JHPCNDF::fopen("temporal_upper", "temporal_lower", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<double> result_u(nmemb);
+  std::vector<float>  result_v(nmemb/2);
+  for(int step=0; step<4; step++)
+  {
+    std::vector<double> u=make_step<double>(nmemb, step);
+    std::vector<float>  v=make_step<float>(nmemb/2, step+100);
+    ASSERT_EQ(nmemb,   JHPCNDF::fread_temporal(&(result_u[0]), nmemb, key, "u"));
+    ASSERT_EQ(nmemb/2, JHPCNDF::fread_temporal(&(result_v[0]), nmemb/2, key, "v"));
+    for(size_t i=0; i<nmemb/2; i++)
+    {
+      ASSERT_EQ(u[i], result_u[i]) << "step = " << step << " i = " << i;
+      ASSERT_EQ(v[i], result_v[i]) << "step = " << step << " i = " << i;
+    }
+  }
+  ASSERT_EQ(nmemb/4, JHPCNDF::fread_temporal(&(result_u[0]), nmemb/4, key, "u"));
+  for(size_t i=0; i<nmemb/4; i++)
+  {
+    ASSERT_EQ(u[i], result_u[i]) << "i = " << i;
+  }
+  JHPCNDF::fclose(key);
+}
+
+TEST(TemporalVariableTest, MismatchedRead)
+{
+  const size_t nmemb=1000;
+  std::vector<double> data=make_step<double>(nmemb, 0);
+  int key=JHPCNDF::fopen("temporal_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fwrite_temporal(&(data[0]), nmemb, key, "u", 0.01);
+  JHPCNDF::fwrite_temporal(&(data[0]), nmemb, key, "u", 0.01);
+  JHPCNDF::fclose(key);
+
+  // キーフレームでないレコードを参照データ無しで読もうとした場合や、型が一致しない場合は読み込まない
+  key=JHPCNDF::fopen("temporal_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<float> wrong_type(nmemb);
+  EXPECT_EQ(0u, JHPCNDF::fread_temporal(&(wrong_type[0]), nmemb, key, "u"));
+  JHPCNDF::fclose(key);
+
+  // 1レコード目を読み飛ばすと2レコード目には参照データが無い
+  key=JHPCNDF::fopen("temporal_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  std::vector<double> result(nmemb);
+  ASSERT_EQ(nmemb, JHPCNDF::fread_temporal(&(result[0]), nmemb, key, "u"));
+  EXPECT_EQ(0u, JHPCNDF::fread_temporal(&(result[0]), nmemb, key, "w"));
+  JHPCNDF::fclose(key);
+}
+
+TEST(TemporalReferenceTest, NeedsKeyframe)
+{
+  JHPCNDF::TemporalReference reference;
+  std::vector<double> data(16, 1.0);
+  EXPECT_TRUE(reference.needs_keyframe(sizeof(double), 16, 3));
+  reference.set_keyframe(&(data[0]), 16);
+  EXPECT_FALSE(reference.needs_keyframe(sizeof(double), 16, 3));
+  EXPECT_TRUE(reference.needs_keyframe(sizeof(float), 16, 3));
+  EXPECT_TRUE(reference.needs_keyframe(sizeof(double), 8, 3));
+  EXPECT_TRUE(reference.needs_keyframe(sizeof(double), 16, 1));
+  reference.to_residual(&(data[0]), 16);
+  EXPECT_EQ(0.0, data[0]);
+  EXPECT_FALSE(reference.needs_keyframe(sizeof(double), 16, 3));
+  reference.to_residual(&(data[0]), 16);
+  EXPECT_TRUE(reference.needs_keyframe(sizeof(double), 16, 3));
+}
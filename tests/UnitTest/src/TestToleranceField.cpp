@@ -0,0 +1,145 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestToleranceField.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "jhpcndf.h"
+#include "TestUtility.h"
+
+REAL_TYPED_TEST_CASE(ToleranceFieldTest);
+
+TYPED_TEST(ToleranceFieldTest, UniformFieldSameAsScalar)
+{
+  const size_t nmemb=20000;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  std::vector<float> tolerances(nmemb, 0.01f);
+  const char* encoders[]={"binary_search", "original", "linear_search", "byte_aligned", "quantize"};
+  for(size_t e=0; e<sizeof(encoders)/sizeof(char*); e++)
+  {
+    int key=JHPCNDF::fopen("scalar_upper", "scalar_lower", "wb");
+    ASSERT_GE(key, 0);
+    JHPCNDF::fwrite(&(data[0]), sizeof(TypeParam), nmemb, key, 0.01f, true, encoders[e]);
+    JHPCNDF::fclose(key);
+
+    key=JHPCNDF::fopen("field_upper", "field_lower", "wb");
+    ASSERT_GE(key, 0);
+    EXPECT_GT(JHPCNDF::fwrite_tolerance_field(&(data[0]), nmemb, key, &(tolerances[0]), true, encoders[e]), 0u);
+    JHPCNDF::fclose(key);
+    EXPECT_TRUE(read_file("scalar_upper") == read_file("field_upper")) << encoders[e];
+  }
+}
+
+TYPED_TEST(ToleranceFieldTest, PerElementTolerance)
+{
+  const size_t nmemb=20000;
+  std::vector<TypeParam> data=make_data<TypeParam>(nmemb);
+  std::vector<float> tolerances(nmemb);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    tolerances[i] = i%1000 < 100 ? 1.0e-4f : 0.5f;
+  }
+  int key=JHPCNDF::fopen("field_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  const size_t field_size=JHPCNDF::fwrite_tolerance_field(&(data[0]), nmemb, key, &(tolerances[0]), false);
+  JHPCNDF::fclose(key);
+
+  std::vector<TypeParam> result(nmemb);
+  key=JHPCNDF::fopen("field_upper", "", "rb");
+  ASSERT_GE(key, 0);
+  JHPCNDF::fread(&(result[0]), sizeof(TypeParam), nmemb, key);
+  JHPCNDF::fclose(key);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    ASSERT_LE(std::fabs(data[i]-result[i]), tolerances[i]) << "i = " << i;
+  }
+
+  //全体を最も厳しい許容誤差で出力するより小さくなる
+  key=JHPCNDF::fopen("scalar_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  const size_t tightest_size=JHPCNDF::fwrite(&(data[0]), sizeof(TypeParam), nmemb, key, 1.0e-4f, false);
+  JHPCNDF::fclose(key);
+  EXPECT_LT(field_size, tightest_size);
+}
+
+TEST(ToleranceMaskTest, RegionTable)
+{
+  const size_t nmemb=30000;
+  std::vector<double> data=make_data<double>(nmemb);
+  std::vector<unsigned char> mask(nmemb);
+  for(size_t i=0; i<nmemb; i++)
+  {
+    mask[i] = i < 500 || i >= nmemb-500 ? 0 : (i%3000 < 200 ? 1 : 2);
+  }
+  std::vector<float> table;
+  table.push_back(1.0e-6f);
+  table.push_back(1.0e-3f);
+  table.push_back(0.1f);
+  const char* encoders[]={"binary_search", "quantize"};
+  for(size_t e=0; e<sizeof(encoders)/sizeof(char*); e++)
+  {
+    int key=JHPCNDF::fopen("field_upper", "field_lower", "wb");
+    ASSERT_GE(key, 0);
+    EXPECT_GT(JHPCNDF::fwrite_tolerance_mask(&(data[0]), nmemb, key, &(mask[0]), table, false, encoders[e]), 0u);
+    JHPCNDF::fclose(key);
+
+    std::vector<double> upper(nmemb);
+    std::vector<double> lossless(nmemb);
+    key=JHPCNDF::fopen("field_upper", "", "rb");
+    ASSERT_GE(key, 0);
+    JHPCNDF::fread(&(upper[0]), sizeof(double), nmemb, key);
+    JHPCNDF::fclose(key);
+    key=JHPCNDF::fopen("field_upper", "field_lower", "rb");
+    ASSERT_GE(key, 0);
+    JHPCNDF::fread(&(lossless[0]), sizeof(double), nmemb, key);
+    JHPCNDF::fclose(key);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      ASSERT_LE(std::fabs(data[i]-upper[i]), table[mask[i]]) << encoders[e] << " i = " << i;
+      ASSERT_EQ(data[i], lossless[i]) << encoders[e] << " i = " << i;
+    }
+  }
+}
+
+TEST(ToleranceMaskTest, OutOfRangeMask)
+{
+  std::vector<float> data=make_data<float>(100);
+  std::vector<unsigned char> mask(100, 0);
+  mask[50]=2;
+  int key=JHPCNDF::fopen("field_upper", "field_lower", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_EQ(0u, JHPCNDF::fwrite_tolerance_mask(&(data[0]), 100, key, &(mask[0]), std::vector<float>(2, 0.01f)));
+  JHPCNDF::fclose(key);
+  EXPECT_TRUE(read_file("field_upper").empty());
+}
+
+TEST(ToleranceMaskTest, CAPI)
+{
+  const size_t nmemb=1000;
+  std::vector<float> data=make_data<float>(nmemb);
+  std::vector<float> tolerances(nmemb, 0.01f);
+  std::vector<unsigned char> mask(nmemb, 1);
+  const float table[]={1.0e-5f, 0.01f};
+  int key=JHPCNDF::fopen("field_upper", "", "wb");
+  ASSERT_GE(key, 0);
+  EXPECT_GT(JHPCNDF_fwrite_tolerance_field_float(&(data[0]), nmemb, key, &(tolerances[0]), 1, "binary_search"), 0u);
+  EXPECT_GT(JHPCNDF_fwrite_tolerance_mask_float(&(data[0]), nmemb, key, &(mask[0]), table, 2, 1, NULL), 0u);
+  JHPCNDF::fclose(key);
+
+  std::vector<float> first(nmemb);
+  std::vector<float> second(nmemb);
+  key=JHPCNDF::fopen("field_upper", "", "rb");
+  JHPCNDF::fread(&(first[0]), sizeof(float), nmemb, key);
+  JHPCNDF::fread(&(second[0]), sizeof(float), nmemb, key);
+  JHPCNDF::fclose(key);
+  EXPECT_TRUE(first == second);
+}
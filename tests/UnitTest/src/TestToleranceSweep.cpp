@@ -0,0 +1,116 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestToleranceSweep.cpp
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+#include "jhpcndf.h"
+#include "ToleranceSweep.h"
+#include "TestUtility.h"
+
+REAL_TYPED_TEST_CASE(ToleranceSweepTest);
+
+TYPED_TEST(ToleranceSweepTest, SameAsBinarySearchEncoder)
+{
+  const size_t nmemb=20000;
+  std::vector<TypeParam> data=make_noisy_data<TypeParam>(nmemb);
+  data[10]=(TypeParam)0.0;
+  data[11]=(TypeParam)-1.0e-30;
+  std::vector<TypeParam> upper(nmemb);
+  const float tolerances[]={1.0e-7f, 1.0e-3f, 0.5f};
+  for(size_t t=0; t<sizeof(tolerances)/sizeof(float); t++)
+  {
+    for(int relative=0; relative<2; relative++)
+    {
+      JHPCNDF::encode(nmemb, &(data[0]), &(upper[0]), (TypeParam*)NULL, tolerances[t], relative == 1);
+      for(size_t i=0; i<nmemb; i++)
+      {
+        const double tolerance = relative == 1 ? tolerances[t]*std::fabs((double)data[i]) : tolerances[t];
+        const unsigned int split_position=JHPCNDF::ToleranceSweep::required_split_position(data[i], tolerance, 0);
+        ASSERT_EQ(upper[i], n_bit_zero_padding(data[i], split_position)) << "tolerance = " << tolerances[t] << " i = " << i;
+      }
+    }
+  }
+}
+
+TYPED_TEST(ToleranceSweepTest, HistogramPerTolerance)
+{
+  const size_t nmemb=50000;
+  std::vector<TypeParam> data=make_noisy_data<TypeParam>(nmemb);
+  //順不同で指定しても指定した順に結果を返す
+  std::vector<float> tolerances;
+  tolerances.push_back(1.0e-3f);
+  tolerances.push_back(1.0e-6f);
+  tolerances.push_back(0.1f);
+  std::vector<JHPCNDF::ToleranceSweepResult> results;
+  ASSERT_EQ(3u, JHPCNDF::sweep_tolerances(&(data[0]), nmemb, tolerances, &results));
+  ASSERT_EQ(3u, results.size());
+  const size_t num_bins = sizeof(TypeParam) == 4 ? 24 : 53;
+  for(size_t k=0; k<results.size(); k++)
+  {
+    EXPECT_EQ(tolerances[k], results[k].tolerance);
+    ASSERT_EQ(num_bins, results[k].histogram.size());
+    size_t total=0;
+    for(size_t n=0; n<num_bins; n++)
+    {
+      total+=results[k].histogram[n];
+    }
+    EXPECT_EQ(nmemb, total);
+
+    //ヒストグラムはbinary_searchエンコーダの分割位置を数えたもの
+    std::vector<size_t> expected(num_bins, 0);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      expected[JHPCNDF::ToleranceSweep::required_split_position(data[i], tolerances[k]*std::fabs((double)data[i]), 0)]++;
+    }
+    EXPECT_TRUE(expected == results[k].histogram) << "tolerance = " << tolerances[k];
+
+    //推定サイズはestimate_compressed_sizeと同じ
+    size_t lower_size=0;
+    EXPECT_EQ(JHPCNDF::estimate_compressed_size(&(data[0]), nmemb, tolerances[k], true, "binary_search", "gzip", &lower_size), results[k].estimated_upper_size);
+    EXPECT_EQ(lower_size, results[k].estimated_lower_size);
+  }
+  //許容誤差が緩いほど0埋めするbit数が増えて、上位bit側が小さくなる
+  EXPECT_LT(results[1].mean_truncated_bits, results[0].mean_truncated_bits);
+  EXPECT_LT(results[0].mean_truncated_bits, results[2].mean_truncated_bits);
+  EXPECT_GT(results[1].estimated_upper_size, results[0].estimated_upper_size);
+  EXPECT_GT(results[0].estimated_upper_size, results[2].estimated_upper_size);
+}
+
+TEST(ToleranceSweepFileTest, InvalidArguments)
+{
+  std::vector<float> data=make_noisy_data<float>(100);
+  std::vector<JHPCNDF::ToleranceSweepResult> results;
+  EXPECT_EQ(0u, JHPCNDF::sweep_tolerances(&(data[0]), 100, std::vector<float>(), &results));
+  EXPECT_EQ(0u, JHPCNDF::sweep_tolerances(&(data[0]), 100, std::vector<float>(1, 0.01f), &results, true, "nbit_filter"));
+  EXPECT_TRUE(results.empty());
+}
+
+TEST(ToleranceSweepFileTest, CAPI)
+{
+  const size_t nmemb=10000;
+  std::vector<double> data=make_noisy_data<double>(nmemb);
+  const float tolerances[]={1.0e-2f, 1.0e-4f};
+  std::vector<size_t> histograms(2*53, 0);
+  size_t upper_sizes[2]={0, 0};
+  size_t lower_sizes[2]={0, 0};
+  EXPECT_EQ(2u, JHPCNDF_sweep_tolerances_double(&(data[0]), nmemb, tolerances, 2, 0, NULL, NULL, &(histograms[0]), upper_sizes, lower_sizes));
+
+  std::vector<JHPCNDF::ToleranceSweepResult> results;
+  JHPCNDF::sweep_tolerances(&(data[0]), nmemb, std::vector<float>(tolerances, tolerances+2), &results, false);
+  for(size_t k=0; k<2; k++)
+  {
+    EXPECT_TRUE(std::vector<size_t>(histograms.begin()+k*53, histograms.begin()+(k+1)*53) == results[k].histogram);
+    EXPECT_EQ(results[k].estimated_upper_size, upper_sizes[k]);
+    EXPECT_EQ(results[k].estimated_lower_size, lower_sizes[k]);
+  }
+  EXPECT_EQ(0u, JHPCNDF_sweep_tolerances_float((float*)NULL, 0, tolerances, 2, 1, NULL, NULL, NULL, NULL, NULL));
+}
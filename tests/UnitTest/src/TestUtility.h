@@ -0,0 +1,107 @@
+/*
+ * JHPCN-DF - Data compression library based on
+ *            Jointed Hierarchical Precision Compression Number Data Format
+ *
+ * Copyright (c) 2014-2015 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+// @file TestUtility.h
+//
+// 複数のテストで共通に使うテストデータの生成関数とファイル操作の補助関数
+
+#ifndef JHPCNDF_TEST_UTILITY_H
+#define JHPCNDF_TEST_UTILITY_H
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+//@brief float, doubleの両方について実行する、メンバを持たない型付きテストのフィクスチャを定義する
+#define REAL_TYPED_TEST_CASE(CaseName) \
+  template<typename T> \
+  class CaseName : public ::testing::Test \
+  { \
+  }; \
+  TYPED_TEST_CASE(CaseName, RealTypes)
+
+typedef ::testing::Types<float, double> RealTypes;
+
+namespace
+{
+  //@brief 滑らかに変化するデータを生成する
+  //@param nmemb  要素数
+  //@param offset 全要素に加える値
+  template<typename T>
+  std::vector<T> make_data(const size_t& nmemb, const double& offset=0.0)
+  {
+    std::vector<T> data(nmemb);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      data[i]=(T)(300.0+offset+std::sin(0.001*i)*20.0+std::cos(0.037*i)*0.5);
+    }
+    return data;
+  }
+
+  //@brief make_dataのデータに、隣接要素間で変化する小さな揺らぎを加えたデータを生成する
+  template<typename T>
+  std::vector<T> make_noisy_data(const size_t& nmemb)
+  {
+    std::vector<T> data(nmemb);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      data[i]=(T)(300.0+std::sin(0.001*i)*20.0+std::cos(0.037*i)*0.5+std::sin(1.3*i)*0.01);
+    }
+    return data;
+  }
+
+  //@brief レコード毎に振幅が異なるデータを生成する
+  //@param record レコード番号
+  template<typename T>
+  std::vector<T> make_record_data(const size_t& nmemb, const int& record)
+  {
+    std::vector<T> data(nmemb);
+    for(size_t i=0; i<nmemb; i++)
+    {
+      data[i]=(T)(std::sin(0.002*i)*(record+1)*100.0);
+    }
+    return data;
+  }
+
+  //@brief ファイルサイズ(byte)を返す
+  //@ret   ファイルを開けなかった時は-1
+  inline long file_size(const char* filename)
+  {
+    FILE* fp=std::fopen(filename, "rb");
+    if(fp == NULL)
+    {
+      return -1;
+    }
+    std::fseek(fp, 0, SEEK_END);
+    const long size=std::ftell(fp);
+    std::fclose(fp);
+    return size;
+  }
+
+  //@brief ファイルの内容を全て読み込む
+  //@ret   ファイルを開けなかった時は空
+  inline std::vector<char> read_file(const char* filename)
+  {
+    std::vector<char> contents;
+    FILE* fp=std::fopen(filename, "rb");
+    if(fp == NULL)
+    {
+      return contents;
+    }
+    char buffer[4096];
+    size_t length=0;
+    while((length=std::fread(buffer, 1, sizeof(buffer), fp)) > 0)
+    {
+      contents.insert(contents.end(), buffer, buffer+length);
+    }
+    std::fclose(fp);
+    return contents;
+  }
+}
+#endif